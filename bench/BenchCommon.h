@@ -0,0 +1,28 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+
+namespace cg::bench
+{
+
+    /**
+     * @brief Executa function runs vezes e retorna o menor tempo medido, em milissegundos
+     *
+     * O melhor tempo descarta interferências externas (agendador, caches frios)
+     * que só podem deixar uma execução mais lenta.
+     */
+    template <typename Function>
+    double bestOfMs(int runs, Function &&function)
+    {
+        double best = 1e30;
+        for (int run = 0; run < runs; ++run)
+        {
+            auto startTime = std::chrono::high_resolution_clock::now();
+            function();
+            auto endTime = std::chrono::high_resolution_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(endTime - startTime).count());
+        }
+        return best;
+    }
+
+} // namespace cg::bench
@@ -0,0 +1,94 @@
+#include "core/Simd.h"
+#include "render/Bvh.h"
+#include "render/FrustumCuller.h"
+#include "BenchCommon.h"
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+// Mede a vazão do frustum culling em lote (FrustumCuller) e hierárquico (Bvh)
+// contra o teste caixa a caixa (Frustum::intersects) para cenas com muitas meshes.
+// Uso: cg_bench_culling [número de caixas] (padrão: 100000)
+
+using cg::bench::bestOfMs;
+
+int main(int argc, char **argv)
+{
+    size_t count = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 100000;
+    if (count == 0)
+        count = 100000;
+
+    // Caixas pequenas espalhadas num cubo de 2 km ao redor da câmera
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> size(0.5f, 20.0f);
+
+    std::vector<cg::BoundingBox> boxes(count);
+    cg::FrustumCuller culler;
+    culler.reserve(count);
+    for (cg::BoundingBox &box : boxes)
+    {
+        glm::vec3 center(position(rng), position(rng), position(rng));
+        glm::vec3 extents(size(rng), size(rng), size(rng));
+        box.min = center - extents;
+        box.max = center + extents;
+        culler.add(box);
+    }
+
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 800.0f);
+    cg::Frustum frustum = cg::Frustum::fromMatrix(projection * view);
+
+    const int runs = 20;
+    std::vector<uint32_t> visible;
+    visible.reserve(count);
+
+    double batchMs = bestOfMs(runs, [&]
+                              { culler.cull(frustum, visible); });
+    size_t batchVisible = visible.size();
+
+    size_t scalarVisible = 0;
+    double scalarMs = bestOfMs(runs, [&]
+                               {
+        scalarVisible = 0;
+        for (const cg::BoundingBox &box : boxes)
+        {
+            if (frustum.intersects(box))
+                ++scalarVisible;
+        } });
+
+    cg::Bvh bvh;
+    double buildMs = bestOfMs(1, [&]
+                              { bvh.build(boxes); });
+    size_t bvhVisible = 0;
+    size_t nodesVisited = 0;
+    double bvhMs = bestOfMs(runs, [&]
+                            { bvhVisible = bvh.cullFrustum(frustum, visible, &nodesVisited); });
+
+#if defined(CG_SIMD_AVX)
+    const char *path = "AVX (8 caixas por lote)";
+#elif defined(CG_SIMD_SSE)
+    const char *path = "SSE (4 caixas por lote)";
+#else
+    const char *path = "escalar";
+#endif
+
+    std::cout << "=== Frustum culling: " << count << " caixas ===" << std::endl;
+    std::cout << "Caminho em lote: " << path << std::endl;
+    std::cout << "Lote (SoA):      " << batchMs << " ms, " << (count / batchMs / 1000.0) << " M caixas/s, "
+              << batchVisible << " visíveis" << std::endl;
+    std::cout << "Caixa a caixa:   " << scalarMs << " ms, " << (count / scalarMs / 1000.0) << " M caixas/s, "
+              << scalarVisible << " visíveis" << std::endl;
+    std::cout << "BVH:             " << bvhMs << " ms, " << (count / bvhMs / 1000.0) << " M caixas/s, "
+              << bvhVisible << " visíveis, " << nodesVisited << " de " << bvh.getNodeCount() << " nós visitados"
+              << " (construção: " << buildMs << " ms)" << std::endl;
+
+    if (batchVisible != scalarVisible || bvhVisible != scalarVisible)
+    {
+        std::cerr << "Resultados divergentes entre os métodos de culling" << std::endl;
+        return 1;
+    }
+    return 0;
+}
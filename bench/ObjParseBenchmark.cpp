@@ -0,0 +1,315 @@
+#include "render/MeshData.h"
+#include "render/ModelLoader.h"
+#include "BenchCommon.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Mede a vazão (linhas/s) do parser OBJ antigo, que lia com std::getline e
+// tokenizava cada linha com std::istringstream, std::stoi e chaves em string,
+// contra o parser atual do ModelLoader lendo o mesmo arquivo linha a linha
+// (useMemoryMap = false) e mapeado em memória (useMemoryMap = true), ambos em
+// modo serial e sem o cache binário.
+// Uso: cg_bench_obj_parse [arquivo.obj] (padrão: malha sintética de 500 x 500 quads)
+
+namespace
+{
+    using cg::bench::bestOfMs;
+
+    // Linhas por segundo, em milhões
+    double mlps(size_t lines, double ms)
+    {
+        return lines / ms / 1000.0;
+    }
+
+    // Grava uma grade de size x size quads (dois triângulos cada) com v/vt/vn e faces v/vt/vn
+    std::string writeSyntheticObj(int size)
+    {
+        std::filesystem::path path = std::filesystem::temp_directory_path() / "cg_bench_obj_parse.obj";
+        std::ofstream out(path);
+        out << "# Malha sintética do cg_bench_obj_parse\n";
+        out << "o Grade\n";
+        for (int z = 0; z <= size; ++z)
+        {
+            for (int x = 0; x <= size; ++x)
+            {
+                out << "v " << x * 0.1f << " " << 0.01f * ((x * 7 + z * 13) % 11) << " " << z * 0.1f << "\n";
+                out << "vt " << static_cast<float>(x) / size << " " << static_cast<float>(z) / size << "\n";
+                out << "vn 0 1 0\n";
+            }
+        }
+        for (int z = 0; z < size; ++z)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                int a = z * (size + 1) + x + 1;
+                int b = a + 1;
+                int c = a + size + 1;
+                int d = c + 1;
+                out << "f " << a << "/" << a << "/" << a << " " << c << "/" << c << "/" << c << " "
+                    << b << "/" << b << "/" << b << "\n";
+                out << "f " << b << "/" << b << "/" << b << " " << c << "/" << c << "/" << c << " "
+                    << d << "/" << d << "/" << d << "\n";
+            }
+        }
+        return path.string();
+    }
+
+    // =================== PARSER ANTIGO (GETLINE + ISTRINGSTREAM) ===================
+    // Reprodução do caminho de parsing anterior ao arquivo mapeado: uma
+    // std::string por linha, trim com cópia, um istringstream por linha e
+    // índices de face separados com split + std::stoi, deduplicados por chave
+    // "p/t/n" em std::unordered_map<std::string, unsigned>.
+    struct LegacyResult
+    {
+        size_t lines = 0;
+        size_t vertices = 0;
+        size_t triangles = 0;
+    };
+
+    struct LegacyFaceIndex
+    {
+        int positionIndex = -1;
+        int texCoordIndex = -1;
+        int normalIndex = -1;
+    };
+
+    std::string trim(const std::string &str)
+    {
+        size_t first = str.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos)
+            return "";
+        size_t last = str.find_last_not_of(" \t\r\n");
+        return str.substr(first, last - first + 1);
+    }
+
+    std::vector<std::string> split(const std::string &str, char delimiter)
+    {
+        std::vector<std::string> tokens;
+        std::string token;
+        std::istringstream tokenStream(str);
+        while (std::getline(tokenStream, token, delimiter))
+            tokens.push_back(token);
+        return tokens;
+    }
+
+    LegacyFaceIndex parseFaceIndex(const std::string &indexStr)
+    {
+        LegacyFaceIndex faceIndex;
+        std::vector<std::string> parts = split(indexStr, '/');
+        if (!parts.empty() && !parts[0].empty())
+            faceIndex.positionIndex = std::stoi(parts[0]);
+        if (parts.size() > 1 && !parts[1].empty())
+            faceIndex.texCoordIndex = std::stoi(parts[1]);
+        if (parts.size() > 2 && !parts[2].empty())
+            faceIndex.normalIndex = std::stoi(parts[2]);
+        return faceIndex;
+    }
+
+    struct LegacyParser
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec2> texCoords;
+        std::vector<cg::Vertex> currentVertices;
+        std::vector<unsigned> currentIndices;
+        std::unordered_map<std::string, unsigned> vertexMap;
+        LegacyResult result;
+
+        void makeAbsolute(LegacyFaceIndex &index) const
+        {
+            if (index.positionIndex < 0)
+                index.positionIndex = static_cast<int>(positions.size()) + index.positionIndex + 1;
+            if (index.texCoordIndex < 0)
+                index.texCoordIndex = static_cast<int>(texCoords.size()) + index.texCoordIndex + 1;
+            if (index.normalIndex < 0)
+                index.normalIndex = static_cast<int>(normals.size()) + index.normalIndex + 1;
+            if (index.positionIndex > 0)
+                index.positionIndex--;
+            if (index.texCoordIndex > 0)
+                index.texCoordIndex--;
+            if (index.normalIndex > 0)
+                index.normalIndex--;
+        }
+
+        unsigned getOrCreateVertex(const LegacyFaceIndex &index)
+        {
+            std::string key = std::to_string(index.positionIndex) + "/" +
+                              std::to_string(index.texCoordIndex) + "/" +
+                              std::to_string(index.normalIndex);
+            auto it = vertexMap.find(key);
+            if (it != vertexMap.end())
+                return it->second;
+
+            cg::Vertex vertex;
+            if (index.positionIndex >= 0 && index.positionIndex < static_cast<int>(positions.size()))
+                vertex.position = positions[index.positionIndex];
+            if (index.texCoordIndex >= 0 && index.texCoordIndex < static_cast<int>(texCoords.size()))
+                vertex.texCoords = texCoords[index.texCoordIndex];
+            if (index.normalIndex >= 0 && index.normalIndex < static_cast<int>(normals.size()))
+                vertex.normal = normals[index.normalIndex];
+
+            unsigned vertexIndex = static_cast<unsigned>(currentVertices.size());
+            currentVertices.push_back(vertex);
+            vertexMap[key] = vertexIndex;
+            return vertexIndex;
+        }
+
+        void finalizeMesh()
+        {
+            result.vertices += currentVertices.size();
+            result.triangles += currentIndices.size() / 3;
+            currentVertices.clear();
+            currentIndices.clear();
+            vertexMap.clear();
+        }
+
+        void parseLine(const std::string &line)
+        {
+            std::string trimmedLine = trim(line);
+            if (trimmedLine.size() < 2 || trimmedLine[0] == '#')
+                return;
+
+            std::istringstream iss(trimmedLine);
+            std::string token;
+            if (trimmedLine[0] == 'v' && trimmedLine[1] == ' ')
+            {
+                float x, y, z;
+                iss >> token;
+                if (!(iss >> x >> y >> z))
+                    throw std::runtime_error("Formato inválido para vértice");
+                positions.emplace_back(x, y, z);
+            }
+            else if (trimmedLine.substr(0, 2) == "vn")
+            {
+                float x, y, z;
+                iss >> token;
+                if (!(iss >> x >> y >> z))
+                    throw std::runtime_error("Formato inválido para normal");
+                glm::vec3 normal(x, y, z);
+                float length = glm::length(normal);
+                if (length > 0.0f)
+                    normal /= length;
+                normals.push_back(normal);
+            }
+            else if (trimmedLine.substr(0, 2) == "vt")
+            {
+                float u, v = 0.0f;
+                iss >> token;
+                if (!(iss >> u))
+                    throw std::runtime_error("Formato inválido para coordenada de textura");
+                iss >> v;
+                texCoords.emplace_back(u, v);
+            }
+            else if (trimmedLine[0] == 'f' && trimmedLine[1] == ' ')
+            {
+                iss >> token;
+                std::vector<LegacyFaceIndex> faceIndices;
+                while (iss >> token)
+                    faceIndices.push_back(parseFaceIndex(token));
+                for (auto &faceIndex : faceIndices)
+                    makeAbsolute(faceIndex);
+                for (size_t i = 2; i < faceIndices.size(); ++i)
+                {
+                    currentIndices.push_back(getOrCreateVertex(faceIndices[0]));
+                    currentIndices.push_back(getOrCreateVertex(faceIndices[i - 1]));
+                    currentIndices.push_back(getOrCreateVertex(faceIndices[i]));
+                }
+            }
+            else if (trimmedLine[0] == 'o' && trimmedLine[1] == ' ')
+            {
+                finalizeMesh();
+            }
+        }
+    };
+
+    LegacyResult parseLegacy(const std::string &path)
+    {
+        std::ifstream file(path);
+        LegacyParser parser;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            parser.result.lines++;
+            try
+            {
+                parser.parseLine(line);
+            }
+            catch (const std::exception &)
+            {
+                // Como no parser antigo: a linha inválida é ignorada
+            }
+        }
+        parser.finalizeMesh();
+        return parser.result;
+    }
+
+    // Melhor tempo de parsing (LoadStats::parseTimeMs) do ModelLoader em runs execuções
+    cg::ModelLoader::LoadStats bestLoaderRun(const std::string &path, bool useMemoryMap, int runs)
+    {
+        cg::ModelLoader::LoadOptions options;
+        options.useMemoryMap = useMemoryMap;
+        options.workerCount = 1;
+        options.useCache = false;
+        options.shareDuplicateGeometry = false;
+
+        cg::ModelLoader::LoadStats best;
+        best.parseTimeMs = 1e30f;
+        for (int run = 0; run < runs; ++run)
+        {
+            cg::ModelLoader::LoadStats stats;
+            if (!cg::ModelLoader::loadModelData(path, "bench", options, &stats))
+                return cg::ModelLoader::LoadStats{};
+            if (stats.parseTimeMs < best.parseTimeMs)
+                best = stats;
+        }
+        return best;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string path = argc > 1 ? argv[1] : writeSyntheticObj(500);
+    if (!std::filesystem::exists(path))
+    {
+        std::cerr << "Arquivo não encontrado: " << path << std::endl;
+        return 1;
+    }
+
+    const int runs = 5;
+
+    LegacyResult legacy;
+    double legacyMs = bestOfMs(runs, [&]
+                               { legacy = parseLegacy(path); });
+
+    cg::ModelLoader::LoadStats getlineStats = bestLoaderRun(path, false, runs);
+    cg::ModelLoader::LoadStats mappedStats = bestLoaderRun(path, true, runs);
+    if (getlineStats.totalLines == 0 || mappedStats.totalLines == 0)
+    {
+        std::cerr << "Falha ao carregar " << path << " com o ModelLoader" << std::endl;
+        return 1;
+    }
+
+    std::cout << "=== Parsing OBJ: " << path << " ===" << std::endl;
+    std::cout << legacy.lines << " linhas, " << legacy.triangles << " triângulos" << std::endl;
+    std::cout << "                          ms       M linhas/s   ganho" << std::endl;
+    std::cout << "Antigo (istringstream):   " << legacyMs << "   " << mlps(legacy.lines, legacyMs)
+              << "   1x" << std::endl;
+    std::cout << "Atual, getline:           " << getlineStats.parseTimeMs << "   "
+              << getlineStats.linesPerSecond / 1.0e6 << "   " << legacyMs / getlineStats.parseTimeMs << "x" << std::endl;
+    std::cout << "Atual, mmap:              " << mappedStats.parseTimeMs << "   "
+              << mappedStats.linesPerSecond / 1.0e6 << "   " << legacyMs / mappedStats.parseTimeMs << "x" << std::endl;
+
+    if (legacy.triangles != mappedStats.totalTriangles || legacy.triangles != getlineStats.totalTriangles)
+    {
+        std::cerr << "Contagem de triângulos divergente entre os parsers" << std::endl;
+        return 1;
+    }
+    return 0;
+}
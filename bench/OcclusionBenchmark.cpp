@@ -0,0 +1,156 @@
+#include "render/OcclusionCuller.h"
+#include "BenchCommon.h"
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+// Mede o OcclusionCuller numa cena sintética, sem GPU: um muro subdividido à
+// frente da câmera esconde parte de muitas caixas espalhadas atrás dele.
+// Cada caixa declarada oculta é conferida analiticamente contra o muro (todos
+// os cantos atrás do plano dele e projetados dentro do retângulo, com a folga
+// de um pixel do buffer: a cobertura é amostrada no centro dos pixels).
+// Uso: cg_bench_occlusion [número de caixas] (padrão: 100000)
+
+namespace
+{
+    using cg::bench::bestOfMs;
+
+    // Muro no plano z = kWallZ, de (-kWallHalfWidth, 0) a (kWallHalfWidth, kWallHeight)
+    constexpr float kWallZ = -20.0f;
+    constexpr float kWallHalfWidth = 10.0f;
+    constexpr float kWallHeight = 12.0f;
+
+    // Caixa inteiramente escondida pelo muro (ampliado por margin), vista da origem
+    bool hiddenByWall(const cg::BoundingBox &box, float margin = 0.0f)
+    {
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            glm::vec3 p((corner & 1) ? box.max.x : box.min.x,
+                        (corner & 2) ? box.max.y : box.min.y,
+                        (corner & 4) ? box.max.z : box.min.z);
+            if (p.z >= kWallZ)
+                return false;
+            float t = kWallZ / p.z;
+            float x = p.x * t;
+            float y = p.y * t;
+            if (x < -kWallHalfWidth - margin || x > kWallHalfWidth + margin || y < -margin || y > kWallHeight + margin)
+                return false;
+        }
+        return true;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t count = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 100000;
+    if (count == 0)
+        count = 100000;
+
+    // =================== OCLUSOR ===================
+    // Muro de 64 x 32 quads (4096 triângulos), como um oclusor com malha densa
+    const int columns = 64;
+    const int rows = 32;
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+    for (int y = 0; y <= rows; ++y)
+    {
+        for (int x = 0; x <= columns; ++x)
+        {
+            positions.emplace_back(-kWallHalfWidth + 2.0f * kWallHalfWidth * x / columns, kWallHeight * y / rows, kWallZ);
+        }
+    }
+    for (int y = 0; y < rows; ++y)
+    {
+        for (int x = 0; x < columns; ++x)
+        {
+            uint32_t i = static_cast<uint32_t>(y * (columns + 1) + x);
+            uint32_t quad[6] = {i, i + 1, i + columns + 2, i, i + columns + 2, i + columns + 1};
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+
+    // =================== CAIXAS ===================
+    // Espalhadas à frente da câmera, entre ela e 200 unidades, dentro do campo de visão
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> depth(-200.0f, -2.0f);
+    std::uniform_real_distribution<float> side(-0.7f, 0.7f);
+    std::uniform_real_distribution<float> height(0.0f, 0.4f);
+    std::uniform_real_distribution<float> size(0.2f, 2.0f);
+
+    std::vector<cg::BoundingBox> boxes(count);
+    size_t hiddenCount = 0;
+    for (cg::BoundingBox &box : boxes)
+    {
+        float z = depth(rng);
+        glm::vec3 center(side(rng) * -z, height(rng) * -z, z);
+        glm::vec3 extents(size(rng), size(rng), size(rng));
+        box.min = center - extents;
+        box.max = center + extents;
+        if (hiddenByWall(box))
+            ++hiddenCount;
+    }
+
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+    glm::mat4 viewProjection = projection * view;
+
+    // Altura de um pixel do buffer (128 linhas) no plano do muro
+    const float pixelAtWall = 2.0f * -kWallZ * std::tan(glm::radians(35.0f)) / 128.0f;
+
+    const int runs = 20;
+    std::cout << "=== Occlusion culling por software: " << count << " caixas, " << indices.size() / 3
+              << " triângulos oclusores ===" << std::endl;
+    std::cout << "Caminho: " << cg::OcclusionCuller::getPathName() << std::endl;
+
+    unsigned maxThreads = std::min(4u, std::max(1u, std::thread::hardware_concurrency()));
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        cg::OcclusionCuller culler(256, 128, threads);
+
+        double rasterMs = bestOfMs(runs, [&]
+                                   {
+            culler.beginFrame(viewProjection);
+            culler.addOccluder(glm::mat4(1.0f), positions.data(), sizeof(glm::vec3), positions.size(),
+                               indices.data(), indices.size());
+            culler.rasterize(); });
+
+        std::vector<uint8_t> occludedFlags(count);
+        double testMs = bestOfMs(runs, [&]
+                                 {
+            for (size_t i = 0; i < count; ++i)
+                occludedFlags[i] = culler.isOccluded(boxes[i]); });
+
+        size_t occluded = 0;
+        size_t wrong = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (occludedFlags[i])
+            {
+                ++occluded;
+                if (!hiddenByWall(boxes[i], pixelAtWall))
+                    ++wrong;
+            }
+        }
+
+        std::cout << threads << " thread(s): oclusores + rasterização " << rasterMs << " ms, teste "
+                  << testMs << " ms (" << testMs * 1e6 / count << " ns/caixa)" << std::endl;
+        if (threads == 1)
+        {
+            std::cout << "Caixas ocultas: " << occluded << " de " << hiddenCount << " escondidas pelo muro ("
+                      << count - occluded << " desenhadas)" << std::endl;
+        }
+
+        if (wrong > 0)
+        {
+            std::cerr << wrong << " caixas visíveis foram declaradas ocultas" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include "render/TransformKernel.h"
+#include "BenchCommon.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+// Mede a vazão do TransformKernel (composição TRS, pai * local e matrizes de
+// normais em estrutura de arrays) contra o caminho escalar com glm usado antes
+// por Model (translate/rotate/scale, produto e transpose(inverse(mat3))).
+// Uso: cg_bench_transforms [número de matrizes] (padrão: 100000)
+
+namespace
+{
+    using cg::bench::bestOfMs;
+
+    glm::mat4 composeGlm(const glm::vec3 &translation, const glm::vec3 &rotation, const glm::vec3 &scale)
+    {
+        glm::mat4 matrix = glm::translate(glm::mat4(1.0f), translation);
+        matrix = glm::rotate(matrix, rotation.x, glm::vec3(1.0f, 0.0f, 0.0f));
+        matrix = glm::rotate(matrix, rotation.y, glm::vec3(0.0f, 1.0f, 0.0f));
+        matrix = glm::rotate(matrix, rotation.z, glm::vec3(0.0f, 0.0f, 1.0f));
+        return glm::scale(matrix, scale);
+    }
+
+    // Matrizes por segundo, em milhões
+    double mps(size_t count, double ms)
+    {
+        return count / ms / 1000.0;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t count = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 100000;
+    if (count == 0)
+        count = 100000;
+
+    // Transformações locais e matrizes de pais aleatórias (escala positiva, sem degeneração)
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+    std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+    std::vector<glm::vec3> translations(count), rotations(count), scales(count);
+    std::vector<glm::mat4> parents(count);
+    cg::TrsArray trs;
+    trs.resize(count);
+    cg::Mat4Array parentArray;
+    parentArray.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        translations[i] = glm::vec3(position(rng), position(rng), position(rng));
+        rotations[i] = glm::vec3(angle(rng), angle(rng), angle(rng));
+        scales[i] = glm::vec3(scale(rng), scale(rng), scale(rng));
+        trs.set(i, translations[i], rotations[i], scales[i]);
+
+        parents[i] = composeGlm(glm::vec3(position(rng), position(rng), position(rng)),
+                                glm::vec3(angle(rng), angle(rng), angle(rng)), glm::vec3(scale(rng)));
+        parentArray.set(i, parents[i]);
+    }
+
+    const int runs = 20;
+
+    // =================== CAMINHO GLM (ESCALAR) ===================
+    std::vector<glm::mat4> locals(count), worlds(count);
+    std::vector<glm::mat3> normals(count);
+    double glmComposeMs = bestOfMs(runs, [&]
+                                   {
+        for (size_t i = 0; i < count; ++i)
+            locals[i] = composeGlm(translations[i], rotations[i], scales[i]); });
+    double glmMultiplyMs = bestOfMs(runs, [&]
+                                    {
+        for (size_t i = 0; i < count; ++i)
+            worlds[i] = parents[i] * locals[i]; });
+    double glmNormalMs = bestOfMs(runs, [&]
+                                  {
+        for (size_t i = 0; i < count; ++i)
+            normals[i] = glm::transpose(glm::inverse(glm::mat3(worlds[i]))); });
+
+    // =================== KERNEL EM LOTE (SoA) ===================
+    cg::Mat4Array localArray, worldArray;
+    cg::Mat3Array normalArray;
+    double batchComposeMs = bestOfMs(runs, [&]
+                                     { cg::TransformKernel::composeTrs(trs, localArray); });
+    double batchMultiplyMs = bestOfMs(runs, [&]
+                                      { cg::TransformKernel::multiply(parentArray, localArray, worldArray); });
+    double batchNormalMs = bestOfMs(runs, [&]
+                                    { cg::TransformKernel::normalMatrices(worldArray, normalArray); });
+
+    // =================== CONFERÊNCIA ===================
+    // Erro relativo à maior magnitude de cada matriz (as escalas acumuladas chegam a ~4)
+    float worldError = 0.0f;
+    float normalError = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+    {
+        glm::mat4 world = worldArray.get(i);
+        glm::mat3 normal = normalArray.get(i);
+        for (int c = 0; c < 4; ++c)
+        {
+            for (int r = 0; r < 4; ++r)
+            {
+                float magnitude = std::max(1.0f, std::abs(worlds[i][c][r]));
+                worldError = std::max(worldError, std::abs(world[c][r] - worlds[i][c][r]) / magnitude);
+            }
+        }
+        for (int c = 0; c < 3; ++c)
+        {
+            for (int r = 0; r < 3; ++r)
+            {
+                float magnitude = std::max(1.0f, std::abs(normals[i][c][r]));
+                normalError = std::max(normalError, std::abs(normal[c][r] - normals[i][c][r]) / magnitude);
+            }
+        }
+    }
+
+    double glmTotalMs = glmComposeMs + glmMultiplyMs + glmNormalMs;
+    double batchTotalMs = batchComposeMs + batchMultiplyMs + batchNormalMs;
+
+    std::cout << "=== Matrizes de mundo e de normais: " << count << " matrizes ===" << std::endl;
+    std::cout << "Caminho em lote: " << cg::TransformKernel::getPathName() << std::endl;
+    std::cout << "                 glm (M/s)   lote (M/s)   ganho" << std::endl;
+    std::cout << "Composição TRS:  " << mps(count, glmComposeMs) << "   " << mps(count, batchComposeMs)
+              << "   " << glmComposeMs / batchComposeMs << "x" << std::endl;
+    std::cout << "Pai * local:     " << mps(count, glmMultiplyMs) << "   " << mps(count, batchMultiplyMs)
+              << "   " << glmMultiplyMs / batchMultiplyMs << "x" << std::endl;
+    std::cout << "Normais:         " << mps(count, glmNormalMs) << "   " << mps(count, batchNormalMs)
+              << "   " << glmNormalMs / batchNormalMs << "x" << std::endl;
+    std::cout << "Total:           " << mps(count, glmTotalMs) << "   " << mps(count, batchTotalMs)
+              << "   " << glmTotalMs / batchTotalMs << "x" << std::endl;
+    std::cout << "Erro máximo (relativo): mundo " << worldError << ", normais " << normalError << std::endl;
+
+    if (worldError > 1e-4f || normalError > 1e-4f)
+    {
+        std::cerr << "Resultados divergentes entre o kernel em lote e o glm" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "render/ModelLoader.h"
+#include "BenchCommon.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Mede a deduplicação de vértices das faces OBJ: o caminho antigo, com chave
+// "p/t/n" montada com std::to_string em std::unordered_map<std::string, GLuint>
+// (e a variante ordenada com std::map), contra a tabela de endereçamento
+// aberto do ModelLoader (VertexDedupTable). A entrada é uma grade de quads
+// triangulada, com cada vértice referenciado por ~6 cantos de face, dividida
+// em objetos de 16 linhas da grade (a tabela é limpa a cada objeto, como no
+// parser).
+// Uso: cg_bench_vertex_dedup [quads por lado] (padrão: 512)
+
+namespace
+{
+    using FaceIndex = cg::ModelLoader::FaceIndex;
+
+    using cg::bench::bestOfMs;
+
+    // Faces por segundo, em milhões
+    double mfps(size_t faces, double ms)
+    {
+        return faces / ms / 1000.0;
+    }
+
+    std::string makeKey(const FaceIndex &index)
+    {
+        return std::to_string(index.positionIndex) + "/" +
+               std::to_string(index.texCoordIndex) + "/" +
+               std::to_string(index.normalIndex);
+    }
+
+    // Percorre os cantos mesh a mesh, inserindo cada chave ausente com o próximo índice.
+    // Retorna o total de vértices únicos (soma por mesh)
+    template <typename Lookup, typename Clear>
+    size_t dedup(const std::vector<FaceIndex> &corners, const std::vector<size_t> &meshEnds,
+                 std::vector<GLuint> &indices, Lookup &&lookup, Clear &&clear)
+    {
+        size_t uniqueVertices = 0;
+        size_t begin = 0;
+        for (size_t end : meshEnds)
+        {
+            GLuint nextVertex = 0;
+            for (size_t i = begin; i < end; ++i)
+                indices[i] = lookup(corners[i], nextVertex);
+            uniqueVertices += nextVertex;
+            clear();
+            begin = end;
+        }
+        return uniqueVertices;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int size = argc > 1 ? std::atoi(argv[1]) : 512;
+    if (size <= 0)
+        size = 512;
+
+    // Cantos de face (índices já absolutos) da grade, objetos de 16 linhas
+    const int rowsPerMesh = 16;
+    std::vector<FaceIndex> corners;
+    std::vector<size_t> meshEnds;
+    corners.reserve(static_cast<size_t>(size) * size * 6);
+    for (int z = 0; z < size; ++z)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            int a = z * (size + 1) + x;
+            int b = a + 1;
+            int c = a + size + 1;
+            int d = c + 1;
+            for (int vertex : {a, c, b, b, c, d})
+                corners.push_back(FaceIndex{vertex, vertex, z % 2});
+        }
+        if ((z + 1) % rowsPerMesh == 0 || z + 1 == size)
+            meshEnds.push_back(corners.size());
+    }
+    size_t faces = corners.size() / 3;
+
+    const int runs = 5;
+    std::vector<GLuint> hashedIndices(corners.size()), orderedIndices(corners.size()), tableIndices(corners.size());
+    size_t hashedUnique = 0, orderedUnique = 0, tableUnique = 0;
+
+    // =================== CHAVES EM STRING (CAMINHO ANTIGO) ===================
+    std::unordered_map<std::string, GLuint> hashedMap;
+    double hashedMs = bestOfMs(runs, [&]
+                               { hashedUnique = dedup(
+                                     corners, meshEnds, hashedIndices,
+                                     [&](const FaceIndex &index, GLuint &nextVertex)
+                                     {
+                                         std::string key = makeKey(index);
+                                         auto it = hashedMap.find(key);
+                                         if (it != hashedMap.end())
+                                             return it->second;
+                                         hashedMap[key] = nextVertex;
+                                         return nextVertex++;
+                                     },
+                                     [&]
+                                     { hashedMap.clear(); }); });
+
+    std::map<std::string, GLuint> orderedMap;
+    double orderedMs = bestOfMs(runs, [&]
+                                { orderedUnique = dedup(
+                                      corners, meshEnds, orderedIndices,
+                                      [&](const FaceIndex &index, GLuint &nextVertex)
+                                      {
+                                          auto result = orderedMap.try_emplace(makeKey(index), nextVertex);
+                                          return result.second ? nextVertex++ : result.first->second;
+                                      },
+                                      [&]
+                                      { orderedMap.clear(); }); });
+
+    // =================== ENDEREÇAMENTO ABERTO ===================
+    cg::ModelLoader::VertexDedupTable table;
+    double tableMs = bestOfMs(runs, [&]
+                              { tableUnique = dedup(
+                                    corners, meshEnds, tableIndices,
+                                    [&](const FaceIndex &index, GLuint &nextVertex)
+                                    {
+                                        bool inserted = false;
+                                        GLuint value = table.findOrInsert(index, nextVertex, inserted);
+                                        if (inserted)
+                                            ++nextVertex;
+                                        return value;
+                                    },
+                                    [&]
+                                    { table.clear(); }); });
+
+    std::cout << "=== Deduplicação de vértices: " << faces << " faces, " << meshEnds.size() << " objetos ===" << std::endl;
+    std::cout << "                                   ms       M faces/s   ganho" << std::endl;
+    std::cout << "unordered_map<string> (antigo):    " << hashedMs << "   " << mfps(faces, hashedMs) << "   1x" << std::endl;
+    std::cout << "map<string>:                       " << orderedMs << "   " << mfps(faces, orderedMs) << "   "
+              << hashedMs / orderedMs << "x" << std::endl;
+    std::cout << "VertexDedupTable:                  " << tableMs << "   " << mfps(faces, tableMs) << "   "
+              << hashedMs / tableMs << "x" << std::endl;
+    std::cout << "Vértices únicos: " << tableUnique << std::endl;
+
+    if (hashedUnique != tableUnique || orderedUnique != tableUnique ||
+        hashedIndices != tableIndices || orderedIndices != tableIndices)
+    {
+        std::cerr << "Resultados divergentes entre as tabelas" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace cg {
+
+/**
+ * @brief Arquivo mapeado em memória (somente leitura)
+ *
+ * Mapeia o conteúdo completo de um arquivo no espaço de endereçamento do
+ * processo (mmap no POSIX, CreateFileMapping no Windows), permitindo que
+ * parsers leiam os bytes diretamente sem cópias intermediárias.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    // Abre e mapeia o arquivo; retorna false se não for possível
+    bool open(const std::string& path);
+
+    // Desfaz o mapeamento e fecha o arquivo
+    void close();
+
+    bool isOpen() const { return mData != nullptr || mOpenEmpty; }
+    const char* data() const { return mData; }
+    size_t size() const { return mSize; }
+    std::string_view view() const { return {mData, mSize}; }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+private:
+    const char* mData = nullptr;
+    size_t mSize = 0;
+    bool mOpenEmpty = false; // arquivos vazios não podem ser mapeados, mas são válidos
+
+#ifdef _WIN32
+    void* mFileHandle = nullptr;
+    void* mMappingHandle = nullptr;
+#endif
+};
+
+} // namespace cg
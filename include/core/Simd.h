@@ -0,0 +1,30 @@
+#pragma once
+
+// Conjuntos de instruções SIMD disponíveis na compilação atual.
+//
+// Os kernels vetorizados usam estas macros para escolher a implementação em
+// tempo de compilação, sempre com uma versão escalar equivalente:
+//   CG_SIMD_SSE  - SSE (sempre presente em x86-64)
+//   CG_SIMD_AVX  - AVX (8 floats por registrador)
+//   CG_SIMD_AVX2 - AVX2 + FMA
+// AVX/AVX2 só são habilitados com a opção CG_ENABLE_AVX2 do CMake (ou flags
+// equivalentes do compilador), já que o executável deixaria de rodar em CPUs
+// sem essas extensões.
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define CG_SIMD_SSE 1
+#endif
+
+#if defined(__AVX__)
+#define CG_SIMD_AVX 1
+#endif
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER)) // /arch:AVX2 do MSVC inclui FMA
+#define CG_SIMD_AVX2 1
+#endif
+
+#if defined(CG_SIMD_AVX)
+#include <immintrin.h>
+#elif defined(CG_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <limits>
+
+namespace cg
+{
+
+    struct Vertex;
+
+    /**
+     * @brief Caixa alinhada aos eixos (AABB)
+     *
+     * O valor padrão é uma caixa vazia (min > max), que se torna válida ao
+     * receber o primeiro ponto.
+     */
+    struct BoundingBox
+    {
+        glm::vec3 min{std::numeric_limits<float>::max()};
+        glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+        bool isEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+        glm::vec3 center() const { return (min + max) * 0.5f; }
+        glm::vec3 extents() const { return (max - min) * 0.5f; } // Meia extensão por eixo
+
+        void expand(const glm::vec3 &point)
+        {
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+    };
+
+    /**
+     * @brief Esfera envolvente
+     */
+    struct BoundingSphere
+    {
+        glm::vec3 center{0.0f};
+        float radius = 0.0f;
+    };
+
+    /**
+     * @brief Volumes envolventes de uma mesh, no espaço local dela
+     *
+     * A esfera é centrada na AABB, com raio igual à maior distância de um vértice
+     * a esse centro (mais justa que a meia diagonal da caixa).
+     */
+    struct MeshBounds
+    {
+        BoundingBox box;
+        BoundingSphere sphere;
+    };
+
+    /**
+     * @brief Calcula AABB e esfera envolvente das posições dos vértices
+     *
+     * Usa SSE quando disponível (duas passadas lineares sobre os vértices) e uma
+     * versão escalar equivalente nas demais plataformas. Posições NaN são ignoradas.
+     * @return Volumes vazios (box.isEmpty()) se não houver vértices
+     */
+    MeshBounds computeMeshBounds(const Vertex *vertices, size_t count);
+
+    /**
+     * @brief AABB que envolve a caixa transformada por uma matriz afim
+     *
+     * Transforma o centro e projeta a meia extensão nos eixos do mundo
+     * (|M| * extents), sem percorrer os 8 cantos.
+     */
+    BoundingBox transformBox(const BoundingBox &box, const glm::mat4 &matrix);
+
+} // namespace cg
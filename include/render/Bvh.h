@@ -0,0 +1,177 @@
+#pragma once
+#include "render/Bounds.h"
+#include "render/FrustumCuller.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace cg
+{
+
+    /**
+     * @brief Hierarquia de volumes envolventes (BVH) sobre AABBs no espaço do mundo
+     *
+     * Cada item é identificado pelo seu índice no vetor passado a build(). A árvore
+     * é construída com SAH por bins (heurística de área de superfície) e guardada
+     * num array plano: os dois filhos de um nó ficam lado a lado, sempre depois
+     * do pai, e cada nó cobre uma faixa contígua de itens.
+     *
+     * Quando as caixas mudam (portas abrindo, modelo movido), update() + refit()
+     * recalculam apenas os nós no caminho até a raiz, sem mudar a topologia. Como
+     * a qualidade cai com refits acumulados, needsRebuild() avisa quando vale
+     * reconstruir.
+     *
+     * Além do frustum culling hierárquico, a mesma estrutura responde consultas
+     * por raio e por caixa.
+     */
+    class Bvh
+    {
+    public:
+        /**
+         * @brief Item cuja caixa é atravessada por um raio
+         */
+        struct RayHit
+        {
+            uint32_t item = 0;     // Índice do item (ordem de build)
+            float distance = 0.0f; // Distância de entrada na caixa ao longo do raio (0 se a origem está dentro)
+        };
+
+        // Retorno de closestHit quando nada é atingido
+        static constexpr uint32_t kNoItem = std::numeric_limits<uint32_t>::max();
+
+        // Itens por folha a partir do qual a divisão é obrigatória
+        static constexpr uint32_t kMaxLeafItems = 8;
+
+        // Número de bins por eixo na avaliação da SAH
+        static constexpr int kSahBins = 16;
+
+        // Razão entre o custo SAH atual e o da construção que torna a reconstrução recomendada
+        static constexpr float kRebuildCostRatio = 1.5f;
+
+        /**
+         * @brief Constrói a árvore (substitui a anterior)
+         * @param boxes Uma caixa por item; caixas vazias entram na árvore mas nunca são retornadas
+         */
+        void build(const std::vector<BoundingBox> &boxes);
+
+        /**
+         * @brief Remove todos os itens e nós
+         */
+        void clear();
+
+        /**
+         * @brief Número de itens
+         */
+        size_t size() const { return mItemBoxes.size(); }
+        bool empty() const { return mItemBoxes.empty(); }
+
+        /**
+         * @brief Número de nós (internos + folhas)
+         */
+        size_t getNodeCount() const { return mNodes.size(); }
+
+        /**
+         * @brief Caixa que envolve todos os itens (vazia se a árvore está vazia)
+         */
+        BoundingBox getBounds() const { return mNodes.empty() ? BoundingBox{} : mNodes[0].bounds; }
+
+        /**
+         * @brief Caixa atual de um item
+         */
+        const BoundingBox &getItemBounds(uint32_t item) const { return mItemBoxes[item]; }
+
+        // =================== ATUALIZAÇÃO INCREMENTAL ===================
+
+        /**
+         * @brief Troca a caixa de um item; a árvore só é ajustada em refit()
+         */
+        void update(uint32_t item, const BoundingBox &box);
+
+        /**
+         * @brief Recalcula as caixas dos nós afetados pelos update() pendentes
+         * @return Número de nós recalculados
+         */
+        size_t refit();
+
+        /**
+         * @brief Indica se os refits degradaram a árvore o bastante para reconstruí-la
+         */
+        bool needsRebuild() const { return mSahCost > kRebuildCostRatio * mBuildSahCost; }
+
+        // =================== CONSULTAS ===================
+
+        /**
+         * @brief Itens cuja caixa intersecta o frustum (teste conservador, como Frustum::intersects)
+         *
+         * Subárvores inteiramente fora de um plano são puladas; subárvores
+         * inteiramente dentro de todos os planos entram sem mais testes.
+         * @param visible Recebe os índices dos itens visíveis (ordem da árvore)
+         * @param nodesVisited Se não nulo, recebe quantos nós foram testados
+         * @return Número de itens visíveis
+         */
+        size_t cullFrustum(const Frustum &frustum, std::vector<uint32_t> &visible, size_t *nodesVisited = nullptr) const;
+
+        /**
+         * @brief Itens cuja caixa intersecta a caixa de consulta
+         * @param results Recebe os índices dos itens
+         */
+        void queryBox(const BoundingBox &box, std::vector<uint32_t> &results) const;
+
+        /**
+         * @brief Itens cuja caixa é atravessada pelo raio, do mais próximo ao mais distante
+         * @param origin Origem do raio
+         * @param direction Direção (não precisa ser normalizada; distâncias ficam em unidades de |direction|)
+         * @param maxDistance Distância máxima ao longo do raio
+         * @param hits Recebe os itens ordenados por RayHit::distance
+         */
+        void queryRay(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                      std::vector<RayHit> &hits) const;
+
+        /**
+         * @brief Item mais próximo ao longo do raio segundo um teste exato por item
+         *
+         * Os nós são visitados do mais próximo ao mais distante e o raio é
+         * encurtado a cada acerto, então caixas atrás do melhor acerto não são
+         * abertas (ex.: BVH sobre triângulos, com o teste do triângulo).
+         * @param intersect Recebe o item e a distância máxima atual; devolve a
+         *                  distância do acerto ou um valor negativo se não acertou
+         * @param hitDistance Se não nulo, recebe a distância do acerto
+         * @return Índice do item, ou kNoItem
+         */
+        uint32_t closestHit(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                            const std::function<float(uint32_t item, float maxDistance)> &intersect,
+                            float *hitDistance = nullptr) const;
+
+    private:
+        /**
+         * @brief Nó da árvore; left == 0 indica folha (a raiz nunca é filha)
+         */
+        struct Node
+        {
+            BoundingBox bounds;
+            uint32_t firstItem = 0; // Início da faixa em mItems
+            uint32_t itemCount = 0; // Itens na subárvore
+            uint32_t left = 0;      // Filho esquerdo (o direito é left + 1)
+        };
+
+        std::vector<Node> mNodes;            // Raiz em mNodes[0]
+        std::vector<uint32_t> mParents;      // Pai de cada nó (a raiz aponta para si mesma)
+        std::vector<uint32_t> mItems;        // Itens ordenados pelas folhas
+        std::vector<BoundingBox> mItemBoxes; // Caixa de cada item (ordem de build)
+        std::vector<uint32_t> mItemLeaf;     // Folha de cada item
+
+        std::vector<uint32_t> mDirtyLeaves; // Folhas com itens alterados desde o último refit
+        std::vector<uint8_t> mNodeDirty;    // Marca por nó usada em refit()
+
+        float mSahCost = 0.0f;      // Soma das áreas dos nós (proporcional ao custo SAH)
+        float mBuildSahCost = 0.0f; // mSahCost logo após build()
+
+        /**
+         * @brief Recalcula a caixa de um nó a partir dos filhos (ou itens, se folha)
+         */
+        void recomputeNode(uint32_t nodeIndex);
+    };
+
+} // namespace cg
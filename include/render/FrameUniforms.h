@@ -0,0 +1,84 @@
+#pragma once
+#include "render/Shader.h"
+#include <glm/glm.hpp>
+
+namespace cg
+{
+
+    /**
+     * @brief Uniform buffer (std140) com os dados de câmera e luz do frame
+     *
+     * Preenchido uma vez por frame em Renderer::render() e ligado a um ponto
+     * fixo; todos os programas embutidos (cena e skybox) declaram o bloco com
+     * glslBlock() e o leem de lá, de modo que trocar de programa não exige
+     * reenviar câmera e luz.
+     */
+    class FrameUniforms
+    {
+    public:
+        // Ponto de ligação do bloco (glBindBufferBase / glUniformBlockBinding)
+        static constexpr unsigned int kBindingPoint = 0;
+
+        // Nome do bloco no GLSL
+        static constexpr const char *kBlockName = "FrameUniforms";
+
+        /**
+         * @brief Conteúdo do bloco, com o layout std140 (vec3 ocupa um vec4)
+         */
+        struct Data
+        {
+            glm::mat4 view{1.0f};
+            glm::mat4 projection{1.0f};
+            glm::mat4 viewProjection{1.0f};
+            glm::vec4 cameraPosition{0.0f}; // xyz
+            glm::vec4 lightPosition{0.0f};  // xyz
+            glm::vec4 lightColor{1.0f};     // rgb
+        };
+
+        FrameUniforms() = default;
+        ~FrameUniforms();
+
+        /**
+         * @brief Declaração GLSL do bloco, para inserir logo após a linha #version
+         *
+         * Os membros ficam no escopo global do shader: uView, uProjection,
+         * uViewProjection, uCameraPos, uLightPos e uLightColor (os três últimos vec4).
+         */
+        static const char *glslBlock();
+
+        /**
+         * @brief Associa o bloco de um programa ao ponto de ligação
+         * @return false se o programa não usa o bloco
+         */
+        static bool attach(const Shader &shader) { return shader.bindUniformBlock(kBlockName, kBindingPoint); }
+
+        /**
+         * @brief Cria o buffer na GPU
+         */
+        bool init();
+
+        /**
+         * @brief Envia os dados do frame e liga o buffer ao ponto de ligação
+         */
+        void update(const Data &data);
+
+        /**
+         * @brief Dados enviados no último update()
+         */
+        const Data &getData() const { return mData; }
+
+        /**
+         * @brief Libera o buffer
+         */
+        void cleanup();
+
+        // Desabilita cópia (o buffer seria liberado duas vezes)
+        FrameUniforms(const FrameUniforms &) = delete;
+        FrameUniforms &operator=(const FrameUniforms &) = delete;
+
+    private:
+        unsigned int mBuffer = 0;
+        Data mData;
+    };
+
+} // namespace cg
@@ -0,0 +1,89 @@
+#pragma once
+#include "render/Bounds.h"
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace cg
+{
+
+    /**
+     * @brief Os seis planos do volume de visão, no espaço do mundo
+     *
+     * Cada plano é (n, d) com n apontando para dentro e |n| = 1: um ponto p
+     * está do lado visível quando dot(n, p) + d >= 0.
+     */
+    struct Frustum
+    {
+        std::array<glm::vec4, 6> planes; // esquerda, direita, baixo, cima, perto, longe
+
+        /**
+         * @brief Extrai os planos de projection * view (Gribb e Hartmann)
+         */
+        static Frustum fromMatrix(const glm::mat4 &viewProjection);
+
+        /**
+         * @brief Teste conservador de uma AABB (false = totalmente fora)
+         */
+        bool intersects(const BoundingBox &box) const;
+    };
+
+    /**
+     * @brief Teste de visibilidade de muitas AABBs contra o frustum em lote
+     *
+     * As caixas ficam em estrutura de arrays (centro e meia extensão por eixo),
+     * testadas de 8 em 8 com AVX, de 4 em 4 com SSE ou uma a uma na versão
+     * escalar. Uma caixa é descartada apenas se estiver inteiramente atrás de
+     * algum plano; o teste é conservador (caixas perto dos cantos do frustum
+     * podem passar sem estar visíveis).
+     */
+    class FrustumCuller
+    {
+    public:
+        /**
+         * @brief Remove todas as caixas (mantém a memória para o próximo frame)
+         */
+        void clear();
+
+        /**
+         * @brief Reserva espaço para count caixas
+         */
+        void reserve(size_t count);
+
+        /**
+         * @brief Adiciona uma caixa no espaço do mundo
+         * @return Índice da caixa (ordem de inserção)
+         */
+        uint32_t add(const BoundingBox &worldBox);
+
+        /**
+         * @brief Substitui a caixa de índice index (ex.: mesh que se moveu)
+         */
+        void set(uint32_t index, const BoundingBox &worldBox);
+
+        /**
+         * @brief Número de caixas adicionadas
+         */
+        size_t size() const { return mCenterX.size(); }
+
+        /**
+         * @brief Testa todas as caixas contra o frustum
+         * @param frustum Planos do frame
+         * @param visible Recebe (em ordem crescente) os índices das caixas visíveis
+         * @return Número de caixas visíveis
+         */
+        size_t cull(const Frustum &frustum, std::vector<uint32_t> &visible) const;
+
+    private:
+        // Estrutura de arrays: uma entrada por caixa
+        std::vector<float> mCenterX, mCenterY, mCenterZ;
+        std::vector<float> mExtentX, mExtentY, mExtentZ;
+
+        /**
+         * @brief Testa as caixas [first, count) uma a uma (versão escalar e resto dos lotes)
+         */
+        void cullScalar(const Frustum &frustum, size_t first, std::vector<uint32_t> &visible) const;
+    };
+
+} // namespace cg
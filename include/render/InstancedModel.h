@@ -0,0 +1,153 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "render/FrustumCuller.h"
+#include "render/Mesh.h"
+#include "render/TransformKernel.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cg
+{
+
+    /**
+     * @brief Uma mesh desenhada muitas vezes com transformações e cores próprias
+     *
+     * Postes, bancos e árvores repetidos na praça: a geometria existe uma vez na
+     * GPU e cada instância ocupa apenas 116 bytes (matriz, matriz normal e cor)
+     * num buffer de instâncias lido com glVertexAttribDivisor. A cada frame as
+     * instâncias fora do frustum são descartadas (em lote, pelo FrustumCuller),
+     * as visíveis são compactadas no início do buffer, com as matrizes normais
+     * calculadas em lote na CPU (TransformKernel), e todas são desenhadas com
+     * um único glDrawElementsInstanced.
+     */
+    class InstancedModel
+    {
+    public:
+        /**
+         * @brief Dados de uma instância (layout do buffer de instâncias)
+         */
+        struct Instance
+        {
+            glm::mat4 transform{1.0f}; // Matriz de mundo
+            glm::vec4 color{1.0f};     // Multiplica a cor do material (rgb)
+        };
+
+        // Locais dos atributos por instância (os da mesh ocupam 0-2)
+        static constexpr GLuint kTransformLocation = 3; // 3 a 6: colunas da matriz
+        static constexpr GLuint kColorLocation = 7;
+        static constexpr GLuint kNormalMatrixLocation = 8; // 8 a 10: colunas da matriz normal
+
+        /**
+         * @brief Cria o modelo a partir de uma mesh já na GPU (o VBO/EBO dela é reaproveitado)
+         */
+        explicit InstancedModel(std::unique_ptr<Mesh> mesh, const std::string &name = "");
+        ~InstancedModel();
+
+        // =================== INSTÂNCIAS ===================
+
+        /**
+         * @brief Adiciona uma instância
+         * @return Índice da instância
+         */
+        uint32_t addInstance(const glm::mat4 &transform, const glm::vec4 &color = glm::vec4(1.0f));
+
+        /**
+         * @brief Substitui transformação e cor de uma instância
+         */
+        void setInstance(uint32_t index, const glm::mat4 &transform, const glm::vec4 &color = glm::vec4(1.0f));
+
+        /**
+         * @brief Remove uma instância; a última passa a ocupar o índice removido
+         */
+        void removeInstance(uint32_t index);
+
+        /**
+         * @brief Remove todas as instâncias
+         */
+        void clearInstances();
+
+        size_t getInstanceCount() const { return mInstances.size(); }
+        const Instance &getInstance(uint32_t index) const { return mInstances[index]; }
+
+        // =================== DESENHO ===================
+
+        /**
+         * @brief Descarta as instâncias fora do frustum e envia as visíveis, compactadas, à GPU
+         * @param frustum Volume de visão (nullptr = todas visíveis)
+         * @param cameraPosition Usada para escolher a instância mais próxima (LOD)
+         * @return Número de instâncias visíveis
+         */
+        size_t cullAndUpload(const Frustum *frustum, const glm::vec3 &cameraPosition);
+
+        /**
+         * @brief Instâncias enviadas no último cullAndUpload
+         */
+        size_t getVisibleCount() const { return mVisibleCount; }
+
+        /**
+         * @brief Matriz da instância visível mais próxima da câmera (referência para o LOD)
+         */
+        const glm::mat4 &getNearestVisibleTransform() const { return mNearestTransform; }
+
+        /**
+         * @brief Desenha as instâncias visíveis no LOD ativo da mesh (VAO deste modelo vinculado)
+         */
+        void drawElements() const;
+
+        /**
+         * @brief VAO com os atributos da mesh e os atributos por instância
+         */
+        GLuint getVertexArray() const { return mVAO; }
+
+        Mesh &getMesh() { return *mMesh; }
+        const Mesh &getMesh() const { return *mMesh; }
+        const std::string &getName() const { return mName; }
+
+        /**
+         * @brief Bytes do buffer de instâncias na GPU (a geometria conta em getMesh())
+         */
+        size_t getInstanceBufferBytes() const { return mInstanceCapacity * sizeof(GpuInstance); }
+
+        // Desabilita cópia (recursos OpenGL)
+        InstancedModel(const InstancedModel &) = delete;
+        InstancedModel &operator=(const InstancedModel &) = delete;
+
+    private:
+        /**
+         * @brief Instância como enviada à GPU (layout do buffer de instâncias)
+         */
+        struct GpuInstance
+        {
+            glm::mat4 transform{1.0f};    // Matriz de desenho (Mesh::getDrawMatrix)
+            glm::mat3 normalMatrix{1.0f}; // transpose(inverse(mat3(transform)))
+            glm::vec4 color{1.0f};
+        };
+
+        std::unique_ptr<Mesh> mMesh;
+        std::string mName;
+
+        std::vector<Instance> mInstances;  // Todas as instâncias (ordem de inserção)
+        FrustumCuller mCuller;             // AABB de mundo de cada instância (mesmos índices)
+        bool mCullerDirty = false;         // Remoções exigem reconstruir o culler
+
+        std::vector<uint32_t> mVisible;    // Índices visíveis no último cullAndUpload
+        std::vector<GpuInstance> mStaging; // Instâncias visíveis compactadas
+        Mat4Array mVisibleMatrices;        // Matrizes das visíveis (entrada do TransformKernel)
+        Mat3Array mVisibleNormals;         // Matrizes normais das visíveis
+        size_t mVisibleCount = 0;
+        glm::mat4 mNearestTransform{1.0f};
+
+        GLuint mVAO = 0;
+        GLuint mInstanceVBO = 0;
+        size_t mInstanceCapacity = 0; // Instâncias que cabem no buffer
+
+        /**
+         * @brief AABB de mundo da mesh numa instância
+         */
+        BoundingBox instanceBox(const glm::mat4 &transform) const;
+    };
+
+} // namespace cg
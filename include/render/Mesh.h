@@ -4,33 +4,37 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <algorithm>
 #include <glm/gtc/matrix_transform.hpp>
 #include "render/Material.h"
+#include "render/MeshData.h"
+#include "render/VertexFormat.h"
 
 namespace cg
 {
 
-    /**
-     * @brief Estrutura que representa um vértice com posição, normal e coordenadas de textura
-     */
-    struct Vertex
-    {
-        glm::vec3 position;  // Posição do vértice no espaço 3D
-        glm::vec3 normal;    // Vetor normal para iluminação
-        glm::vec2 texCoords; // Coordenadas de textura (UV mapping)
-
-        Vertex() : position(0.0f), normal(0.0f), texCoords(0.0f) {}
-
-        Vertex(const glm::vec3 &pos, const glm::vec3 &norm = glm::vec3(0.0f), const glm::vec2 &tex = glm::vec2(0.0f))
-            : position(pos), normal(norm), texCoords(tex) {}
-    };
-
     /**
      * @brief Classe que representa uma malha de triângulos (mesh)
      *
      * Uma mesh é uma coleção de vértices e índices que formam triângulos.
      * Cada mesh tem seus próprios buffers OpenGL (VAO, VBO, EBO) e pode
      * ser renderizada independentemente.
+     *
+     * Na CPU os vértices ficam sempre em Vertex (float); na GPU eles podem ser
+     * quantizados em um dos VertexFormat compactos. Meshes com menos de 65536
+     * vértices usam índices de 16 bits na GPU.
+     *
+     * Os níveis de detalhe (MeshData::lods) ficam no mesmo EBO, logo após os
+     * índices do LOD 0, e compartilham o VBO; draw() desenha o nível ativo.
+     *
+     * Depois do upload, a cópia na CPU segue a CpuResidency da mesh: com
+     * ReleaseAfterUpload os arrays são liberados e a geometria existe apenas na
+     * GPU. Contagens e volumes envolventes continuam disponíveis em qualquer caso.
+     *
+     * Meshes com a mesma geometria (duplicatas detectadas pelo ModelLoader)
+     * compartilham VAO/VBO/EBO: a que chega depois é construída a partir da
+     * primeira e guarda apenas a translação entre os dois espaços locais
+     * (getGeometryOffset), aplicada na matriz de desenho.
      */
     class Mesh
     {
@@ -38,6 +42,7 @@ namespace cg
         // =================== DADOS DA GEOMETRIA ===================
         std::vector<Vertex> vertices;       // Lista de vértices da mesh
         std::vector<GLuint> indices;        // Lista de índices (3 índices = 1 triângulo)
+        std::vector<glm::vec3> positions;   // Apenas posições (com CpuResidency::KeepPositionsOnly)
         std::string name;                   // Nome opcional da mesh (para debug)
         std::shared_ptr<Material> material; // Material da mesh
 
@@ -53,27 +58,189 @@ namespace cg
              const std::string &name = "",
              std::shared_ptr<Material> material = nullptr);
 
+        /**
+         * @brief Constrói a mesh a partir de dados de CPU e envia-os para a GPU
+         *
+         * Etapa de upload: requer contexto OpenGL ativo na thread atual. Os arrays
+         * de vértices e índices são movidos (sem cópia) e a transformação local de
+         * data é aplicada à mesh. Usa data.bounds se já calculados.
+         * @param data Dados produzidos pelo ModelLoader (ou montados manualmente)
+         * @param format Formato dos vértices na GPU
+         * @param residency O que manter na CPU após o upload
+         */
+        explicit Mesh(MeshData &&data, VertexFormat format = VertexFormat::Standard,
+                      CpuResidency residency = CpuResidency::Keep);
+
+        /**
+         * @brief Constrói a mesh reutilizando os buffers da GPU de outra mesh (sem upload)
+         *
+         * Nome, material, transformação local, volumes envolventes e a cópia na CPU
+         * vêm de data; formato, índices e LODs vêm de geometry. data.geometryOffset
+         * leva o espaço da geometria compartilhada ao espaço local desta mesh.
+         * @param data Dados da duplicata (data.sharedGeometry é ignorado)
+         * @param geometry Mesh dona da geometria
+         * @param residency O que manter na CPU
+         */
+        Mesh(MeshData &&data, const Mesh &geometry, CpuResidency residency = CpuResidency::Keep);
+
         /**
          * @brief Destrutor que libera recursos OpenGL
          */
         ~Mesh();
 
         /**
-         * @brief Renderiza a mesh usando OpenGL
+         * @brief Renderiza a mesh usando OpenGL (no LOD ativo)
          */
         void draw() const;
 
         /**
-         * @brief Obtém o número de triângulos da mesh
+         * @brief Emite o draw call do LOD ativo sem vincular o VAO
+         *
+         * Para quem agrupa draws por VAO (RenderQueue): o VAO desta mesh
+         * (getVertexArray()) precisa estar vinculado.
+         */
+        void drawElements() const;
+
+        /**
+         * @brief Como drawElements(), para instanceCount instâncias (glDrawElementsInstanced)
+         */
+        void drawElementsInstanced(GLsizei instanceCount) const;
+
+        /**
+         * @brief VAO com a configuração de atributos desta mesh
+         */
+        GLuint getVertexArray() const { return mVAO; }
+
+        /**
+         * @brief VBO e EBO da mesh (para cópias na GPU, ex.: StaticBatch)
+         */
+        GLuint getVertexBuffer() const { return mVBO; }
+        GLuint getIndexBuffer() const { return mEBO; }
+
+        /**
+         * @brief Bytes do EBO (todos os níveis de detalhe)
+         */
+        size_t getIndexBufferBytes() const { return mBufferBytes - mVertexCount * mLayout->stride; }
+
+        // =================== GEOMETRIA COMPARTILHADA ===================
+
+        /**
+         * @brief true se os buffers da GPU foram criados por outra mesh
+         */
+        bool sharesGeometry() const { return mSharedGeometry; }
+
+        /**
+         * @brief true se os buffers da GPU são usados por mais de uma mesh (origem ou cópia)
+         */
+        bool isGeometryShared() const { return mSharedGeometry || (mBuffers && mBuffers.use_count() > 1); }
+
+        /**
+         * @brief Translação do espaço da geometria na GPU para o espaço local da mesh (zero se própria)
+         */
+        const glm::vec3 &getGeometryOffset() const { return mGeometryOffset; }
+
+        /**
+         * @brief Matriz usada para desenhar os vértices do VBO a partir da matriz de mundo da mesh
+         */
+        glm::mat4 getDrawMatrix(const glm::mat4 &worldMatrix) const
+        {
+            glm::mat4 drawMatrix = worldMatrix;
+            drawMatrix[3] += worldMatrix * glm::vec4(mGeometryOffset, 0.0f);
+            return drawMatrix;
+        }
+
+        // =================== GEOMETRIA ENTREGUE AO LOTE ESTÁTICO ===================
+
+        /**
+         * @brief true se a mesh tem VAO/VBO/EBO próprios (false depois de releaseGpuGeometry)
+         */
+        bool hasGpuGeometry() const { return mVAO != 0; }
+
+        /**
+         * @brief Libera VAO, VBO e EBO, mantendo layout, quantização, contagens, tipo de índice e faixas dos LODs
+         *
+         * Usado pelo StaticBatch quando a geometria passa a existir só no lote; a
+         * mesh não é desenhada até restoreGpuGeometry. Não faz nada se os buffers
+         * são compartilhados com outras meshes.
+         */
+        void releaseGpuGeometry();
+
+        /**
+         * @brief Adota buffers recriados a partir do lote estático
+         * @param vbo Vértices no layout e com a quantização da mesh (getVertexLayout, getQuantization), no espaço local
+         * @param ebo Índices com o mesmo tipo e as mesmas faixas de LOD de antes
+         */
+        void restoreGpuGeometry(GLuint vbo, GLuint ebo);
+
+        // =================== NÍVEIS DE DETALHE ===================
+
+        /**
+         * @brief Número de níveis de detalhe (1 = apenas a geometria original)
+         */
+        size_t getLodCount() const { return mLods.size(); }
+
+        /**
+         * @brief Erro geométrico de um nível, no espaço do objeto (0 para o LOD 0)
+         */
+        float getLodError(size_t lod) const { return mLods[lod].error; }
+
+        /**
+         * @brief Triângulos de um nível
+         */
+        size_t getLodTriangleCount(size_t lod) const { return static_cast<size_t>(mLods[lod].indexCount) / 3; }
+
+        /**
+         * @brief Índices de um nível e seu início no EBO, em bytes
+         */
+        GLsizei getLodIndexCount(size_t lod) const { return mLods[lod].indexCount; }
+        size_t getLodIndexOffset(size_t lod) const { return mLods[lod].byteOffset; }
+
+        /**
+         * @brief Nível usado por draw()
+         */
+        size_t getActiveLod() const { return mActiveLod; }
+        void setActiveLod(size_t lod) { mActiveLod = std::min(lod, mLods.size() - 1); }
+
+        // =================== VOLUMES ENVOLVENTES ===================
+
+        /**
+         * @brief AABB e esfera envolvente no espaço local da mesh (calculados uma vez no carregamento)
+         */
+        const MeshBounds &getBounds() const { return mBounds; }
+        const BoundingBox &getBoundingBox() const { return mBounds.box; }
+        const BoundingSphere &getBoundingSphere() const { return mBounds.sphere; }
+
+        /**
+         * @brief Obtém o número de triângulos da mesh (LOD 0)
          * @return Número de triângulos (índices / 3)
          */
-        size_t getTriangleCount() const { return indices.size() / 3; }
+        size_t getTriangleCount() const { return mLods.empty() ? 0 : static_cast<size_t>(mLods[0].indexCount) / 3; }
 
         /**
          * @brief Obtém o número de vértices da mesh
-         * @return Número de vértices
+         * @return Número de vértices (também após liberar os arrays da CPU)
+         */
+        size_t getVertexCount() const { return mVertexCount; }
+
+        // =================== RESIDÊNCIA NA CPU ===================
+
+        /**
+         * @brief Política atual de residência dos dados na CPU
+         */
+        CpuResidency getCpuResidency() const { return mResidency; }
+
+        /**
+         * @brief Aplica uma política de residência, liberando o que ela não mantém
+         *
+         * Só reduz os dados em memória: dados já liberados não são recuperados
+         * (voltar para Keep depois de liberar não tem efeito).
          */
-        size_t getVertexCount() const { return vertices.size(); }
+        void setCpuResidency(CpuResidency residency);
+
+        /**
+         * @brief Bytes de geometria mantidos na memória do sistema (vertices, indices e positions)
+         */
+        size_t getCpuMemoryBytes() const;
 
         // =================== GERENCIAMENTO DE MATERIAIS ===================
 
@@ -101,6 +268,28 @@ namespace cg
          */
         bool isTransparent() const { return material && material->isTransparent(); }
 
+        // =================== FORMATO NA GPU ===================
+
+        /**
+         * @brief Layout dos vértices no VBO (define o shader usado para desenhar)
+         */
+        const VertexLayoutInfo &getVertexLayout() const { return *mLayout; }
+
+        /**
+         * @brief Parâmetros para reconstruir as posições quantizadas (uPosOffset/uPosScale)
+         */
+        const QuantizationParams &getQuantization() const { return mQuantization; }
+
+        /**
+         * @brief Tipo dos índices no EBO (GL_UNSIGNED_SHORT ou GL_UNSIGNED_INT)
+         */
+        GLenum getIndexType() const { return mIndexType; }
+
+        /**
+         * @brief Bytes ocupados pelo VBO e EBO na GPU (0 se a geometria pertence a outra mesh ou ao lote)
+         */
+        size_t getGpuMemoryBytes() const { return mSharedGeometry || !mVAO ? 0 : mBufferBytes; }
+
         // Desabilita cópia para evitar problemas com recursos OpenGL
         Mesh(const Mesh &) = delete;
         Mesh &operator=(const Mesh &) = delete;
@@ -114,7 +303,11 @@ namespace cg
          * @brief Define a transformação local da mesh (relativa ao Model)
          * @param transform Matriz 4x4 de transformação local
          */
-        void setLocalTransform(const glm::mat4 &transform) { mLocalTransform = transform; }
+        void setLocalTransform(const glm::mat4 &transform)
+        {
+            mLocalTransform = transform;
+            ++mTransformVersion;
+        }
 
         /**
          * @brief Obtém a transformação local da mesh
@@ -122,19 +315,62 @@ namespace cg
          */
         const glm::mat4 &getLocalTransform() const { return mLocalTransform; }
 
+        /**
+         * @brief Contador incrementado a cada setLocalTransform (detecção de mudanças)
+         */
+        uint32_t getTransformVersion() const { return mTransformVersion; }
+
     private:
         // =================== RECURSOS OPENGL ===================
         GLuint mVAO = 0; // Vertex Array Object - armazena configuração de atributos
         GLuint mVBO = 0; // Vertex Buffer Object - armazena dados dos vértices
         GLuint mEBO = 0; // Element Buffer Object - armazena índices dos triângulos
 
+        /**
+         * @brief Dono dos buffers; compartilhado entre as meshes com a mesma geometria
+         */
+        struct GpuBuffers
+        {
+            GLuint vao = 0;
+            GLuint vbo = 0;
+            GLuint ebo = 0;
+            ~GpuBuffers();
+        };
+        std::shared_ptr<GpuBuffers> mBuffers;
+
+        const VertexLayoutInfo *mLayout = &StandardVertexLayout::info(); // Layout do VBO
+        QuantizationParams mQuantization;                                // Dequantização das posições
+        GLenum mIndexType = GL_UNSIGNED_INT;                             // Tipo dos índices no EBO
+        size_t mBufferBytes = 0;                                         // VBO + EBO
+        bool mSharedGeometry = false;                                    // Buffers criados por outra mesh
+        glm::vec3 mGeometryOffset{0.0f};                                 // Espaço da geometria -> local
+
+        /**
+         * @brief Faixa do EBO ocupada por um nível de detalhe
+         */
+        struct LodRange
+        {
+            GLsizei indexCount = 0;   // Índices do nível
+            size_t byteOffset = 0;    // Início do nível no EBO
+            float error = 0.0f;       // Erro geométrico (espaço do objeto)
+        };
+        std::vector<LodRange> mLods; // LOD 0 primeiro
+        size_t mActiveLod = 0;       // Nível desenhado por draw()
+
+        MeshBounds mBounds;                             // Volumes envolventes (espaço local)
+        size_t mVertexCount = 0;                        // Vértices no VBO
+        CpuResidency mResidency = CpuResidency::Keep;   // O que permanece na CPU
+
         // =================== TRANSFORMAÇÃO LOCAL ===================
         glm::mat4 mLocalTransform{1.0f};
+        uint32_t mTransformVersion = 0; // Incrementado quando mLocalTransform muda
 
         /**
          * @brief Configura os buffers OpenGL (VAO, VBO, EBO)
+         * @param format Formato dos vértices na GPU
+         * @param lods Níveis de detalhe enviados após o LOD 0
          */
-        void setupMesh();
+        void setupMesh(VertexFormat format, const std::vector<MeshLod> &lods = {});
 
         /**
          * @brief Libera recursos OpenGL
@@ -0,0 +1,115 @@
+#pragma once
+#include "render/MeshData.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cg
+{
+
+    /**
+     * @brief Cache binário de meshes gerado a partir de um arquivo OBJ
+     *
+     * Após um parsing bem-sucedido, o ModelLoader grava ao lado do .obj um arquivo
+     * ".meshcache" com os arrays finais de Vertex/índices de cada mesh (incluindo
+     * os níveis de detalhe), nomes, transformações locais e os parâmetros
+     * resolvidos dos materiais. Nos próximos
+     * carregamentos o cache é mapeado em memória e os blocos de vértices/índices são
+     * copiados direto das páginas mapeadas para o ModelData, sem parsing de texto.
+     * Nenhuma chamada OpenGL é feita aqui.
+     *
+     * O cache é identificado pelo tamanho, data de modificação e hash do conteúdo do
+     * arquivo de origem, mais a versão do formato, a versão do loader e as etapas de
+     * pós-processamento aplicadas (que assim só são pagas uma vez). Como os
+     * materiais gravados vêm das bibliotecas .mtl, cada arquivo citado em mtllib
+     * também é registrado (caminho resolvido, tamanho, data e hash) e conferido
+     * no carregamento. Caches desatualizados ou corrompidos (checksum do conteúdo
+     * não confere) são descartados e reconstruídos.
+     */
+    class MeshCache
+    {
+    public:
+        /**
+         * @brief Identificação do arquivo de origem
+         */
+        struct SourceKey
+        {
+            uint64_t size = 0;        // Tamanho do arquivo em bytes
+            int64_t mtime = 0;        // Data de modificação (ticks do relógio do filesystem)
+            uint64_t contentHash = 0; // Hash de 64 bits do conteúdo
+        };
+
+        /**
+         * @brief Arquivo do qual o conteúdo do cache também depende (biblioteca .mtl)
+         */
+        struct Dependency
+        {
+            std::string path;     // Caminho resolvido, como aberto pelo loader
+            bool exists = false;  // false se o arquivo não pôde ser lido (a chave fica zerada)
+            SourceKey key;        // Tamanho, data e hash do conteúdo
+
+            bool operator==(const Dependency &other) const
+            {
+                return path == other.path && exists == other.exists && key.size == other.key.size &&
+                       key.mtime == other.key.mtime && key.contentHash == other.key.contentHash;
+            }
+        };
+
+        // Versão do layout binário; incrementar ao alterar o formato
+        static constexpr uint32_t kFormatVersion = 3;
+
+        /**
+         * @brief Caminho do cache correspondente a um arquivo OBJ
+         */
+        static std::string cachePathFor(const std::string &objPath);
+
+        /**
+         * @brief Monta a chave do arquivo de origem
+         * @param objPath Caminho do arquivo de origem (para tamanho e data)
+         * @param contents Conteúdo completo do arquivo (já mapeado em memória)
+         * @param key Chave preenchida
+         * @return false se os metadados do arquivo não puderem ser lidos
+         */
+        static bool makeSourceKey(const std::string &objPath, std::string_view contents, SourceKey &key);
+
+        /**
+         * @brief Lê o estado atual de um arquivo de dependência (mapeia e calcula o hash)
+         * @param path Caminho resolvido do arquivo
+         * @return Dependência preenchida; exists = false se o arquivo não puder ser lido
+         */
+        static Dependency makeDependency(const std::string &path);
+
+        /**
+         * @brief Carrega um modelo a partir do cache, se ele for válido
+         *
+         * As dependências gravadas no cache são relidas do disco; qualquer
+         * diferença (arquivo alterado, criado ou removido) invalida o cache.
+         * @param cachePath Caminho do arquivo de cache
+         * @param key Chave esperada do arquivo de origem
+         * @param loaderVersion Versão do loader que gerou o cache
+         * @param processingFlags Etapas de pós-processamento esperadas (ex.: otimização de meshes)
+         * @param modelName Nome do modelo a ser criado
+         * @return Dados do modelo (apenas CPU), ou nullptr se o cache não existir, estiver desatualizado ou corrompido
+         */
+        static std::unique_ptr<ModelData> load(const std::string &cachePath, const SourceKey &key,
+                                               uint32_t loaderVersion, uint32_t processingFlags,
+                                               const std::string &modelName);
+
+        /**
+         * @brief Grava o cache de um modelo recém-carregado
+         * @param dependencies Estado das bibliotecas .mtl lidas no parsing (makeDependency)
+         * @return true se o arquivo foi escrito com sucesso
+         */
+        static bool write(const std::string &cachePath, const SourceKey &key,
+                          const std::vector<Dependency> &dependencies,
+                          uint32_t loaderVersion, uint32_t processingFlags, const ModelData &model);
+
+        /**
+         * @brief Hash não criptográfico de 64 bits (processa 8 bytes por passo)
+         */
+        static uint64_t hashBytes(const void *data, size_t size, uint64_t seed = 0);
+    };
+
+} // namespace cg
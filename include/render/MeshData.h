@@ -0,0 +1,106 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include "render/Material.h"
+#include "render/Bounds.h"
+
+namespace cg
+{
+
+    /**
+     * @brief Estrutura que representa um vértice com posição, normal e coordenadas de textura
+     */
+    struct Vertex
+    {
+        glm::vec3 position;  // Posição do vértice no espaço 3D
+        glm::vec3 normal;    // Vetor normal para iluminação
+        glm::vec2 texCoords; // Coordenadas de textura (UV mapping)
+
+        Vertex() : position(0.0f), normal(0.0f), texCoords(0.0f) {}
+
+        Vertex(const glm::vec3 &pos, const glm::vec3 &norm = glm::vec3(0.0f), const glm::vec2 &tex = glm::vec2(0.0f))
+            : position(pos), normal(norm), texCoords(tex) {}
+    };
+
+    /**
+     * @brief Nível de detalhe simplificado de uma mesh
+     *
+     * Usa os mesmos vértices da mesh (apenas um array de índices próprio).
+     */
+    struct MeshLod
+    {
+        std::vector<GLuint> indices; // Índices do nível (3 índices = 1 triângulo)
+        float error = 0.0f;          // Desvio geométrico máximo no espaço do objeto
+    };
+
+    /**
+     * @brief O que uma Mesh mantém na memória do sistema depois do upload para a GPU
+     *
+     * Em ordem crescente de economia: uma mesh só avança nesta ordem.
+     */
+    enum class CpuResidency : uint8_t
+    {
+        Keep,              // Mantém vertices e indices (edição, depuração)
+        KeepPositionsOnly, // Mantém apenas posições e índices (consultas e oclusão na CPU)
+        ReleaseAfterUpload // Libera tudo: a geometria existe apenas na GPU
+    };
+
+    /**
+     * @brief Dados de uma mesh apenas na CPU (sem recursos OpenGL)
+     *
+     * É o que o ModelLoader produz. Pode ser criada, processada e descartada em
+     * qualquer thread, inclusive sem contexto OpenGL; a criação dos buffers da
+     * GPU acontece depois, ao construir uma Mesh a partir destes dados.
+     */
+    struct MeshData
+    {
+        std::vector<Vertex> vertices;       // Lista de vértices
+        std::vector<GLuint> indices;        // Lista de índices (3 índices = 1 triângulo)
+        std::string name;                   // Nome da mesh
+        std::shared_ptr<Material> material; // Material (pode ser nullptr)
+        glm::mat4 localTransform{1.0f};     // Transformação local (relativa ao Model)
+        std::vector<MeshLod> lods;          // LODs 1..N, do mais detalhado ao mais simples (LOD 0 = indices)
+        MeshBounds bounds;                  // AABB e esfera no espaço local (vazios até o cálculo)
+
+        // Geometria duplicada (ModelLoader): índice, em ModelData::meshes, da mesh cujos
+        // buffers da GPU esta reutiliza (-1 = buffers próprios), e a translação do espaço
+        // daquela geometria para o desta mesh
+        int32_t sharedGeometry = -1;
+        glm::vec3 geometryOffset{0.0f};
+
+        size_t getTriangleCount() const { return indices.size() / 3; }
+        size_t getVertexCount() const { return vertices.size(); }
+    };
+
+    /**
+     * @brief Dados de um modelo completo apenas na CPU
+     */
+    struct ModelData
+    {
+        std::string name;             // Nome do modelo
+        std::vector<MeshData> meshes; // Meshes na ordem do arquivo
+
+        size_t getMeshCount() const { return meshes.size(); }
+
+        size_t getTotalTriangleCount() const
+        {
+            size_t total = 0;
+            for (const auto &mesh : meshes)
+                total += mesh.getTriangleCount();
+            return total;
+        }
+
+        size_t getTotalVertexCount() const
+        {
+            size_t total = 0;
+            for (const auto &mesh : meshes)
+                total += mesh.getVertexCount();
+            return total;
+        }
+    };
+
+} // namespace cg
@@ -0,0 +1,84 @@
+#pragma once
+#include "render/MeshData.h"
+#include <vector>
+#include <cstddef>
+
+namespace cg
+{
+
+    /**
+     * @brief Otimizações de ordem de triângulos e vértices para meshes indexadas
+     *
+     * Opera apenas sobre dados de CPU (MeshData), sem chamadas OpenGL, e pode ser
+     * executado em paralelo para meshes diferentes. A sequência completa (optimize)
+     * é a clássica para GPUs:
+     * 1. Cache de vértices pós-transformação: reordena triângulos com o algoritmo
+     *    Tipsify (Sander, Nehab e Barczak, 2007), em tempo linear;
+     * 2. Overdraw: agrupa a saída do passo 1 em clusters e os ordena "de fora para
+     *    dentro", favorecendo o early-Z, sem piorar o ACMR além de um limiar;
+     * 3. Busca de vértices: renumera os vértices na ordem do primeiro uso, para que
+     *    o vertex fetch percorra o VBO de forma sequencial.
+     *
+     * As métricas usam um cache FIFO de kCacheSize entradas.
+     */
+    class MeshOptimizer
+    {
+    public:
+        // Tamanho do cache de vértices simulado (FIFO)
+        static constexpr unsigned kCacheSize = 16;
+
+        // ACMR máximo aceito no passo de overdraw, relativo ao obtido pelo Tipsify
+        static constexpr float kOverdrawThreshold = 1.05f;
+
+        /**
+         * @brief Resultado da simulação do cache de vértices
+         */
+        struct CacheStats
+        {
+            size_t triangles = 0; // Triângulos processados
+            size_t vertices = 0;  // Vértices distintos referenciados
+            size_t misses = 0;    // Vértices transformados (faltas no cache)
+
+            // Average Cache Miss Ratio: vértices transformados por triângulo (ideal ~0.5)
+            double acmr() const { return triangles ? static_cast<double>(misses) / triangles : 0.0; }
+
+            // Average Transformed Vertex Ratio: vértices transformados por vértice distinto (ideal 1.0)
+            double atvr() const { return vertices ? static_cast<double>(misses) / vertices : 0.0; }
+        };
+
+        /**
+         * @brief Simula um cache FIFO de vértices sobre a lista de índices
+         * @param indices Índices (3 por triângulo)
+         * @param vertexCount Número de vértices da mesh
+         * @param cacheSize Entradas do cache simulado
+         */
+        static CacheStats analyzeVertexCache(const std::vector<GLuint> &indices, size_t vertexCount,
+                                             unsigned cacheSize = kCacheSize);
+
+        /**
+         * @brief Executa as três etapas em ordem sobre a mesh
+         */
+        static void optimize(MeshData &mesh);
+
+        /**
+         * @brief Reordena os triângulos para localidade no cache de vértices (Tipsify)
+         */
+        static void optimizeVertexCache(std::vector<GLuint> &indices, size_t vertexCount,
+                                        unsigned cacheSize = kCacheSize);
+
+        /**
+         * @brief Reordena clusters de triângulos para reduzir overdraw
+         * @param indices Índices já otimizados para o cache de vértices
+         * @param vertices Vértices da mesh (usa apenas as posições)
+         * @param threshold ACMR máximo aceito, relativo ao ACMR de entrada
+         */
+        static void optimizeOverdraw(std::vector<GLuint> &indices, const std::vector<Vertex> &vertices,
+                                     float threshold = kOverdrawThreshold, unsigned cacheSize = kCacheSize);
+
+        /**
+         * @brief Renumera os vértices na ordem do primeiro uso (vértices não referenciados são removidos)
+         */
+        static void optimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<GLuint> &indices);
+    };
+
+} // namespace cg
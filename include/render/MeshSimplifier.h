@@ -0,0 +1,60 @@
+#pragma once
+#include "render/MeshData.h"
+#include <vector>
+#include <cstddef>
+
+namespace cg
+{
+
+    /**
+     * @brief Simplificação de meshes por métricas de erro quádrico (Garland e Heckbert, 1997)
+     *
+     * Colapsa arestas em passes: cada passe calcula o custo de todas as arestas,
+     * executa os colapsos mais baratos que não compartilham vizinhança e reescreve
+     * os índices. O vértice removido é movido para o vértice que permanece, de modo
+     * que o resultado é apenas um novo array de índices sobre os mesmos vértices:
+     * todos os níveis de LOD compartilham o VBO da mesh.
+     *
+     * Costuras de UV/normal (vértices na mesma posição com atributos diferentes) e
+     * bordas abertas só colapsam ao longo delas mesmas, e recebem planos de restrição
+     * extras na quádrica para que seu contorno seja preservado. Opera apenas sobre
+     * dados de CPU e pode rodar em paralelo para meshes diferentes.
+     */
+    class MeshSimplifier
+    {
+    public:
+        // Níveis gerados além do LOD 0
+        static constexpr unsigned kMaxLodLevels = 3;
+
+        // Fração de triângulos de cada nível em relação ao nível anterior
+        static constexpr float kLodTriangleRatio = 0.5f;
+
+        // Erro máximo aceito, relativo à diagonal da AABB da mesh
+        static constexpr float kMaxLodError = 0.02f;
+
+        // Meshes menores que isso não recebem LODs
+        static constexpr size_t kMinLodTriangles = 128;
+
+        /**
+         * @brief Simplifica a mesh até atingir o número de índices ou o erro máximo
+         * @param vertices Vértices da mesh (não são alterados)
+         * @param indices Índices de origem (3 por triângulo)
+         * @param targetIndexCount Número de índices desejado
+         * @param targetError Distância máxima (no espaço do objeto) aceita para os colapsos
+         * @param resultError Se não for nulo, recebe o erro do colapso mais caro executado
+         * @return Novos índices, referenciando o mesmo array de vértices
+         */
+        static std::vector<GLuint> simplify(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices,
+                                            size_t targetIndexCount, float targetError, float *resultError = nullptr);
+
+        /**
+         * @brief Gera a cadeia de LODs da mesh em MeshData::lods
+         *
+         * Cada nível é simplificado a partir do LOD 0 (para que o erro seja sempre
+         * relativo à geometria original). A cadeia termina antes de kMaxLodLevels se
+         * um nível não reduzir o suficiente em relação ao anterior.
+         */
+        static void generateLods(MeshData &mesh);
+    };
+
+} // namespace cg
@@ -1,8 +1,11 @@
 #pragma once
 #include "render/Mesh.h"
+#include "render/TransformKernel.h"
 #include <vector>
 #include <memory>
 #include <string>
+#include <cstdint>
+#include <unordered_map>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -69,11 +72,39 @@ namespace cg
 
     /**
      * @brief Obtém a matriz mundo de uma mesh específica (modelo * cadeia de pais * local)
+     *
+     * Atualiza o cache (updateWorldMatrices) e o consulta; quem percorre todas as
+     * meshes deve atualizar uma vez e usar getWorldMatrix(índice).
      * @param mesh Ponteiro para a mesh pertencente a este Model
      * @return Matriz 4x4 da transformação no espaço do mundo
      */
     glm::mat4 getWorldMatrixForMesh(const Mesh *mesh) const;
 
+    /**
+     * @brief Atualiza as matrizes de mundo e de normais em cache numa passada linear
+     *
+     * A hierarquia fica achatada em ordem topológica (pais antes dos filhos), então
+     * cada mesh é recalculada a partir da matriz já pronta do pai. Só são
+     * recalculadas as meshes cujo setLocalTransform mudou e seus descendentes, ou
+     * todas se a posição/rotação/escala do modelo mudou.
+     * @return Número de meshes recalculadas
+     */
+    size_t updateWorldMatrices() const;
+
+    /**
+     * @brief Matrizes em cache de uma mesh (índice em getMeshes()), da última updateWorldMatrices()
+     */
+    const glm::mat4 &getWorldMatrix(size_t meshIndex) const { return mWorldMatrices[meshIndex]; }
+    const glm::mat3 &getNormalMatrix(size_t meshIndex) const { return mNormalMatrices[meshIndex]; }
+
+    /**
+     * @brief Número de passadas de updateWorldMatrices() que mudaram alguma matriz
+     *
+     * getWorldStamp(i) > v indica que a matriz da mesh i mudou depois de a versão v ser vista.
+     */
+    uint64_t getWorldVersion() const { return mWorldVersion; }
+    uint64_t getWorldStamp(size_t meshIndex) const { return mWorldStamps[meshIndex]; }
+
     /**
      * @brief Define a relação pai-filho entre duas meshes por nome
      * @param childName Nome da mesh filha
@@ -90,6 +121,15 @@ namespace cg
      */
     bool setParent(Mesh *child, Mesh *parent);
 
+    /**
+     * @brief Valor que muda sempre que a matriz de mundo de alguma mesh pode ter mudado
+     *
+     * Combina as alterações de posição/rotação/escala, de hierarquia e das
+     * transformações locais das meshes (Mesh::getTransformVersion). Os contadores
+     * só crescem, então basta comparar com o valor visto anteriormente.
+     */
+    uint64_t getTransformVersion() const;
+
         // =================== GETTERS ===================
 
         const glm::vec3 &getPosition() const { return mPosition; }
@@ -112,6 +152,39 @@ namespace cg
          */
         size_t getTotalVertexCount() const;
 
+        /**
+         * @brief Obtém os bytes de VBO/EBO ocupados na GPU por todas as meshes
+         */
+        size_t getTotalGpuMemoryBytes() const;
+
+        /**
+         * @brief Obtém os bytes de geometria mantidos na CPU por todas as meshes
+         */
+        size_t getTotalCpuMemoryBytes() const;
+
+        /**
+         * @brief Aplica uma política de residência na CPU a todas as meshes do modelo
+         * @param residency Política (só libera dados; ver Mesh::setCpuResidency)
+         */
+        void setCpuResidency(CpuResidency residency);
+
+        // =================== GEOMETRIA ESTÁTICA ===================
+
+        /**
+         * @brief Marca o modelo como estático (não se move depois de entrar na cena)
+         *
+         * O Renderer agrupa as meshes opacas de modelos estáticos em lotes
+         * (StaticBatch); meshes que participam da hierarquia pai-filho, como as
+         * portas, continuam sendo desenhadas individualmente.
+         */
+        void setStatic(bool isStatic) { mStatic = isStatic; }
+        bool isStatic() const { return mStatic; }
+
+        /**
+         * @brief Verifica se a mesh tem pai ou filhos (transformação animável pela hierarquia)
+         */
+        bool isInHierarchy(const Mesh *mesh) const;
+
         /**
          * @brief Verifica se o modelo está vazio (sem meshes)
          */
@@ -123,11 +196,6 @@ namespace cg
          */
         const std::vector<std::unique_ptr<Mesh>> &getMeshes() const { return mMeshes; }
 
-        /**
-         * @brief Acesso mutável às meshes (para aplicar transformações locais)
-         */
-        std::vector<std::unique_ptr<Mesh>> &getMeshesMutable() { return mMeshes; }
-
         /**
          * @brief Obtém um ponteiro para a mesh pelo nome (somente leitura)
          * @param meshName Nome da mesh
@@ -188,13 +256,56 @@ namespace cg
         /**
          * @brief Marca que a matriz de transformação precisa ser recalculada
          */
-        void markMatrixDirty() { mMatrixNeedsUpdate = true; }
+        void markMatrixDirty()
+        {
+            mMatrixNeedsUpdate = true;
+            mAllWorldDirty = true;
+            ++mTransformVersion;
+        }
+
+        uint64_t mTransformVersion = 0; // Mudanças de transformação e hierarquia do próprio modelo
+        bool mStatic = false;           // Meshes fora da hierarquia podem ir para lotes estáticos
 
         // Utilitário: retorna o índice de uma mesh pelo ponteiro; -1 se não pertencer ao modelo
         int indexOf(const Mesh *mesh) const;
 
-        // Utilitário: calcula a transformação local acumulada ao longo da cadeia de pais até a raiz
-        glm::mat4 accumulateLocalUpToRoot(int meshIndex) const;
+        // =================== HIERARQUIA ACHATADA ===================
+        /**
+         * @brief Mesh na ordem topológica da hierarquia
+         */
+        struct TransformNode
+        {
+            int mesh = -1;   // Índice em mMeshes
+            int parent = -1; // Posição do pai em mTransformNodes (-1 = raiz)
+        };
+
+        std::unordered_map<const Mesh *, int> mIndexByMesh; // Ponteiro -> índice em mMeshes
+        std::vector<uint32_t> mChildCounts;                 // Filhos diretos por mesh (alinha com mMeshes)
+
+        mutable std::vector<TransformNode> mTransformNodes; // Pais antes dos filhos
+        mutable bool mHierarchyDirty = true;                // mParents mudou: refazer mTransformNodes
+        mutable bool mAllWorldDirty = true;                 // Matriz do modelo mudou: recalcular tudo
+        mutable std::vector<uint8_t> mNodeDirty;            // Por nó, na passada atual (propagação aos filhos)
+
+        // Por mesh (alinham com mMeshes)
+        mutable std::vector<glm::mat4> mWorldMatrices;  // Modelo * pais * local
+        mutable std::vector<glm::mat3> mNormalMatrices; // Transposta da inversa de mat3(mundo)
+        mutable std::vector<uint32_t> mLocalVersions;   // Mesh::getTransformVersion() usada no cálculo
+        mutable std::vector<uint64_t> mWorldStamps;     // mWorldVersion da passada que recalculou a mesh
+        mutable uint64_t mWorldVersion = 0;
+
+        // Lote de um nível em updateWorldMatrices (TransformKernel, memória reaproveitada)
+        mutable std::vector<uint32_t> mLevelStarts; // Primeiro nó de cada profundidade + total no fim
+        mutable std::vector<uint32_t> mBatchNodes;  // Nós sujos do nível atual
+        mutable Mat4Array mBatchParents;
+        mutable Mat4Array mBatchLocals;
+        mutable Mat4Array mBatchWorlds;
+        mutable Mat3Array mBatchNormals;
+
+        /**
+         * @brief Refaz a ordem topológica (busca em largura a partir das raízes) e marca tudo para recálculo
+         */
+        void rebuildTransformOrder() const;
     };
 
 } // namespace cg
@@ -1,9 +1,14 @@
 #pragma once
 #include "render/Model.h"
+#include "render/MeshData.h"
+#include "render/VertexFormat.h"
 #include <string>
+#include <string_view>
 #include <memory>
 #include <vector>
 #include <unordered_map>
+#include <cstdint>
+#include <future>
 
 namespace cg
 {
@@ -19,6 +24,14 @@ namespace cg
      * - Múltiplos objetos em um arquivo (o nome)
      * - Comentários (#)
      *
+     * O arquivo é mapeado em memória e tokenizado direto dos bytes mapeados
+     * (std::string_view + std::from_chars), sem alocações por linha.
+     *
+     * O carregamento tem duas etapas: loadModelData produz apenas dados de CPU
+     * (ModelData) e não faz chamadas OpenGL, podendo rodar em qualquer thread;
+     * uploadModel cria os buffers da GPU na thread que possui o contexto.
+     * loadModel executa as duas em sequência.
+     *
      * Limitações atuais:
      * - Apenas faces triangulares (não quads)
      * - Não suporta grupos (g)
@@ -34,11 +47,83 @@ namespace cg
             size_t totalVertices = 0;  // Total de vértices únicos carregados
             size_t totalTriangles = 0; // Total de triângulos carregados
             size_t totalMeshes = 0;    // Total de meshes criadas
+            size_t totalLines = 0;     // Total de linhas do arquivo OBJ processadas
             float loadTimeMs = 0.0f;   // Tempo de carregamento em milissegundos
+            float parseTimeMs = 0.0f;  // Tempo gasto apenas no parsing das linhas
+            double linesPerSecond = 0; // Vazão do parser (linhas / segundo)
+            unsigned workerThreads = 1; // Threads usadas no parsing (1 = modo serial)
+            bool fromCache = false;     // true se as meshes vieram do cache binário
+            float uploadTimeMs = 0.0f;  // Tempo de criação dos buffers da GPU (apenas loadModel)
+
+            // Otimização de meshes (LoadOptions::optimizeMeshes; zeros se não executada)
+            float optimizeTimeMs = 0.0f; // Tempo total da otimização (todas as meshes)
+            double acmrBefore = 0.0;     // Vértices transformados por triângulo, antes
+            double acmrAfter = 0.0;      // Vértices transformados por triângulo, depois
+            double atvrBefore = 0.0;     // Vértices transformados por vértice único, antes
+            double atvrAfter = 0.0;      // Vértices transformados por vértice único, depois
+
+            // Geração de LODs (LoadOptions::generateLods; zeros se não executada)
+            float lodTimeMs = 0.0f; // Tempo total da simplificação (todas as meshes)
+            size_t lodMeshes = 0;   // Meshes que receberam ao menos um LOD
+            size_t lodLevels = 0;   // Total de níveis gerados (além dos LOD 0)
+
+            // Geometria duplicada (LoadOptions::shareDuplicateGeometry)
+            size_t sharedGeometryMeshes = 0; // Meshes que reutilizam os buffers de outra
+            size_t sharedGeometryBytes = 0;  // Bytes de VBO/EBO que deixam de ser enviados à GPU
 
             void print() const; // Imprime estatísticas no console
         };
 
+        /**
+         * @brief Opções de carregamento
+         */
+        struct LoadOptions
+        {
+            // Lê o arquivo mapeado em memória (mmap). Se desativado, ou se o
+            // mapeamento falhar, usa leitura linha a linha com std::getline
+            bool useMemoryMap = true;
+
+            // Número de threads do parsing paralelo (requer arquivo mapeado).
+            // 1 = modo serial; 0 = usa todos os núcleos disponíveis
+            unsigned workerCount = 1;
+
+            // Usa (e grava) o cache binário "<arquivo>.meshcache" ao lado do OBJ
+            bool useCache = true;
+
+            // Reordena triângulos e vértices de cada mesh para o cache de vértices da GPU,
+            // overdraw e vertex fetch (MeshOptimizer). Executado em paralelo por mesh
+            // (workerCount threads); o resultado é gravado no cache binário
+            bool optimizeMeshes = false;
+
+            // Formato dos vértices na GPU (quantizado no upload; os dados de CPU e o
+            // cache binário continuam em float)
+            VertexFormat vertexFormat = VertexFormat::Standard;
+
+            // Gera níveis de detalhe por mesh (MeshSimplifier), em paralelo por mesh;
+            // o resultado é gravado no cache binário
+            bool generateLods = false;
+
+            // O que cada mesh mantém na memória do sistema depois do upload para a GPU
+            CpuResidency cpuResidency = CpuResidency::Keep;
+
+            // Detecta meshes com a mesma geometria (a menos de uma translação) e faz
+            // com que compartilhem os buffers da GPU (MeshData::sharedGeometry)
+            bool shareDuplicateGeometry = true;
+        };
+
+        /**
+         * @brief Resultado de um carregamento em background
+         */
+        struct AsyncResult
+        {
+            std::unique_ptr<ModelData> data; // nullptr se houve erro
+            LoadStats stats;                 // Estatísticas do carregamento
+        };
+
+        // Versão da saída do loader; incrementar quando o resultado do parsing mudar,
+        // para invalidar caches binários gravados por versões anteriores
+        static constexpr uint32_t kLoaderVersion = 1;
+
         /**
          * @brief Carrega um modelo 3D de um arquivo OBJ
          * @param filePath Caminho para o arquivo .obj
@@ -48,12 +133,128 @@ namespace cg
         static std::unique_ptr<Model> loadModel(const std::string &filePath,
                                                 const std::string &modelName = "");
 
+        /**
+         * @brief Carrega um modelo 3D de um arquivo OBJ com opções explícitas
+         * @param filePath Caminho para o arquivo .obj
+         * @param modelName Nome do modelo (se vazio, usa o nome do arquivo)
+         * @param options Opções de carregamento
+         * @return Ponteiro único para o modelo carregado, ou nullptr se houve erro
+         */
+        static std::unique_ptr<Model> loadModel(const std::string &filePath,
+                                                const std::string &modelName,
+                                                const LoadOptions &options);
+
+        /**
+         * @brief Carrega apenas os dados de CPU de um arquivo OBJ (sem chamadas OpenGL)
+         *
+         * Não depende de contexto OpenGL nem de estado global: pode ser chamado em
+         * threads de background ou em ferramentas sem GPU.
+         * @param filePath Caminho para o arquivo .obj
+         * @param modelName Nome do modelo (se vazio, usa o nome do arquivo)
+         * @param options Opções de carregamento
+         * @param stats Se não for nullptr, recebe as estatísticas deste carregamento
+         * @return Dados do modelo, ou nullptr se houve erro
+         */
+        static std::unique_ptr<ModelData> loadModelData(const std::string &filePath,
+                                                        const std::string &modelName,
+                                                        const LoadOptions &options,
+                                                        LoadStats *stats = nullptr);
+
+        /**
+         * @brief Executa loadModelData em uma thread de background
+         * @param filePath Caminho para o arquivo .obj
+         * @param modelName Nome do modelo (se vazio, usa o nome do arquivo)
+         * @param options Opções de carregamento
+         * @return Future com os dados do modelo; o upload (uploadModel) fica a cargo
+         *         de quem o consumir, na thread do contexto OpenGL
+         */
+        static std::future<AsyncResult> loadModelDataAsync(const std::string &filePath,
+                                                           const std::string &modelName,
+                                                           const LoadOptions &options);
+
+        /**
+         * @brief Cria o modelo desenhável (buffers da GPU) a partir de dados já carregados
+         *
+         * Requer contexto OpenGL ativo na thread atual. Os arrays de data são movidos
+         * para as meshes, sem cópia.
+         * @param data Dados produzidos por loadModelData
+         * @param format Formato dos vértices na GPU
+         * @param residency O que cada mesh mantém na CPU após o upload
+         * @return Modelo pronto para renderização
+         */
+        static std::unique_ptr<Model> uploadModel(ModelData &&data, VertexFormat format = VertexFormat::Standard,
+                                                  CpuResidency residency = CpuResidency::Keep);
+
         /**
          * @brief Obtém as estatísticas do último carregamento
          * @return Estrutura com estatísticas detalhadas
+         * @note Atualizadas apenas por loadModel (use o parâmetro stats de loadModelData)
          */
         static const LoadStats &getLastLoadStats() { return sLastStats; }
 
+        // =================== DEDUPLICAÇÃO DE VÉRTICES ===================
+
+        /**
+         * @brief Estrutura para representar um índice de face no formato OBJ
+         */
+        struct FaceIndex
+        {
+            int positionIndex = -1; // Índice da posição (obrigatório)
+            int texCoordIndex = -1; // Índice da coordenada de textura (opcional)
+            int normalIndex = -1;   // Índice da normal (opcional)
+
+            // Converte índices relativos do OBJ para absolutos
+            void makeAbsolute(size_t posCount, size_t texCount, size_t normCount);
+        };
+
+        /**
+         * @brief Tabela hash de endereçamento aberto para deduplicação de vértices
+         *
+         * A chave é a tripla (posição, textura, normal) de índices já absolutos,
+         * guardada diretamente nos slots (sem strings nem nós alocados). A limpeza
+         * entre meshes é O(1): cada slot carrega a geração em que foi escrito, e
+         * clear() apenas avança a geração, mantendo a capacidade reservada.
+         * Pública para ser medida isoladamente (bench/VertexDedupBenchmark.cpp).
+         */
+        class VertexDedupTable
+        {
+        public:
+            /**
+             * @brief Garante capacidade para pelo menos expectedKeys chaves sem crescer
+             */
+            void reserve(size_t expectedKeys);
+
+            /**
+             * @brief Esvazia a tabela mantendo a memória para a próxima mesh
+             */
+            void clear();
+
+            /**
+             * @brief Procura a chave; se ausente, insere com o valor informado
+             * @param key Índices da face (já absolutos)
+             * @param value Valor a inserir caso a chave não exista
+             * @param inserted Recebe true se a chave foi inserida agora
+             * @return Valor associado à chave
+             */
+            GLuint findOrInsert(const FaceIndex &key, GLuint value, bool &inserted);
+
+        private:
+            struct Slot
+            {
+                int positionIndex;
+                int texCoordIndex;
+                int normalIndex;
+                GLuint value;
+                uint32_t generation; // Slot ocupado apenas se igual a mGeneration
+            };
+
+            std::vector<Slot> mSlots; // Capacidade sempre potência de 2
+            size_t mSize = 0;
+            uint32_t mGeneration = 1;
+
+            void rehash(size_t newCapacity);
+        };
+
     private:
         // =================== ESTRUTURAS INTERNAS ===================
 
@@ -72,90 +273,213 @@ namespace cg
             std::string currentObjectName;
             std::shared_ptr<Material> currentMaterial; // Material atual
 
-            // Mapa para evitar vértices duplicados (otimização)
-            std::unordered_map<std::string, GLuint> vertexMap;
+            // Tabela para evitar vértices duplicados (otimização)
+            VertexDedupTable vertexMap;
 
             // Biblioteca de materiais carregados
             std::unordered_map<std::string, std::shared_ptr<Material>> materials;
+
+            // Caminhos resolvidos dos arquivos .mtl lidos (dependências do cache binário)
+            std::vector<std::string> materialLibraries;
+
+            // Buffer reutilizado entre faces (evita alocação por linha)
+            std::vector<FaceIndex> faceScratch;
+
+            // Mensagem do último erro de parsing (nullptr se não houve erro)
+            const char *lastError = nullptr;
         };
 
         /**
-         * @brief Estrutura para representar um índice de face no formato OBJ
+         * @brief Tipo de uma linha OBJ, decidido pelo primeiro token
          */
-        struct FaceIndex
+        enum class LineType
         {
-            int positionIndex = -1; // Índice da posição (obrigatório)
-            int texCoordIndex = -1; // Índice da coordenada de textura (opcional)
-            int normalIndex = -1;   // Índice da normal (opcional)
+            Ignored,     // Vazia, comentário ou comando não suportado (s, g, ...)
+            Vertex,      // v
+            Normal,      // vn
+            TexCoord,    // vt
+            Face,        // f
+            Object,      // o
+            MaterialLib, // mtllib
+            UseMaterial  // usemtl
+        };
 
-            // Converte índices relativos do OBJ para absolutos
-            void makeAbsolute(size_t posCount, size_t texCount, size_t normCount);
+        /**
+         * @brief Evento registrado por um worker do parsing paralelo
+         *
+         * Guarda quantos v/vn/vt o bloco já tinha lido quando o evento ocorreu,
+         * para que a etapa de merge reproduza exatamente o estado do modo serial.
+         */
+        struct ChunkEvent
+        {
+            LineType type = LineType::Ignored; // Face, Object, MaterialLib ou UseMaterial
+            size_t positionCount = 0;          // v lidos no bloco até este evento
+            size_t texCoordCount = 0;          // vt lidos no bloco até este evento
+            size_t normalCount = 0;            // vn lidos no bloco até este evento
+            size_t firstFaceIndex = 0;         // Face: início em ParseChunk::faceIndices
+            size_t faceIndexCount = 0;         // Face: quantidade de índices
+            size_t lineNumber = 0;             // Linha local ao bloco (para mensagens de erro)
+            std::string_view line;             // Linha original (aponta para o buffer mapeado)
+            const char *error = nullptr;       // Mensagem se a linha for inválida
+        };
 
-            // Cria string única para identificar este vértice (para evitar duplicatas)
-            std::string getKey() const;
+        /**
+         * @brief Bloco do arquivo (alinhado em quebras de linha) processado por um worker
+         */
+        struct ParseChunk
+        {
+            std::string_view text;           // Trecho do buffer mapeado
+            ParseData data;                  // v/vn/vt locais ao bloco
+            std::vector<FaceIndex> faceIndices; // Índices brutos das faces (antes de makeAbsolute)
+            std::vector<ChunkEvent> events;  // Eventos em ordem de ocorrência
+            size_t lineCount = 0;            // Linhas contidas no bloco
         };
 
         // =================== MÉTODOS DE PARSING ===================
 
         /**
          * @brief Faz o parsing de uma linha do arquivo OBJ
-         * @param line Linha a ser processada
+         * @param line Linha a ser processada (visão sobre o buffer do arquivo, sem cópia)
          * @param data Dados de parsing onde armazenar resultados
-         * @param model Modelo onde adicionar meshes completas
+         * @param model Dados do modelo onde adicionar meshes completas
          * @param objFilePath Caminho do arquivo OBJ (para resolver caminhos relativos de .mtl)
+         * @return false se a linha for inválida (mensagem em data.lastError)
+         */
+        static bool parseLine(std::string_view line, ParseData &data, ModelData &model, const std::string &objFilePath);
+
+        /**
+         * @brief Identifica o tipo de uma linha já sem espaços nas extremidades
+         */
+        static LineType classifyLine(std::string_view trimmedLine);
+
+        /**
+         * @brief Faz o parsing paralelo de um arquivo mapeado em memória
+         *
+         * Divide o buffer em blocos alinhados em quebras de linha; cada worker lê
+         * v/vn/vt para arrays próprios e registra eventos f/o/usemtl/mtllib. O merge,
+         * serial e determinístico, resolve os índices globais e relativos e monta as
+         * meshes pelos mesmos caminhos do modo serial (resultado idêntico).
+         * @return Número de linhas processadas
+         */
+        static size_t parseParallel(std::string_view buffer, ParseData &data, ModelData &model,
+                                    const std::string &objFilePath, unsigned workerCount);
+
+        /**
+         * @brief Processa um bloco do arquivo (executado em uma thread worker)
          */
-        static void parseLine(const std::string &line, ParseData &data, Model &model, const std::string &objFilePath);
+        static void parseChunk(ParseChunk &chunk);
+
+        /**
+         * @brief Conta os cantos de face de cada objeto de um arquivo mapeado (modo serial)
+         *
+         * Permite reservar a tabela de deduplicação uma vez por objeto, como o
+         * merge do modo paralelo faz a partir dos eventos.
+         * @param objectLines Recebe o início de cada linha "o", na ordem do arquivo
+         * @return Cantos antes do primeiro "o" seguidos dos cantos de cada objeto
+         */
+        static std::vector<size_t> countObjectCorners(std::string_view buffer, std::vector<const char *> &objectLines);
 
         /**
          * @brief Processa uma linha de vértice (v x y z)
          */
-        static void parseVertex(const std::string &line, ParseData &data);
+        static bool parseVertex(std::string_view line, ParseData &data);
 
         /**
          * @brief Processa uma linha de normal (vn x y z)
          */
-        static void parseNormal(const std::string &line, ParseData &data);
+        static bool parseNormal(std::string_view line, ParseData &data);
 
         /**
          * @brief Processa uma linha de coordenada de textura (vt u v)
          */
-        static void parseTexCoord(const std::string &line, ParseData &data);
+        static bool parseTexCoord(std::string_view line, ParseData &data);
 
         /**
          * @brief Processa uma linha de face (f v1/vt1/vn1 v2/vt2/vn2 v3/vt3/vn3)
          */
-        static void parseFace(const std::string &line, ParseData &data);
+        static bool parseFace(std::string_view line, ParseData &data);
+
+        /**
+         * @brief Lê os índices brutos de uma linha de face (sem resolvê-los)
+         * @param line Linha de face completa
+         * @param out Vetor onde os índices são acrescentados
+         * @return false se algum índice for inválido
+         */
+        static bool tokenizeFace(std::string_view line, std::vector<FaceIndex> &out);
+
+        /**
+         * @brief Resolve os índices em data.faceScratch e triangula a face (fan)
+         */
+        static void emitFace(ParseData &data);
 
         /**
          * @brief Processa uma linha de objeto (o nome)
          */
-        static void parseObject(const std::string &line, ParseData &data, Model &model);
+        static void parseObject(std::string_view line, ParseData &data, ModelData &model);
 
         /**
          * @brief Processa uma linha de biblioteca de materiais (mtllib arquivo.mtl)
          */
-        static void parseMaterialLib(const std::string &line, ParseData &data, const std::string &objFilePath);
+        static void parseMaterialLib(std::string_view line, ParseData &data, const std::string &objFilePath);
 
         /**
          * @brief Processa uma linha de uso de material (usemtl nome_material)
          */
-        static void parseUseMaterial(const std::string &line, ParseData &data);
+        static void parseUseMaterial(std::string_view line, ParseData &data);
 
         /**
          * @brief Finaliza a mesh atual e a adiciona ao modelo
          */
-        static void finalizeMesh(ParseData &data, Model &model);
+        static void finalizeMesh(ParseData &data, ModelData &model);
 
         /**
          * @brief Processa um índice de face no formato "v/vt/vn" ou "v//vn" ou "v"
+         * @return false se algum componente não for um inteiro válido
          */
-        static FaceIndex parseFaceIndex(const std::string &indexStr);
+        static bool parseFaceIndex(std::string_view indexStr, FaceIndex &faceIndex);
 
         /**
          * @brief Cria ou reutiliza um vértice baseado nos índices da face
          */
         static GLuint getOrCreateVertex(const FaceIndex &faceIndex, ParseData &data);
 
+        /**
+         * @brief Otimiza todas as meshes do modelo em paralelo e preenche as métricas em stats
+         */
+        static void optimizeMeshes(ModelData &model, unsigned workerCount, LoadStats &stats);
+
+        /**
+         * @brief Gera os LODs de todas as meshes em paralelo e preenche as métricas em stats
+         * @param optimizeLods Reordena os índices de cada nível para o cache de vértices
+         */
+        static void generateLods(ModelData &model, unsigned workerCount, bool optimizeLods, LoadStats &stats);
+
+        /**
+         * @brief Calcula MeshData::bounds de todas as meshes em paralelo
+         */
+        static void computeBounds(ModelData &model, unsigned workerCount);
+
+        /**
+         * @brief Marca as meshes cuja geometria repete a de uma mesh anterior
+         *
+         * Cada mesh é levada a um referencial canônico (vértices relativos ao centro
+         * da AABB) e resumida por um hash de vértices, índices e LODs; candidatas com
+         * o mesmo hash são confirmadas por comparação com tolerância. A duplicata
+         * mantém seus dados de CPU e recebe sharedGeometry/geometryOffset.
+         * Requer MeshData::bounds já calculados.
+         */
+        static void shareDuplicateGeometry(ModelData &model, unsigned workerCount, VertexFormat format,
+                                           LoadStats &stats);
+
+        // Bits de processingFlags
+        static constexpr uint32_t kProcessOptimizeMeshes = 1u << 0;
+        static constexpr uint32_t kProcessGenerateLods = 1u << 1;
+
+        /**
+         * @brief Etapas de pós-processamento ativadas pelas opções (gravadas no cache)
+         */
+        static uint32_t processingFlags(const LoadOptions &options);
+
         /**
          * @brief Calcula normais automaticamente se não estiverem presentes no arquivo
          */
@@ -166,11 +490,6 @@ namespace cg
          */
         static std::string trim(const std::string &str);
 
-        /**
-         * @brief Divide uma string em tokens usando um delimitador
-         */
-        static std::vector<std::string> split(const std::string &str, char delimiter);
-
         // =================== MÉTODOS PARA MATERIAIS ===================
 
         /**
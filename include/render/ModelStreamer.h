@@ -0,0 +1,156 @@
+#pragma once
+#include "render/Model.h"
+#include "render/ModelLoader.h"
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cg
+{
+
+    /**
+     * @brief Carregamento assíncrono de modelos com upload gradual para a GPU
+     *
+     * O parsing (e qualquer pós-processamento do ModelLoader) roda em uma thread
+     * de background. Quando os dados ficam prontos, update() — chamado uma vez por
+     * frame na thread do contexto OpenGL — envia as meshes para a GPU respeitando
+     * um orçamento de bytes por frame, para que o tempo de frame continue estável
+     * enquanto modelos grandes são carregados. O modelo só é entregue (onReady)
+     * depois que todas as suas meshes estão na GPU.
+     */
+    class ModelStreamer
+    {
+    public:
+        /**
+         * @brief Etapa atual de um carregamento
+         */
+        enum class LoadState
+        {
+            Parsing,   // Lendo o arquivo em background
+            Uploading, // Enviando meshes para a GPU (algumas por frame)
+            Ready,     // Modelo entregue
+            Failed     // Erro ao carregar o arquivo
+        };
+
+        /**
+         * @brief Acompanhamento de um carregamento (consultado na thread de renderização)
+         */
+        class Handle
+        {
+        public:
+            LoadState getState() const { return mState; }
+            bool isFinished() const { return mState == LoadState::Ready || mState == LoadState::Failed; }
+            const std::string &getFilePath() const { return mFilePath; }
+
+            // Bytes de vértices/índices já enviados e total do modelo (conhecido após o parsing)
+            size_t getUploadedBytes() const { return mUploadedBytes; }
+            size_t getTotalBytes() const { return mTotalBytes; }
+
+            // Fração do upload concluída (0..1)
+            float getProgress() const
+            {
+                if (mState == LoadState::Ready)
+                    return 1.0f;
+                return mTotalBytes ? static_cast<float>(mUploadedBytes) / static_cast<float>(mTotalBytes) : 0.0f;
+            }
+
+            // Estatísticas do parsing (válidas a partir de Uploading)
+            const ModelLoader::LoadStats &getLoadStats() const { return mLoadStats; }
+
+        private:
+            friend class ModelStreamer;
+
+            LoadState mState = LoadState::Parsing;
+            std::string mFilePath;
+            size_t mUploadedBytes = 0;
+            size_t mTotalBytes = 0;
+            ModelLoader::LoadStats mLoadStats;
+        };
+
+        using ReadyCallback = std::function<void(std::unique_ptr<Model>)>;
+        using FailedCallback = std::function<void()>;
+
+        /**
+         * @brief Estatísticas de upload do último frame
+         */
+        struct FrameStats
+        {
+            size_t uploadedBytes = 0;  // Bytes enviados à GPU neste frame
+            size_t uploadedMeshes = 0; // Meshes criadas neste frame
+            size_t pendingLoads = 0;   // Carregamentos ainda não concluídos
+            float uploadTimeMs = 0.0f; // Tempo gasto com upload neste frame
+        };
+
+        // Orçamento padrão de upload por frame
+        static constexpr size_t kDefaultUploadBudget = 8 * 1024 * 1024;
+
+        ModelStreamer() = default;
+        ~ModelStreamer() = default;
+
+        ModelStreamer(const ModelStreamer &) = delete;
+        ModelStreamer &operator=(const ModelStreamer &) = delete;
+
+        /**
+         * @brief Inicia o carregamento de um modelo em background
+         * @param filePath Caminho para o arquivo .obj
+         * @param modelName Nome do modelo (se vazio, usa o nome do arquivo)
+         * @param options Opções do ModelLoader
+         * @param onReady Recebe o modelo quando todas as meshes estiverem na GPU
+         * @param onFailed Chamado se o arquivo não puder ser carregado
+         * @return Handle para acompanhar o progresso
+         * @note Os callbacks são executados dentro de update(), na thread de renderização
+         */
+        std::shared_ptr<const Handle> load(const std::string &filePath,
+                                           const std::string &modelName,
+                                           const ModelLoader::LoadOptions &options,
+                                           ReadyCallback onReady,
+                                           FailedCallback onFailed = nullptr);
+
+        /**
+         * @brief Processa carregamentos pendentes (uma vez por frame, com contexto OpenGL ativo)
+         *
+         * Envia meshes em ordem até atingir o orçamento. Pelo menos uma mesh é
+         * enviada por frame, mesmo que sozinha ultrapasse o orçamento.
+         */
+        void update();
+
+        /**
+         * @brief Define o orçamento de upload por frame
+         * @param bytesPerFrame Bytes de vértices/índices por frame (0 = sem limite)
+         */
+        void setUploadBudget(size_t bytesPerFrame) { mUploadBudget = bytesPerFrame; }
+        size_t getUploadBudget() const { return mUploadBudget; }
+
+        bool hasPendingLoads() const { return !mPending.empty(); }
+        const FrameStats &getFrameStats() const { return mFrameStats; }
+
+    private:
+        /**
+         * @brief Carregamento em andamento
+         */
+        struct PendingLoad
+        {
+            std::shared_ptr<Handle> handle;
+            std::future<ModelLoader::AsyncResult> future; // Parsing em background
+            std::unique_ptr<ModelData> data;              // Dados prontos (após o parsing)
+            std::unique_ptr<Model> model;                 // Modelo sendo montado
+            size_t nextMesh = 0;                          // Próxima mesh a enviar
+            VertexFormat vertexFormat = VertexFormat::Standard; // Formato dos vértices na GPU
+            CpuResidency cpuResidency = CpuResidency::Keep;     // O que fica na CPU após o upload
+            ReadyCallback onReady;
+            FailedCallback onFailed;
+        };
+
+        std::vector<PendingLoad> mPending; // Em ordem de solicitação
+        size_t mUploadBudget = kDefaultUploadBudget;
+        FrameStats mFrameStats;
+
+        /**
+         * @brief Bytes de GPU ocupados pelos arrays de uma mesh no formato dado
+         */
+        static size_t meshBytes(const MeshData &mesh, VertexFormat format);
+    };
+
+} // namespace cg
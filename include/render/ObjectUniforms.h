@@ -0,0 +1,131 @@
+#pragma once
+#include "render/Shader.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace cg
+{
+
+    /**
+     * @brief Ring buffer de uniforms por objeto (std140), um slot por draw
+     *
+     * A cada frame, todos os objetos visíveis são escritos de uma vez numa das
+     * kFrameCount regiões do buffer (mapeada sem sincronização); cada draw só
+     * faz glBindBufferRange para o seu slot. Uma fence por região garante que
+     * a CPU não sobrescreve dados que a GPU ainda está lendo.
+     *
+     * Uso por frame: beginFrame(n), at(i) para i < n, endWrites(), bind(i) nos
+     * draws e endFrame() depois do último draw.
+     */
+    class ObjectUniforms
+    {
+    public:
+        // Ponto de ligação do bloco (FrameUniforms usa o 0)
+        static constexpr unsigned int kBindingPoint = 1;
+
+        // Nome do bloco no GLSL
+        static constexpr const char *kBlockName = "ObjectUniforms";
+
+        // Regiões do ring (frames que a CPU pode estar à frente da GPU)
+        static constexpr uint32_t kFrameCount = 3;
+
+        /**
+         * @brief Conteúdo de um slot, com o layout std140
+         */
+        struct Data
+        {
+            glm::mat4 model{1.0f};
+            glm::vec4 normalMatrix[3]; // mat3 em std140: três colunas vec4
+            glm::vec4 color{1.0f};     // rgb = cor do objeto, a = alpha
+            glm::vec4 specular{0.0f};  // rgb = cor especular, a = shininess
+            glm::vec4 positionOffset{0.0f}; // Dequantização das posições (xyz)
+            glm::vec4 positionScale{1.0f};
+        };
+
+        ObjectUniforms() = default;
+        ~ObjectUniforms();
+
+        /**
+         * @brief Declaração GLSL do bloco, para inserir logo após a linha #version
+         *
+         * Membros no escopo global: uModel, uNormalMatrix, uObjectColor,
+         * uSpecular, uPosOffset e uPosScale.
+         */
+        static const char *glslBlock();
+
+        /**
+         * @brief Associa o bloco de um programa ao ponto de ligação
+         * @return false se o programa não usa o bloco
+         */
+        static bool attach(const Shader &shader) { return shader.bindUniformBlock(kBlockName, kBindingPoint); }
+
+        /**
+         * @brief Cria o buffer e lê o alinhamento de offsets exigido pelo driver
+         */
+        bool init();
+
+        /**
+         * @brief Prepara a próxima região para count objetos e a mapeia para escrita
+         *
+         * Espera a fence da região (se a GPU ainda a usa) e cresce o buffer quando
+         * count excede a capacidade.
+         * @return false se o mapeamento falhou (nada deve ser desenhado)
+         */
+        bool beginFrame(size_t count);
+
+        /**
+         * @brief Slot de escrita do objeto index (válido entre beginFrame e endWrites)
+         */
+        Data &at(uint32_t index) { return *reinterpret_cast<Data *>(mMapped + index * mStride); }
+
+        /**
+         * @brief Desmapeia a região (antes do primeiro draw)
+         */
+        void endWrites();
+
+        /**
+         * @brief Liga o slot do objeto index ao ponto de ligação
+         */
+        void bind(uint32_t index) const;
+
+        /**
+         * @brief Insere a fence da região do frame (depois do último draw)
+         */
+        void endFrame();
+
+        /**
+         * @brief Quantas vezes beginFrame precisou esperar a GPU
+         */
+        size_t getStallCount() const { return mStallCount; }
+
+        /**
+         * @brief Libera o buffer e as fences
+         */
+        void cleanup();
+
+        // Desabilita cópia (o buffer seria liberado duas vezes)
+        ObjectUniforms(const ObjectUniforms &) = delete;
+        ObjectUniforms &operator=(const ObjectUniforms &) = delete;
+
+    private:
+        unsigned int mBuffer = 0;
+        size_t mStride = 0;        // sizeof(Data) arredondado para GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+        size_t mCapacity = 0;      // Slots por região
+        uint32_t mRegion = 0;      // Região do frame atual
+        uint8_t *mMapped = nullptr; // Início da região mapeada
+        void *mFences[kFrameCount] = {}; // GLsync de cada região (nullptr = livre)
+        size_t mStallCount = 0;
+
+        /**
+         * @brief Realoca o buffer para capacity slots por região
+         */
+        void reallocate(size_t capacity);
+
+        /**
+         * @brief Espera e descarta a fence de uma região
+         */
+        void waitRegion(uint32_t region);
+    };
+
+} // namespace cg
@@ -0,0 +1,165 @@
+#pragma once
+#include "render/Bounds.h"
+#include <glm/glm.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cg
+{
+
+    /**
+     * @brief Occlusion culling por software: buffer de profundidade de baixa resolução na CPU
+     *
+     * A cada frame alguns oclusores (meshes grandes e opacas, ou proxies de
+     * poucos polígonos) são rasterizados num buffer pequeno; depois as AABBs
+     * das meshes são projetadas e comparadas com ele. Nada depende de OpenGL,
+     * então o culler roda (e pode ser testado) sem GPU.
+     *
+     * - Profundidade guardada como 1/w (maior = mais perto), que varia
+     *   linearmente na tela e mantém precisão para objetos distantes.
+     * - Os triângulos são recortados pelo plano perto e distribuídos em tiles
+     *   (kTileWidth x kTileHeight); cada tile é rasterizado por uma thread,
+     *   8 pixels por vez com AVX, 4 com SSE ou um a um na versão escalar.
+     * - Ao fim de cada tile, cada bloco de kBlockWidth x kBlockHeight pixels
+     *   guarda a profundidade do oclusor mais distante (Hi-Z); o teste de uma
+     *   caixa lê apenas os blocos cobertos pelo retângulo dela na tela.
+     *
+     * O teste é conservador no nível dos blocos: uma caixa só é descartada se
+     * o ponto mais próximo dela estiver atrás do oclusor mais distante de
+     * todos os blocos que ela cobre. Caixas que cruzam o plano perto são
+     * sempre visíveis.
+     */
+    class OcclusionCuller
+    {
+    public:
+        static constexpr int kTileWidth = 32;
+        static constexpr int kTileHeight = 32;
+        static constexpr int kBlockWidth = 8;
+        static constexpr int kBlockHeight = 8;
+
+        /**
+         * @brief Contadores do último frame
+         */
+        struct Stats
+        {
+            size_t occluders = 0;          // Meshes adicionadas como oclusoras
+            size_t trianglesRasterized = 0; // Triângulos distribuídos nos tiles
+            size_t trianglesClipped = 0;    // Triângulos recortados pelo plano perto
+            size_t trianglesRejected = 0;   // Atrás da câmera, fora da tela ou degenerados
+            size_t boxesTested = 0;
+            size_t boxesOccluded = 0;
+            float rasterTimeMs = 0.0f;      // Rasterização dos tiles + Hi-Z
+        };
+
+        /**
+         * @brief Cria o buffer de profundidade e as threads de rasterização
+         * @param width Largura em pixels (arredondada para múltiplo de kTileWidth)
+         * @param height Altura em pixels (arredondada para múltiplo de kTileHeight)
+         * @param threadCount Threads que rasterizam tiles, contando a que chama rasterize() (0 = até 4, conforme os núcleos)
+         */
+        explicit OcclusionCuller(int width = 256, int height = 128, unsigned threadCount = 0);
+        ~OcclusionCuller();
+
+        /**
+         * @brief Limpa o buffer e os tiles para um novo frame
+         * @param viewProjection projection * view da câmera
+         */
+        void beginFrame(const glm::mat4 &viewProjection);
+
+        /**
+         * @brief Adiciona os triângulos de uma mesh oclusora (apenas preparação e distribuição nos tiles)
+         * @param world Matriz de mundo da mesh
+         * @param positions Posição do primeiro vértice (espaço local)
+         * @param stride Bytes entre posições consecutivas (ex.: sizeof(Vertex))
+         * @param vertexCount Número de vértices
+         * @param indices Três índices por triângulo
+         * @param indexCount Número de índices
+         */
+        void addOccluder(const glm::mat4 &world, const glm::vec3 *positions, size_t stride, size_t vertexCount,
+                         const uint32_t *indices, size_t indexCount);
+
+        /**
+         * @brief Rasteriza os tiles em paralelo e monta o Hi-Z (chamar antes dos testes)
+         */
+        void rasterize();
+
+        /**
+         * @brief Testa uma AABB de mundo contra os oclusores
+         * @return true se a caixa está inteiramente escondida
+         */
+        bool isOccluded(const BoundingBox &worldBox);
+
+        const Stats &getStats() const { return mStats; }
+
+        int getWidth() const { return mWidth; }
+        int getHeight() const { return mHeight; }
+
+        /**
+         * @brief Profundidade (1/w, 0 = sem oclusor) do pixel (x, y), com y = 0 na base da tela
+         */
+        float getDepth(int x, int y) const { return mDepth[static_cast<size_t>(y) * mWidth + x]; }
+
+        /**
+         * @brief Caminho escolhido na compilação (para estatísticas e benchmarks)
+         */
+        static const char *getPathName();
+
+        // Desabilita cópia (threads)
+        OcclusionCuller(const OcclusionCuller &) = delete;
+        OcclusionCuller &operator=(const OcclusionCuller &) = delete;
+
+    private:
+        /**
+         * @brief Triângulo preparado para a rasterização, em pixels
+         *
+         * Arestas e profundidade como funções lineares de (x, y):
+         * edge[i] = a * x + b * y + c >= 0 no interior; depth = 1/w interpolado.
+         */
+        struct Triangle
+        {
+            float edgeA[3], edgeB[3], edgeC[3];
+            float depthA, depthB, depthC;
+            int minX, minY, maxX, maxY; // Retângulo de pixels (inclusivo, já limitado à tela)
+        };
+
+        int mWidth = 0;
+        int mHeight = 0;
+        int mTilesX = 0;
+        int mTilesY = 0;
+        int mBlocksX = 0;
+        int mBlocksY = 0;
+        glm::mat4 mViewProjection{1.0f};
+
+        std::vector<float> mDepth;                    // 1/w por pixel (linha 0 = base da tela)
+        std::vector<float> mHiZ;                      // Menor 1/w (oclusor mais distante) por bloco
+        std::vector<Triangle> mTriangles;             // Triângulos do frame
+        std::vector<std::vector<uint32_t>> mTileBins; // Índices em mTriangles por tile
+        std::vector<glm::vec4> mClipScratch;          // Vértices de uma mesh no espaço de recorte
+        Stats mStats;
+
+        // =================== THREADS ===================
+        std::vector<std::thread> mWorkers;   // Threads além da que chama rasterize()
+        std::mutex mMutex;
+        std::condition_variable mWake;       // Novo frame para rasterizar (ou encerramento)
+        std::condition_variable mDone;       // Todas as threads terminaram o frame
+        uint64_t mGeneration = 0;            // Incrementado a cada rasterize()
+        unsigned mActiveWorkers = 0;         // Threads ainda rasterizando o frame atual
+        bool mStopping = false;
+        std::atomic<int> mNextTile{0};
+
+        void workerLoop();
+        void rasterizeTiles();
+        void rasterizeTile(int tile);
+
+        /**
+         * @brief Prepara um triângulo já na frente do plano perto e o distribui nos tiles
+         */
+        void setupTriangle(const glm::vec4 &v0, const glm::vec4 &v1, const glm::vec4 &v2);
+    };
+
+} // namespace cg
@@ -0,0 +1,137 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "render/Bounds.h"
+#include "render/Shader.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cg
+{
+
+    /**
+     * @brief Occlusion queries na GPU com renderização condicional
+     *
+     * Depois do passe opaco, a AABB de cada mesh desenhada individualmente é
+     * rasterizada (sem escrever cor nem profundidade) dentro de uma query
+     * GL_ANY_SAMPLES_PASSED. No frame seguinte o draw da mesh fica entre
+     * glBeginConditionalRender/glEndConditionalRender com GL_QUERY_NO_WAIT:
+     * a GPU descarta o draw se a caixa não teve nenhuma amostra visível e
+     * desenha normalmente se o resultado ainda não chegou. A CPU nunca espera
+     * por resultados.
+     *
+     * As queries vêm de um pool: cada mesh recebe uma na primeira vez que é
+     * consultada e a mantém até reset() (cena reconstruída), quando todas
+     * voltam ao pool sem serem apagadas.
+     *
+     * Uma mesh que reaparece atrás de um oclusor é desenhada com um frame de
+     * atraso (a query do frame anterior ainda dizia "oculta").
+     */
+    class OcclusionQueries
+    {
+    public:
+        /**
+         * @brief Contadores do último frame
+         */
+        struct Stats
+        {
+            size_t queries = 0;          // Queries emitidas (caixas rasterizadas)
+            size_t conditionalDraws = 0; // Draws condicionados ao resultado do frame anterior
+            size_t skipped = 0;          // Desses, os que a GPU descarta (resultado já disponível e zero)
+        };
+
+        OcclusionQueries() = default;
+        ~OcclusionQueries();
+
+        /**
+         * @brief Compila o programa das caixas e cria o cubo unitário
+         */
+        bool init();
+
+        /**
+         * @brief Devolve todas as queries ao pool e prepara itemCount entradas
+         *
+         * Chamado quando os índices das meshes mudam (cena reconstruída).
+         */
+        void reset(size_t itemCount);
+
+        /**
+         * @brief Zera os contadores e avança o frame
+         */
+        void beginFrame();
+
+        // =================== RENDERIZAÇÃO CONDICIONAL ===================
+
+        /**
+         * @brief Inicia a renderização condicional do item, se houver query do frame anterior
+         * @return true se glBeginConditionalRender foi chamado (chamar endConditional depois do draw)
+         */
+        bool beginConditional(uint32_t item);
+
+        /**
+         * @brief Encerra a renderização condicional iniciada por beginConditional
+         */
+        void endConditional();
+
+        // =================== PASSE DE QUERIES ===================
+
+        /**
+         * @brief Desativa escrita de cor e profundidade e vincula programa e cubo
+         */
+        void beginQueries();
+
+        /**
+         * @brief Rasteriza a AABB do item dentro da query dele
+         *
+         * Com a câmera dentro (ou muito perto) da caixa nenhuma query é
+         * emitida e o item é desenhado sem condição no próximo frame.
+         */
+        void query(uint32_t item, const BoundingBox &worldBox, const glm::vec3 &cameraPosition);
+
+        /**
+         * @brief Restaura escrita de cor e profundidade e o teste GL_LESS
+         */
+        void endQueries();
+
+        const Stats &getStats() const { return mStats; }
+
+        /**
+         * @brief Queries criadas até agora (em uso + livres no pool)
+         */
+        size_t getPoolSize() const { return mAllQueries.size(); }
+
+        // Desabilita cópia (recursos OpenGL)
+        OcclusionQueries(const OcclusionQueries &) = delete;
+        OcclusionQueries &operator=(const OcclusionQueries &) = delete;
+
+    private:
+        /**
+         * @brief Query de um item e o frame em que foi emitida
+         */
+        struct ItemQuery
+        {
+            GLuint query = 0;
+            uint64_t frame = 0; // 0 = nunca emitida desde o último reset()
+        };
+
+        std::vector<ItemQuery> mItems;    // Indexado pelo índice do item no Renderer
+        std::vector<GLuint> mFreeQueries; // Pool: queries sem item
+        std::vector<GLuint> mAllQueries;  // Todas as queries criadas (para liberar)
+        uint64_t mFrame = 0;
+        Stats mStats;
+
+        Shader mShader;
+        Uniform<glm::vec3> mBoxMin;
+        Uniform<glm::vec3> mBoxSize;
+        GLuint mVAO = 0;
+        GLuint mVBO = 0;
+        GLuint mEBO = 0;
+
+        /**
+         * @brief Query livre do pool (cria um lote novo se vazio)
+         */
+        GLuint acquireQuery();
+    };
+
+} // namespace cg
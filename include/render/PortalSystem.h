@@ -0,0 +1,162 @@
+#pragma once
+#include "render/Bounds.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cg
+{
+
+    /**
+     * @brief Células e portais definidos por convenção de nomes das meshes
+     *
+     * - `CELL_<nome>`: a AABB da mesh é o volume da célula (ex.: o interior do
+     *   memorial). Tudo fora dos volumes pertence à célula implícita "Exterior".
+     * - `PORTAL_<célulaA>-<célulaB>`: a mesh é o quad da abertura entre as duas
+     *   células; o quad usado é a face da AABB perpendicular ao eixo mais fino.
+     *
+     * Sufixos de duplicata do Blender (".001") são ignorados. Essas meshes
+     * auxiliares nunca são desenhadas. Uma mesh comum pertence apenas a uma
+     * célula se a sua AABB estiver inteiramente dentro do volume dela; senão
+     * pertence ao Exterior e a todas as células que toca (ex.: paredes).
+     *
+     * Um portal é fechado por portas: meshes opacas cuja AABB toca a do portal e
+     * cujo estado foi informado com setDoorOpen(). Com portas, ele só deixa
+     * passar a visão se alguma estiver aberta.
+     *
+     * A cada frame a travessia parte da célula da câmera e atravessa os portais
+     * abertos, reduzindo um retângulo na tela (NDC) ao retângulo de cada portal.
+     * Uma mesh é visível se alguma das suas células foi alcançada e a sua AABB
+     * projetada cruza o retângulo com que a célula foi vista.
+     */
+    class PortalSystem
+    {
+    public:
+        // Máximo de células (a pertinência de cada mesh é uma máscara de 64 bits)
+        static constexpr size_t kMaxCells = 64;
+
+        // Profundidade máxima da travessia (limita ciclos entre células)
+        static constexpr int kMaxDepth = 8;
+
+        static constexpr const char *kExteriorName = "Exterior";
+
+        /**
+         * @brief Mesh da cena vista pelo sistema (índice = índice do item no Renderer)
+         */
+        struct SceneMesh
+        {
+            std::string name;     // Pode ser vazio (mesh sem nome)
+            BoundingBox worldBox; // AABB de mundo (vazia para entradas sem mesh)
+            bool opaque = true;   // Portas transparentes (vidro) não fecham portais
+        };
+
+        /**
+         * @brief Contadores da última travessia
+         */
+        struct Stats
+        {
+            size_t cells = 0;            // Células, incluindo o Exterior
+            size_t portals = 0;
+            size_t cellsVisible = 0;     // Células alcançadas a partir da câmera
+            size_t portalsTraversed = 0; // Portais atravessados (com repetições)
+            uint32_t cameraCell = 0;
+        };
+
+        /**
+         * @brief Verdadeiro para nomes de meshes auxiliares (CELL_ e PORTAL_)
+         */
+        static bool isHelperName(const std::string &name);
+
+        /**
+         * @brief Reconstrói células, portais e a pertinência das meshes
+         */
+        void build(const std::vector<SceneMesh> &meshes);
+
+        /**
+         * @brief Há pelo menos uma célula definida além do Exterior
+         */
+        bool isActive() const { return mCells.size() > 1; }
+
+        /**
+         * @brief Informa o estado de uma porta (nome da mesh); vale também para builds futuros
+         */
+        void setDoorOpen(const std::string &doorName, bool open);
+
+        /**
+         * @brief Calcula as células visíveis e o retângulo de cada uma
+         * @param viewProjection projection * view da câmera
+         * @param cameraPosition Posição da câmera no mundo
+         */
+        void traverse(const glm::mat4 &viewProjection, const glm::vec3 &cameraPosition);
+
+        /**
+         * @brief Testa um item depois de traverse()
+         * @param item Índice da mesh em build()
+         * @param worldBox AABB de mundo atual da mesh
+         */
+        bool isVisible(uint32_t item, const BoundingBox &worldBox) const;
+
+        const Stats &getStats() const { return mStats; }
+
+        /**
+         * @brief Nome da célula (0 = Exterior)
+         */
+        const std::string &getCellName(uint32_t cell) const { return mCells[cell].name; }
+
+    private:
+        /**
+         * @brief Retângulo em NDC (vazio se min > max)
+         */
+        struct Rect
+        {
+            glm::vec2 min{1.0f};
+            glm::vec2 max{-1.0f};
+
+            bool isEmpty() const { return min.x > max.x || min.y > max.y; }
+        };
+
+        struct Cell
+        {
+            std::string name;
+            BoundingBox volume;           // Vazio para o Exterior
+            std::vector<uint32_t> portals; // Portais que tocam a célula
+        };
+
+        struct Portal
+        {
+            std::string name;
+            uint32_t cells[2] = {0, 0};
+            glm::vec3 corners[4];            // Quad no mundo
+            BoundingBox box;                 // AABB da mesh do portal
+            std::vector<std::string> doors;  // Portas que fecham o portal
+        };
+
+        std::vector<Cell> mCells;               // mCells[0] = Exterior
+        std::vector<Portal> mPortals;
+        std::vector<uint64_t> mItemCells;       // Máscara de células por item (0 = auxiliar ou sem mesh)
+        std::unordered_map<std::string, bool> mDoorStates;
+
+        glm::mat4 mViewProjection{1.0f};
+        std::vector<Rect> mCellRects;           // Retângulo em que cada célula foi vista (travessia atual)
+        Stats mStats;
+
+        uint32_t findOrAddCell(const std::string &name);
+        bool isPortalOpen(const Portal &portal) const;
+
+        /**
+         * @brief Retângulo do quad do portal na tela, já recortado pelo plano perto
+         */
+        Rect projectPortal(const Portal &portal) const;
+
+        /**
+         * @brief Retângulo da AABB na tela (tela inteira se cruzar o plano perto)
+         */
+        Rect projectBox(const BoundingBox &box) const;
+
+        void visit(uint32_t cell, const Rect &rect, uint32_t arrivalPortal, int depth, const glm::vec3 &cameraPosition);
+    };
+
+} // namespace cg
@@ -0,0 +1,167 @@
+#pragma once
+#include "render/Bounds.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cg
+{
+
+    class Model;
+
+    /**
+     * @brief Conjuntos potencialmente visíveis (PVS) pré-calculados por célula de vista
+     *
+     * O bake divide o espaço caminhável do modelo em células: colunas de
+     * cellSize x cellSize no plano XZ, uma célula por piso encontrado na coluna
+     * (triângulo voltado para cima com altura livre acima dele), cobrindo a faixa
+     * de altura dos olhos. De pontos amostrados em cada célula são lançados raios
+     * em todas as direções contra os triângulos (BVH, em várias threads); a mesh
+     * do primeiro triângulo opaco atingido, e as transparentes antes dele, entram
+     * no conjunto da célula. Meshes que tocam a célula e meshes dinâmicas
+     * (hierarquia das portas) entram sempre.
+     *
+     * O resultado é um bitset de meshes por célula, gravado em "<arquivo>.pvs"
+     * ao lado do ".meshcache" e identificado por um hash da geometria no mundo e
+     * das opções do bake. Em tempo de execução, com a câmera numa célula, só as
+     * meshes do conjunto dela precisam ser consideradas; fora das células nada
+     * é descartado.
+     *
+     * A visibilidade é amostrada: raysPerSample e dilate controlam o quanto o
+     * conjunto é conservador.
+     */
+    class PvsGrid
+    {
+    public:
+        // Versão do layout do arquivo; incrementar ao alterar o formato
+        static constexpr uint32_t kFormatVersion = 1;
+
+        // Retorno de findCell fora das células
+        static constexpr int32_t kNoCell = -1;
+
+        /**
+         * @brief Parâmetros do bake (entram no hash do arquivo)
+         */
+        struct BakeOptions
+        {
+            float cellSize = 2.0f;           // Lado das colunas no plano XZ (unidades do mundo)
+            float eyeHeightMin = 0.5f;       // Faixa de altura da câmera acima do piso coberta pela célula
+            float eyeHeightMax = 3.0f;
+            float minFloorNormalY = 0.7f;    // Componente vertical mínima da normal de um piso
+            uint32_t samplesPerCell = 4;     // Pontos de vista por célula
+            uint32_t raysPerSample = 512;    // Raios por ponto de vista
+            bool dilate = true;              // Une cada conjunto ao das células vizinhas (cobre falhas da amostragem)
+            unsigned threadCount = 0;        // 0 = todos os núcleos
+        };
+
+        /**
+         * @brief Papel de uma mesh no bake
+         */
+        enum class MeshRole : uint8_t
+        {
+            Occluder,    // Opaca: bloqueia os raios
+            Transparent, // Deixa os raios passarem; visível se algum raio a atravessa
+            Dynamic,     // Pode se mover (ex.: portas): não bloqueia e é sempre visível
+            Ignored      // Não desenhada (células e portais auxiliares)
+        };
+
+        /**
+         * @brief Triângulos do modelo no espaço do mundo
+         */
+        struct Geometry
+        {
+            std::vector<glm::vec3> positions;
+            std::vector<uint32_t> indices;        // 3 por triângulo
+            std::vector<uint32_t> triangleMeshes; // Mesh (índice em Model::getMeshes()) de cada triângulo
+            std::vector<BoundingBox> meshBoxes;   // AABB de mundo por mesh (vazia sem geometria)
+            std::vector<MeshRole> roles;          // Papel por mesh
+        };
+
+        /**
+         * @brief Estatísticas do último bake ou carregamento
+         */
+        struct Stats
+        {
+            size_t cells = 0;
+            size_t meshes = 0;
+            size_t rays = 0;               // Raios lançados no bake (0 se carregado do arquivo)
+            float averageVisible = 0.0f;   // Média de meshes por conjunto
+            float bakeTimeMs = 0.0f;
+        };
+
+        /**
+         * @brief Caminho do arquivo de PVS correspondente a um arquivo OBJ
+         */
+        static std::string cachePathFor(const std::string &objPath);
+
+        /**
+         * @brief Copia os triângulos do modelo (LOD 0, geometria na CPU) para o espaço do mundo
+         *
+         * Atualiza as matrizes de mundo do modelo. Meshes sem geometria na CPU
+         * são tratadas como dinâmicas (sempre visíveis).
+         */
+        static Geometry gather(const Model &model);
+
+        /**
+         * @brief Hash da geometria e das opções que identifica um arquivo de PVS
+         */
+        static uint64_t signature(const Geometry &geometry, const BakeOptions &options);
+
+        /**
+         * @brief Voxeliza o espaço caminhável e calcula o conjunto de cada célula
+         * @return false se nenhuma célula caminhável foi encontrada
+         */
+        bool bake(const Geometry &geometry, const BakeOptions &options);
+
+        /**
+         * @brief Carrega o arquivo se ele existir e tiver a assinatura esperada
+         */
+        bool load(const std::string &path, uint64_t expectedSignature);
+
+        /**
+         * @brief Grava os conjuntos com a assinatura informada
+         */
+        bool write(const std::string &path, uint64_t signature) const;
+
+        bool empty() const { return mCellBoxes.empty(); }
+
+        /**
+         * @brief Célula que contém a posição, ou kNoCell
+         */
+        int32_t findCell(const glm::vec3 &position) const;
+
+        /**
+         * @brief A mesh pertence ao conjunto da célula
+         */
+        bool isVisible(int32_t cell, uint32_t mesh) const
+        {
+            return (mBits[static_cast<size_t>(cell) * mWordsPerCell + mesh / 64] >> (mesh % 64)) & 1;
+        }
+
+        size_t getCellCount() const { return mCellBoxes.size(); }
+        size_t getMeshCount() const { return mMeshCount; }
+        const BoundingBox &getCellBox(int32_t cell) const { return mCellBoxes[cell]; }
+        const Stats &getStats() const { return mStats; }
+
+    private:
+        // =================== GRADE DE COLUNAS ===================
+        glm::vec2 mOrigin{0.0f};           // Canto mínimo (x, z) da grade
+        float mCellSize = 1.0f;
+        uint32_t mColumnsX = 0;
+        uint32_t mColumnsZ = 0;
+        std::vector<uint32_t> mColumnFirst; // Primeira célula de cada coluna (+1 entrada final)
+        std::vector<BoundingBox> mCellBoxes; // Volume de cada célula, agrupadas por coluna
+
+        // =================== CONJUNTOS ===================
+        size_t mMeshCount = 0;
+        size_t mWordsPerCell = 0;
+        std::vector<uint64_t> mBits; // mWordsPerCell palavras por célula
+
+        Stats mStats;
+
+        void computeAverage();
+    };
+
+} // namespace cg
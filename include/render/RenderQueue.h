@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cg
+{
+
+    /**
+     * @brief Fila de desenho ordenada por chave de 64 bits
+     *
+     * Cada draw visível entra como um pacote (chave, item). A chave codifica,
+     * do bit mais significativo para o menos, o estado que mais custa trocar,
+     * de modo que a ordenação agrupa draws com o mesmo estado:
+     *
+     *   opaco:        [passe:2][shader:8][material:16][VAO:16][profundidade:22]
+     *   transparente: [passe:2][profundidade invertida:22][shader:8][material:16][VAO:16]
+     *
+     * Opacos são desenhados de frente para trás dentro de cada grupo de estado;
+     * transparentes, de trás para frente (a ordem de composição vem antes do estado).
+     * A ordenação é um radix sort LSD de 8 bits por passada, que pula os bytes
+     * iguais em todas as chaves.
+     */
+    class RenderQueue
+    {
+    public:
+        /**
+         * @brief Passe de renderização (bits mais significativos da chave)
+         */
+        enum class Pass : uint64_t
+        {
+            Opaque = 0,
+            Transparent = 1
+        };
+
+        /**
+         * @brief Um draw: chave de ordenação e índice do item no chamador
+         */
+        struct Packet
+        {
+            uint64_t key = 0;
+            uint32_t item = 0;
+        };
+
+        /**
+         * @brief Monta a chave de um draw opaco
+         * @param shader Índice pequeno do programa (8 bits)
+         * @param material Identificador do material (16 bits; colisões só afetam o agrupamento)
+         * @param vertexArray Identificador do VAO (16 bits)
+         * @param viewDistance Distância até a câmera (>= 0)
+         */
+        static uint64_t makeOpaqueKey(uint32_t shader, uint32_t material, uint32_t vertexArray, float viewDistance);
+
+        /**
+         * @brief Monta a chave de um draw transparente (ordem de trás para frente)
+         */
+        static uint64_t makeTransparentKey(uint32_t shader, uint32_t material, uint32_t vertexArray, float viewDistance);
+
+        /**
+         * @brief Passe codificado numa chave
+         */
+        static Pass passOf(uint64_t key) { return static_cast<Pass>(key >> 62); }
+
+        /**
+         * @brief Esvazia a fila (mantém a memória para o próximo frame)
+         */
+        void clear() { mPackets.clear(); }
+
+        /**
+         * @brief Reserva espaço para count pacotes
+         */
+        void reserve(size_t count) { mPackets.reserve(count); }
+
+        /**
+         * @brief Adiciona um draw
+         */
+        void push(uint64_t key, uint32_t item) { mPackets.push_back({key, item}); }
+
+        /**
+         * @brief Ordena os pacotes por chave (estável)
+         */
+        void sort();
+
+        const std::vector<Packet> &getPackets() const { return mPackets; }
+        size_t size() const { return mPackets.size(); }
+        bool empty() const { return mPackets.empty(); }
+
+    private:
+        std::vector<Packet> mPackets;
+        std::vector<Packet> mScratch; // Buffer auxiliar do radix sort
+    };
+
+} // namespace cg
@@ -1,10 +1,26 @@
 #pragma once
 #include "render/Model.h"
+#include "render/Bvh.h"
+#include "render/FrameUniforms.h"
+#include "render/FrustumCuller.h"
+#include "render/InstancedModel.h"
+#include "render/ModelStreamer.h"
+#include "render/ObjectUniforms.h"
+#include "render/OcclusionCuller.h"
+#include "render/OcclusionQueries.h"
+#include "render/PortalSystem.h"
+#include "render/PvsGrid.h"
+#include "render/RenderQueue.h"
 #include "render/Shader.h"
 #include "render/Skybox.h"
+#include "render/StaticBatch.h"
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <future>
+#include <algorithm>
 
 namespace cg
 {
@@ -28,8 +44,24 @@ namespace cg
             bool enableBackfaceCulling = true;            // Ativa descarte de faces traseiras
             bool enableDepthTest = true;                  // Ativa teste de profundidade
             glm::vec4 clearColor{0.5f, 0.8f, 1.0f, 1.0f}; // Cor de fundo (azul céu para teste)
+            bool enableFrustumCulling = true;             // Descarta meshes fora do volume de visão
+            bool enableBvhCulling = true;                 // Culling hierárquico pela BVH (false = teste em lote de todas as caixas)
+            bool enablePvsCulling = true;                 // Restringe as meshes ao PVS da célula da câmera (modelos com loadPvsAsync)
+            bool enablePortalCulling = true;              // Células e portais (meshes CELL_*/PORTAL_*) limitam o que é visível
+            bool enableOcclusionCulling = true;           // Descarta meshes escondidas pelas maiores meshes opacas (rasterização na CPU)
+            size_t occluderTriangleBudget = 20000;        // Triângulos de oclusores rasterizados por frame
+            bool enableOcclusionQueries = false;          // Draws condicionados a occlusion queries do frame anterior (GPU)
+            bool enableLod = true;                        // Seleciona o nível de detalhe de cada mesh por distância
+            float lodPixelError = 1.0f;                   // Erro máximo aceito na tela, em pixels
+            bool enableStaticBatching = true;             // Agrupa as meshes de modelos estáticos (Model::setStatic)
+            glm::vec3 lightPosition{10.0f, 10.0f, 10.0f}; // Posição da luz pontual (espaço do mundo)
+            glm::vec3 lightColor{1.0f, 1.0f, 1.0f};       // Cor da luz
         };
 
+        // Faixa de histerese da seleção de LOD: um nível mais simples só é adotado quando
+        // seu erro projetado fica abaixo de (1 - kLodHysteresis) * lodPixelError
+        static constexpr float kLodHysteresis = 0.25f;
+
         /**
          * @brief Construtor padrão
          */
@@ -53,6 +85,43 @@ namespace cg
          */
         void addModel(std::unique_ptr<Model> model, const std::string &id = "");
 
+        /**
+         * @brief Carrega um modelo em background e o adiciona à cena quando estiver na GPU
+         *
+         * O parsing roda em outra thread; as meshes são enviadas à GPU aos poucos
+         * durante render(), respeitando o orçamento de upload por frame. O modelo
+         * só aparece na cena quando todas as meshes estiverem carregadas.
+         * @param filePath Caminho para o arquivo .obj
+         * @param id Identificador do modelo na cena
+         * @param modelName Nome do modelo (se vazio, usa o nome do arquivo)
+         * @param options Opções do ModelLoader
+         * @param onReady Chamado com o modelo pronto, antes de entrar na cena (ex.: configurar hierarquia)
+         * @param onFailed Chamado se o arquivo não puder ser carregado
+         * @return Handle para acompanhar o progresso
+         */
+        std::shared_ptr<const ModelStreamer::Handle> loadModelAsync(const std::string &filePath,
+                                                                    const std::string &id,
+                                                                    const std::string &modelName = "",
+                                                                    const ModelLoader::LoadOptions &options = {},
+                                                                    std::function<void(Model &)> onReady = nullptr,
+                                                                    std::function<void()> onFailed = nullptr);
+
+        /**
+         * @brief Define quantos bytes de geometria podem ser enviados à GPU por frame
+         * @param bytesPerFrame Orçamento em bytes (0 = sem limite)
+         */
+        void setUploadBudget(size_t bytesPerFrame) { mStreamer.setUploadBudget(bytesPerFrame); }
+
+        /**
+         * @brief Verifica se ainda há modelos sendo carregados em background
+         */
+        bool hasPendingLoads() const { return mStreamer.hasPendingLoads(); }
+
+        /**
+         * @brief Estatísticas de upload do último frame
+         */
+        const ModelStreamer::FrameStats &getStreamingStats() const { return mStreamer.getFrameStats(); }
+
         /**
          * @brief Remove um modelo da cena
          * @param id Identificador do modelo a ser removido
@@ -67,6 +136,28 @@ namespace cg
          */
         Model *getModel(const std::string &id);
 
+        // =================== MODELOS INSTANCIADOS ===================
+
+        /**
+         * @brief Adiciona um modelo instanciado (uma mesh repetida em várias posições)
+         *
+         * As instâncias podem ser adicionadas antes ou depois; cada modelo vira um
+         * único draw por frame com as instâncias visíveis. Desenhado no passe
+         * opaco com o shader básico (a cor da instância multiplica a do material).
+         * @return Ponteiro para o modelo (pertence ao Renderer)
+         */
+        InstancedModel *addInstancedModel(std::unique_ptr<InstancedModel> model, const std::string &id = "");
+
+        /**
+         * @brief Remove um modelo instanciado
+         */
+        bool removeInstancedModel(const std::string &id);
+
+        /**
+         * @brief Obtém um modelo instanciado pelo ID (nullptr se não existe)
+         */
+        InstancedModel *getInstancedModel(const std::string &id);
+
         /**
          * @brief Renderiza todos os modelos na cena
          * @param viewMatrix Matriz de visualização da câmera
@@ -112,6 +203,111 @@ namespace cg
          */
         const RenderSettings &getRenderSettings() const { return mSettings; }
 
+        /**
+         * @brief Informa a altura do viewport (usada para projetar o erro dos LODs em pixels)
+         */
+        void setViewportHeight(int height) { mViewportHeight = static_cast<float>(std::max(1, height)); }
+
+        /**
+         * @brief Estatísticas do último frame renderizado
+         */
+        struct FrameStats
+        {
+            size_t meshesTested = 0;    // Meshes testadas contra o frustum
+            size_t meshesSubmitted = 0; // Meshes enviadas para desenho
+            size_t meshesCulled = 0;    // Meshes descartadas pelo frustum
+            size_t meshesPvsCulled = 0;    // Meshes no frustum fora do PVS da célula da câmera
+            size_t meshesPortalCulled = 0; // Meshes no frustum em células não vistas pelos portais
+            size_t cellsVisible = 0;       // Células alcançadas a partir da célula da câmera
+            size_t meshesOccluded = 0;  // Meshes no frustum escondidas pelos oclusores
+            size_t occluders = 0;       // Meshes rasterizadas como oclusoras
+            size_t bvhNodesVisited = 0; // Nós da BVH testados (0 sem culling hierárquico)
+            size_t bvhNodesRefit = 0;   // Nós da BVH recalculados por mudanças de transformação
+            size_t triangles = 0;       // Triângulos enviados (após a seleção de LOD)
+            size_t drawCalls = 0;          // Draws emitidos pela fila (um por grupo do lote estático)
+            size_t batchedMeshes = 0;      // Meshes visíveis desenhadas pelo lote estático
+            size_t instancesDrawn = 0;     // Instâncias visíveis de modelos instanciados
+            size_t instancesCulled = 0;    // Instâncias descartadas pelo frustum
+            size_t programChanges = 0;     // glUseProgram
+            size_t vertexArrayChanges = 0; // glBindVertexArray
+            size_t uniformUploads = 0;     // glUniform* emitidos no frame (todos os shaders)
+            size_t uniformsSkipped = 0;    // Envios ignorados por repetir o valor atual do uniform
+            float cullTimeMs = 0.0f;    // Tempo do estágio de culling (atualização da cena + teste)
+            float occlusionTimeMs = 0.0f; // Parte de cullTimeMs gasta com oclusores e testes de oclusão
+            size_t occlusionQueries = 0;  // Caixas testadas na GPU entre os passes opaco e transparente
+            size_t conditionalDraws = 0;  // Draws condicionados ao resultado da query do frame anterior
+            size_t conditionalSkips = 0;  // Desses, os descartados pela GPU (resultado já disponível)
+        };
+
+        const FrameStats &getFrameStats() const { return mFrameStats; }
+
+        // =================== CÉLULAS E PORTAIS ===================
+
+        /**
+         * @brief Informa se uma porta está aberta
+         *
+         * Uma mesh opaca com esse nome que toca um portal (PORTAL_*) fecha o
+         * portal enquanto estiver fechada. O estado vale para modelos
+         * carregados depois.
+         * @param doorMeshName Nome da mesh da porta
+         * @param open true se a porta deixa passar a visão
+         */
+        void setDoorOpen(const std::string &doorMeshName, bool open);
+
+        const PortalSystem &getPortalSystem() const { return mPortals; }
+
+        // =================== PVS PRÉ-CALCULADO ===================
+
+        /**
+         * @brief Carrega o PVS do modelo de "<objPath>.pvs" ou o calcula em background e grava
+         *
+         * Os triângulos são copiados agora, com as matrizes de mundo atuais:
+         * chamar com o modelo pronto e já posicionado (ex.: no onReady de
+         * loadModelAsync). O conjunto passa a valer quando o cálculo termina e
+         * apenas enquanto o modelo for estático (Model::setStatic).
+         * @param modelId ID do modelo na cena
+         * @param model Modelo com geometria na CPU (CpuResidency Keep ou KeepPositionsOnly)
+         * @param objPath Arquivo de origem do modelo (o PVS fica ao lado do ".meshcache")
+         * @param options Parâmetros do bake
+         */
+        void loadPvsAsync(const std::string &modelId, const Model &model, const std::string &objPath,
+                          const PvsGrid::BakeOptions &options = PvsGrid::BakeOptions{});
+
+        /**
+         * @brief PVS em uso por um modelo, ou nullptr
+         */
+        const PvsGrid *getPvs(const std::string &modelId) const;
+
+        // =================== CONSULTAS ESPACIAIS ===================
+
+        /**
+         * @brief Mesh da cena encontrada por uma consulta espacial
+         */
+        struct SceneHit
+        {
+            Model *model = nullptr;
+            Mesh *mesh = nullptr;
+            float distance = 0.0f; // Distância de entrada na AABB de mundo (consultas por raio)
+        };
+
+        /**
+         * @brief Meshes cuja AABB de mundo é atravessada pelo raio, da mais próxima à mais distante
+         *
+         * Usa a BVH da cena (atualizada antes da consulta). O teste é contra as
+         * caixas, não contra os triângulos.
+         */
+        std::vector<SceneHit> raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance);
+
+        /**
+         * @brief Meshes cuja AABB de mundo intersecta a caixa (no espaço do mundo)
+         */
+        std::vector<SceneHit> queryBox(const BoundingBox &box);
+
+        /**
+         * @brief Triângulos desenhados no último frame (após a seleção de LOD)
+         */
+        size_t getFrameTriangleCount() const { return mFrameStats.triangles; }
+
         /**
          * @brief Obtém estatísticas de renderização
          */
@@ -121,6 +317,32 @@ namespace cg
             size_t totalMeshes = 0;    // Número total de meshes renderizadas
             size_t totalTriangles = 0; // Número total de triângulos renderizados
             size_t totalVertices = 0;  // Número total de vértices renderizados
+            size_t gpuMemoryBytes = 0; // Bytes de VBO/EBO ocupados na GPU
+            size_t cpuMemoryBytes = 0; // Bytes de geometria mantidos na CPU (CpuResidency)
+            size_t meshesSubmitted = 0; // Meshes desenhadas no último frame
+            size_t meshesCulled = 0;    // Meshes descartadas pelo frustum no último frame
+            size_t meshesPvsCulled = 0;    // Meshes fora do PVS da célula da câmera no último frame
+            size_t pvsCells = 0;           // Células de vista dos PVS carregados
+            size_t meshesPortalCulled = 0; // Meshes descartadas pelos portais no último frame
+            size_t cells = 0;              // Células da cena (incluindo o Exterior)
+            size_t portals = 0;            // Portais entre células
+            size_t cellsVisible = 0;       // Células visíveis no último frame
+            size_t meshesOccluded = 0;  // Meshes escondidas por oclusores no último frame
+            size_t occlusionQueries = 0; // Occlusion queries emitidas no último frame
+            size_t conditionalSkips = 0; // Draws descartados pela GPU por renderização condicional no último frame
+            size_t occlusionQueryPool = 0; // Queries criadas (reaproveitadas entre frames)
+            size_t bvhNodes = 0;        // Nós da BVH da cena
+            size_t staticBatchGroups = 0; // Grupos (layout + material + tipo de índice) do lote estático
+            size_t staticBatchBytes = 0;  // VBO/EBO do lote estático (incluído em gpuMemoryBytes)
+            size_t batchedMeshes = 0;     // Meshes desenhadas pelo lote estático no último frame
+            size_t instancedModels = 0;   // Modelos instanciados na cena
+            size_t instancesDrawn = 0;    // Instâncias desenhadas no último frame
+            size_t instancesCulled = 0;   // Instâncias descartadas no último frame
+            size_t drawCalls = 0;          // Draws no último frame
+            size_t programChanges = 0;     // Trocas de programa no último frame
+            size_t vertexArrayChanges = 0; // Trocas de VAO no último frame
+            size_t uniformUploads = 0;     // Uniforms enviados no último frame
+            size_t uniformsSkipped = 0;    // Envios de uniform ignorados (valor repetido) no último frame
         };
 
         /**
@@ -139,17 +361,129 @@ namespace cg
         std::vector<std::string> mModelOrder;                            // Ordem de renderização dos modelos
         size_t mNextAutoId = 0;                                          // Contador para IDs automáticos
 
+        std::unordered_map<std::string, std::unique_ptr<InstancedModel>> mInstancedModels; // Modelos instanciados por ID
+        std::vector<std::string> mInstancedOrder;                                          // Ordem de inserção
+
+        // =================== CARREGAMENTO EM BACKGROUND ===================
+        ModelStreamer mStreamer; // Parsing assíncrono + upload limitado por frame
+
         // =================== SKYBOX ===================
         Skybox mSkybox;
         bool mSkyboxEnabled = true;
 
         // =================== SHADERS ===================
-        Shader mBasicShader;       // Shader básico para geometria sólida
-        Shader mTransparentShader; // Shader para materiais transparentes
+        /**
+         * @brief Shaders da cena compilados para um layout de vértice
+         */
+        struct SceneShaders
+        {
+            Shader basic;                    // Shader básico para geometria sólida
+            Shader transparent;              // Shader para materiais transparentes
+            Shader instanced;                // Shader básico com matriz e cor por instância
+            uint32_t sortIndex = 0;          // Índice de basic/transparent na chave da RenderQueue
+            uint32_t instancedSortIndex = 0; // Índice de instanced na chave da RenderQueue
+        };
+
+        // Uma variante por VertexLayoutInfo::id (nullptr se a compilação falhou)
+        std::unordered_map<uint32_t, std::unique_ptr<SceneShaders>> mSceneShaders;
+        uint32_t mNextShaderSortIndex = 0; // Próximo SceneShaders::sortIndex
+
+        // Câmera e luz do frame (ponto de ligação FrameUniforms::kBindingPoint)
+        FrameUniforms mFrameUniforms;
+
+        // Matrizes e material de cada mesh visível, um slot por draw
+        ObjectUniforms mObjectUniforms;
 
         // =================== CONFIGURAÇÕES ===================
         RenderSettings mSettings;
 
+        // =================== ESTADO DO FRAME ===================
+        float mViewportHeight = 720.0f;     // Altura do viewport em pixels
+        glm::vec3 mCameraPosition{0.0f};    // Posição da câmera no frame atual
+        float mLodPixelScale = 0.0f;        // Pixels por unidade de mundo a uma unidade de distância
+        FrameStats mFrameStats;             // Contadores do frame atual
+        uint64_t mFrameIndex = 0;           // Incrementado a cada render()
+
+        // =================== CULLING ===================
+        /**
+         * @brief Mesh da cena com a matriz e a AABB de mundo em cache
+         */
+        struct DrawItem
+        {
+            Model *model = nullptr;
+            Mesh *mesh = nullptr;
+            glm::mat4 modelMatrix{1.0f};
+            glm::mat3 normalMatrix{1.0f};
+            BoundingBox worldBox;
+            SceneShaders *shaders = nullptr; // Programas do layout da mesh (preenchido na fila)
+            int32_t batchEntry = -1;         // Entrada no lote estático (-1 = desenhada individualmente)
+        };
+
+        /**
+         * @brief Faixa de mDrawItems ocupada por um modelo
+         */
+        struct SceneModel
+        {
+            Model *model = nullptr;
+            uint64_t worldVersion = 0;     // Model::getWorldVersion() quando as matrizes foram copiadas
+            bool isStatic = false;         // Model::isStatic() quando o lote foi montado
+            uint32_t firstItem = 0;
+            uint32_t itemCount = 0;
+            const PvsGrid *pvs = nullptr;  // PVS do modelo (índices = meshes de getMeshes())
+        };
+
+        std::vector<SceneModel> mSceneModels;  // Modelos na ordem de mModelOrder
+        std::vector<DrawItem> mDrawItems;      // Todas as meshes da cena, na ordem de desenho
+        bool mSceneDirty = true;               // Modelos adicionados/removidos: reconstruir tudo
+        Bvh mBvh;                              // BVH sobre as AABBs de mDrawItems (mesmos índices)
+        FrustumCuller mCuller;                 // As mesmas AABBs em SoA, para o teste em lote
+        std::vector<uint32_t> mVisibleItems;   // Índices em mDrawItems que passaram no culling
+        OcclusionCuller mOcclusionCuller;      // Buffer de profundidade dos oclusores, na CPU
+        OcclusionQueries mOcclusionQueries;    // Queries por item de mDrawItems (mesmos índices)
+        PortalSystem mPortals;                 // Células e portais da cena (mesmos índices de mDrawItems)
+        bool mPortalsDirty = true;             // Refazer células/portais (cena ou transformações mudaram)
+
+        /**
+         * @brief PVS sendo carregado ou calculado em background
+         */
+        struct PendingPvs
+        {
+            std::string modelId;
+            const Model *model = nullptr; // Modelo do bake (nullptr: removido, o resultado é descartado)
+            std::future<std::shared_ptr<const PvsGrid>> future;
+        };
+        std::unordered_map<std::string, std::shared_ptr<const PvsGrid>> mPvs; // PVS prontos por ID de modelo
+        std::vector<PendingPvs> mPendingPvs;
+        std::vector<int32_t> mPvsCells;        // Célula da câmera em cada SceneModel (frame atual)
+
+        /**
+         * @brief Mesh visível candidata a oclusora, com a área aparente da sua AABB
+         */
+        struct OccluderCandidate
+        {
+            float score = 0.0f;
+            uint32_t item = 0;
+        };
+        std::vector<OccluderCandidate> mOccluderCandidates;
+        RenderQueue mRenderQueue;              // Draws visíveis ordenados por estado
+
+        // =================== LOTE ESTÁTICO ===================
+        StaticBatch mStaticBatch;       // Meshes opacas de modelos estáticos em buffers compartilhados
+        bool mStaticBatchDirty = false; // Remontar o lote na próxima updateScene()
+        std::unordered_set<const Model *> mMovedStaticModels; // Modelos estáticos que se moveram depois de entrar no lote
+        uint32_t mFirstBatchSlot = 0;   // Primeiro slot de mObjectUniforms usado pelos grupos do lote
+
+        /**
+         * @brief Modelo instanciado com instâncias visíveis no frame (slot mFirstInstancedSlot + índice)
+         */
+        struct InstancedDraw
+        {
+            InstancedModel *model = nullptr;
+            SceneShaders *shaders = nullptr;
+        };
+        std::vector<InstancedDraw> mInstancedDraws;
+        uint32_t mFirstInstancedSlot = 0; // Primeiro slot de mObjectUniforms usado pelos modelos instanciados
+
         /**
          * @brief Gera um ID automático único para um modelo
          */
@@ -166,20 +500,111 @@ namespace cg
         void clearBuffers();
 
         /**
-         * @brief Renderiza um modelo específico (objetos opacos)
-         * @param model Modelo a ser renderizado
-         * @param viewMatrix Matriz de visualização
-         * @param projectionMatrix Matriz de projeção
+         * @brief Obtém (compilando na primeira vez) os shaders da cena para um layout de vértice
+         * @return Shaders do layout ou nullptr se a compilação falhou
          */
-        void renderModelOpaque(const Model &model, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix);
+        SceneShaders *getSceneShaders(const VertexLayoutInfo &layout);
 
         /**
-         * @brief Renderiza um modelo específico (objetos transparentes)
-         * @param model Modelo a ser renderizado
-         * @param viewMatrix Matriz de visualização
-         * @param projectionMatrix Matriz de projeção
+         * @brief Escolhe o LOD da mesh pelo erro projetado na tela, com histerese
+         * @param mesh Mesh com pelo menos um LOD além do original
+         * @param modelMatrix Matriz de mundo da mesh
+         * @return Índice do nível a ser desenhado
+         */
+        size_t selectLod(const Mesh &mesh, const glm::mat4 &modelMatrix) const;
+
+        /**
+         * @brief Sincroniza mDrawItems, a BVH e o culler com os modelos da cena
+         *
+         * Reconstrói tudo quando modelos entram ou saem; caso contrário recalcula
+         * apenas as meshes dos modelos cuja transformação mudou e faz o refit da
+         * BVH (reconstruindo-a se os refits a degradaram).
+         */
+        void updateScene();
+
+        /**
+         * @brief Remonta o lote estático com as meshes elegíveis de mDrawItems
+         */
+        void rebuildStaticBatch();
+
+        /**
+         * @brief Descarta as meshes que estão fora do frustum
+         *
+         * O resultado (mVisibleItems, em ordem de desenho) é consumido pelos passes
+         * opaco e transparente.
+         */
+        void cullScene(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix);
+
+        /**
+         * @brief Instala os PVS cujo cálculo terminou (a cena é reconstruída para usá-los)
+         */
+        void pollPendingPvs();
+
+        /**
+         * @brief Marca os cálculos de PVS em andamento de um modelo para descarte
+         */
+        void discardPendingPvs(const std::string &modelId);
+
+        /**
+         * @brief Remove de mVisibleItems as meshes fora do PVS da célula da câmera
+         *
+         * Só os modelos estáticos com PVS e com a câmera dentro de uma das células
+         * são filtrados; um teste de bit por mesh.
+         */
+        void cullPvs();
+
+        /**
+         * @brief Refaz células, portais e a pertinência das meshes com as AABBs atuais
+         *
+         * As meshes auxiliares (CELL_*, PORTAL_*) não têm item desenhável, então
+         * as caixas são recalculadas a partir dos modelos.
+         */
+        void rebuildPortals();
+
+        /**
+         * @brief Remove de mVisibleItems as meshes em células não vistas pelos portais
+         */
+        void cullPortals(const glm::mat4 &viewProjection);
+
+        /**
+         * @brief Remove de mVisibleItems as meshes escondidas por oclusores
+         *
+         * As meshes opacas visíveis com geometria na CPU (CpuResidency Keep ou
+         * KeepPositionsOnly) são ordenadas pela área aparente da AABB e as
+         * maiores, até occluderTriangleBudget triângulos, são rasterizadas no
+         * OcclusionCuller; depois cada AABB visível é testada contra ele.
+         */
+        void cullOccluded(const glm::mat4 &viewProjection);
+
+        /**
+         * @brief Monta e ordena a RenderQueue com as meshes visíveis (mVisibleItems)
+         *
+         * Na mesma passada escreve matrizes e material de cada mesh no seu slot de
+         * mObjectUniforms (slot = posição em mVisibleItems = Packet::item).
+         */
+        void buildRenderQueue();
+
+        /**
+         * @brief Desenha a fila na ordem das chaves, trocando apenas o estado que muda
+         *
+         * Programa e VAO só são trocados quando diferem do pacote anterior. Nenhum
+         * uniform é enviado por draw: matrizes e material já foram escritos no slot
+         * do objeto em mObjectUniforms, e cada draw só liga o bloco ObjectUniforms a
+         * esse slot (glBindBufferRange). O blending é ativado ao entrar no passe
+         * transparente; câmera e luz já estão em mFrameUniforms. Ao final, endFrame
+         * coloca a fence da região do ring usada neste frame, que só é reescrita
+         * quando a GPU terminar estes draws.
+         */
+        void submitRenderQueue();
+
+        /**
+         * @brief Emite uma occlusion query por mesh visível desenhada individualmente
+         *
+         * Chamado por submitRenderQueue entre os passes opaco e transparente; os
+         * resultados condicionam os draws das mesmas meshes no próximo frame.
+         * Meshes do lote estático e modelos instanciados não são consultados.
          */
-        void renderModelTransparent(const Model &model, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix);
+        void issueOcclusionQueries();
     };
 
 } // namespace cg
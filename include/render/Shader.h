@@ -1,30 +1,176 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <glm/glm.hpp>
 
 namespace cg
 {
 
+    /**
+     * @brief Hash FNV-1a de 32 bits de um nome de uniform
+     *
+     * constexpr para que nomes literais sejam hasheados na compilação.
+     */
+    constexpr uint32_t hashUniformName(std::string_view name)
+    {
+        uint32_t hash = 2166136261u;
+        for (char c : name)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Nome de uniform com o hash já calculado
+     *
+     * Conversão implícita a partir de literais: setMat4("uModel", ...) calcula o
+     * hash em tempo de compilação e a busca na tabela não percorre a string.
+     */
+    struct UniformName
+    {
+        constexpr UniformName(const char *text) : name(text), hash(hashUniformName(name)) {}
+        constexpr UniformName(std::string_view text) : name(text), hash(hashUniformName(text)) {}
+
+        std::string_view name;
+        uint32_t hash;
+    };
+
+    /**
+     * @brief Handle tipado para um uniform de um Shader específico
+     *
+     * Obtido uma vez com Shader::getUniform<T>() após a compilação; inválido se o
+     * uniform não existe (ou foi removido pelo compilador) ou se o tipo não confere.
+     */
+    template <typename T>
+    struct Uniform
+    {
+        int32_t slot = -1; // Índice na tabela de uniforms do Shader
+        bool isValid() const { return slot >= 0; }
+    };
+
     class Shader
     {
     public:
         Shader() = default;
         ~Shader();
 
+        /**
+         * @brief Compila e linka o programa; em seguida lê os uniforms ativos (glGetActiveUniform)
+         */
         bool compile(const char *vsSrc, const char *fsSrc);
+
+        /**
+         * @brief Compila um programa só com vertex shader, com as saídas capturadas por transform feedback
+         * @param varyings Saídas gravadas intercaladas no buffer (GL_INTERLEAVED_ATTRIBS), nesta ordem
+         */
+        bool compileFeedback(const char *vsSrc, const char *const *varyings, int varyingCount);
         void bind() const;
         static void unbind();
 
         // =================== MÉTODOS PARA DEFINIR UNIFORMS ===================
-        void setMat4(const char *name, const glm::mat4 &m) const;
-        void setMat3(const char *name, const glm::mat3 &m) const;
-        void setVec3(const char *name, const glm::vec3 &v) const;
-        void setVec4(const char *name, const glm::vec4 &v) const;
-        void setFloat(const char *name, float value) const;
-        void setInt(const char *name, int value) const;
+        // Os setters por nome consultam a tabela refletida após o link (sem
+        // glGetUniformLocation) e ignoram envios com o mesmo valor já definido.
+        void setMat4(UniformName name, const glm::mat4 &m) const;
+        void setMat3(UniformName name, const glm::mat3 &m) const;
+        void setVec3(UniformName name, const glm::vec3 &v) const;
+        void setVec4(UniformName name, const glm::vec4 &v) const;
+        void setFloat(UniformName name, float value) const;
+        void setInt(UniformName name, int value) const;
+
+        // =================== HANDLES TIPADOS ===================
+
+        /**
+         * @brief Resolve um uniform uma vez (T: mat4, mat3, vec3, vec4, float ou int)
+         * @return Handle inválido se o uniform não está ativo ou tem outro tipo no GLSL
+         */
+        template <typename T>
+        Uniform<T> getUniform(UniformName name) const;
+
+        void set(Uniform<glm::mat4> uniform, const glm::mat4 &m) const;
+        void set(Uniform<glm::mat3> uniform, const glm::mat3 &m) const;
+        void set(Uniform<glm::vec3> uniform, const glm::vec3 &v) const;
+        void set(Uniform<glm::vec4> uniform, const glm::vec4 &v) const;
+        void set(Uniform<float> uniform, float value) const;
+        void set(Uniform<int> uniform, int value) const;
+
+        /**
+         * @brief Verifica se o programa tem um uniform ativo com esse nome
+         */
+        bool hasUniform(UniformName name) const { return findSlot(name) >= 0; }
+
+        /**
+         * @brief Associa um uniform block do programa a um ponto de ligação (glUniformBlockBinding)
+         * @return false se o programa não usa o bloco
+         */
+        bool bindUniformBlock(const char *blockName, unsigned int bindingPoint) const;
+
+        // =================== ESTATÍSTICAS ===================
+
+        /**
+         * @brief Contadores de glUniform* de todos os shaders (contexto OpenGL único)
+         */
+        struct UploadStats
+        {
+            size_t uploads = 0; // glUniform* emitidos
+            size_t skipped = 0; // Envios ignorados por repetir o último valor
+        };
+
+        static const UploadStats &getUploadStats() { return sUploadStats; }
+        static void resetUploadStats() { sUploadStats = UploadStats{}; }
+
+        // Desabilita cópia (o programa OpenGL seria liberado duas vezes)
+        Shader(const Shader &) = delete;
+        Shader &operator=(const Shader &) = delete;
 
     private:
+        /**
+         * @brief Uniform ativo refletido após o link
+         */
+        struct UniformSlot
+        {
+            std::string name;          // Nome sem o sufixo "[0]" de arrays
+            uint32_t hash = 0;         // hashUniformName(name)
+            int32_t location = -1;     // Localização no programa
+            uint32_t type = 0;         // Tipo GLSL (GL_FLOAT_MAT4, GL_FLOAT_VEC3, ...)
+            uint32_t shadowOffset = 0; // Início do último valor enviado em mShadow
+            uint32_t shadowSize = 0;   // Bytes do valor
+            mutable bool hasValue = false;
+        };
+
         unsigned int mProgram = 0;
+        std::vector<UniformSlot> mUniforms;  // Poucos uniforms: busca linear pelo hash
+        mutable std::vector<uint8_t> mShadow; // Último valor enviado por uniform
+
+        static UploadStats sUploadStats;
+
+        /**
+         * @brief Preenche mUniforms com os uniforms ativos do programa linkado
+         */
+        void reflectUniforms();
+
+        /**
+         * @brief Índice do uniform na tabela ou -1
+         */
+        int32_t findSlot(UniformName name) const;
+
+        /**
+         * @brief Compara com o último valor enviado e o atualiza
+         * @return true se o valor mudou (e precisa ser enviado)
+         */
+        bool updateShadow(int32_t slot, const void *data, size_t size) const;
+
+        // Envio por índice na tabela (comum aos setters por nome e por handle)
+        void uploadMat4(int32_t slot, const glm::mat4 &m) const;
+        void uploadMat3(int32_t slot, const glm::mat3 &m) const;
+        void uploadVec3(int32_t slot, const glm::vec3 &v) const;
+        void uploadVec4(int32_t slot, const glm::vec4 &v) const;
+        void uploadFloat(int32_t slot, float value) const;
+        void uploadInt(int32_t slot, int value) const;
     };
 
 } // namespace cg
@@ -49,10 +49,10 @@ namespace cg
 
         /**
          * @brief Renderiza o skybox
-         * @param viewMatrix Matriz de visualização (sem translação)
-         * @param projectionMatrix Matriz de projeção
+         *
+         * Câmera lida do bloco FrameUniforms (a translação da view é descartada no shader).
          */
-        void render(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix);
+        void render();
 
         /**
          * @brief Atualiza as configurações do skybox
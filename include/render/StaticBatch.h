@@ -0,0 +1,199 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "render/Bounds.h"
+#include "render/Mesh.h"
+#include "render/Shader.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace cg
+{
+
+    /**
+     * @brief Lote de geometria estática em buffers compartilhados
+     *
+     * build() copia meshes que não se movem para um VBO por layout de vértice
+     * (VertexLayoutInfo::id) e um EBO compartilhado, já no espaço do mundo, e as
+     * agrupa por layout, material e tipo de índice. Os vértices são
+     * transformados na GPU por transform feedback a partir do VBO de cada mesh
+     * e regravados no mesmo layout; nos layouts quantizados as posições são
+     * requantizadas contra a AABB de mundo do grupo. Funciona com a cópia da CPU
+     * liberada (CpuResidency). Os índices (todos os LODs) são copiados com
+     * glCopyBufferSubData.
+     *
+     * Depois da cópia, cada mesh do lote libera seus próprios buffers
+     * (Mesh::releaseGpuGeometry): a geometria estática fica na GPU uma única
+     * vez, no formato em que foi carregada. Num novo build, as meshes sem
+     * buffers são copiadas do lote anterior sem passar de novo pela matriz de
+     * mundo; por isso a matriz delas não pode mudar (uma mesh movida precisa
+     * sair do lote antes, com restoreGeometry). Meshes com geometria
+     * compartilhada (Mesh::isGeometryShared) ficam fora: expandir cada cópia no
+     * lote custaria mais memória do que o draw que se economiza. Meshes com
+     * matriz singular também ficam fora: não seria possível recuperá-las.
+     *
+     * A cada frame o chamador informa as meshes visíveis (addVisible) e cada
+     * grupo é desenhado com um único glMultiDrawElementsBaseVertex, com o
+     * programa da cena do seu layout. Como tudo está no espaço do mundo, o grupo
+     * usa a matriz identidade, a quantização do grupo e um só conjunto de
+     * parâmetros de material.
+     */
+    class StaticBatch
+    {
+    public:
+        /**
+         * @brief Mesh a incluir no lote, com sua matriz de mundo no momento do build
+         */
+        struct Source
+        {
+            Mesh *mesh = nullptr;
+            glm::mat4 worldMatrix{1.0f};
+        };
+
+        /**
+         * @brief Mesh copiada para o lote
+         */
+        struct Entry
+        {
+            Mesh *mesh = nullptr;
+            glm::mat4 worldMatrix{1.0f}; // Matriz aplicada aos vértices
+            GLint baseVertex = 0;        // Primeiro vértice no VBO do lote
+            size_t indexOffset = 0;      // Início do EBO da mesh no EBO do lote, em bytes
+            uint32_t group = 0;          // Grupo (layout + material + tipo de índice)
+        };
+
+        /**
+         * @brief Meshes com o mesmo layout, material e tipo de índice, desenhadas numa chamada
+         */
+        struct Group
+        {
+            Mesh *representative = nullptr;            // Primeira mesh do grupo (material e transparência)
+            const Material *material = nullptr;        // Material das meshes (só comparado)
+            const VertexLayoutInfo *layout = nullptr;  // Layout dos vértices (o das meshes)
+            uint32_t vertexBuffer = 0;                 // VBO/VAO do layout no lote
+            GLenum indexType = GL_UNSIGNED_INT;
+            BoundingBox bounds;                        // AABB de mundo das meshes do grupo
+            QuantizationParams quantization;           // Dequantização das posições (relativa a bounds)
+            std::vector<uint32_t> entries;             // Índices em getEntries()
+
+            // Draws visíveis no frame atual (argumentos de glMultiDrawElementsBaseVertex)
+            std::vector<GLsizei> counts;
+            std::vector<const void *> offsets;
+            std::vector<GLint> baseVertices;
+        };
+
+        StaticBatch() = default;
+        ~StaticBatch();
+
+        /**
+         * @brief Monta o lote (substitui o anterior)
+         *
+         * Requer contexto OpenGL. Meshes transparentes devem ficar fora: o lote
+         * não preserva a ordem de trás para frente. Meshes do lote atual que não
+         * estão em sources devem ser recuperadas antes (restoreGeometry).
+         * @return false se não havia meshes ou a etapa de transformação falhou
+         */
+        bool build(const std::vector<Source> &sources);
+
+        /**
+         * @brief Recria VBO/EBO próprios (layout e quantização da mesh, espaço local) para uma mesh do lote
+         * @return false se a mesh não está no lote ou ainda tem seus buffers
+         */
+        bool restoreGeometry(Mesh *mesh);
+
+        /**
+         * @brief Libera os buffers e esvazia o lote (recuperar as meshes antes com restoreGeometry)
+         */
+        void clear();
+
+        bool empty() const { return mEntries.empty(); }
+
+        /**
+         * @brief Índice da entrada de uma mesh, ou -1 se ela não está no lote
+         */
+        int32_t findEntry(const Mesh *mesh) const;
+
+        const std::vector<Entry> &getEntries() const { return mEntries; }
+        const std::vector<Group> &getGroups() const { return mGroups; }
+
+        // =================== DESENHO ===================
+
+        /**
+         * @brief Esvazia as listas de draws visíveis de todos os grupos
+         */
+        void beginFrame();
+
+        /**
+         * @brief Adiciona a mesh de uma entrada, no nível de detalhe dado, aos draws do frame
+         */
+        void addVisible(uint32_t entry, size_t lod);
+
+        /**
+         * @brief Desenha os itens visíveis de um grupo (VAO do grupo vinculado)
+         */
+        void draw(uint32_t group) const;
+
+        /**
+         * @brief VAO do layout de um grupo
+         */
+        GLuint getVertexArray(uint32_t group) const { return mVertexBuffers[mGroups[group].vertexBuffer].vao; }
+
+        /**
+         * @brief Bytes de VBO/EBO ocupados pelo lote na GPU
+         */
+        size_t getGpuMemoryBytes() const { return mGpuMemoryBytes; }
+
+        // Desabilita cópia (os buffers seriam liberados duas vezes)
+        StaticBatch(const StaticBatch &) = delete;
+        StaticBatch &operator=(const StaticBatch &) = delete;
+
+    private:
+        /**
+         * @brief Vértices do lote num layout
+         */
+        struct VertexBuffer
+        {
+            const VertexLayoutInfo *layout = nullptr;
+            GLuint vao = 0;
+            GLuint vbo = 0;
+            size_t vertexCount = 0;
+        };
+
+        std::vector<VertexBuffer> mVertexBuffers; // Um por layout
+        GLuint mEBO = 0;
+        size_t mGpuMemoryBytes = 0;
+
+        std::vector<Entry> mEntries;
+        std::vector<Group> mGroups;
+        std::unordered_map<const Mesh *, uint32_t> mEntryByMesh;
+
+        // Programas de transform feedback por par de layouts (origem | destino << 16)
+        std::unordered_map<uint32_t, std::unique_ptr<Shader>> mTransformShaders;
+
+        /**
+         * @brief Obtém (compilando na primeira vez) o programa que decodifica um layout e grava em outro
+         */
+        const Shader *getTransformShader(const VertexLayoutInfo &source, const VertexLayoutInfo &target);
+
+        /**
+         * @brief Grava vértices de um VAO, transformados por matrix, no layout de destino em target
+         *
+         * Requer GL_RASTERIZER_DISCARD ativo.
+         * @param targetQuantization Quantização das posições gravadas (layouts quantizados)
+         * @param targetVertex Primeiro vértice de destino em target
+         */
+        bool transformVertices(GLuint sourceVertexArray, GLint firstVertex, size_t vertexCount,
+                               const VertexLayoutInfo &sourceLayout, const QuantizationParams &sourceQuantization,
+                               const glm::mat4 &matrix, const VertexLayoutInfo &targetLayout,
+                               const QuantizationParams &targetQuantization, GLuint target, size_t targetVertex);
+
+        /**
+         * @brief restoreGeometry lendo de outro lote (o anterior, durante build)
+         */
+        bool restoreFrom(const StaticBatch &batch, Mesh *mesh);
+    };
+
+} // namespace cg
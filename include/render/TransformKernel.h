@@ -0,0 +1,107 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace cg
+{
+
+    /**
+     * @brief Matrizes 4x4 em estrutura de arrays: um array por elemento
+     *
+     * O elemento e = coluna * 4 + linha segue a ordem de colunas do glm, então
+     * element(e)[i] == matriz_i[e / 4][e % 4].
+     */
+    class Mat4Array
+    {
+    public:
+        void resize(size_t count);
+        size_t size() const { return mElements[0].size(); }
+
+        void set(size_t index, const glm::mat4 &matrix);
+        glm::mat4 get(size_t index) const;
+
+        float *element(int e) { return mElements[e].data(); }
+        const float *element(int e) const { return mElements[e].data(); }
+
+    private:
+        std::vector<float> mElements[16];
+    };
+
+    /**
+     * @brief Matrizes 3x3 em estrutura de arrays (elemento e = coluna * 3 + linha)
+     */
+    class Mat3Array
+    {
+    public:
+        void resize(size_t count);
+        size_t size() const { return mElements[0].size(); }
+
+        void set(size_t index, const glm::mat3 &matrix);
+        glm::mat3 get(size_t index) const;
+
+        float *element(int e) { return mElements[e].data(); }
+        const float *element(int e) const { return mElements[e].data(); }
+
+    private:
+        std::vector<float> mElements[9];
+    };
+
+    /**
+     * @brief Translação, rotação (ângulos de Euler em radianos) e escala em estrutura de arrays
+     */
+    struct TrsArray
+    {
+        std::vector<float> translation[3];
+        std::vector<float> rotation[3];
+        std::vector<float> scale[3];
+
+        void resize(size_t count);
+        size_t size() const { return translation[0].size(); }
+        void set(size_t index, const glm::vec3 &t, const glm::vec3 &r, const glm::vec3 &s);
+    };
+
+    /**
+     * @brief Kernels em lote para matrizes de mundo e de normais
+     *
+     * Cada lane do registrador SIMD é uma matriz diferente (estrutura de
+     * arrays): 8 matrizes por iteração com AVX (FMA com AVX2), 4 com SSE. O
+     * resto que não completa um lote, e a versão sem SIMD, usam o mesmo código
+     * com floats escalares, então as fórmulas são idênticas em todos os caminhos.
+     */
+    class TransformKernel
+    {
+    public:
+        /**
+         * @brief T * Rx * Ry * Rz * S de uma única matriz (a mesma convenção de Model)
+         */
+        static glm::mat4 composeTrs(const glm::vec3 &translation, const glm::vec3 &rotation, const glm::vec3 &scale);
+
+        /**
+         * @brief T * Rx * Ry * Rz * S de todas as entradas de trs
+         *
+         * Senos e cossenos são calculados por lane com std::sin/std::cos; o resto
+         * da composição é vetorizado.
+         */
+        static void composeTrs(const TrsArray &trs, Mat4Array &out);
+
+        /**
+         * @brief out[i] = parents[i] * locals[i]
+         */
+        static void multiply(const Mat4Array &parents, const Mat4Array &locals, Mat4Array &out);
+
+        /**
+         * @brief out[i] = transpose(inverse(mat3(matrices[i])))
+         *
+         * Calculada pelos produtos vetoriais das colunas divididos pelo
+         * determinante (matriz dos cofatores), sem inversão geral.
+         */
+        static void normalMatrices(const Mat4Array &matrices, Mat3Array &out);
+
+        /**
+         * @brief Caminho escolhido na compilação (para estatísticas e benchmarks)
+         */
+        static const char *getPathName();
+    };
+
+} // namespace cg
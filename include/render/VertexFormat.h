@@ -0,0 +1,386 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "render/MeshData.h"
+
+namespace cg
+{
+
+    // =================== CODIFICAÇÕES POR ATRIBUTO ===================
+
+    enum class PositionEncoding : uint8_t
+    {
+        Float32, // 3 floats (12 bytes)
+        Half16,  // 3 half floats relativos à AABB da mesh (8 bytes)
+        Snorm16  // 3 inteiros normalizados de 16 bits relativos à AABB da mesh (8 bytes)
+    };
+
+    enum class NormalEncoding : uint8_t
+    {
+        Float32,      // 3 floats (12 bytes)
+        Octahedral16, // Mapeamento octaédrico em 2 inteiros normalizados de 16 bits (4 bytes)
+        Snorm10       // Formato 10:10:10:2 normalizado (4 bytes)
+    };
+
+    enum class TexCoordEncoding : uint8_t
+    {
+        Float32, // 2 floats (8 bytes)
+        Half16   // 2 half floats (4 bytes)
+    };
+
+    /**
+     * @brief Formatos de vértice selecionáveis no carregamento (LoadOptions::vertexFormat)
+     */
+    enum class VertexFormat : uint8_t
+    {
+        Standard,          // 32 bytes: igual a Vertex (sem quantização)
+        Compact,           // 16 bytes: posição snorm16, normal 10:10:10:2, UV half
+        CompactOctahedral, // 16 bytes: posição snorm16, normal octaédrica, UV half
+        HalfFloat          // 16 bytes: posição half, normal octaédrica, UV half
+    };
+
+    /**
+     * @brief Parâmetros de dequantização das posições (por mesh)
+     *
+     * Posições quantizadas guardam (p - positionOffset) / positionScale em [-1, 1];
+     * o vertex shader reconstrói p = uPosOffset + a * uPosScale.
+     */
+    struct QuantizationParams
+    {
+        glm::vec3 positionOffset{0.0f}; // Centro da AABB
+        glm::vec3 positionScale{1.0f};  // Meia extensão da AABB (por eixo)
+
+        /**
+         * @brief Calcula os parâmetros a partir da AABB da mesh (MeshData::bounds)
+         */
+        static QuantizationParams fromBounds(const BoundingBox &box);
+    };
+
+    // =================== CONVERSÕES ===================
+
+    uint16_t packHalf(float value);                      // float -> half (arredondamento para o mais próximo)
+    int16_t packSnorm16(float value);                    // [-1, 1] -> inteiro normalizado de 16 bits
+    uint32_t packSnorm10(const glm::vec3 &value);        // [-1, 1]^3 -> 10:10:10:2 (w = 0)
+    glm::vec2 encodeOctahedral(const glm::vec3 &normal); // Normal unitária -> [-1, 1]^2
+
+    /**
+     * @brief Descrição de um atributo para glVertexAttribPointer
+     */
+    struct VertexAttribute
+    {
+        GLuint location;
+        GLint components;
+        GLenum type;
+        GLboolean normalized;
+        uint32_t offset;
+    };
+
+    /**
+     * @brief Visão em tempo de execução de um VertexLayout
+     *
+     * Permite que Mesh e Renderer tratem qualquer layout de forma uniforme; os dados
+     * são gerados em tempo de compilação pelo template VertexLayout.
+     */
+    struct VertexLayoutInfo
+    {
+        uint32_t id;                               // Identificador único (combinação das codificações)
+        uint32_t stride;                           // Bytes por vértice
+        bool quantizedPosition;                    // Requer uPosOffset/uPosScale (bloco ObjectUniforms)
+        std::array<VertexAttribute, 3> attributes; // Posição (0), normal (1), UV (2)
+        std::array<const char *, 3> glsl;          // Declaração + função de decodificação por atributo
+        std::array<const char *, 3> glslEncode;    // Função de codificação por atributo (palavras de 32 bits)
+        void (*encode)(const Vertex *src, size_t count, const QuantizationParams &params, uint8_t *dst);
+
+        /**
+         * @brief Configura os atributos no VAO/VBO atualmente vinculados
+         */
+        void setupAttributes() const;
+
+        /**
+         * @brief Trecho GLSL com as entradas e as funções decodePosition/decodeNormal/decodeTexCoord
+         */
+        std::string glslPrelude() const;
+
+        /**
+         * @brief Trecho GLSL com encodePosition/encodeNormal/encodeTexCoord
+         *
+         * Cada função devolve as palavras de 32 bits do atributo no VBO (uvec3,
+         * componentes além do tamanho do atributo valem zero), com os mesmos
+         * arredondamentos de encode(). Usado para gravar vértices neste layout
+         * por transform feedback.
+         */
+        std::string glslEncoder() const;
+    };
+
+    // =================== TRAITS DE CADA CODIFICAÇÃO ===================
+
+    template <PositionEncoding E>
+    struct PositionAttribute;
+
+    template <>
+    struct PositionAttribute<PositionEncoding::Float32>
+    {
+        static constexpr uint32_t size = 12;
+        static constexpr GLint components = 3;
+        static constexpr GLenum type = GL_FLOAT;
+        static constexpr GLboolean normalized = GL_FALSE;
+        static constexpr bool quantized = false;
+        static constexpr const char *glsl =
+            "layout(location = 0) in vec3 aPosition;\n"
+            "vec3 decodePosition() { return aPosition; }\n";
+        static constexpr const char *glslEncode =
+            "uvec3 encodePosition(vec3 p, vec3 offset, vec3 scale) { return floatBitsToUint(p); }\n";
+
+        static void write(const glm::vec3 &p, const QuantizationParams &, uint8_t *dst)
+        {
+            std::memcpy(dst, &p, size);
+        }
+    };
+
+    template <>
+    struct PositionAttribute<PositionEncoding::Half16>
+    {
+        static constexpr uint32_t size = 8; // 6 bytes + 2 de preenchimento (alinhamento de 4)
+        static constexpr GLint components = 3;
+        static constexpr GLenum type = GL_HALF_FLOAT;
+        static constexpr GLboolean normalized = GL_FALSE;
+        static constexpr bool quantized = true;
+        static constexpr const char *glsl =
+            "layout(location = 0) in vec3 aPosition;\n"
+            "vec3 decodePosition() { return uPosOffset.xyz + aPosition * uPosScale.xyz; }\n"; // ObjectUniforms
+        static constexpr const char *glslEncode =
+            "uvec3 encodePosition(vec3 p, vec3 offset, vec3 scale) {\n"
+            "    vec3 n = (p - offset) / scale;\n"
+            "    return uvec3(encodeHalf(n.x) | (encodeHalf(n.y) << 16), encodeHalf(n.z), 0u);\n"
+            "}\n";
+
+        static void write(const glm::vec3 &p, const QuantizationParams &params, uint8_t *dst)
+        {
+            glm::vec3 n = (p - params.positionOffset) / params.positionScale;
+            uint16_t packed[4] = {packHalf(n.x), packHalf(n.y), packHalf(n.z), 0};
+            std::memcpy(dst, packed, size);
+        }
+    };
+
+    template <>
+    struct PositionAttribute<PositionEncoding::Snorm16>
+    {
+        static constexpr uint32_t size = 8; // 6 bytes + 2 de preenchimento (alinhamento de 4)
+        static constexpr GLint components = 3;
+        static constexpr GLenum type = GL_SHORT;
+        static constexpr GLboolean normalized = GL_TRUE;
+        static constexpr bool quantized = true;
+        static constexpr const char *glsl =
+            "layout(location = 0) in vec3 aPosition;\n"
+            "vec3 decodePosition() { return uPosOffset.xyz + aPosition * uPosScale.xyz; }\n"; // ObjectUniforms
+        static constexpr const char *glslEncode =
+            "uvec3 encodePosition(vec3 p, vec3 offset, vec3 scale) {\n"
+            "    vec3 n = (p - offset) / scale;\n"
+            "    return uvec3(encodeSnorm16(n.x) | (encodeSnorm16(n.y) << 16), encodeSnorm16(n.z), 0u);\n"
+            "}\n";
+
+        static void write(const glm::vec3 &p, const QuantizationParams &params, uint8_t *dst)
+        {
+            glm::vec3 n = (p - params.positionOffset) / params.positionScale;
+            int16_t packed[4] = {packSnorm16(n.x), packSnorm16(n.y), packSnorm16(n.z), 0};
+            std::memcpy(dst, packed, size);
+        }
+    };
+
+    template <NormalEncoding E>
+    struct NormalAttribute;
+
+    template <>
+    struct NormalAttribute<NormalEncoding::Float32>
+    {
+        static constexpr uint32_t size = 12;
+        static constexpr GLint components = 3;
+        static constexpr GLenum type = GL_FLOAT;
+        static constexpr GLboolean normalized = GL_FALSE;
+        static constexpr const char *glsl =
+            "layout(location = 1) in vec3 aNormal;\n"
+            "vec3 decodeNormal() { return aNormal; }\n";
+        static constexpr const char *glslEncode =
+            "uvec3 encodeNormal(vec3 n) { return floatBitsToUint(n); }\n";
+
+        static void write(const glm::vec3 &n, uint8_t *dst)
+        {
+            std::memcpy(dst, &n, size);
+        }
+    };
+
+    template <>
+    struct NormalAttribute<NormalEncoding::Octahedral16>
+    {
+        static constexpr uint32_t size = 4;
+        static constexpr GLint components = 2;
+        static constexpr GLenum type = GL_SHORT;
+        static constexpr GLboolean normalized = GL_TRUE;
+        static constexpr const char *glsl =
+            "layout(location = 1) in vec2 aNormal;\n"
+            "vec3 decodeNormal() {\n"
+            "    vec3 n = vec3(aNormal, 1.0 - abs(aNormal.x) - abs(aNormal.y));\n"
+            "    if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);\n"
+            "    return n;\n"
+            "}\n";
+        static constexpr const char *glslEncode =
+            "uvec3 encodeNormal(vec3 n) {\n"
+            "    float sum = abs(n.x) + abs(n.y) + abs(n.z);\n"
+            "    if (!(sum > 0.0) || isinf(sum)) return uvec3(0u);\n"
+            "    vec2 p = n.xy / sum;\n"
+            "    if (n.z < 0.0) p = (1.0 - abs(p.yx)) * vec2(p.x >= 0.0 ? 1.0 : -1.0, p.y >= 0.0 ? 1.0 : -1.0);\n"
+            "    return uvec3(encodeSnorm16(p.x) | (encodeSnorm16(p.y) << 16), 0u, 0u);\n"
+            "}\n";
+
+        static void write(const glm::vec3 &n, uint8_t *dst)
+        {
+            glm::vec2 e = encodeOctahedral(n);
+            int16_t packed[2] = {packSnorm16(e.x), packSnorm16(e.y)};
+            std::memcpy(dst, packed, size);
+        }
+    };
+
+    template <>
+    struct NormalAttribute<NormalEncoding::Snorm10>
+    {
+        static constexpr uint32_t size = 4;
+        static constexpr GLint components = 4;
+        static constexpr GLenum type = GL_INT_2_10_10_10_REV;
+        static constexpr GLboolean normalized = GL_TRUE;
+        static constexpr const char *glsl =
+            "layout(location = 1) in vec4 aNormal;\n"
+            "vec3 decodeNormal() { return aNormal.xyz; }\n";
+        static constexpr const char *glslEncode =
+            "uvec3 encodeNormal(vec3 n) {\n"
+            "    return uvec3(encodeSnorm10(n.x) | (encodeSnorm10(n.y) << 10) | (encodeSnorm10(n.z) << 20), 0u, 0u);\n"
+            "}\n";
+
+        static void write(const glm::vec3 &n, uint8_t *dst)
+        {
+            uint32_t packed = packSnorm10(n);
+            std::memcpy(dst, &packed, size);
+        }
+    };
+
+    template <TexCoordEncoding E>
+    struct TexCoordAttribute;
+
+    template <>
+    struct TexCoordAttribute<TexCoordEncoding::Float32>
+    {
+        static constexpr uint32_t size = 8;
+        static constexpr GLint components = 2;
+        static constexpr GLenum type = GL_FLOAT;
+        static constexpr GLboolean normalized = GL_FALSE;
+        static constexpr const char *glsl =
+            "layout(location = 2) in vec2 aTexCoord;\n"
+            "vec2 decodeTexCoord() { return aTexCoord; }\n";
+        static constexpr const char *glslEncode =
+            "uvec3 encodeTexCoord(vec2 uv) { return uvec3(floatBitsToUint(uv), 0u); }\n";
+
+        static void write(const glm::vec2 &uv, uint8_t *dst)
+        {
+            std::memcpy(dst, &uv, size);
+        }
+    };
+
+    template <>
+    struct TexCoordAttribute<TexCoordEncoding::Half16>
+    {
+        static constexpr uint32_t size = 4;
+        static constexpr GLint components = 2;
+        static constexpr GLenum type = GL_HALF_FLOAT;
+        static constexpr GLboolean normalized = GL_FALSE;
+        static constexpr const char *glsl =
+            "layout(location = 2) in vec2 aTexCoord;\n"
+            "vec2 decodeTexCoord() { return aTexCoord; }\n";
+        static constexpr const char *glslEncode =
+            "uvec3 encodeTexCoord(vec2 uv) { return uvec3(encodeHalf(uv.x) | (encodeHalf(uv.y) << 16), 0u, 0u); }\n";
+
+        static void write(const glm::vec2 &uv, uint8_t *dst)
+        {
+            uint16_t packed[2] = {packHalf(uv.x), packHalf(uv.y)};
+            std::memcpy(dst, packed, size);
+        }
+    };
+
+    // =================== DESCRITOR DE LAYOUT ===================
+
+    /**
+     * @brief Layout de vértice definido em tempo de compilação
+     *
+     * Offsets, stride, atributos OpenGL, codificação e o trecho GLSL de
+     * dequantização saem todos das codificações escolhidas, de modo que a
+     * configuração do VAO e o shader nunca ficam dessincronizados.
+     */
+    template <PositionEncoding P, NormalEncoding N, TexCoordEncoding T>
+    struct VertexLayout
+    {
+        using Position = PositionAttribute<P>;
+        using Normal = NormalAttribute<N>;
+        using TexCoord = TexCoordAttribute<T>;
+
+        static constexpr uint32_t positionOffset = 0;
+        static constexpr uint32_t normalOffset = positionOffset + Position::size;
+        static constexpr uint32_t texCoordOffset = normalOffset + Normal::size;
+        static constexpr uint32_t stride = texCoordOffset + TexCoord::size;
+        static constexpr uint32_t id = static_cast<uint32_t>(P) |
+                                       (static_cast<uint32_t>(N) << 4) |
+                                       (static_cast<uint32_t>(T) << 8);
+
+        static_assert(stride % 4 == 0, "Atributos precisam permanecer alinhados em 4 bytes");
+
+        static constexpr std::array<VertexAttribute, 3> attributes = {{
+            {0, Position::components, Position::type, Position::normalized, positionOffset},
+            {1, Normal::components, Normal::type, Normal::normalized, normalOffset},
+            {2, TexCoord::components, TexCoord::type, TexCoord::normalized, texCoordOffset},
+        }};
+
+        static void encode(const Vertex *src, size_t count, const QuantizationParams &params, uint8_t *dst)
+        {
+            for (size_t i = 0; i < count; ++i, dst += stride)
+            {
+                Position::write(src[i].position, params, dst + positionOffset);
+                Normal::write(src[i].normal, dst + normalOffset);
+                TexCoord::write(src[i].texCoords, dst + texCoordOffset);
+            }
+        }
+
+        static const VertexLayoutInfo &info()
+        {
+            static const VertexLayoutInfo layoutInfo{
+                id, stride, Position::quantized, attributes,
+                {Position::glsl, Normal::glsl, TexCoord::glsl},
+                {Position::glslEncode, Normal::glslEncode, TexCoord::glslEncode}, &encode};
+            return layoutInfo;
+        }
+    };
+
+    using StandardVertexLayout = VertexLayout<PositionEncoding::Float32, NormalEncoding::Float32, TexCoordEncoding::Float32>;
+    using CompactVertexLayout = VertexLayout<PositionEncoding::Snorm16, NormalEncoding::Snorm10, TexCoordEncoding::Half16>;
+    using CompactOctahedralVertexLayout = VertexLayout<PositionEncoding::Snorm16, NormalEncoding::Octahedral16, TexCoordEncoding::Half16>;
+    using HalfFloatVertexLayout = VertexLayout<PositionEncoding::Half16, NormalEncoding::Octahedral16, TexCoordEncoding::Half16>;
+
+    static_assert(StandardVertexLayout::stride == sizeof(Vertex), "Layout padrão deve coincidir com Vertex");
+    static_assert(CompactVertexLayout::stride == 16, "Layout compacto deve ocupar 16 bytes");
+    static_assert(CompactOctahedralVertexLayout::stride == 16, "Layout compacto deve ocupar 16 bytes");
+    static_assert(HalfFloatVertexLayout::stride == 16, "Layout half deve ocupar 16 bytes");
+
+    /**
+     * @brief Layout correspondente a um formato selecionável
+     */
+    const VertexLayoutInfo &getVertexLayout(VertexFormat format);
+
+    /**
+     * @brief Tipo de índice usado na GPU: 16 bits quando todos os vértices cabem nele
+     */
+    inline GLenum getIndexType(size_t vertexCount)
+    {
+        return vertexCount < 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    }
+
+} // namespace cg
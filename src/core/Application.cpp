@@ -6,7 +6,7 @@
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include <limits>
+#include <filesystem>
 
 namespace cg
 {
@@ -98,6 +98,7 @@ namespace cg
 
         // Configuração inicial do viewport
         glViewport(0, 0, mWindow.width(), mWindow.height());
+        mRenderer.setViewportHeight(mWindow.height());
 
         // Calcula matriz de projeção inicial
         float aspect = static_cast<float>(mWindow.width()) / static_cast<float>(std::max(1, mWindow.height()));
@@ -127,51 +128,73 @@ namespace cg
             "../../models/structure_v7.obj", // Duas pastas acima
         };
 
-        std::unique_ptr<Model> model = nullptr;
+        // Usa o primeiro caminho existente; o carregamento em si roda em background
         std::string usedPath;
-
-        // Tenta carregar o modelo usando diferentes caminhos
         for (const auto &path : possiblePaths)
         {
-            std::cout << "Tentando carregar modelo de: " << path << std::endl;
-            model = ModelLoader::loadModel(path, "CentroHistorico");
-            if (model)
+            std::cout << "Procurando modelo em: " << path << std::endl;
+            if (std::filesystem::exists(path))
             {
                 usedPath = path;
                 break;
             }
         }
 
-        if (!model)
+        // Cria um modelo de teste simples (cubo) se nenhum arquivo puder ser carregado
+        auto addTestCube = [this]()
         {
             std::cerr << "ERRO: Falha ao carregar qualquer modelo. Criando modelo de teste..." << std::endl;
-
-            // Cria um modelo de teste simples (cubo) se nenhum arquivo puder ser carregado
-            model = createTestCube();
-            if (!model)
+            auto cube = createTestCube();
+            if (!cube)
             {
                 std::cerr << "ERRO: Falha ao criar modelo de teste" << std::endl;
-                return false;
+                return;
             }
-            usedPath = "modelo_teste_cubo";
-        }
+            mRenderer.addModel(std::move(cube), "centro_historico");
+        };
+
+        // Configura o modelo assim que todas as meshes estiverem na GPU (antes de entrar na cena)
+        auto onModelReady = [this, usedPath](Model &model)
+        {
+            std::cout << "Modelo carregado com sucesso de: " << usedPath << std::endl;
+
+            // Posiciona o modelo no centro da cena
+            model.setPosition(glm::vec3(0.0f, 0.0f, 0.0f));
+            model.setScale(glm::vec3(1.0f, 1.0f, 1.0f)); // Tamanho original
+
+            model.setParentByName("Front", "DoorLeft_glass");
+            model.setParentByName("Front2", "DoorRight_glass");
+            model.setParentByName("Back", "DoorLeft_glass");
+            model.setParentByName("Back2", "DoorRight_glass");
 
-        std::cout << "Modelo carregado com sucesso de: " << usedPath << std::endl;
+            // O memorial não se move: as meshes fora da hierarquia das portas vão para o lote estático
+            model.setStatic(true);
 
-        // Posiciona o modelo no centro da cena
-        model->setPosition(glm::vec3(0.0f, 0.0f, 0.0f));
-        model->setScale(glm::vec3(1.0f, 1.0f, 1.0f)); // Tamanho original
+            // O modelo chega com as portas fechadas, mesmo que E tenha sido pressionada durante o carregamento
+            mDoorsOpen = false;
 
-        if (model)
+            // Conjuntos visíveis por célula de vista: lidos de "<obj>.pvs" ou calculados em background
+            mRenderer.loadPvsAsync("centro_historico", model, usedPath);
+        };
+
+        if (usedPath.empty())
         {
-            model->setParentByName("Front", "DoorLeft_glass");
-            model->setParentByName("Front2", "DoorRight_glass");
-            model->setParentByName("Back", "DoorLeft_glass");
-            model->setParentByName("Back2", "DoorRight_glass");
+            addTestCube();
+        }
+        else
+        {
+            // Parsing, otimização e LODs das meshes em paralelo, usando todos os núcleos disponíveis;
+            // vértices quantizados (16 bytes) na GPU; na CPU ficam apenas posições e índices
+            ModelLoader::LoadOptions loadOptions;
+            loadOptions.workerCount = 0;
+            loadOptions.optimizeMeshes = true;
+            loadOptions.vertexFormat = VertexFormat::Compact;
+            loadOptions.generateLods = true;
+            loadOptions.cpuResidency = CpuResidency::KeepPositionsOnly;
+
+            mRenderer.loadModelAsync(usedPath, "centro_historico", "CentroHistorico", loadOptions,
+                                     onModelReady, addTestCube);
         }
-
-        // Adiciona o modelo ao renderer
-        mRenderer.addModel(std::move(model), "centro_historico");
 
         // =================== CONFIGURAÇÃO DA CÂMERA ===================
         // Posição inicial: elevada e afastada para ter visão geral do modelo
@@ -268,6 +291,7 @@ namespace cg
             float leftAngle = mDoorsOpen ? -90.0f : 0.0f; // abre para esquerda
             float rightAngle = mDoorsOpen ? 90.0f : 0.0f; // abre para direita
             applyDoorTransforms(leftAngle, rightAngle);
+            // Portas de vidro não fecham portais: o estado não é informado ao Renderer::setDoorOpen
             std::cout << (mDoorsOpen ? "Portas ABERTAS" : "Portas FECHADAS") << std::endl;
         }
         prevE = pressedE;
@@ -296,33 +320,18 @@ namespace cg
 
         auto buildHingedTransform = [](const Mesh *mesh, float angleDeg, bool useMinX) -> glm::mat4
         {
-            if (!mesh || mesh->vertices.empty())
+            if (!mesh || mesh->getBoundingBox().isEmpty())
             {
                 return glm::rotate(glm::mat4(1.0f), glm::radians(angleDeg), glm::vec3(0, 1, 0));
             }
 
-            // Calcula AABB (axis-aligned-bounding-box) da mesh
-            float minX = std::numeric_limits<float>::max();
-            float maxX = std::numeric_limits<float>::lowest();
-            float minY = std::numeric_limits<float>::max();
-            float maxY = std::numeric_limits<float>::lowest();
-            float minZ = std::numeric_limits<float>::max();
-            float maxZ = std::numeric_limits<float>::lowest();
-
-            for (const auto &v : mesh->vertices)
-            {
-                minX = std::min(minX, v.position.x);
-                maxX = std::max(maxX, v.position.x);
-                minY = std::min(minY, v.position.y);
-                maxY = std::max(maxY, v.position.y);
-                minZ = std::min(minZ, v.position.z);
-                maxZ = std::max(maxZ, v.position.z);
-            }
+            // AABB (axis-aligned-bounding-box) da mesh, calculada no carregamento
+            const BoundingBox &box = mesh->getBoundingBox();
 
             // Pivô ao longo da aresta vertical (eixo Y) do batente
-            float pivotX = useMinX ? minX : maxX;
-            float pivotY = (minY + maxY) * 0.5f;
-            float pivotZ = (minZ + maxZ) * 0.5f;
+            float pivotX = useMinX ? box.min.x : box.max.x;
+            float pivotY = (box.min.y + box.max.y) * 0.5f;
+            float pivotZ = (box.min.z + box.max.z) * 0.5f;
             glm::vec3 pivot(pivotX, pivotY, pivotZ);
 
             glm::mat4 T_toOrigin = glm::translate(glm::mat4(1.0f), -pivot);
@@ -351,6 +360,7 @@ namespace cg
 
         // Atualiza viewport do OpenGL
         glViewport(0, 0, w, h);
+        mRenderer.setViewportHeight(h);
 
         // Recalcula matriz de projeção com novo aspect ratio
         float aspect = static_cast<float>(w) / static_cast<float>(std::max(1, h));
@@ -0,0 +1,159 @@
+#include "core/MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cg {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mData(other.mData), mSize(other.mSize), mOpenEmpty(other.mOpenEmpty)
+#ifdef _WIN32
+    , mFileHandle(other.mFileHandle), mMappingHandle(other.mMappingHandle)
+#endif
+{
+    other.mData = nullptr;
+    other.mSize = 0;
+    other.mOpenEmpty = false;
+#ifdef _WIN32
+    other.mFileHandle = nullptr;
+    other.mMappingHandle = nullptr;
+#endif
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(mData, other.mData);
+        std::swap(mSize, other.mSize);
+        std::swap(mOpenEmpty, other.mOpenEmpty);
+#ifdef _WIN32
+        std::swap(mFileHandle, other.mFileHandle);
+        std::swap(mMappingHandle, other.mMappingHandle);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    // Arquivos vazios não podem ser mapeados; tratamos como conteúdo vazio válido
+    if (fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        mOpenEmpty = true;
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    mFileHandle = file;
+    mMappingHandle = mapping;
+    mData = static_cast<const char*>(view);
+    mSize = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (mData)
+        UnmapViewOfFile(mData);
+    if (mMappingHandle)
+        CloseHandle(static_cast<HANDLE>(mMappingHandle));
+    if (mFileHandle)
+        CloseHandle(static_cast<HANDLE>(mFileHandle));
+
+    mData = nullptr;
+    mSize = 0;
+    mOpenEmpty = false;
+    mFileHandle = nullptr;
+    mMappingHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+
+    // Arquivos vazios não podem ser mapeados; tratamos como conteúdo vazio válido
+    if (st.st_size == 0) {
+        ::close(fd);
+        mOpenEmpty = true;
+        return true;
+    }
+
+    void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // O descritor pode ser fechado logo após o mmap; o mapeamento continua válido
+    ::close(fd);
+    if (addr == MAP_FAILED)
+        return false;
+
+    // Leitura é sequencial: pede ao kernel para antecipar páginas
+    madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+    mData = static_cast<const char*>(addr);
+    mSize = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (mData)
+        munmap(const_cast<char*>(mData), mSize);
+
+    mData = nullptr;
+    mSize = 0;
+    mOpenEmpty = false;
+}
+
+#endif
+
+} // namespace cg
@@ -0,0 +1,151 @@
+#include "render/Bounds.h"
+#include "render/MeshData.h"
+#include "core/Simd.h"
+#include <cmath>
+
+namespace cg
+{
+
+    namespace
+    {
+#ifdef CG_SIMD_SSE
+        // Carrega a posição do vértice em x, y, z (o quarto componente é normal.x e é ignorado).
+        // Seguro: Vertex sempre tem a normal logo após a posição
+        inline __m128 loadPosition(const Vertex &vertex)
+        {
+            static_assert(offsetof(Vertex, normal) == offsetof(Vertex, position) + sizeof(glm::vec3),
+                          "loadPosition lê 16 bytes a partir da posição");
+            return _mm_loadu_ps(&vertex.position.x);
+        }
+
+        BoundingBox computeBoxSSE(const Vertex *vertices, size_t count)
+        {
+            // Dois acumuladores independentes para não serializar min/max
+            // Ordem dos operandos: _mm_min_ps(p, acc) devolve acc quando p é NaN
+            __m128 min0 = _mm_set1_ps(std::numeric_limits<float>::max());
+            __m128 max0 = _mm_set1_ps(std::numeric_limits<float>::lowest());
+            __m128 min1 = min0;
+            __m128 max1 = max0;
+
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                __m128 p0 = loadPosition(vertices[i]);
+                __m128 p1 = loadPosition(vertices[i + 1]);
+                min0 = _mm_min_ps(p0, min0);
+                max0 = _mm_max_ps(p0, max0);
+                min1 = _mm_min_ps(p1, min1);
+                max1 = _mm_max_ps(p1, max1);
+            }
+            if (i < count)
+            {
+                __m128 p = loadPosition(vertices[i]);
+                min0 = _mm_min_ps(p, min0);
+                max0 = _mm_max_ps(p, max0);
+            }
+
+            alignas(16) float minOut[4];
+            alignas(16) float maxOut[4];
+            _mm_store_ps(minOut, _mm_min_ps(min0, min1));
+            _mm_store_ps(maxOut, _mm_max_ps(max0, max1));
+
+            BoundingBox box;
+            box.min = glm::vec3(minOut[0], minOut[1], minOut[2]);
+            box.max = glm::vec3(maxOut[0], maxOut[1], maxOut[2]);
+            return box;
+        }
+
+        float computeMaxDistanceSquaredSSE(const Vertex *vertices, size_t count, const glm::vec3 &center)
+        {
+            const __m128 c = _mm_setr_ps(center.x, center.y, center.z, 0.0f);
+            __m128 best = _mm_setzero_ps();
+            for (size_t i = 0; i < count; ++i)
+            {
+                __m128 d = _mm_sub_ps(loadPosition(vertices[i]), c);
+                __m128 d2 = _mm_mul_ps(d, d);
+
+                // x² + y² + z² na primeira lane (a quarta lane fica de fora)
+                __m128 sum = _mm_add_ss(d2, _mm_shuffle_ps(d2, d2, _MM_SHUFFLE(1, 1, 1, 1)));
+                sum = _mm_add_ss(sum, _mm_shuffle_ps(d2, d2, _MM_SHUFFLE(2, 2, 2, 2)));
+                best = _mm_max_ss(sum, best);
+            }
+            return _mm_cvtss_f32(best);
+        }
+#else
+        BoundingBox computeBoxScalar(const Vertex *vertices, size_t count)
+        {
+            // Comparações falsas para NaN: posições inválidas não alteram a caixa
+            BoundingBox box;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const glm::vec3 &p = vertices[i].position;
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    if (p[axis] < box.min[axis])
+                        box.min[axis] = p[axis];
+                    if (p[axis] > box.max[axis])
+                        box.max[axis] = p[axis];
+                }
+            }
+            return box;
+        }
+
+        float computeMaxDistanceSquaredScalar(const Vertex *vertices, size_t count, const glm::vec3 &center)
+        {
+            float best = 0.0f;
+            for (size_t i = 0; i < count; ++i)
+            {
+                glm::vec3 d = vertices[i].position - center;
+                float distanceSquared = glm::dot(d, d);
+                if (distanceSquared > best)
+                    best = distanceSquared;
+            }
+            return best;
+        }
+#endif
+    } // namespace
+
+    MeshBounds computeMeshBounds(const Vertex *vertices, size_t count)
+    {
+        MeshBounds bounds;
+        if (!vertices || count == 0)
+            return bounds;
+
+#ifdef CG_SIMD_SSE
+        bounds.box = computeBoxSSE(vertices, count);
+#else
+        bounds.box = computeBoxScalar(vertices, count);
+#endif
+        if (bounds.box.isEmpty())
+            return bounds; // nenhuma posição válida
+
+        bounds.sphere.center = bounds.box.center();
+#ifdef CG_SIMD_SSE
+        float maxDistanceSquared = computeMaxDistanceSquaredSSE(vertices, count, bounds.sphere.center);
+#else
+        float maxDistanceSquared = computeMaxDistanceSquaredScalar(vertices, count, bounds.sphere.center);
+#endif
+        bounds.sphere.radius = std::sqrt(maxDistanceSquared);
+        return bounds;
+    }
+
+    BoundingBox transformBox(const BoundingBox &box, const glm::mat4 &matrix)
+    {
+        if (box.isEmpty())
+            return box;
+
+        glm::vec3 center = glm::vec3(matrix * glm::vec4(box.center(), 1.0f));
+        glm::vec3 extents = box.extents();
+        glm::vec3 worldExtents(0.0f);
+        for (int column = 0; column < 3; ++column)
+        {
+            worldExtents += glm::abs(glm::vec3(matrix[column])) * extents[column];
+        }
+
+        BoundingBox result;
+        result.min = center - worldExtents;
+        result.max = center + worldExtents;
+        return result;
+    }
+
+} // namespace cg
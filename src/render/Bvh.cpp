@@ -0,0 +1,577 @@
+#include "render/Bvh.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+
+namespace cg
+{
+
+    namespace
+    {
+        // União de duas caixas; a caixa vazia padrão (min = +max, max = -max) é o elemento
+        // neutro, então não precisa de teste
+        inline void merge(BoundingBox &target, const BoundingBox &box)
+        {
+            target.min = glm::min(target.min, box.min);
+            target.max = glm::max(target.max, box.max);
+        }
+
+        // Metade da área de superfície (o fator 2 não muda a comparação entre custos)
+        inline float halfArea(const BoundingBox &box)
+        {
+            if (box.isEmpty())
+                return 0.0f;
+            glm::vec3 size = box.max - box.min;
+            return size.x * size.y + size.y * size.z + size.z * size.x;
+        }
+
+        inline bool overlaps(const BoundingBox &a, const BoundingBox &b)
+        {
+            return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+                   a.min.y <= b.max.y && a.max.y >= b.min.y &&
+                   a.min.z <= b.max.z && a.max.z >= b.min.z;
+        }
+
+        // Teste do slab; retorna a distância de entrada ou um valor negativo se não há interseção
+        inline float intersectRay(const BoundingBox &box, const glm::vec3 &origin, const glm::vec3 &inverseDirection,
+                                  float maxDistance)
+        {
+            glm::vec3 t0 = (box.min - origin) * inverseDirection;
+            glm::vec3 t1 = (box.max - origin) * inverseDirection;
+            glm::vec3 tNear = glm::min(t0, t1);
+            glm::vec3 tFar = glm::max(t0, t1);
+            float entry = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+            float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+            return entry <= exit ? entry : -1.0f;
+        }
+
+        // Resultado do teste de uma caixa contra os planos ainda ativos
+        enum class PlaneTest
+        {
+            Outside,
+            Intersecting,
+            Inside
+        };
+
+        // Planos em que a caixa está inteiramente do lado de dentro saem da máscara
+        inline PlaneTest testPlanes(const Frustum &frustum, const BoundingBox &box, uint32_t &planeMask)
+        {
+            glm::vec3 center = box.center();
+            glm::vec3 extents = box.extents();
+            for (uint32_t p = 0; p < 6; ++p)
+            {
+                if (!(planeMask & (1u << p)))
+                    continue;
+
+                const glm::vec4 &plane = frustum.planes[p];
+                float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+                float radius = std::abs(plane.x) * extents.x + std::abs(plane.y) * extents.y + std::abs(plane.z) * extents.z;
+                if (distance + radius < 0.0f)
+                    return PlaneTest::Outside;
+                if (distance - radius >= 0.0f)
+                    planeMask &= ~(1u << p);
+            }
+            return planeMask == 0 ? PlaneTest::Inside : PlaneTest::Intersecting;
+        }
+
+        constexpr uint32_t kAllPlanes = 0x3F;
+
+        // Custo de visitar um nó interno, relativo ao teste de um item (SAH)
+        constexpr float kTraversalCost = 1.0f;
+    } // namespace
+
+    // =================== CONSTRUÇÃO ===================
+
+    void Bvh::clear()
+    {
+        mNodes.clear();
+        mParents.clear();
+        mItems.clear();
+        mItemBoxes.clear();
+        mItemLeaf.clear();
+        mDirtyLeaves.clear();
+        mNodeDirty.clear();
+        mSahCost = 0.0f;
+        mBuildSahCost = 0.0f;
+    }
+
+    void Bvh::build(const std::vector<BoundingBox> &boxes)
+    {
+        clear();
+        if (boxes.empty())
+            return;
+
+        const uint32_t count = static_cast<uint32_t>(boxes.size());
+        mItemLeaf.assign(count, 0);
+
+        // Caixa, centroide e índice andam juntos nas partições (acesso sequencial em vez de indireto)
+        struct BuildItem
+        {
+            BoundingBox box;
+            glm::vec3 centroid;
+            uint32_t item;
+        };
+        std::vector<BuildItem> work(count);
+        mItemBoxes.resize(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            // Qualquer caixa vazia vira a caixa vazia padrão (neutra em merge)
+            mItemBoxes[i] = boxes[i].isEmpty() ? BoundingBox{} : boxes[i];
+            work[i].box = mItemBoxes[i];
+            work[i].centroid = boxes[i].isEmpty() ? glm::vec3(0.0f) : boxes[i].center();
+            work[i].item = i;
+        }
+
+        // Uma árvore binária com folhas não vazias tem no máximo 2n - 1 nós
+        mNodes.reserve(2 * static_cast<size_t>(count) - 1);
+        mParents.reserve(2 * static_cast<size_t>(count) - 1);
+
+        Node root;
+        root.firstItem = 0;
+        root.itemCount = count;
+        mNodes.push_back(root);
+        mParents.push_back(0);
+
+        // Pilha explícita de nós a dividir (evita recursão profunda em cenas degeneradas)
+        std::vector<uint32_t> pending{0};
+        while (!pending.empty())
+        {
+            uint32_t nodeIndex = pending.back();
+            pending.pop_back();
+
+            const uint32_t first = mNodes[nodeIndex].firstItem;
+            const uint32_t itemCount = mNodes[nodeIndex].itemCount;
+
+            BoundingBox bounds;
+            BoundingBox centroidBounds;
+            for (uint32_t i = first; i < first + itemCount; ++i)
+            {
+                merge(bounds, work[i].box);
+                centroidBounds.expand(work[i].centroid);
+            }
+            mNodes[nodeIndex].bounds = bounds;
+
+            auto makeLeaf = [&]
+            {
+                for (uint32_t i = first; i < first + itemCount; ++i)
+                    mItemLeaf[work[i].item] = nodeIndex;
+            };
+
+            if (itemCount <= 2)
+            {
+                makeLeaf();
+                continue;
+            }
+
+            // =================== SAH POR BINS ===================
+            // Custo de uma divisão: área * kTraversalCost + área(esq) * n(esq) + área(dir) * n(dir);
+            // o da folha é área * n (testar um nó custa o mesmo que testar um item)
+            const float nodeArea = halfArea(bounds);
+            float bestCost = nodeArea * static_cast<float>(itemCount);
+            int bestAxis = -1;
+            int bestSplit = 0;
+            glm::vec3 centroidSize = centroidBounds.max - centroidBounds.min;
+            // Nós pequenos usam menos bins (o custo fixo dos bins dominaria a construção)
+            const int binCount = std::min(kSahBins, static_cast<int>(itemCount));
+
+            // Os três eixos são distribuídos numa única passada pelos itens
+            std::array<std::array<BoundingBox, kSahBins>, 3> axisBinBounds{};
+            std::array<std::array<uint32_t, kSahBins>, 3> axisBinCounts{};
+            glm::vec3 binScale(0.0f);
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (centroidSize[axis] > 0.0f)
+                    binScale[axis] = binCount / centroidSize[axis];
+            }
+            for (uint32_t i = first; i < first + itemCount; ++i)
+            {
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    int bin = std::min(binCount - 1, static_cast<int>((work[i].centroid[axis] - centroidBounds.min[axis]) * binScale[axis]));
+                    ++axisBinCounts[axis][bin];
+                    merge(axisBinBounds[axis][bin], work[i].box);
+                }
+            }
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (centroidSize[axis] <= 0.0f)
+                    continue;
+
+                const std::array<BoundingBox, kSahBins> &binBounds = axisBinBounds[axis];
+                const std::array<uint32_t, kSahBins> &binCounts = axisBinCounts[axis];
+
+                // Varredura da direita para a esquerda: custo de todos os bins à direita de cada plano
+                std::array<float, kSahBins> rightCost{};
+                BoundingBox rightBox;
+                uint32_t rightCount = 0;
+                for (int bin = binCount - 1; bin > 0; --bin)
+                {
+                    merge(rightBox, binBounds[bin]);
+                    rightCount += binCounts[bin];
+                    rightCost[bin - 1] = halfArea(rightBox) * static_cast<float>(rightCount);
+                }
+
+                BoundingBox leftBox;
+                uint32_t leftCount = 0;
+                for (int split = 0; split < binCount - 1; ++split)
+                {
+                    merge(leftBox, binBounds[split]);
+                    leftCount += binCounts[split];
+                    if (leftCount == 0 || leftCount == itemCount)
+                        continue;
+
+                    float cost = nodeArea * kTraversalCost + halfArea(leftBox) * static_cast<float>(leftCount) + rightCost[split];
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = split;
+                    }
+                }
+            }
+
+            uint32_t middle = first;
+            if (bestAxis >= 0)
+            {
+                const float scale = binScale[bestAxis];
+                const float axisMin = centroidBounds.min[bestAxis];
+                auto splitIt = std::partition(work.begin() + first, work.begin() + first + itemCount,
+                                              [&](const BuildItem &entry)
+                                              {
+                                                  int bin = std::min(binCount - 1, static_cast<int>((entry.centroid[bestAxis] - axisMin) * scale));
+                                                  return bin <= bestSplit;
+                                              });
+                middle = static_cast<uint32_t>(splitIt - work.begin());
+            }
+            else if (itemCount > kMaxLeafItems)
+            {
+                // Nenhuma divisão compensa, mas a folha ficaria grande demais: mediana no maior eixo
+                int axis = 0;
+                if (centroidSize.y > centroidSize[axis])
+                    axis = 1;
+                if (centroidSize.z > centroidSize[axis])
+                    axis = 2;
+                middle = first + itemCount / 2;
+                std::nth_element(work.begin() + first, work.begin() + middle, work.begin() + first + itemCount,
+                                 [&](const BuildItem &a, const BuildItem &b)
+                                 { return a.centroid[axis] < b.centroid[axis]; });
+            }
+
+            if (middle == first || middle == first + itemCount)
+            {
+                makeLeaf();
+                continue;
+            }
+
+            // Filhos lado a lado no fim do array (sempre depois do pai)
+            uint32_t left = static_cast<uint32_t>(mNodes.size());
+            Node leftNode;
+            leftNode.firstItem = first;
+            leftNode.itemCount = middle - first;
+            Node rightNode;
+            rightNode.firstItem = middle;
+            rightNode.itemCount = first + itemCount - middle;
+            mNodes.push_back(leftNode);
+            mNodes.push_back(rightNode);
+            mParents.push_back(nodeIndex);
+            mParents.push_back(nodeIndex);
+            mNodes[nodeIndex].left = left;
+
+            pending.push_back(left + 1);
+            pending.push_back(left);
+        }
+
+        mItems.resize(count);
+        for (uint32_t i = 0; i < count; ++i)
+            mItems[i] = work[i].item;
+
+        mNodeDirty.assign(mNodes.size(), 0);
+        for (const Node &node : mNodes)
+            mSahCost += halfArea(node.bounds);
+        mBuildSahCost = mSahCost;
+    }
+
+    // =================== ATUALIZAÇÃO INCREMENTAL ===================
+
+    void Bvh::update(uint32_t item, const BoundingBox &box)
+    {
+        mItemBoxes[item] = box.isEmpty() ? BoundingBox{} : box;
+        uint32_t leaf = mItemLeaf[item];
+        if (!mNodeDirty[leaf])
+        {
+            mNodeDirty[leaf] = 1;
+            mDirtyLeaves.push_back(leaf);
+        }
+    }
+
+    size_t Bvh::refit()
+    {
+        if (mDirtyLeaves.empty())
+            return 0;
+
+        // Marca os ancestrais (para na primeira marca já existente: o resto do caminho já entrou)
+        std::vector<uint32_t> nodes;
+        for (uint32_t leaf : mDirtyLeaves)
+        {
+            nodes.push_back(leaf);
+            uint32_t node = leaf;
+            while (node != 0)
+            {
+                node = mParents[node];
+                if (mNodeDirty[node])
+                    break;
+                mNodeDirty[node] = 1;
+                nodes.push_back(node);
+            }
+        }
+        mDirtyLeaves.clear();
+
+        // Filhos têm índice maior que o pai: ordem decrescente recalcula de baixo para cima
+        std::sort(nodes.begin(), nodes.end(), std::greater<uint32_t>());
+        for (uint32_t node : nodes)
+        {
+            recomputeNode(node);
+            mNodeDirty[node] = 0;
+        }
+        return nodes.size();
+    }
+
+    void Bvh::recomputeNode(uint32_t nodeIndex)
+    {
+        Node &node = mNodes[nodeIndex];
+        BoundingBox bounds;
+        if (node.left == 0)
+        {
+            for (uint32_t i = node.firstItem; i < node.firstItem + node.itemCount; ++i)
+                merge(bounds, mItemBoxes[mItems[i]]);
+        }
+        else
+        {
+            merge(bounds, mNodes[node.left].bounds);
+            merge(bounds, mNodes[node.left + 1].bounds);
+        }
+
+        mSahCost += halfArea(bounds) - halfArea(node.bounds);
+        node.bounds = bounds;
+    }
+
+    // =================== CONSULTAS ===================
+
+    size_t Bvh::cullFrustum(const Frustum &frustum, std::vector<uint32_t> &visible, size_t *nodesVisited) const
+    {
+        visible.clear();
+        size_t visited = 0;
+        if (mNodes.empty())
+        {
+            if (nodesVisited)
+                *nodesVisited = 0;
+            return 0;
+        }
+
+        // Cada entrada leva a máscara dos planos que ainda cortam o pai
+        struct Entry
+        {
+            uint32_t node;
+            uint32_t planeMask;
+        };
+        std::vector<Entry> stack;
+        stack.reserve(64);
+        stack.push_back({0, kAllPlanes});
+
+        while (!stack.empty())
+        {
+            Entry entry = stack.back();
+            stack.pop_back();
+            const Node &node = mNodes[entry.node];
+            ++visited;
+
+            if (node.bounds.isEmpty())
+                continue;
+
+            uint32_t planeMask = entry.planeMask;
+            PlaneTest test = testPlanes(frustum, node.bounds, planeMask);
+            if (test == PlaneTest::Outside)
+                continue;
+
+            if (test == PlaneTest::Inside)
+            {
+                // Subárvore inteira dentro: os itens entram sem testes
+                for (uint32_t i = node.firstItem; i < node.firstItem + node.itemCount; ++i)
+                {
+                    if (!mItemBoxes[mItems[i]].isEmpty())
+                        visible.push_back(mItems[i]);
+                }
+                continue;
+            }
+
+            if (node.left == 0)
+            {
+                for (uint32_t i = node.firstItem; i < node.firstItem + node.itemCount; ++i)
+                {
+                    const BoundingBox &box = mItemBoxes[mItems[i]];
+                    uint32_t itemMask = planeMask;
+                    if (!box.isEmpty() && testPlanes(frustum, box, itemMask) != PlaneTest::Outside)
+                        visible.push_back(mItems[i]);
+                }
+                continue;
+            }
+
+            stack.push_back({node.left + 1, planeMask});
+            stack.push_back({node.left, planeMask});
+        }
+
+        if (nodesVisited)
+            *nodesVisited = visited;
+        return visible.size();
+    }
+
+    void Bvh::queryBox(const BoundingBox &box, std::vector<uint32_t> &results) const
+    {
+        results.clear();
+        if (mNodes.empty() || box.isEmpty())
+            return;
+
+        std::vector<uint32_t> stack{0};
+        while (!stack.empty())
+        {
+            const Node &node = mNodes[stack.back()];
+            stack.pop_back();
+            if (node.bounds.isEmpty() || !overlaps(node.bounds, box))
+                continue;
+
+            if (node.left == 0)
+            {
+                for (uint32_t i = node.firstItem; i < node.firstItem + node.itemCount; ++i)
+                {
+                    const BoundingBox &itemBox = mItemBoxes[mItems[i]];
+                    if (!itemBox.isEmpty() && overlaps(itemBox, box))
+                        results.push_back(mItems[i]);
+                }
+                continue;
+            }
+
+            stack.push_back(node.left + 1);
+            stack.push_back(node.left);
+        }
+    }
+
+    void Bvh::queryRay(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                       std::vector<RayHit> &hits) const
+    {
+        hits.clear();
+        if (mNodes.empty())
+            return;
+
+        // Componentes nulas viram um inverso enorme com o mesmo sinal (evita 0 * inf = NaN no slab)
+        glm::vec3 inverseDirection;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float d = direction[axis];
+            inverseDirection[axis] = std::abs(d) > 1e-20f ? 1.0f / d : std::copysign(1e30f, d);
+        }
+
+        std::vector<uint32_t> stack{0};
+        while (!stack.empty())
+        {
+            const Node &node = mNodes[stack.back()];
+            stack.pop_back();
+            if (node.bounds.isEmpty() || intersectRay(node.bounds, origin, inverseDirection, maxDistance) < 0.0f)
+                continue;
+
+            if (node.left == 0)
+            {
+                for (uint32_t i = node.firstItem; i < node.firstItem + node.itemCount; ++i)
+                {
+                    const BoundingBox &itemBox = mItemBoxes[mItems[i]];
+                    if (itemBox.isEmpty())
+                        continue;
+                    float distance = intersectRay(itemBox, origin, inverseDirection, maxDistance);
+                    if (distance >= 0.0f)
+                        hits.push_back({mItems[i], distance});
+                }
+                continue;
+            }
+
+            stack.push_back(node.left + 1);
+            stack.push_back(node.left);
+        }
+
+        std::sort(hits.begin(), hits.end(), [](const RayHit &a, const RayHit &b)
+                  { return a.distance < b.distance; });
+    }
+
+    uint32_t Bvh::closestHit(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                             const std::function<float(uint32_t item, float maxDistance)> &intersect,
+                             float *hitDistance) const
+    {
+        uint32_t best = kNoItem;
+        if (mNodes.empty())
+            return best;
+
+        glm::vec3 inverseDirection;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float d = direction[axis];
+            inverseDirection[axis] = std::abs(d) > 1e-20f ? 1.0f / d : std::copysign(1e30f, d);
+        }
+
+        // Pilha reaproveitada entre chamadas da mesma thread (muitos raios por bake)
+        thread_local std::vector<uint32_t> stack;
+        stack.clear();
+        if (intersectRay(mNodes[0].bounds, origin, inverseDirection, maxDistance) >= 0.0f)
+            stack.push_back(0);
+
+        while (!stack.empty())
+        {
+            const Node &node = mNodes[stack.back()];
+            stack.pop_back();
+            if (intersectRay(node.bounds, origin, inverseDirection, maxDistance) < 0.0f)
+                continue; // o raio foi encurtado depois que o nó foi empilhado
+
+            if (node.left == 0)
+            {
+                for (uint32_t i = node.firstItem; i < node.firstItem + node.itemCount; ++i)
+                {
+                    uint32_t item = mItems[i];
+                    if (mItemBoxes[item].isEmpty() ||
+                        intersectRay(mItemBoxes[item], origin, inverseDirection, maxDistance) < 0.0f)
+                        continue;
+                    float distance = intersect(item, maxDistance);
+                    if (distance >= 0.0f && distance <= maxDistance)
+                    {
+                        maxDistance = distance;
+                        best = item;
+                    }
+                }
+                continue;
+            }
+
+            float nearDistance = mNodes[node.left].bounds.isEmpty()
+                                     ? -1.0f
+                                     : intersectRay(mNodes[node.left].bounds, origin, inverseDirection, maxDistance);
+            float farDistance = mNodes[node.left + 1].bounds.isEmpty()
+                                    ? -1.0f
+                                    : intersectRay(mNodes[node.left + 1].bounds, origin, inverseDirection, maxDistance);
+            uint32_t nearChild = node.left;
+            uint32_t farChild = node.left + 1;
+            if (farDistance >= 0.0f && (nearDistance < 0.0f || farDistance < nearDistance))
+            {
+                std::swap(nearChild, farChild);
+                std::swap(nearDistance, farDistance);
+            }
+
+            // O mais próximo fica no topo da pilha
+            if (farDistance >= 0.0f)
+                stack.push_back(farChild);
+            if (nearDistance >= 0.0f)
+                stack.push_back(nearChild);
+        }
+
+        if (hitDistance && best != kNoItem)
+            *hitDistance = maxDistance;
+        return best;
+    }
+
+} // namespace cg
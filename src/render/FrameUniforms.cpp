@@ -0,0 +1,68 @@
+#include "render/FrameUniforms.h"
+#include <glad/glad.h>
+
+namespace cg
+{
+
+    namespace
+    {
+        // Mesma ordem e tipos de FrameUniforms::Data
+        const char *kFrameBlockSource = R"GLSL(
+        layout(std140) uniform FrameUniforms {
+            mat4 uView;
+            mat4 uProjection;
+            mat4 uViewProjection;
+            vec4 uCameraPos;
+            vec4 uLightPos;
+            vec4 uLightColor;
+        };
+    )GLSL";
+
+        static_assert(sizeof(FrameUniforms::Data) == 3 * 64 + 3 * 16, "FrameUniforms::Data deve seguir o layout std140");
+    } // namespace
+
+    FrameUniforms::~FrameUniforms()
+    {
+        cleanup();
+    }
+
+    const char *FrameUniforms::glslBlock()
+    {
+        return kFrameBlockSource;
+    }
+
+    bool FrameUniforms::init()
+    {
+        if (mBuffer == 0)
+        {
+            glGenBuffers(1, &mBuffer);
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, mBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(Data), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        return mBuffer != 0;
+    }
+
+    void FrameUniforms::update(const Data &data)
+    {
+        mData = data;
+
+        // Reespecifica o armazenamento a cada frame: o driver troca o bloco em vez
+        // de esperar a GPU terminar de ler o do frame anterior
+        glBindBuffer(GL_UNIFORM_BUFFER, mBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(Data), &mData, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        glBindBufferBase(GL_UNIFORM_BUFFER, kBindingPoint, mBuffer);
+    }
+
+    void FrameUniforms::cleanup()
+    {
+        if (mBuffer)
+        {
+            glDeleteBuffers(1, &mBuffer);
+            mBuffer = 0;
+        }
+    }
+
+} // namespace cg
@@ -0,0 +1,224 @@
+#include "render/FrustumCuller.h"
+#include "core/Simd.h"
+#include <cmath>
+#include <limits>
+
+namespace cg
+{
+
+    // =================== FRUSTUM ===================
+
+    Frustum Frustum::fromMatrix(const glm::mat4 &m)
+    {
+        // Linhas da matriz (glm armazena por colunas)
+        glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+        Frustum frustum;
+        frustum.planes = {row3 + row0, row3 - row0,  // esquerda, direita
+                          row3 + row1, row3 - row1,  // baixo, cima
+                          row3 + row2, row3 - row2}; // perto, longe (clip z em [-w, w])
+
+        for (glm::vec4 &plane : frustum.planes)
+        {
+            float length = glm::length(glm::vec3(plane));
+            if (length > 0.0f)
+                plane = plane / length;
+        }
+        return frustum;
+    }
+
+    bool Frustum::intersects(const BoundingBox &box) const
+    {
+        if (box.isEmpty())
+            return false;
+
+        glm::vec3 center = box.center();
+        glm::vec3 extents = box.extents();
+        for (const glm::vec4 &plane : planes)
+        {
+            glm::vec3 normal(plane);
+            float distance = glm::dot(normal, center) + plane.w;
+            float radius = glm::dot(glm::abs(normal), extents);
+            if (distance + radius < 0.0f)
+                return false;
+        }
+        return true;
+    }
+
+    // =================== CULLING EM LOTE ===================
+
+    void FrustumCuller::clear()
+    {
+        mCenterX.clear();
+        mCenterY.clear();
+        mCenterZ.clear();
+        mExtentX.clear();
+        mExtentY.clear();
+        mExtentZ.clear();
+    }
+
+    void FrustumCuller::reserve(size_t count)
+    {
+        mCenterX.reserve(count);
+        mCenterY.reserve(count);
+        mCenterZ.reserve(count);
+        mExtentX.reserve(count);
+        mExtentY.reserve(count);
+        mExtentZ.reserve(count);
+    }
+
+    uint32_t FrustumCuller::add(const BoundingBox &worldBox)
+    {
+        mCenterX.push_back(0.0f);
+        mCenterY.push_back(0.0f);
+        mCenterZ.push_back(0.0f);
+        mExtentX.push_back(0.0f);
+        mExtentY.push_back(0.0f);
+        mExtentZ.push_back(0.0f);
+
+        uint32_t index = static_cast<uint32_t>(mCenterX.size() - 1);
+        set(index, worldBox);
+        return index;
+    }
+
+    void FrustumCuller::set(uint32_t index, const BoundingBox &worldBox)
+    {
+        // Caixa vazia: centro NaN faz todas as comparações falharem (sempre descartada)
+        glm::vec3 center = worldBox.isEmpty() ? glm::vec3(std::numeric_limits<float>::quiet_NaN()) : worldBox.center();
+        glm::vec3 extents = worldBox.isEmpty() ? glm::vec3(0.0f) : worldBox.extents();
+
+        mCenterX[index] = center.x;
+        mCenterY[index] = center.y;
+        mCenterZ[index] = center.z;
+        mExtentX[index] = extents.x;
+        mExtentY[index] = extents.y;
+        mExtentZ[index] = extents.z;
+    }
+
+    size_t FrustumCuller::cull(const Frustum &frustum, std::vector<uint32_t> &visible) const
+    {
+        visible.clear();
+        const size_t count = size();
+        size_t i = 0;
+
+#if defined(CG_SIMD_AVX)
+        // Planos replicados nas 8 lanes, com |n| para a projeção da meia extensão
+        __m256 nx[6], ny[6], nz[6], nw[6], ax[6], ay[6], az[6];
+        for (int p = 0; p < 6; ++p)
+        {
+            const glm::vec4 &plane = frustum.planes[p];
+            nx[p] = _mm256_set1_ps(plane.x);
+            ny[p] = _mm256_set1_ps(plane.y);
+            nz[p] = _mm256_set1_ps(plane.z);
+            nw[p] = _mm256_set1_ps(plane.w);
+            ax[p] = _mm256_set1_ps(std::abs(plane.x));
+            ay[p] = _mm256_set1_ps(std::abs(plane.y));
+            az[p] = _mm256_set1_ps(std::abs(plane.z));
+        }
+        const __m256 zero = _mm256_setzero_ps();
+
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 cx = _mm256_loadu_ps(&mCenterX[i]);
+            __m256 cy = _mm256_loadu_ps(&mCenterY[i]);
+            __m256 cz = _mm256_loadu_ps(&mCenterZ[i]);
+            __m256 ex = _mm256_loadu_ps(&mExtentX[i]);
+            __m256 ey = _mm256_loadu_ps(&mExtentY[i]);
+            __m256 ez = _mm256_loadu_ps(&mExtentZ[i]);
+
+            __m256 inside = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ); // todos os bits em 1
+            for (int p = 0; p < 6; ++p)
+            {
+                // distância do centro + raio projetado no normal: < 0 significa totalmente fora
+                // (mesma ordem de soma da versão escalar, para resultados idênticos)
+                __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx[p], cx), _mm256_mul_ps(ny[p], cy)),
+                                                              _mm256_mul_ps(nz[p], cz)),
+                                                nw[p]);
+                __m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax[p], ex), _mm256_mul_ps(ay[p], ey)),
+                                              _mm256_mul_ps(az[p], ez));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+            }
+
+            int mask = _mm256_movemask_ps(inside);
+            for (int lane = 0; mask != 0; ++lane, mask >>= 1)
+            {
+                if (mask & 1)
+                    visible.push_back(static_cast<uint32_t>(i + lane));
+            }
+        }
+#elif defined(CG_SIMD_SSE)
+        __m128 nx[6], ny[6], nz[6], nw[6], ax[6], ay[6], az[6];
+        for (int p = 0; p < 6; ++p)
+        {
+            const glm::vec4 &plane = frustum.planes[p];
+            nx[p] = _mm_set1_ps(plane.x);
+            ny[p] = _mm_set1_ps(plane.y);
+            nz[p] = _mm_set1_ps(plane.z);
+            nw[p] = _mm_set1_ps(plane.w);
+            ax[p] = _mm_set1_ps(std::abs(plane.x));
+            ay[p] = _mm_set1_ps(std::abs(plane.y));
+            az[p] = _mm_set1_ps(std::abs(plane.z));
+        }
+        const __m128 zero = _mm_setzero_ps();
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 cx = _mm_loadu_ps(&mCenterX[i]);
+            __m128 cy = _mm_loadu_ps(&mCenterY[i]);
+            __m128 cz = _mm_loadu_ps(&mCenterZ[i]);
+            __m128 ex = _mm_loadu_ps(&mExtentX[i]);
+            __m128 ey = _mm_loadu_ps(&mExtentY[i]);
+            __m128 ez = _mm_loadu_ps(&mExtentZ[i]);
+
+            __m128 inside = _mm_cmpeq_ps(zero, zero); // todos os bits em 1
+            for (int p = 0; p < 6; ++p)
+            {
+                // distância do centro + raio projetado no normal: < 0 significa totalmente fora
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)),
+                                                        _mm_mul_ps(nz[p], cz)),
+                                             nw[p]);
+                __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[p], ex), _mm_mul_ps(ay[p], ey)),
+                                           _mm_mul_ps(az[p], ez));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+            }
+
+            int mask = _mm_movemask_ps(inside);
+            for (int lane = 0; mask != 0; ++lane, mask >>= 1)
+            {
+                if (mask & 1)
+                    visible.push_back(static_cast<uint32_t>(i + lane));
+            }
+        }
+#endif
+
+        // Versão escalar (ou o resto que não completou um lote)
+        cullScalar(frustum, i, visible);
+        return visible.size();
+    }
+
+    void FrustumCuller::cullScalar(const Frustum &frustum, size_t first, std::vector<uint32_t> &visible) const
+    {
+        for (size_t i = first; i < size(); ++i)
+        {
+            bool inside = true;
+            for (const glm::vec4 &plane : frustum.planes)
+            {
+                float distance = plane.x * mCenterX[i] + plane.y * mCenterY[i] + plane.z * mCenterZ[i] + plane.w;
+                float radius = std::abs(plane.x) * mExtentX[i] + std::abs(plane.y) * mExtentY[i] +
+                               std::abs(plane.z) * mExtentZ[i];
+                // Escrito como !(>= 0) para que NaN (caixa vazia) também seja descartado
+                if (!(distance + radius >= 0.0f))
+                {
+                    inside = false;
+                    break;
+                }
+            }
+            if (inside)
+                visible.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+} // namespace cg
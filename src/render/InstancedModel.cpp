@@ -0,0 +1,182 @@
+#include "render/InstancedModel.h"
+#include <cstddef>
+#include <limits>
+
+namespace cg
+{
+
+    InstancedModel::InstancedModel(std::unique_ptr<Mesh> mesh, const std::string &name)
+        : mMesh(std::move(mesh)), mName(name.empty() && mMesh ? mMesh->name : name)
+    {
+        // =================== VAO ===================
+        // Atributos da mesh a partir do VBO/EBO dela, mais os atributos por instância
+        glGenVertexArrays(1, &mVAO);
+        glGenBuffers(1, &mInstanceVBO);
+
+        glBindVertexArray(mVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, mMesh->getVertexBuffer());
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mMesh->getIndexBuffer());
+        mMesh->getVertexLayout().setupAttributes();
+
+        glBindBuffer(GL_ARRAY_BUFFER, mInstanceVBO);
+        for (GLuint column = 0; column < 4; ++column)
+        {
+            GLuint location = kTransformLocation + column;
+            glEnableVertexAttribArray(location);
+            glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(GpuInstance),
+                                  reinterpret_cast<const void *>(offsetof(GpuInstance, transform) + column * sizeof(glm::vec4)));
+            glVertexAttribDivisor(location, 1);
+        }
+        for (GLuint column = 0; column < 3; ++column)
+        {
+            GLuint location = kNormalMatrixLocation + column;
+            glEnableVertexAttribArray(location);
+            glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, sizeof(GpuInstance),
+                                  reinterpret_cast<const void *>(offsetof(GpuInstance, normalMatrix) + column * sizeof(glm::vec3)));
+            glVertexAttribDivisor(location, 1);
+        }
+        glEnableVertexAttribArray(kColorLocation);
+        glVertexAttribPointer(kColorLocation, 4, GL_FLOAT, GL_FALSE, sizeof(GpuInstance),
+                              reinterpret_cast<const void *>(offsetof(GpuInstance, color)));
+        glVertexAttribDivisor(kColorLocation, 1);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+    InstancedModel::~InstancedModel()
+    {
+        if (mVAO)
+        {
+            glDeleteVertexArrays(1, &mVAO);
+        }
+        if (mInstanceVBO)
+        {
+            glDeleteBuffers(1, &mInstanceVBO);
+        }
+    }
+
+    BoundingBox InstancedModel::instanceBox(const glm::mat4 &transform) const
+    {
+        return transformBox(mMesh->getBoundingBox(), transform);
+    }
+
+    uint32_t InstancedModel::addInstance(const glm::mat4 &transform, const glm::vec4 &color)
+    {
+        mInstances.push_back({transform, color});
+        if (!mCullerDirty)
+        {
+            mCuller.add(instanceBox(transform));
+        }
+        return static_cast<uint32_t>(mInstances.size() - 1);
+    }
+
+    void InstancedModel::setInstance(uint32_t index, const glm::mat4 &transform, const glm::vec4 &color)
+    {
+        mInstances[index] = {transform, color};
+        if (!mCullerDirty)
+        {
+            mCuller.set(index, instanceBox(transform));
+        }
+    }
+
+    void InstancedModel::removeInstance(uint32_t index)
+    {
+        mInstances[index] = mInstances.back();
+        mInstances.pop_back();
+        mCullerDirty = true;
+    }
+
+    void InstancedModel::clearInstances()
+    {
+        mInstances.clear();
+        mCuller.clear();
+        mCullerDirty = false;
+    }
+
+    size_t InstancedModel::cullAndUpload(const Frustum *frustum, const glm::vec3 &cameraPosition)
+    {
+        if (mCullerDirty)
+        {
+            mCuller.clear();
+            mCuller.reserve(mInstances.size());
+            for (const Instance &instance : mInstances)
+            {
+                mCuller.add(instanceBox(instance.transform));
+            }
+            mCullerDirty = false;
+        }
+
+        // =================== CULLING ===================
+        if (frustum)
+        {
+            mCuller.cull(*frustum, mVisible);
+        }
+        else
+        {
+            mVisible.resize(mInstances.size());
+            for (uint32_t i = 0; i < mVisible.size(); ++i)
+            {
+                mVisible[i] = i;
+            }
+        }
+
+        // =================== COMPACTAÇÃO ===================
+        // Visíveis no início do buffer; a mais próxima serve de referência para o LOD
+        mStaging.resize(mVisible.size());
+        mVisibleMatrices.resize(mVisible.size());
+        float nearestDistance = std::numeric_limits<float>::max();
+        for (size_t i = 0; i < mVisible.size(); ++i)
+        {
+            const Instance &instance = mInstances[mVisible[i]];
+            mStaging[i].transform = mMesh->getDrawMatrix(instance.transform);
+            mStaging[i].color = instance.color;
+            mVisibleMatrices.set(i, mStaging[i].transform);
+
+            glm::vec3 delta = glm::vec3(instance.transform[3]) - cameraPosition;
+            float distance = glm::dot(delta, delta);
+            if (distance < nearestDistance)
+            {
+                nearestDistance = distance;
+                mNearestTransform = instance.transform;
+            }
+        }
+        mVisibleCount = mVisible.size();
+
+        if (mVisibleCount == 0)
+        {
+            return 0;
+        }
+
+        // =================== MATRIZES NORMAIS ===================
+        // Em lote na CPU (o shader não inverte matrizes por vértice)
+        TransformKernel::normalMatrices(mVisibleMatrices, mVisibleNormals);
+        for (size_t i = 0; i < mVisibleCount; ++i)
+        {
+            mStaging[i].normalMatrix = mVisibleNormals.get(i);
+        }
+
+        // =================== UPLOAD ===================
+        // Reespecificar o armazenamento evita esperar a GPU terminar o frame anterior
+        glBindBuffer(GL_ARRAY_BUFFER, mInstanceVBO);
+        if (mInstances.size() > mInstanceCapacity)
+        {
+            mInstanceCapacity = mInstances.size();
+        }
+        glBufferData(GL_ARRAY_BUFFER, mInstanceCapacity * sizeof(GpuInstance), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, mVisibleCount * sizeof(GpuInstance), mStaging.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        return mVisibleCount;
+    }
+
+    void InstancedModel::drawElements() const
+    {
+        if (mVisibleCount > 0)
+        {
+            mMesh->drawElementsInstanced(static_cast<GLsizei>(mVisibleCount));
+        }
+    }
+
+} // namespace cg
@@ -12,7 +12,7 @@ namespace cg
     {
 
         // Configura os buffers OpenGL para esta mesh
-        setupMesh();
+        setupMesh(VertexFormat::Standard);
 
         std::string materialInfo = material ? " com material " + material->getName() : " sem material";
         std::cout << "Mesh criada: " << name
@@ -21,13 +21,58 @@ namespace cg
                   << materialInfo << std::endl;
     }
 
+    Mesh::Mesh(MeshData &&data, VertexFormat format, CpuResidency residency)
+        : vertices(std::move(data.vertices)), indices(std::move(data.indices)), name(std::move(data.name)),
+          material(std::move(data.material)), mBounds(data.bounds), mLocalTransform(data.localTransform)
+    {
+        // Upload para a GPU a partir dos arrays já prontos na CPU
+        setupMesh(format, data.lods);
+        data.lods.clear();
+
+        std::string materialInfo = material ? " com material " + material->getName() : " sem material";
+        std::cout << "Mesh criada: " << name
+                  << " (Vértices: " << getVertexCount()
+                  << ", Triângulos: " << getTriangleCount() << ")"
+                  << materialInfo << std::endl;
+
+        // A cópia na CPU não é mais necessária para desenhar
+        setCpuResidency(residency);
+    }
+
+    Mesh::Mesh(MeshData &&data, const Mesh &geometry, CpuResidency residency)
+        : vertices(std::move(data.vertices)), indices(std::move(data.indices)), name(std::move(data.name)),
+          material(std::move(data.material)), mVAO(geometry.mVAO), mVBO(geometry.mVBO), mEBO(geometry.mEBO),
+          mBuffers(geometry.mBuffers), mLayout(geometry.mLayout), mQuantization(geometry.mQuantization),
+          mIndexType(geometry.mIndexType), mBufferBytes(geometry.mBufferBytes), mSharedGeometry(true),
+          mGeometryOffset(data.geometryOffset), mLods(geometry.mLods), mBounds(data.bounds),
+          mVertexCount(geometry.mVertexCount), mLocalTransform(data.localTransform)
+    {
+        // Os LODs são os da geometria compartilhada (mesmos índices)
+        data.lods.clear();
+        if (mBounds.box.isEmpty())
+        {
+            mBounds = geometry.mBounds;
+            mBounds.box.min += mGeometryOffset;
+            mBounds.box.max += mGeometryOffset;
+            mBounds.sphere.center += mGeometryOffset;
+        }
+
+        std::cout << "Mesh criada: " << name << " (geometria compartilhada com " << geometry.name << ")" << std::endl;
+
+        setCpuResidency(residency);
+    }
+
     Mesh::~Mesh()
     {
         cleanup();
     }
 
     Mesh::Mesh(Mesh &&other) noexcept
-        : vertices(std::move(other.vertices)), indices(std::move(other.indices)), name(std::move(other.name)), material(std::move(other.material)), mVAO(other.mVAO), mVBO(other.mVBO), mEBO(other.mEBO)
+        : vertices(std::move(other.vertices)), indices(std::move(other.indices)), positions(std::move(other.positions)), name(std::move(other.name)), material(std::move(other.material)), mVAO(other.mVAO), mVBO(other.mVBO), mEBO(other.mEBO),
+          mBuffers(std::move(other.mBuffers)), mLayout(other.mLayout), mQuantization(other.mQuantization), mIndexType(other.mIndexType), mBufferBytes(other.mBufferBytes),
+          mSharedGeometry(other.mSharedGeometry), mGeometryOffset(other.mGeometryOffset),
+          mLods(std::move(other.mLods)), mActiveLod(other.mActiveLod), mBounds(other.mBounds), mVertexCount(other.mVertexCount),
+          mResidency(other.mResidency), mLocalTransform(other.mLocalTransform), mTransformVersion(other.mTransformVersion)
     {
 
         // Zera os recursos do objeto movido para evitar double-deletion
@@ -46,11 +91,26 @@ namespace cg
             // Move dados do outro objeto
             vertices = std::move(other.vertices);
             indices = std::move(other.indices);
+            positions = std::move(other.positions);
             name = std::move(other.name);
             material = std::move(other.material);
             mVAO = other.mVAO;
             mVBO = other.mVBO;
             mEBO = other.mEBO;
+            mBuffers = std::move(other.mBuffers);
+            mLayout = other.mLayout;
+            mQuantization = other.mQuantization;
+            mIndexType = other.mIndexType;
+            mBufferBytes = other.mBufferBytes;
+            mSharedGeometry = other.mSharedGeometry;
+            mGeometryOffset = other.mGeometryOffset;
+            mLods = std::move(other.mLods);
+            mActiveLod = other.mActiveLod;
+            mBounds = other.mBounds;
+            mVertexCount = other.mVertexCount;
+            mResidency = other.mResidency;
+            mLocalTransform = other.mLocalTransform;
+            mTransformVersion = std::max(mTransformVersion, other.mTransformVersion) + 1;
 
             // Zera recursos do objeto movido
             other.mVAO = 0;
@@ -60,79 +120,210 @@ namespace cg
         return *this;
     }
 
-    void Mesh::setupMesh()
+    void Mesh::setupMesh(VertexFormat format, const std::vector<MeshLod> &lods)
     {
+        // Volumes envolventes: normalmente já vêm do ModelLoader; meshes montadas à mão calculam aqui
+        mVertexCount = vertices.size();
+        if (mBounds.box.isEmpty())
+        {
+            mBounds = computeMeshBounds(vertices.data(), vertices.size());
+        }
+
+        mLayout = &cg::getVertexLayout(format);
+        if (mLayout->quantizedPosition)
+        {
+            // Posições guardadas relativas à AABB da mesh
+            mQuantization = QuantizationParams::fromBounds(mBounds.box);
+        }
+
         // =================== GERAÇÃO DE BUFFERS ===================
-        glGenVertexArrays(1, &mVAO);
-        glGenBuffers(1, &mVBO);
-        glGenBuffers(1, &mEBO);
+        mBuffers = std::make_shared<GpuBuffers>();
+        glGenVertexArrays(1, &mBuffers->vao);
+        glGenBuffers(1, &mBuffers->vbo);
+        glGenBuffers(1, &mBuffers->ebo);
+        mVAO = mBuffers->vao;
+        mVBO = mBuffers->vbo;
+        mEBO = mBuffers->ebo;
 
         // =================== CONFIGURAÇÃO DO VAO ===================
         glBindVertexArray(mVAO);
 
         // =================== CONFIGURAÇÃO DO VBO (VÉRTICES) ===================
         glBindBuffer(GL_ARRAY_BUFFER, mVBO);
-        glBufferData(GL_ARRAY_BUFFER,
-                     vertices.size() * sizeof(Vertex),
-                     vertices.data(),
-                     GL_STATIC_DRAW);
+        size_t vertexBytes = vertices.size() * mLayout->stride;
+        if (mLayout->id == StandardVertexLayout::id)
+        {
+            // Formato padrão: envia os vértices sem conversão
+            glBufferData(GL_ARRAY_BUFFER, vertexBytes, vertices.data(), GL_STATIC_DRAW);
+        }
+        else
+        {
+            std::vector<uint8_t> packed(vertexBytes);
+            mLayout->encode(vertices.data(), vertices.size(), mQuantization, packed.data());
+            glBufferData(GL_ARRAY_BUFFER, vertexBytes, packed.data(), GL_STATIC_DRAW);
+        }
 
         // =================== CONFIGURAÇÃO DO EBO (ÍNDICES) ===================
+        // LOD 0 seguido dos demais níveis; índices de 16 bits quando todos os vértices cabem neles
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                     indices.size() * sizeof(GLuint),
-                     indices.data(),
-                     GL_STATIC_DRAW);
+        mIndexType = cg::getIndexType(vertices.size());
+        size_t indexSize = mIndexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(GLuint);
 
-        // =================== CONFIGURAÇÃO DE ATRIBUTOS DE VÉRTICE ===================
-
-        // Atributo 0: Posição (vec3)
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, position));
+        size_t totalIndices = indices.size();
+        for (const MeshLod &lod : lods)
+        {
+            totalIndices += lod.indices.size();
+        }
+        size_t indexBytes = totalIndices * indexSize;
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, nullptr, GL_STATIC_DRAW);
 
-        // Atributo 1: Normal (vec3)
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, normal));
+        mLods.clear();
+        mActiveLod = 0;
+        std::vector<uint16_t> shortIndices;
+        auto uploadLevel = [&](const std::vector<GLuint> &levelIndices, float error)
+        {
+            size_t offset = mLods.empty() ? 0 : mLods.back().byteOffset + mLods.back().indexCount * indexSize;
+            mLods.push_back({static_cast<GLsizei>(levelIndices.size()), offset, error});
+            if (mIndexType == GL_UNSIGNED_SHORT)
+            {
+                shortIndices.assign(levelIndices.begin(), levelIndices.end());
+                glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, shortIndices.size() * indexSize, shortIndices.data());
+            }
+            else
+            {
+                glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, levelIndices.size() * indexSize, levelIndices.data());
+            }
+        };
+        uploadLevel(indices, 0.0f);
+        for (const MeshLod &lod : lods)
+        {
+            uploadLevel(lod.indices, lod.error);
+        }
 
-        // Atributo 2: Coordenadas de textura (vec2)
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, texCoords));
+        // =================== CONFIGURAÇÃO DE ATRIBUTOS DE VÉRTICE ===================
+        // Posição (0), normal (1) e coordenadas de textura (2), conforme o layout
+        mLayout->setupAttributes();
 
         // =================== DESVINCULAÇÃO (BOA PRÁTICA) ===================
         glBindVertexArray(0);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+        mBufferBytes = vertexBytes + indexBytes;
+    }
+
+    void Mesh::setCpuResidency(CpuResidency residency)
+    {
+        if (residency <= mResidency)
+            return; // nada a liberar (ou os dados já foram liberados)
+
+        if (residency == CpuResidency::KeepPositionsOnly)
+        {
+            positions.resize(vertices.size());
+            for (size_t i = 0; i < vertices.size(); ++i)
+            {
+                positions[i] = vertices[i].position;
+            }
+        }
+        else
+        {
+            std::vector<GLuint>().swap(indices);
+            std::vector<glm::vec3>().swap(positions);
+        }
+        std::vector<Vertex>().swap(vertices);
+        mResidency = residency;
+    }
+
+    size_t Mesh::getCpuMemoryBytes() const
+    {
+        return vertices.capacity() * sizeof(Vertex) + indices.capacity() * sizeof(GLuint) +
+               positions.capacity() * sizeof(glm::vec3);
     }
 
     void Mesh::draw() const
     {
+        if (!mVAO)
+        {
+            return; // geometria entregue ao lote estático
+        }
+
         // Vincula o VAO que contém toda a configuração desta mesh
         glBindVertexArray(mVAO);
 
-        // Desenha os triângulos usando os índices
-        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
+        drawElements();
 
         // Desvincula o VAO (boa prática)
         glBindVertexArray(0);
     }
 
+    void Mesh::drawElements() const
+    {
+        // Desenha os triângulos do nível de detalhe ativo
+        const LodRange &lod = mLods[mActiveLod];
+        glDrawElements(GL_TRIANGLES, lod.indexCount, mIndexType, reinterpret_cast<const void *>(lod.byteOffset));
+    }
+
+    void Mesh::drawElementsInstanced(GLsizei instanceCount) const
+    {
+        const LodRange &lod = mLods[mActiveLod];
+        glDrawElementsInstanced(GL_TRIANGLES, lod.indexCount, mIndexType, reinterpret_cast<const void *>(lod.byteOffset),
+                                instanceCount);
+    }
+
     void Mesh::cleanup()
+    {
+        // Os buffers são liberados quando a última mesh que os usa deixa de existir
+        mBuffers.reset();
+        mVAO = 0;
+        mVBO = 0;
+        mEBO = 0;
+    }
+
+    void Mesh::releaseGpuGeometry()
+    {
+        if (!mBuffers || isGeometryShared())
+        {
+            return;
+        }
+
+        // mBufferBytes é mantido: getIndexBufferBytes() continua válido para o lote
+        cleanup();
+    }
+
+    void Mesh::restoreGpuGeometry(GLuint vbo, GLuint ebo)
+    {
+        mBuffers = std::make_shared<GpuBuffers>();
+        mBuffers->vbo = vbo;
+        mBuffers->ebo = ebo;
+        glGenVertexArrays(1, &mBuffers->vao);
+        mVAO = mBuffers->vao;
+        mVBO = vbo;
+        mEBO = ebo;
+
+        // Os vértices voltam do lote no layout original da mesh (mLayout e mQuantization não mudaram)
+        glBindVertexArray(mVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
+        mLayout->setupAttributes();
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+    Mesh::GpuBuffers::~GpuBuffers()
     {
         // Libera recursos OpenGL se ainda não foram liberados
-        if (mEBO)
+        if (ebo)
         {
-            glDeleteBuffers(1, &mEBO);
-            mEBO = 0;
+            glDeleteBuffers(1, &ebo);
         }
-        if (mVBO)
+        if (vbo)
         {
-            glDeleteBuffers(1, &mVBO);
-            mVBO = 0;
+            glDeleteBuffers(1, &vbo);
         }
-        if (mVAO)
+        if (vao)
         {
-            glDeleteVertexArrays(1, &mVAO);
-            mVAO = 0;
+            glDeleteVertexArrays(1, &vao);
         }
     }
 
@@ -0,0 +1,552 @@
+#include "render/MeshCache.h"
+#include "render/Material.h"
+#include "core/MappedFile.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+
+namespace cg
+{
+
+    namespace
+    {
+        // =================== LAYOUT DO ARQUIVO ===================
+        // [CacheHeader][dependências][payload]
+        // dependências: por arquivo .mtl, caminho, existe, tamanho, data e hash.
+        // payload: materiais, depois meshes (nome, material, transformação, vértices, índices,
+        // níveis de detalhe).
+        // Blocos de vértices/índices são alinhados em 16 bytes relativos ao início do arquivo,
+        // para que possam ser usados direto das páginas mapeadas.
+
+        constexpr char kMagic[4] = {'C', 'G', 'M', 'C'};
+        constexpr uint32_t kEndianMarker = 0x01020304u;
+        constexpr size_t kBlockAlignment = 16;
+
+        struct CacheHeader
+        {
+            char magic[4];
+            uint32_t endianMarker;
+            uint32_t formatVersion;
+            uint32_t loaderVersion;
+            uint32_t vertexSize;      // sizeof(Vertex) no momento da escrita
+            uint32_t processingFlags; // Pós-processamento aplicado às meshes (0 = nenhum)
+            uint32_t dependencyCount;     // Bibliotecas .mtl registradas
+            uint32_t dependencyTableSize; // Bytes da tabela de dependências
+            uint64_t sourceSize;
+            int64_t sourceMtime;
+            uint64_t sourceHash;
+            uint64_t dependencyHash; // Checksum da tabela de dependências
+            uint64_t payloadSize;
+            uint64_t payloadHash;
+        };
+        static_assert(sizeof(CacheHeader) % kBlockAlignment == 0, "CacheHeader deve manter o alinhamento dos blocos");
+
+        struct MaterialRecord
+        {
+            uint32_t type;
+            float albedo[3];
+            float specular[3];
+            float shininess;
+            float alpha;
+            float emissive[3];
+            float indexOfRefraction;
+        };
+
+        uint64_t rotl(uint64_t x, int r)
+        {
+            return (x << r) | (x >> (64 - r));
+        }
+
+        uint64_t fmix64(uint64_t k)
+        {
+            k ^= k >> 33;
+            k *= 0xFF51AFD7ED558CCDull;
+            k ^= k >> 33;
+            k *= 0xC4CEB9FE1A85EC53ull;
+            k ^= k >> 33;
+            return k;
+        }
+
+        // Escritor sequencial que mantém o deslocamento para alinhar blocos
+        class BlobWriter
+        {
+        public:
+            explicit BlobWriter(std::vector<char> &out, size_t baseOffset) : mOut(out), mBase(baseOffset) {}
+
+            void bytes(const void *data, size_t size)
+            {
+                const char *p = static_cast<const char *>(data);
+                mOut.insert(mOut.end(), p, p + size);
+            }
+
+            template <typename T>
+            void value(const T &v) { bytes(&v, sizeof(T)); }
+
+            void string(const std::string &s)
+            {
+                value(static_cast<uint32_t>(s.size()));
+                bytes(s.data(), s.size());
+            }
+
+            void align()
+            {
+                while ((mBase + mOut.size()) % kBlockAlignment != 0)
+                    mOut.push_back('\0');
+            }
+
+        private:
+            std::vector<char> &mOut;
+            size_t mBase;
+        };
+
+        // Leitor com verificação de limites sobre o buffer mapeado
+        class BlobReader
+        {
+        public:
+            BlobReader(const char *begin, const char *cursor, const char *end)
+                : mBegin(begin), mCursor(cursor), mEnd(end) {}
+
+            bool ok() const { return mOk; }
+
+            const char *take(size_t size)
+            {
+                if (!mOk || static_cast<size_t>(mEnd - mCursor) < size)
+                {
+                    mOk = false;
+                    return nullptr;
+                }
+                const char *p = mCursor;
+                mCursor += size;
+                return p;
+            }
+
+            template <typename T>
+            bool value(T &out)
+            {
+                const char *p = take(sizeof(T));
+                if (p)
+                    std::memcpy(&out, p, sizeof(T));
+                return p != nullptr;
+            }
+
+            bool string(std::string &out)
+            {
+                uint32_t size = 0;
+                if (!value(size))
+                    return false;
+                const char *p = take(size);
+                if (p)
+                    out.assign(p, size);
+                return p != nullptr;
+            }
+
+            void align()
+            {
+                size_t offset = static_cast<size_t>(mCursor - mBegin);
+                size_t padding = (kBlockAlignment - offset % kBlockAlignment) % kBlockAlignment;
+                take(padding);
+            }
+
+        private:
+            const char *mBegin;
+            const char *mCursor;
+            const char *mEnd;
+            bool mOk = true;
+        };
+    } // namespace
+
+    std::string MeshCache::cachePathFor(const std::string &objPath)
+    {
+        return objPath + ".meshcache";
+    }
+
+    bool MeshCache::makeSourceKey(const std::string &objPath, std::string_view contents, SourceKey &key)
+    {
+        std::error_code ec;
+        auto mtime = std::filesystem::last_write_time(objPath, ec);
+        if (ec)
+            return false;
+
+        key.size = contents.size();
+        key.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+        key.contentHash = hashBytes(contents.data(), contents.size());
+        return true;
+    }
+
+    MeshCache::Dependency MeshCache::makeDependency(const std::string &path)
+    {
+        Dependency dependency;
+        dependency.path = path;
+
+        MappedFile file;
+        dependency.exists = file.open(path) && makeSourceKey(path, file.view(), dependency.key);
+        if (!dependency.exists)
+            dependency.key = SourceKey{};
+        return dependency;
+    }
+
+    uint64_t MeshCache::hashBytes(const void *data, size_t size, uint64_t seed)
+    {
+        const auto *p = static_cast<const unsigned char *>(data);
+        const uint64_t c1 = 0x87C37B91114253D5ull;
+        const uint64_t c2 = 0x4CF5AD432745937Full;
+
+        // Quatro acumuladores independentes para aproveitar o paralelismo da CPU
+        uint64_t h[4] = {seed ^ c1, seed ^ c2, seed + c1, seed - c2};
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32)
+        {
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                uint64_t k;
+                std::memcpy(&k, p + i + lane * 8, 8);
+                k *= c1;
+                k = rotl(k, 31);
+                k *= c2;
+                h[lane] ^= k;
+                h[lane] = rotl(h[lane], 27) * 5 + 0x52DCE729;
+            }
+        }
+
+        uint64_t acc = static_cast<uint64_t>(size) * c1;
+        for (uint64_t lane : h)
+            acc = rotl(acc ^ fmix64(lane), 29) * c2;
+
+        // Bytes restantes
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t k;
+            std::memcpy(&k, p + i, 8);
+            acc = rotl(acc ^ (k * c1), 31) * c2;
+        }
+        uint64_t tail = 0;
+        for (size_t shift = 0; i < size; ++i, shift += 8)
+            tail |= static_cast<uint64_t>(p[i]) << shift;
+        acc ^= tail * c2;
+
+        return fmix64(acc);
+    }
+
+    std::unique_ptr<ModelData> MeshCache::load(const std::string &cachePath, const SourceKey &key,
+                                               uint32_t loaderVersion, uint32_t processingFlags,
+                                               const std::string &modelName)
+    {
+        MappedFile file;
+        if (!file.open(cachePath))
+            return nullptr; // cache ainda não existe
+
+        // =================== VALIDAÇÃO DO CABEÇALHO ===================
+        CacheHeader header{};
+        if (file.size() < sizeof(CacheHeader))
+        {
+            std::cerr << "AVISO: Cache de meshes corrompido (cabeçalho truncado): " << cachePath << std::endl;
+            return nullptr;
+        }
+        std::memcpy(&header, file.data(), sizeof(CacheHeader));
+
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.endianMarker != kEndianMarker)
+        {
+            std::cerr << "AVISO: Arquivo de cache inválido: " << cachePath << std::endl;
+            return nullptr;
+        }
+        if (header.formatVersion != kFormatVersion || header.loaderVersion != loaderVersion ||
+            header.vertexSize != sizeof(Vertex))
+        {
+            std::cout << "Cache de meshes de versão diferente, será reconstruído: " << cachePath << std::endl;
+            return nullptr;
+        }
+        if (header.processingFlags != processingFlags)
+        {
+            std::cout << "Cache de meshes gerado com outras opções, será reconstruído: " << cachePath << std::endl;
+            return nullptr;
+        }
+        if (header.sourceSize != key.size || header.sourceMtime != key.mtime || header.sourceHash != key.contentHash)
+        {
+            std::cout << "Cache de meshes desatualizado, será reconstruído: " << cachePath << std::endl;
+            return nullptr;
+        }
+
+        // =================== DEPENDÊNCIAS ===================
+        // Os materiais gravados só valem se as bibliotecas .mtl continuam iguais
+        const char *dependencyTable = file.data() + sizeof(CacheHeader);
+        if (header.dependencyTableSize > file.size() - sizeof(CacheHeader) ||
+            hashBytes(dependencyTable, header.dependencyTableSize) != header.dependencyHash)
+        {
+            std::cerr << "AVISO: Cache de meshes corrompido (dependências): " << cachePath << std::endl;
+            return nullptr;
+        }
+
+        BlobReader dependencyReader(file.data(), dependencyTable, dependencyTable + header.dependencyTableSize);
+        for (uint32_t i = 0; i < header.dependencyCount; ++i)
+        {
+            Dependency stored;
+            uint32_t exists = 0;
+            dependencyReader.string(stored.path);
+            dependencyReader.value(exists);
+            dependencyReader.value(stored.key.size);
+            dependencyReader.value(stored.key.mtime);
+            dependencyReader.value(stored.key.contentHash);
+            if (!dependencyReader.ok())
+            {
+                std::cerr << "AVISO: Cache de meshes corrompido (dependências): " << cachePath << std::endl;
+                return nullptr;
+            }
+            stored.exists = exists != 0;
+
+            if (!(makeDependency(stored.path) == stored))
+            {
+                std::cout << "Biblioteca de materiais alterada (" << stored.path
+                          << "), cache será reconstruído: " << cachePath << std::endl;
+                return nullptr;
+            }
+        }
+
+        const char *payload = dependencyTable + header.dependencyTableSize;
+        if (header.payloadSize != file.size() - sizeof(CacheHeader) - header.dependencyTableSize ||
+            hashBytes(payload, header.payloadSize) != header.payloadHash)
+        {
+            std::cerr << "AVISO: Cache de meshes corrompido (checksum inválido): " << cachePath << std::endl;
+            return nullptr;
+        }
+
+        BlobReader reader(file.data(), payload, file.data() + file.size());
+
+        // =================== MATERIAIS ===================
+        uint32_t materialCount = 0;
+        reader.value(materialCount);
+
+        std::vector<std::shared_ptr<Material>> materials;
+        for (uint32_t i = 0; i < materialCount && reader.ok(); ++i)
+        {
+            std::string name;
+            MaterialRecord record{};
+            if (!reader.string(name) || !reader.value(record) || record.type > static_cast<uint32_t>(MaterialType::EMISSIVE))
+            {
+                std::cerr << "AVISO: Cache de meshes corrompido (materiais): " << cachePath << std::endl;
+                return nullptr;
+            }
+
+            // O tipo é restaurado primeiro; setAlpha reproduz a mesma transição de tipo do parsing
+            auto material = std::make_shared<Material>(static_cast<MaterialType>(record.type), name);
+            material->setAlbedo(glm::vec3(record.albedo[0], record.albedo[1], record.albedo[2]));
+            material->setSpecular(glm::vec3(record.specular[0], record.specular[1], record.specular[2]));
+            material->setShininess(record.shininess);
+            material->setEmissive(glm::vec3(record.emissive[0], record.emissive[1], record.emissive[2]));
+            material->setIndexOfRefraction(record.indexOfRefraction);
+            material->setAlpha(record.alpha);
+            materials.push_back(std::move(material));
+        }
+
+        // =================== MESHES ===================
+        uint32_t meshCount = 0;
+        reader.value(meshCount);
+
+        auto model = std::make_unique<ModelData>();
+        model->name = modelName;
+        for (uint32_t i = 0; i < meshCount && reader.ok(); ++i)
+        {
+            std::string name;
+            int32_t materialIndex = -1;
+            glm::mat4 localTransform(1.0f);
+            uint64_t vertexCount = 0;
+            uint64_t indexCount = 0;
+
+            reader.string(name);
+            reader.value(materialIndex);
+            reader.value(localTransform);
+            reader.value(vertexCount);
+            reader.value(indexCount);
+
+            if (!reader.ok() || materialIndex < -1 || materialIndex >= static_cast<int32_t>(materials.size()) ||
+                vertexCount > file.size() / sizeof(Vertex) || indexCount > file.size() / sizeof(GLuint))
+            {
+                std::cerr << "AVISO: Cache de meshes corrompido (mesh " << i << "): " << cachePath << std::endl;
+                return nullptr;
+            }
+
+            reader.align();
+            const char *vertexBytes = reader.take(vertexCount * sizeof(Vertex));
+            reader.align();
+            const char *indexBytes = reader.take(indexCount * sizeof(GLuint));
+            if (!reader.ok())
+            {
+                std::cerr << "AVISO: Cache de meshes corrompido (dados da mesh " << name << "): " << cachePath << std::endl;
+                return nullptr;
+            }
+
+            // Os blocos estão alinhados dentro do arquivo mapeado: uma cópia direta por bloco
+            // (o mapeamento é fechado antes do upload, que pode ocorrer em outra thread)
+            MeshData &mesh = model->meshes.emplace_back();
+            mesh.name = std::move(name);
+            mesh.material = materialIndex >= 0 ? materials[materialIndex] : nullptr;
+            mesh.localTransform = localTransform;
+            mesh.vertices.resize(vertexCount);
+            mesh.indices.resize(indexCount);
+            std::memcpy(mesh.vertices.data(), vertexBytes, vertexCount * sizeof(Vertex));
+            std::memcpy(mesh.indices.data(), indexBytes, indexCount * sizeof(GLuint));
+
+            // Níveis de detalhe: [erro][quantidade de índices][índices alinhados]
+            uint32_t lodCount = 0;
+            reader.value(lodCount);
+            for (uint32_t l = 0; l < lodCount; ++l)
+            {
+                float error = 0.0f;
+                uint64_t lodIndexCount = 0;
+                reader.value(error);
+                reader.value(lodIndexCount);
+                const char *lodBytes = nullptr;
+                if (reader.ok() && lodIndexCount <= file.size() / sizeof(GLuint))
+                {
+                    reader.align();
+                    lodBytes = reader.take(lodIndexCount * sizeof(GLuint));
+                }
+                if (!lodBytes || !reader.ok())
+                {
+                    std::cerr << "AVISO: Cache de meshes corrompido (LOD " << l << " da mesh " << mesh.name << "): " << cachePath << std::endl;
+                    return nullptr;
+                }
+
+                MeshLod &lod = mesh.lods.emplace_back();
+                lod.error = error;
+                lod.indices.resize(lodIndexCount);
+                std::memcpy(lod.indices.data(), lodBytes, lodIndexCount * sizeof(GLuint));
+            }
+        }
+
+        if (!reader.ok())
+        {
+            std::cerr << "AVISO: Cache de meshes corrompido (truncado): " << cachePath << std::endl;
+            return nullptr;
+        }
+
+        return model;
+    }
+
+    bool MeshCache::write(const std::string &cachePath, const SourceKey &key,
+                          const std::vector<Dependency> &dependencies,
+                          uint32_t loaderVersion, uint32_t processingFlags, const ModelData &model)
+    {
+        // =================== DEPENDÊNCIAS ===================
+        std::vector<char> dependencyTable;
+        BlobWriter dependencyWriter(dependencyTable, sizeof(CacheHeader));
+        for (const Dependency &dependency : dependencies)
+        {
+            dependencyWriter.string(dependency.path);
+            dependencyWriter.value(static_cast<uint32_t>(dependency.exists ? 1 : 0));
+            dependencyWriter.value(dependency.key.size);
+            dependencyWriter.value(dependency.key.mtime);
+            dependencyWriter.value(dependency.key.contentHash);
+        }
+
+        std::vector<char> payload;
+        BlobWriter writer(payload, sizeof(CacheHeader) + dependencyTable.size());
+
+        // =================== MATERIAIS ===================
+        // Materiais compartilhados entre meshes são gravados uma única vez
+        std::vector<const Material *> materials;
+        std::unordered_map<const Material *, int32_t> materialIndices;
+        for (const MeshData &mesh : model.meshes)
+        {
+            const Material *material = mesh.material.get();
+            if (material && materialIndices.emplace(material, static_cast<int32_t>(materials.size())).second)
+                materials.push_back(material);
+        }
+
+        writer.value(static_cast<uint32_t>(materials.size()));
+        for (const Material *material : materials)
+        {
+            MaterialRecord record{};
+            record.type = static_cast<uint32_t>(material->getType());
+            std::memcpy(record.albedo, &material->getAlbedo()[0], sizeof(record.albedo));
+            std::memcpy(record.specular, &material->getSpecular()[0], sizeof(record.specular));
+            record.shininess = material->getShininess();
+            record.alpha = material->getAlpha();
+            std::memcpy(record.emissive, &material->getEmissive()[0], sizeof(record.emissive));
+            record.indexOfRefraction = material->getIndexOfRefraction();
+
+            writer.string(material->getName());
+            writer.value(record);
+        }
+
+        // =================== MESHES ===================
+        writer.value(static_cast<uint32_t>(model.meshes.size()));
+        for (const MeshData &mesh : model.meshes)
+        {
+            const Material *material = mesh.material.get();
+            writer.string(mesh.name);
+            writer.value(material ? materialIndices[material] : int32_t(-1));
+            writer.value(mesh.localTransform);
+            writer.value(static_cast<uint64_t>(mesh.vertices.size()));
+            writer.value(static_cast<uint64_t>(mesh.indices.size()));
+
+            writer.align();
+            writer.bytes(mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex));
+            writer.align();
+            writer.bytes(mesh.indices.data(), mesh.indices.size() * sizeof(GLuint));
+
+            writer.value(static_cast<uint32_t>(mesh.lods.size()));
+            for (const MeshLod &lod : mesh.lods)
+            {
+                writer.value(lod.error);
+                writer.value(static_cast<uint64_t>(lod.indices.size()));
+                writer.align();
+                writer.bytes(lod.indices.data(), lod.indices.size() * sizeof(GLuint));
+            }
+        }
+
+        // =================== CABEÇALHO ===================
+        CacheHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.endianMarker = kEndianMarker;
+        header.formatVersion = kFormatVersion;
+        header.loaderVersion = loaderVersion;
+        header.vertexSize = sizeof(Vertex);
+        header.processingFlags = processingFlags;
+        header.dependencyCount = static_cast<uint32_t>(dependencies.size());
+        header.dependencyTableSize = static_cast<uint32_t>(dependencyTable.size());
+        header.sourceSize = key.size;
+        header.sourceMtime = key.mtime;
+        header.sourceHash = key.contentHash;
+        header.dependencyHash = hashBytes(dependencyTable.data(), dependencyTable.size());
+        header.payloadSize = payload.size();
+        header.payloadHash = hashBytes(payload.data(), payload.size());
+
+        // Grava em arquivo temporário e renomeia, para nunca deixar um cache pela metade
+        std::string tempPath = cachePath + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open())
+            {
+                std::cerr << "AVISO: Não foi possível criar o cache de meshes: " << tempPath << std::endl;
+                return false;
+            }
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            out.write(dependencyTable.data(), static_cast<std::streamsize>(dependencyTable.size()));
+            out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+            if (!out)
+            {
+                std::cerr << "AVISO: Falha ao escrever o cache de meshes: " << tempPath << std::endl;
+                out.close();
+                std::error_code ec;
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, cachePath, ec);
+        if (ec)
+        {
+            std::cerr << "AVISO: Falha ao gravar o cache de meshes: " << cachePath << " (" << ec.message() << ")" << std::endl;
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        std::cout << "Cache de meshes gravado: " << cachePath << " (" << (sizeof(header) + payload.size()) / 1024 << " KB)" << std::endl;
+        return true;
+    }
+
+} // namespace cg
@@ -0,0 +1,335 @@
+#include "render/MeshOptimizer.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace cg
+{
+
+    namespace
+    {
+        // Cache FIFO de vértices simulado com carimbos de tempo (sem fila explícita):
+        // um vértice está no cache se foi inserido há no máximo "size" inserções
+        class FifoCache
+        {
+        public:
+            FifoCache(size_t vertexCount, unsigned size)
+                : mStamps(vertexCount, 0), mSize(size), mTime(static_cast<uint64_t>(size) + 1) {}
+
+            // Retorna true se o vértice precisou ser transformado (falta no cache)
+            bool access(GLuint vertex)
+            {
+                if (mTime - mStamps[vertex] <= mSize)
+                    return false;
+                mStamps[vertex] = mTime++;
+                return true;
+            }
+
+            unsigned accessTriangle(const GLuint *triangle)
+            {
+                return access(triangle[0]) + access(triangle[1]) + access(triangle[2]);
+            }
+
+            // Esvazia o cache em O(1)
+            void reset() { mTime += static_cast<uint64_t>(mSize) + 1; }
+
+        private:
+            std::vector<uint64_t> mStamps;
+            uint64_t mSize;
+            uint64_t mTime;
+        };
+
+        // Centroide ponderado por área e normal acumulada de um conjunto de triângulos
+        struct ClusterGeometry
+        {
+            glm::vec3 weightedCentroid{0.0f}; // soma(centroide * área)
+            glm::vec3 centroidSum{0.0f};      // soma(centroide), para triângulos degenerados
+            glm::vec3 normal{0.0f};           // soma dos produtos vetoriais (2 * área * normal)
+            float area = 0.0f;
+            size_t triangles = 0;
+
+            void add(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c)
+            {
+                glm::vec3 cross = glm::cross(b - a, c - a);
+                float triArea = glm::length(cross) * 0.5f;
+                glm::vec3 centroid = (a + b + c) / 3.0f;
+
+                weightedCentroid += centroid * triArea;
+                centroidSum += centroid;
+                normal += cross;
+                area += triArea;
+                triangles++;
+            }
+
+            glm::vec3 centroid() const
+            {
+                if (area > 0.0f)
+                    return weightedCentroid / area;
+                return triangles ? centroidSum / static_cast<float>(triangles) : glm::vec3(0.0f);
+            }
+        };
+    } // namespace
+
+    MeshOptimizer::CacheStats MeshOptimizer::analyzeVertexCache(const std::vector<GLuint> &indices, size_t vertexCount,
+                                                                unsigned cacheSize)
+    {
+        CacheStats stats;
+        stats.triangles = indices.size() / 3;
+
+        FifoCache cache(vertexCount, cacheSize);
+        std::vector<uint8_t> seen(vertexCount, 0);
+        for (size_t i = 0; i < stats.triangles * 3; ++i)
+        {
+            GLuint vertex = indices[i];
+            stats.misses += cache.access(vertex) ? 1 : 0;
+            if (!seen[vertex])
+            {
+                seen[vertex] = 1;
+                stats.vertices++;
+            }
+        }
+        return stats;
+    }
+
+    void MeshOptimizer::optimize(MeshData &mesh)
+    {
+        if (mesh.indices.size() < 3 || mesh.vertices.empty())
+            return;
+
+        optimizeVertexCache(mesh.indices, mesh.vertices.size());
+        optimizeOverdraw(mesh.indices, mesh.vertices);
+        optimizeVertexFetch(mesh.vertices, mesh.indices);
+    }
+
+    void MeshOptimizer::optimizeVertexCache(std::vector<GLuint> &indices, size_t vertexCount, unsigned cacheSize)
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0 || vertexCount == 0)
+            return;
+
+        // =================== ADJACÊNCIA VÉRTICE -> TRIÂNGULOS (CSR) ===================
+        std::vector<uint32_t> liveTriangles(vertexCount, 0);
+        for (size_t i = 0; i < triangleCount * 3; ++i)
+            liveTriangles[indices[i]]++;
+
+        std::vector<size_t> adjacencyOffsets(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; ++v)
+            adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+
+        std::vector<uint32_t> adjacency(triangleCount * 3);
+        {
+            std::vector<size_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < triangleCount * 3; ++i)
+                adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        // =================== TIPSIFY ===================
+        std::vector<uint64_t> cacheTime(vertexCount, 0); // Momento em que o vértice entrou no cache
+        std::vector<uint8_t> emitted(triangleCount, 0);
+        std::vector<GLuint> deadEnd;                     // Pilha de vértices recentes (para becos sem saída)
+        std::vector<GLuint> candidates;
+        std::vector<GLuint> result;
+        deadEnd.reserve(triangleCount * 3);
+        result.reserve(triangleCount * 3);
+
+        uint64_t time = static_cast<uint64_t>(cacheSize) + 1;
+        size_t scanCursor = 0; // Próximo vértice na varredura sequencial
+        int64_t fanning = 0;   // Vértice cujo leque de triângulos está sendo emitido
+
+        while (fanning >= 0)
+        {
+            // Emite todos os triângulos ainda não emitidos ao redor do vértice atual
+            candidates.clear();
+            for (size_t a = adjacencyOffsets[fanning]; a < adjacencyOffsets[fanning + 1]; ++a)
+            {
+                uint32_t triangle = adjacency[a];
+                if (emitted[triangle])
+                    continue;
+
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    GLuint v = indices[triangle * 3 + k];
+                    result.push_back(v);
+                    deadEnd.push_back(v);
+                    candidates.push_back(v);
+                    liveTriangles[v]--;
+                    if (time - cacheTime[v] > cacheSize)
+                    {
+                        cacheTime[v] = time;
+                        time++;
+                    }
+                }
+                emitted[triangle] = 1;
+            }
+
+            // Próximo vértice: o candidato mais antigo que ainda estará no cache
+            // depois de emitir seus triângulos restantes
+            int64_t best = -1;
+            int64_t bestPriority = -1;
+            for (GLuint v : candidates)
+            {
+                if (liveTriangles[v] == 0)
+                    continue;
+
+                int64_t priority = 0;
+                uint64_t age = time - cacheTime[v];
+                if (age + 2 * static_cast<uint64_t>(liveTriangles[v]) <= cacheSize)
+                    priority = static_cast<int64_t>(age);
+
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    best = v;
+                }
+            }
+
+            if (best < 0)
+            {
+                // Beco sem saída: volta para um vértice recente com triângulos pendentes,
+                // ou segue a varredura sequencial
+                while (!deadEnd.empty() && best < 0)
+                {
+                    GLuint v = deadEnd.back();
+                    deadEnd.pop_back();
+                    if (liveTriangles[v] > 0)
+                        best = v;
+                }
+                while (best < 0 && scanCursor < vertexCount)
+                {
+                    if (liveTriangles[scanCursor] > 0)
+                        best = static_cast<int64_t>(scanCursor);
+                    else
+                        scanCursor++;
+                }
+            }
+
+            fanning = best;
+        }
+
+        // Índices além do último triângulo completo (se houver) são preservados
+        result.insert(result.end(), indices.begin() + static_cast<std::ptrdiff_t>(triangleCount * 3), indices.end());
+        indices.swap(result);
+    }
+
+    void MeshOptimizer::optimizeOverdraw(std::vector<GLuint> &indices, const std::vector<Vertex> &vertices,
+                                         float threshold, unsigned cacheSize)
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount < 2 || vertices.empty())
+            return;
+
+        // =================== FRONTEIRAS "FORTES" ===================
+        // Triângulos com 3 faltas no cache iniciam uma nova sequência do Tipsify
+        FifoCache cache(vertices.size(), cacheSize);
+        std::vector<size_t> hardBoundaries;
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            if (cache.accessTriangle(&indices[t * 3]) == 3 || t == 0)
+                hardBoundaries.push_back(t);
+        }
+        hardBoundaries.push_back(triangleCount);
+
+        // =================== FRONTEIRAS "FRACAS" ===================
+        // Dentro de cada sequência, corta o cluster assim que o ACMR acumulado cai
+        // abaixo do limiar; cada corte esvazia o cache, então o ACMR final de cada
+        // cluster fica limitado a threshold * ACMR da sequência
+        std::vector<size_t> clusters;
+        for (size_t h = 0; h + 1 < hardBoundaries.size(); ++h)
+        {
+            size_t start = hardBoundaries[h];
+            size_t end = hardBoundaries[h + 1];
+
+            cache.reset();
+            size_t sequenceMisses = 0;
+            for (size_t t = start; t < end; ++t)
+                sequenceMisses += cache.accessTriangle(&indices[t * 3]);
+            double sequenceAcmr = static_cast<double>(sequenceMisses) / static_cast<double>(end - start);
+
+            cache.reset();
+            clusters.push_back(start);
+            size_t clusterStart = start;
+            size_t clusterMisses = 0;
+            for (size_t t = start; t < end; ++t)
+            {
+                clusterMisses += cache.accessTriangle(&indices[t * 3]);
+                size_t clusterTriangles = t - clusterStart + 1;
+                if (t + 1 < end && clusterMisses <= threshold * sequenceAcmr * static_cast<double>(clusterTriangles))
+                {
+                    clusters.push_back(t + 1);
+                    clusterStart = t + 1;
+                    clusterMisses = 0;
+                    cache.reset();
+                }
+            }
+        }
+        clusters.push_back(triangleCount);
+
+        // =================== ORDENAÇÃO DE FORA PARA DENTRO ===================
+        // Clusters cuja normal aponta para longe do centro do objeto tendem a ficar na
+        // frente dos demais: desenhá-los primeiro faz o teste de profundidade descartar
+        // mais fragmentos ocultos
+        size_t clusterCount = clusters.size() - 1;
+        std::vector<ClusterGeometry> geometry(clusterCount);
+        ClusterGeometry meshGeometry;
+        for (size_t c = 0; c < clusterCount; ++c)
+        {
+            for (size_t t = clusters[c]; t < clusters[c + 1]; ++t)
+            {
+                const glm::vec3 &a = vertices[indices[t * 3 + 0]].position;
+                const glm::vec3 &b = vertices[indices[t * 3 + 1]].position;
+                const glm::vec3 &p = vertices[indices[t * 3 + 2]].position;
+                geometry[c].add(a, b, p);
+                meshGeometry.add(a, b, p);
+            }
+        }
+
+        glm::vec3 meshCentroid = meshGeometry.centroid();
+        std::vector<float> sortKeys(clusterCount, 0.0f);
+        for (size_t c = 0; c < clusterCount; ++c)
+        {
+            float length = glm::length(geometry[c].normal);
+            if (length > 0.0f)
+                sortKeys[c] = glm::dot(geometry[c].centroid() - meshCentroid, geometry[c].normal / length);
+        }
+
+        std::vector<size_t> order(clusterCount);
+        for (size_t c = 0; c < clusterCount; ++c)
+            order[c] = c;
+        std::stable_sort(order.begin(), order.end(), [&sortKeys](size_t a, size_t b)
+                         { return sortKeys[a] > sortKeys[b]; });
+
+        std::vector<GLuint> result;
+        result.reserve(indices.size());
+        for (size_t c : order)
+        {
+            result.insert(result.end(),
+                          indices.begin() + static_cast<std::ptrdiff_t>(clusters[c] * 3),
+                          indices.begin() + static_cast<std::ptrdiff_t>(clusters[c + 1] * 3));
+        }
+        result.insert(result.end(), indices.begin() + static_cast<std::ptrdiff_t>(triangleCount * 3), indices.end());
+        indices.swap(result);
+    }
+
+    void MeshOptimizer::optimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<GLuint> &indices)
+    {
+        constexpr GLuint kUnused = std::numeric_limits<GLuint>::max();
+
+        std::vector<GLuint> remap(vertices.size(), kUnused);
+        GLuint nextVertex = 0;
+        for (GLuint &index : indices)
+        {
+            if (remap[index] == kUnused)
+                remap[index] = nextVertex++;
+            index = remap[index];
+        }
+
+        std::vector<Vertex> result(nextVertex);
+        for (size_t v = 0; v < vertices.size(); ++v)
+        {
+            if (remap[v] != kUnused)
+                result[remap[v]] = vertices[v];
+        }
+        vertices.swap(result);
+    }
+
+} // namespace cg
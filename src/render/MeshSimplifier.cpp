@@ -0,0 +1,500 @@
+#include "render/MeshSimplifier.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace cg
+{
+
+    namespace
+    {
+        constexpr uint32_t kInvalid = std::numeric_limits<uint32_t>::max();
+
+        // Peso dos planos de restrição de bordas e costuras, relativo aos planos das faces
+        constexpr double kBoundaryWeight = 10.0;
+
+        // Quádrica simétrica: soma de peso * (n·p + d)^2 sobre os planos acumulados
+        struct Quadric
+        {
+            double a00 = 0.0, a11 = 0.0, a22 = 0.0, a01 = 0.0, a02 = 0.0, a12 = 0.0;
+            double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+            double c = 0.0;
+            double weight = 0.0;
+
+            void addPlane(const glm::vec3 &normal, const glm::vec3 &point, double w)
+            {
+                double x = normal.x, y = normal.y, z = normal.z;
+                double d = -(x * point.x + y * point.y + z * point.z);
+                a00 += w * x * x;
+                a11 += w * y * y;
+                a22 += w * z * z;
+                a01 += w * x * y;
+                a02 += w * x * z;
+                a12 += w * y * z;
+                b0 += w * x * d;
+                b1 += w * y * d;
+                b2 += w * z * d;
+                c += w * d * d;
+                weight += w;
+            }
+
+            Quadric &operator+=(const Quadric &o)
+            {
+                a00 += o.a00;
+                a11 += o.a11;
+                a22 += o.a22;
+                a01 += o.a01;
+                a02 += o.a02;
+                a12 += o.a12;
+                b0 += o.b0;
+                b1 += o.b1;
+                b2 += o.b2;
+                c += o.c;
+                weight += o.weight;
+                return *this;
+            }
+
+            // Distância quadrática média (ponderada) de p aos planos acumulados
+            double error(const glm::vec3 &p) const
+            {
+                double x = p.x, y = p.y, z = p.z;
+                double r = a00 * x * x + a11 * y * y + a22 * z * z +
+                           2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                           2.0 * (b0 * x + b1 * y + b2 * z) + c;
+                return weight > 0.0 ? std::abs(r) / weight : 0.0;
+            }
+        };
+
+        enum class VertexKind : uint8_t
+        {
+            Interior, // Colapsa em qualquer direção (costuras são limitadas pelo mapeamento de wedges)
+            Border,   // Em borda aberta: colapsa apenas ao longo da borda
+            Locked    // Topologia complexa: nunca colapsa
+        };
+
+        struct Collapse
+        {
+            uint32_t from;
+            uint32_t to;
+            double error;
+        };
+
+        // Agrupa vértices com a mesma posição; retorna o número de posições distintas
+        uint32_t weldPositions(const std::vector<Vertex> &vertices, std::vector<uint32_t> &positionOf)
+        {
+            auto key = [&vertices](uint32_t v)
+            {
+                // + 0.0f transforma -0 em +0, para que ambos caiam na mesma posição
+                glm::vec3 p = vertices[v].position + glm::vec3(0.0f);
+                std::array<uint32_t, 3> bits;
+                std::memcpy(bits.data(), &p[0], sizeof(bits));
+                return bits;
+            };
+
+            std::vector<uint32_t> order(vertices.size());
+            std::iota(order.begin(), order.end(), 0u);
+            std::sort(order.begin(), order.end(), [&key](uint32_t a, uint32_t b)
+                      { return key(a) < key(b); });
+
+            positionOf.assign(vertices.size(), 0);
+            uint32_t count = 0;
+            for (size_t i = 0; i < order.size(); ++i)
+            {
+                if (i == 0 || key(order[i]) != key(order[i - 1]))
+                    count++;
+                positionOf[order[i]] = count - 1;
+            }
+            return count;
+        }
+
+        // Triângulos ao redor de cada posição (CSR), com consultas de arestas orientadas
+        class Topology
+        {
+        public:
+            Topology(const std::vector<GLuint> &indices, const std::vector<uint32_t> &positionOf, size_t positionCount)
+                : mIndices(indices), mPositionOf(positionOf), mOffsets(positionCount + 1, 0)
+            {
+                size_t triangleCount = indices.size() / 3;
+                for (size_t i = 0; i < triangleCount * 3; ++i)
+                    mOffsets[positionOf[indices[i]] + 1]++;
+                for (size_t p = 0; p < positionCount; ++p)
+                    mOffsets[p + 1] += mOffsets[p];
+
+                mTriangles.resize(triangleCount * 3);
+                std::vector<uint32_t> fill(mOffsets.begin(), mOffsets.end() - 1);
+                for (size_t i = 0; i < triangleCount * 3; ++i)
+                    mTriangles[fill[positionOf[indices[i]]]++] = static_cast<uint32_t>(i / 3);
+            }
+
+            const uint32_t *begin(uint32_t position) const { return mTriangles.data() + mOffsets[position]; }
+            const uint32_t *end(uint32_t position) const { return mTriangles.data() + mOffsets[position + 1]; }
+
+            uint32_t position(uint32_t triangle, unsigned corner) const
+            {
+                return mPositionOf[mIndices[triangle * 3 + corner]];
+            }
+
+            // Canto do triângulo que está na posição dada (ou 3 se não houver)
+            unsigned cornerOf(uint32_t triangle, uint32_t position) const
+            {
+                for (unsigned k = 0; k < 3; ++k)
+                {
+                    if (this->position(triangle, k) == position)
+                        return k;
+                }
+                return 3;
+            }
+
+            // Existe algum triângulo com a aresta orientada from -> to (entre posições)?
+            bool hasPositionEdge(uint32_t from, uint32_t to) const
+            {
+                for (const uint32_t *t = begin(from); t != end(from); ++t)
+                {
+                    unsigned k = cornerOf(*t, from);
+                    if (position(*t, (k + 1) % 3) == to)
+                        return true;
+                }
+                return false;
+            }
+
+            // Existe algum triângulo com a aresta orientada a -> b (entre vértices com atributos)?
+            bool hasVertexEdge(GLuint a, GLuint b) const
+            {
+                uint32_t from = mPositionOf[a];
+                for (const uint32_t *t = begin(from); t != end(from); ++t)
+                {
+                    for (unsigned k = 0; k < 3; ++k)
+                    {
+                        if (mIndices[*t * 3 + k] == a && mIndices[*t * 3 + (k + 1) % 3] == b)
+                            return true;
+                    }
+                }
+                return false;
+            }
+
+        private:
+            const std::vector<GLuint> &mIndices;
+            const std::vector<uint32_t> &mPositionOf;
+            std::vector<uint32_t> mOffsets;
+            std::vector<uint32_t> mTriangles;
+        };
+    } // namespace
+
+    std::vector<GLuint> MeshSimplifier::simplify(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices,
+                                                 size_t targetIndexCount, float targetError, float *resultError)
+    {
+        size_t triangleCount = indices.size() / 3;
+        std::vector<GLuint> result(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(triangleCount * 3));
+        if (resultError)
+            *resultError = 0.0f;
+        if (triangleCount == 0 || vertices.empty() || result.size() <= targetIndexCount)
+            return result;
+
+        // =================== VÉRTICES POR POSIÇÃO ===================
+        // Vértices na mesma posição com atributos diferentes ("wedges") formam uma costura
+        std::vector<uint32_t> positionOf;
+        uint32_t positionCount = weldPositions(vertices, positionOf);
+        std::vector<glm::vec3> positions(positionCount);
+        for (size_t v = 0; v < vertices.size(); ++v)
+            positions[positionOf[v]] = vertices[v].position;
+
+        auto position = [&](GLuint index) -> const glm::vec3 &
+        { return positions[positionOf[index]]; };
+
+        // =================== QUÁDRICAS INICIAIS ===================
+        std::vector<Quadric> quadrics(positionCount);
+        {
+            Topology topology(result, positionOf, positionCount);
+            for (size_t t = 0; t < triangleCount; ++t)
+            {
+                const GLuint *tri = &result[t * 3];
+                glm::vec3 cross = glm::cross(position(tri[1]) - position(tri[0]), position(tri[2]) - position(tri[0]));
+                float length = glm::length(cross);
+                if (!(length > 0.0f))
+                    continue; // degenerado (ou NaN)
+                glm::vec3 normal = cross / length;
+
+                // Plano da face, ponderado pela área
+                for (unsigned k = 0; k < 3; ++k)
+                    quadrics[positionOf[tri[k]]].addPlane(normal, position(tri[0]), length * 0.5f);
+
+                // Planos perpendiculares à face nas bordas abertas e nas costuras
+                for (unsigned k = 0; k < 3; ++k)
+                {
+                    GLuint a = tri[k];
+                    GLuint b = tri[(k + 1) % 3];
+                    bool border = !topology.hasPositionEdge(positionOf[b], positionOf[a]);
+                    if (!border && topology.hasVertexEdge(b, a))
+                        continue;
+
+                    glm::vec3 edge = position(b) - position(a);
+                    glm::vec3 edgeNormal = glm::cross(edge, normal);
+                    float edgeNormalLength = glm::length(edgeNormal);
+                    if (!(edgeNormalLength > 0.0f))
+                        continue;
+
+                    double weight = static_cast<double>(glm::dot(edge, edge)) * kBoundaryWeight;
+                    quadrics[positionOf[a]].addPlane(edgeNormal / edgeNormalLength, position(a), weight);
+                    quadrics[positionOf[b]].addPlane(edgeNormal / edgeNormalLength, position(a), weight);
+                }
+            }
+        }
+
+        // =================== PASSES DE COLAPSO ===================
+        size_t targetTriangles = targetIndexCount / 3;
+        double errorLimit = static_cast<double>(targetError) * static_cast<double>(targetError);
+        double maxError = 0.0;
+
+        std::vector<VertexKind> kinds(positionCount);
+        std::vector<uint8_t> locked(positionCount);
+        std::vector<GLuint> wedgeRemap(vertices.size());
+        std::vector<Collapse> collapses;
+        std::vector<uint8_t> openCorner;                   // Aresta que sai do canto não tem oposta
+        std::vector<uint32_t> fanCorners, fanNext, fanPrev; // Leque de triângulos da posição atual
+
+        while (triangleCount > targetTriangles)
+        {
+            Topology topology(result, positionOf, positionCount);
+            openCorner.assign(result.size(), 0);
+
+            // Classificação: wedges distintos e arestas abertas ao redor de cada posição.
+            // A aresta p -> next tem oposta se algum triângulo do leque de p tem next como anterior a p
+            for (uint32_t p = 0; p < positionCount; ++p)
+            {
+                fanCorners.clear();
+                fanNext.clear();
+                fanPrev.clear();
+                GLuint wedges[2] = {kInvalid, kInvalid};
+                bool manyWedges = false;
+                for (const uint32_t *t = topology.begin(p); t != topology.end(p); ++t)
+                {
+                    unsigned k = topology.cornerOf(*t, p);
+                    GLuint wedge = result[*t * 3 + k];
+                    if (wedges[0] == kInvalid || wedges[0] == wedge)
+                        wedges[0] = wedge;
+                    else if (wedges[1] == kInvalid || wedges[1] == wedge)
+                        wedges[1] = wedge;
+                    else
+                        manyWedges = true;
+
+                    fanCorners.push_back(*t * 3 + k);
+                    fanNext.push_back(topology.position(*t, (k + 1) % 3));
+                    fanPrev.push_back(topology.position(*t, (k + 2) % 3));
+                }
+
+                unsigned openEdges = 0;
+                for (size_t i = 0; i < fanCorners.size(); ++i)
+                {
+                    bool outgoingOpen = std::find(fanPrev.begin(), fanPrev.end(), fanNext[i]) == fanPrev.end();
+                    bool incomingOpen = std::find(fanNext.begin(), fanNext.end(), fanPrev[i]) == fanNext.end();
+                    openCorner[fanCorners[i]] = outgoingOpen ? 1 : 0;
+                    openEdges += (outgoingOpen ? 1 : 0) + (incomingOpen ? 1 : 0);
+                }
+
+                bool seam = wedges[1] != kInvalid;
+                if (manyWedges || openEdges > 2 || (openEdges > 0 && seam))
+                    kinds[p] = VertexKind::Locked;
+                else if (openEdges > 0)
+                    kinds[p] = VertexKind::Border;
+                else
+                    kinds[p] = VertexKind::Interior;
+            }
+
+            // Candidatos: cada aresta, na direção permitida mais barata
+            collapses.clear();
+            for (size_t t = 0; t < triangleCount; ++t)
+            {
+                for (unsigned k = 0; k < 3; ++k)
+                {
+                    uint32_t a = positionOf[result[t * 3 + k]];
+                    uint32_t b = positionOf[result[t * 3 + (k + 1) % 3]];
+                    bool open = openCorner[t * 3 + k] != 0;
+                    if (!open && a > b)
+                        continue; // aresta interna: considerada só pelo lado a < b
+
+                    auto allowed = [&](uint32_t from)
+                    {
+                        return kinds[from] == VertexKind::Interior || (kinds[from] == VertexKind::Border && open);
+                    };
+
+                    Collapse best{kInvalid, kInvalid, std::numeric_limits<double>::max()};
+                    for (int direction = 0; direction < 2; ++direction)
+                    {
+                        uint32_t from = direction == 0 ? a : b;
+                        uint32_t to = direction == 0 ? b : a;
+                        if (!allowed(from))
+                            continue;
+
+                        Quadric merged = quadrics[from];
+                        merged += quadrics[to];
+                        double error = merged.error(positions[to]);
+                        if (error < best.error)
+                            best = {from, to, error};
+                    }
+                    if (best.from != kInvalid)
+                        collapses.push_back(best);
+                }
+            }
+
+            if (collapses.empty())
+                break;
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse &x, const Collapse &y)
+                      { return x.error < y.error; });
+
+            // Executa colapsos independentes: a vizinhança de cada colapso fica travada até o próximo passe
+            std::fill(locked.begin(), locked.end(), 0);
+            std::iota(wedgeRemap.begin(), wedgeRemap.end(), 0u);
+            size_t performed = 0;
+
+            for (const Collapse &collapse : collapses)
+            {
+                if (triangleCount <= targetTriangles || collapse.error > errorLimit)
+                    break;
+                if (locked[collapse.from] || locked[collapse.to])
+                    continue;
+
+                // Cada wedge de "from" precisa ir para exatamente um wedge de "to" (mantém as costuras)
+                GLuint wedges[2] = {kInvalid, kInvalid};
+                GLuint targets[2] = {kInvalid, kInvalid};
+                size_t removedTriangles = 0;
+                bool valid = true;
+
+                for (const uint32_t *t = topology.begin(collapse.from); valid && t != topology.end(collapse.from); ++t)
+                {
+                    const GLuint *tri = &result[*t * 3];
+                    unsigned k = topology.cornerOf(*t, collapse.from);
+                    unsigned j = topology.cornerOf(*t, collapse.to);
+
+                    int slot = (wedges[0] == kInvalid || wedges[0] == tri[k]) ? 0 : (wedges[1] == kInvalid || wedges[1] == tri[k]) ? 1
+                                                                                                                                    : -1;
+                    if (slot < 0)
+                    {
+                        valid = false;
+                        break;
+                    }
+                    wedges[slot] = tri[k];
+
+                    if (j < 3)
+                    {
+                        // Triângulo que desaparece com o colapso
+                        if (targets[slot] != kInvalid && targets[slot] != tri[j])
+                            valid = false;
+                        targets[slot] = tri[j];
+                        removedTriangles++;
+                    }
+                    else
+                    {
+                        // Triângulo que permanece: não pode inverter a orientação
+                        glm::vec3 p[3] = {position(tri[0]), position(tri[1]), position(tri[2])};
+                        glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                        p[k] = positions[collapse.to];
+                        glm::vec3 after = glm::cross(p[1] - p[0], p[2] - p[0]);
+                        if (glm::dot(before, before) > 0.0f && glm::dot(before, after) <= 0.0f)
+                            valid = false;
+                    }
+                }
+
+                for (int slot = 0; slot < 2; ++slot)
+                {
+                    if (wedges[slot] != kInvalid && targets[slot] == kInvalid)
+                        valid = false;
+                }
+                if (!valid)
+                    continue;
+
+                // =================== APLICA O COLAPSO ===================
+                for (int slot = 0; slot < 2; ++slot)
+                {
+                    if (wedges[slot] != kInvalid)
+                        wedgeRemap[wedges[slot]] = targets[slot];
+                }
+                quadrics[collapse.to] += quadrics[collapse.from];
+
+                for (const uint32_t *t = topology.begin(collapse.from); t != topology.end(collapse.from); ++t)
+                {
+                    for (unsigned k = 0; k < 3; ++k)
+                        locked[topology.position(*t, k)] = 1;
+                }
+                locked[collapse.to] = 1;
+
+                triangleCount -= removedTriangles;
+                maxError = std::max(maxError, collapse.error);
+                performed++;
+            }
+
+            if (performed == 0)
+                break;
+
+            // Reescreve os índices e remove os triângulos que degeneraram
+            size_t write = 0;
+            for (size_t t = 0; t < result.size() / 3; ++t)
+            {
+                GLuint a = wedgeRemap[result[t * 3 + 0]];
+                GLuint b = wedgeRemap[result[t * 3 + 1]];
+                GLuint c = wedgeRemap[result[t * 3 + 2]];
+                if (positionOf[a] == positionOf[b] || positionOf[b] == positionOf[c] || positionOf[a] == positionOf[c])
+                    continue;
+                result[write * 3 + 0] = a;
+                result[write * 3 + 1] = b;
+                result[write * 3 + 2] = c;
+                write++;
+            }
+            result.resize(write * 3);
+            triangleCount = write;
+        }
+
+        if (resultError)
+            *resultError = static_cast<float>(std::sqrt(maxError));
+        return result;
+    }
+
+    void MeshSimplifier::generateLods(MeshData &mesh)
+    {
+        mesh.lods.clear();
+        size_t triangleCount = mesh.getTriangleCount();
+        if (triangleCount < kMinLodTriangles || mesh.vertices.empty())
+            return;
+
+        // Erro máximo proporcional ao tamanho da mesh
+        glm::vec3 minBounds(std::numeric_limits<float>::max());
+        glm::vec3 maxBounds(std::numeric_limits<float>::lowest());
+        for (const Vertex &vertex : mesh.vertices)
+        {
+            minBounds = glm::min(minBounds, vertex.position);
+            maxBounds = glm::max(maxBounds, vertex.position);
+        }
+        float maxError = glm::length(maxBounds - minBounds) * kMaxLodError;
+        if (!std::isfinite(maxError))
+            return;
+
+        size_t previousTriangles = triangleCount;
+        float previousError = 0.0f;
+        float targetTriangles = static_cast<float>(triangleCount);
+        for (unsigned level = 1; level <= kMaxLodLevels; ++level)
+        {
+            targetTriangles *= kLodTriangleRatio;
+
+            float error = 0.0f;
+            std::vector<GLuint> indices = simplify(mesh.vertices, mesh.indices,
+                                                   static_cast<size_t>(targetTriangles) * 3, maxError, &error);
+
+            // Redução pequena demais (costuras/bordas travadas ou erro máximo atingido): encerra a cadeia
+            size_t lodTriangles = indices.size() / 3;
+            if (lodTriangles == 0 || static_cast<float>(lodTriangles) > static_cast<float>(previousTriangles) * 0.8f)
+                break;
+
+            // O erro não pode diminuir ao longo da cadeia (a seleção por distância assume isso)
+            MeshLod &lod = mesh.lods.emplace_back();
+            lod.indices = std::move(indices);
+            lod.error = std::max(error, previousError);
+
+            previousTriangles = lodTriangles;
+            previousError = lod.error;
+        }
+    }
+
+} // namespace cg
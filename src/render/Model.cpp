@@ -1,4 +1,6 @@
 #include "render/Model.h"
+#include "render/TransformKernel.h"
+#include <algorithm>
 #include <iostream>
 
 namespace cg
@@ -15,9 +17,13 @@ namespace cg
         if (mesh)
         {
             std::cout << "Adicionando mesh '" << mesh->name << "' ao modelo '" << mName << "'" << std::endl;
+            mIndexByMesh[mesh.get()] = static_cast<int>(mMeshes.size());
             mMeshes.push_back(std::move(mesh));
             // Expande estrutura de pais mantendo sem pai por padrão
             mParents.push_back(-1);
+            mChildCounts.push_back(0);
+            mHierarchyDirty = true;
+            ++mTransformVersion;
         }
     }
 
@@ -67,47 +73,149 @@ namespace cg
         {
             // =================== ORDEM DAS TRANSFORMAÇÕES ===================
             // 1. Escala primeiro (altera o tamanho)
-            // 2. Rotação (gira em torno da origem)
+            // 2. Rotação (gira em torno da origem, ordem: X, Y, Z)
             // 3. Translação por último (move para posição final)
+            mModelMatrix = TransformKernel::composeTrs(mPosition, mRotation, mScale);
+            mMatrixNeedsUpdate = false;
+        }
+
+        return mModelMatrix;
+    }
+
+    glm::mat4 Model::getWorldMatrixForMesh(const Mesh *mesh) const
+    {
+        if (!mesh)
+            return getModelMatrix();
+        int idx = indexOf(mesh);
+        if (idx < 0)
+            return getModelMatrix();
+
+        // world = Model * (ParentLocal * ... * ChildLocal), já acumulado no cache
+        updateWorldMatrices();
+        return mWorldMatrices[idx];
+    }
 
-            mModelMatrix = glm::mat4(1.0f); // Matriz identidade
+    size_t Model::updateWorldMatrices() const
+    {
+        if (mHierarchyDirty)
+        {
+            rebuildTransformOrder();
+        }
 
-            // Aplicar translação (posição)
-            mModelMatrix = glm::translate(mModelMatrix, mPosition);
+        glm::mat4 modelMatrix = getModelMatrix();
+        bool all = mAllWorldDirty;
+        size_t updated = 0;
 
-            // Aplicar rotações (ordem: X, Y, Z)
-            if (mRotation.x != 0.0f)
+        // Um nível por vez: os nós de um nível são independentes entre si e os pais
+        // (nível anterior) já estão prontos, então os sujos vão juntos para o kernel em lote
+        for (size_t level = 0; level + 1 < mLevelStarts.size(); ++level)
+        {
+            mBatchNodes.clear();
+            for (uint32_t n = mLevelStarts[level]; n < mLevelStarts[level + 1]; ++n)
             {
-                mModelMatrix = glm::rotate(mModelMatrix, mRotation.x, glm::vec3(1.0f, 0.0f, 0.0f));
+                const TransformNode &node = mTransformNodes[n];
+                const Mesh *mesh = mMeshes[node.mesh].get();
+                uint32_t localVersion = mesh ? mesh->getTransformVersion() : 0;
+
+                bool dirty = all || localVersion != mLocalVersions[node.mesh] ||
+                             (node.parent >= 0 && mNodeDirty[node.parent]);
+                mNodeDirty[n] = dirty;
+                if (dirty)
+                {
+                    mLocalVersions[node.mesh] = localVersion;
+                    mBatchNodes.push_back(n);
+                }
             }
-            if (mRotation.y != 0.0f)
+            if (mBatchNodes.empty())
+                continue;
+
+            // =================== PAI * LOCAL E NORMAIS EM LOTE ===================
+            mBatchParents.resize(mBatchNodes.size());
+            mBatchLocals.resize(mBatchNodes.size());
+            for (size_t j = 0; j < mBatchNodes.size(); ++j)
             {
-                mModelMatrix = glm::rotate(mModelMatrix, mRotation.y, glm::vec3(0.0f, 1.0f, 0.0f));
+                const TransformNode &node = mTransformNodes[mBatchNodes[j]];
+                const Mesh *mesh = mMeshes[node.mesh].get();
+                mBatchParents.set(j, node.parent >= 0 ? mWorldMatrices[mTransformNodes[node.parent].mesh] : modelMatrix);
+                mBatchLocals.set(j, mesh ? mesh->getLocalTransform() : glm::mat4(1.0f));
             }
-            if (mRotation.z != 0.0f)
+            TransformKernel::multiply(mBatchParents, mBatchLocals, mBatchWorlds);
+            TransformKernel::normalMatrices(mBatchWorlds, mBatchNormals);
+
+            for (size_t j = 0; j < mBatchNodes.size(); ++j)
             {
-                mModelMatrix = glm::rotate(mModelMatrix, mRotation.z, glm::vec3(0.0f, 0.0f, 1.0f));
+                int meshIndex = mTransformNodes[mBatchNodes[j]].mesh;
+                mWorldMatrices[meshIndex] = mBatchWorlds.get(j);
+                mNormalMatrices[meshIndex] = mBatchNormals.get(j);
+                mWorldStamps[meshIndex] = mWorldVersion + 1;
             }
-
-            // Aplicar escala
-            mModelMatrix = glm::scale(mModelMatrix, mScale);
-
-            mMatrixNeedsUpdate = false;
+            updated += mBatchNodes.size();
         }
 
-        return mModelMatrix;
+        mAllWorldDirty = false;
+        if (updated > 0)
+            ++mWorldVersion;
+        return updated;
     }
 
-    glm::mat4 Model::getWorldMatrixForMesh(const Mesh *mesh) const
+    void Model::rebuildTransformOrder() const
     {
-        if (!mesh)
-            return getModelMatrix();
-        int idx = indexOf(mesh);
-        if (idx < 0)
-            return getModelMatrix();
+        size_t count = mMeshes.size();
+
+        // Filhos de cada mesh em listas contíguas (CSR): firstChild[i]..firstChild[i + 1]
+        std::vector<int> firstChild(count + 1, 0);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (mParents[i] >= 0)
+                firstChild[mParents[i] + 1]++;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            firstChild[i + 1] += firstChild[i];
+        }
+        std::vector<int> children(static_cast<size_t>(firstChild[count]));
+        std::vector<int> cursor(firstChild.begin(), firstChild.end() - 1);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (mParents[i] >= 0)
+                children[cursor[mParents[i]]++] = static_cast<int>(i);
+        }
 
-        // world = Model * (ParentLocal * ... * ChildLocal)
-        return getModelMatrix() * accumulateLocalUpToRoot(idx);
+        // Busca em largura a partir das raízes: cada nó entra depois do seu pai
+        mTransformNodes.clear();
+        mTransformNodes.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (mParents[i] < 0)
+                mTransformNodes.push_back({static_cast<int>(i), -1});
+        }
+        // Os níveis ficam contíguos: mLevelStarts[k] é o primeiro nó de profundidade k
+        mLevelStarts.clear();
+        mLevelStarts.push_back(0);
+        size_t levelEnd = mTransformNodes.size();
+        for (size_t n = 0; n < mTransformNodes.size(); ++n)
+        {
+            if (n == levelEnd)
+            {
+                mLevelStarts.push_back(static_cast<uint32_t>(n));
+                levelEnd = mTransformNodes.size();
+            }
+            int meshIndex = mTransformNodes[n].mesh;
+            for (int c = firstChild[meshIndex]; c < firstChild[meshIndex + 1]; ++c)
+            {
+                mTransformNodes.push_back({children[c], static_cast<int>(n)});
+            }
+        }
+        mLevelStarts.push_back(static_cast<uint32_t>(mTransformNodes.size()));
+
+        mNodeDirty.assign(count, 0);
+        mWorldMatrices.resize(count, glm::mat4(1.0f));
+        mNormalMatrices.resize(count, glm::mat3(1.0f));
+        mLocalVersions.resize(count, 0);
+        mWorldStamps.resize(count, 0);
+
+        mHierarchyDirty = false;
+        mAllWorldDirty = true;
     }
 
     bool Model::setParentByName(const std::string &childName, const std::string &parentName)
@@ -146,38 +254,46 @@ namespace cg
             }
         }
 
-        mParents[cIdx] = pIdx;
+        if (mParents[cIdx] != pIdx)
+        {
+            if (mParents[cIdx] >= 0)
+                mChildCounts[mParents[cIdx]]--;
+            if (pIdx >= 0)
+                mChildCounts[pIdx]++;
+            mParents[cIdx] = pIdx;
+            mHierarchyDirty = true;
+            ++mTransformVersion;
+        }
         return true;
     }
 
-    int Model::indexOf(const Mesh *mesh) const
+    uint64_t Model::getTransformVersion() const
     {
-        for (size_t i = 0; i < mMeshes.size(); ++i)
+        uint64_t version = mTransformVersion;
+        for (const auto &mesh : mMeshes)
         {
-            if (mMeshes[i].get() == mesh)
-                return static_cast<int>(i);
+            if (mesh)
+            {
+                version += mesh->getTransformVersion();
+            }
         }
-        return -1;
+        return version;
     }
 
-    glm::mat4 Model::accumulateLocalUpToRoot(int meshIndex) const
+    bool Model::isInHierarchy(const Mesh *mesh) const
     {
-        glm::mat4 acc(1.0f);
-        int idx = meshIndex;
-        // Constrói cadeia de baixo para cima e acumula em ordem correta (pai antes do filho)
-        // Estratégia: empilhar índices e depois multiplicar na ordem da raiz até o filho
-        std::vector<int> chain;
-        while (idx != -1)
-        {
-            chain.push_back(idx);
-            idx = (idx >= 0 && idx < static_cast<int>(mParents.size())) ? mParents[idx] : -1;
-        }
-        for (int i = static_cast<int>(chain.size()) - 1; i >= 0; --i)
+        int meshIndex = indexOf(mesh);
+        if (meshIndex < 0)
         {
-            const Mesh *m = mMeshes[chain[i]].get();
-            acc = acc * (m ? m->getLocalTransform() : glm::mat4(1.0f));
+            return false;
         }
-        return acc;
+        return mParents[meshIndex] != -1 || mChildCounts[meshIndex] > 0;
+    }
+
+    int Model::indexOf(const Mesh *mesh) const
+    {
+        auto it = mIndexByMesh.find(mesh);
+        return it != mIndexByMesh.end() ? it->second : -1;
     }
 
     size_t Model::getTotalTriangleCount() const
@@ -206,4 +322,41 @@ namespace cg
         return total;
     }
 
+    size_t Model::getTotalGpuMemoryBytes() const
+    {
+        size_t total = 0;
+        for (const auto &mesh : mMeshes)
+        {
+            if (mesh)
+            {
+                total += mesh->getGpuMemoryBytes();
+            }
+        }
+        return total;
+    }
+
+    size_t Model::getTotalCpuMemoryBytes() const
+    {
+        size_t total = 0;
+        for (const auto &mesh : mMeshes)
+        {
+            if (mesh)
+            {
+                total += mesh->getCpuMemoryBytes();
+            }
+        }
+        return total;
+    }
+
+    void Model::setCpuResidency(CpuResidency residency)
+    {
+        for (auto &mesh : mMeshes)
+        {
+            if (mesh)
+            {
+                mesh->setCpuResidency(residency);
+            }
+        }
+    }
+
 } // namespace cg
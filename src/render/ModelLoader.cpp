@@ -1,15 +1,153 @@
 #include "render/ModelLoader.h"
 #include "render/Material.h"
+#include "render/MeshCache.h"
+#include "render/MeshOptimizer.h"
+#include "render/MeshSimplifier.h"
+#include "core/MappedFile.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <chrono>
 #include <algorithm>
 #include <filesystem>
+#include <charconv>
+#include <cstring>
+#include <cstdlib>
+#include <thread>
+#include <atomic>
+#include <cmath>
 
 namespace cg
 {
 
+    // =================== TOKENIZAÇÃO SEM ALOCAÇÃO ===================
+    // Funções auxiliares que operam sobre std::string_view apontando direto
+    // para o buffer do arquivo (mapeado ou linha lida), sem cópias.
+    namespace
+    {
+        constexpr const char *kWhitespace = " \t\r\n\v\f";
+
+        bool isSpace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+        }
+
+        std::string_view trimView(std::string_view str)
+        {
+            size_t start = str.find_first_not_of(" \t\r\n");
+            if (start == std::string_view::npos)
+                return {};
+
+            size_t end = str.find_last_not_of(" \t\r\n");
+            return str.substr(start, end - start + 1);
+        }
+
+        void skipSpaces(std::string_view &str)
+        {
+            size_t i = 0;
+            while (i < str.size() && isSpace(str[i]))
+                ++i;
+            str.remove_prefix(i);
+        }
+
+        // Extrai o próximo token separado por espaços (equivalente a "iss >> token")
+        std::string_view nextToken(std::string_view &str)
+        {
+            skipSpaces(str);
+            size_t end = str.find_first_of(kWhitespace);
+            if (end == std::string_view::npos)
+                end = str.size();
+            std::string_view token = str.substr(0, end);
+            str.remove_prefix(end);
+            return token;
+        }
+
+        // Lê um float a partir da posição atual (equivalente a "iss >> value").
+        // Avança a visão até o fim do número lido.
+        bool parseFloat(std::string_view &str, float &value)
+        {
+            skipSpaces(str);
+            const char *first = str.data();
+            const char *last = str.data() + str.size();
+            if (first != last && *first == '+')
+                ++first; // std::from_chars não aceita '+' explícito
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            auto [ptr, ec] = std::from_chars(first, last, value);
+            if (ec != std::errc() || ptr == first)
+                return false;
+#else
+            // Fallback para bibliotecas sem from_chars de ponto flutuante:
+            // copia o número para um buffer local terminado em '\0'
+            char buffer[64];
+            size_t len = 0;
+            while (first + len != last && len < sizeof(buffer) - 1 && !isSpace(first[len]))
+            {
+                buffer[len] = first[len];
+                ++len;
+            }
+            buffer[len] = '\0';
+            char *endPtr = nullptr;
+            value = std::strtof(buffer, &endPtr);
+            if (endPtr == buffer)
+                return false;
+            const char *ptr = first + (endPtr - buffer);
+#endif
+            str.remove_prefix(static_cast<size_t>(ptr - str.data()));
+            return true;
+        }
+
+        // Lê um inteiro no início da string (equivalente a std::stoi, sem exceções)
+        bool parseInt(std::string_view str, int &value)
+        {
+            const char *first = str.data();
+            const char *last = str.data() + str.size();
+            if (first != last && *first == '+')
+                ++first;
+
+            auto [ptr, ec] = std::from_chars(first, last, value);
+            return ec == std::errc() && ptr != first;
+        }
+
+        bool startsWith(std::string_view str, std::string_view prefix)
+        {
+            return str.size() >= prefix.size() && str.compare(0, prefix.size(), prefix) == 0;
+        }
+
+        // Executa fn(mesh) para todas as meshes em até workerCount threads.
+        // Meshes maiores primeiro: evita que uma mesh grande fique por último em uma única thread
+        template <typename Fn>
+        void forEachMeshParallel(std::vector<MeshData> &meshes, unsigned workerCount, Fn &&fn)
+        {
+            std::vector<size_t> order(meshes.size());
+            for (size_t i = 0; i < order.size(); ++i)
+                order[i] = i;
+            std::sort(order.begin(), order.end(), [&meshes](size_t a, size_t b)
+                      { return meshes[a].indices.size() > meshes[b].indices.size(); });
+
+            std::atomic<size_t> next{0};
+            auto worker = [&]()
+            {
+                for (size_t i = next++; i < order.size(); i = next++)
+                {
+                    fn(order[i], meshes[order[i]]);
+                }
+            };
+
+            std::vector<std::thread> threads;
+            unsigned threadCount = static_cast<unsigned>(std::min<size_t>(workerCount, order.size()));
+            for (unsigned t = 1; t < threadCount; ++t)
+            {
+                threads.emplace_back(worker);
+            }
+            worker();
+            for (auto &thread : threads)
+            {
+                thread.join();
+            }
+        }
+    } // namespace
+
     // Inicialização do membro estático
     ModelLoader::LoadStats ModelLoader::sLastStats;
 
@@ -19,25 +157,115 @@ namespace cg
         std::cout << "Meshes criadas: " << totalMeshes << std::endl;
         std::cout << "Vértices únicos: " << totalVertices << std::endl;
         std::cout << "Triângulos: " << totalTriangles << std::endl;
+        std::cout << "Origem: " << (fromCache ? "cache binário" : "parsing do OBJ") << std::endl;
+        std::cout << "Linhas processadas: " << totalLines << std::endl;
+        std::cout << "Tempo de parsing: " << parseTimeMs << " ms ("
+                  << static_cast<size_t>(linesPerSecond) << " linhas/s)" << std::endl;
+        if (optimizeTimeMs > 0.0f)
+        {
+            std::cout << "Otimização de meshes: " << optimizeTimeMs << " ms (ACMR "
+                      << acmrBefore << " -> " << acmrAfter << ", ATVR "
+                      << atvrBefore << " -> " << atvrAfter << ")" << std::endl;
+        }
+        if (lodTimeMs > 0.0f)
+        {
+            std::cout << "LODs: " << lodLevels << " níveis em " << lodMeshes << " meshes ("
+                      << lodTimeMs << " ms)" << std::endl;
+        }
+        if (sharedGeometryMeshes > 0)
+        {
+            std::cout << "Geometria compartilhada: " << sharedGeometryMeshes << " meshes duplicadas ("
+                      << sharedGeometryBytes / 1024 << " KB a menos na GPU)" << std::endl;
+        }
         std::cout << "Tempo de carregamento: " << loadTimeMs << " ms" << std::endl;
         std::cout << "===================================" << std::endl;
     }
 
     std::unique_ptr<Model> ModelLoader::loadModel(const std::string &filePath, const std::string &modelName)
+    {
+        return loadModel(filePath, modelName, LoadOptions{});
+    }
+
+    std::unique_ptr<Model> ModelLoader::loadModel(const std::string &filePath, const std::string &modelName,
+                                                  const LoadOptions &options)
+    {
+        LoadStats stats;
+        auto data = loadModelData(filePath, modelName, options, &stats);
+        sLastStats = stats;
+        if (!data)
+            return nullptr;
+
+        // =================== UPLOAD PARA A GPU ===================
+        auto uploadStart = std::chrono::high_resolution_clock::now();
+        auto model = uploadModel(std::move(*data), options.vertexFormat, options.cpuResidency);
+        auto uploadEnd = std::chrono::high_resolution_clock::now();
+
+        sLastStats.uploadTimeMs = std::chrono::duration_cast<std::chrono::microseconds>(uploadEnd - uploadStart).count() / 1000.0f;
+        std::cout << "Upload para a GPU: " << sLastStats.uploadTimeMs << " ms ("
+                  << model->getTotalGpuMemoryBytes() / 1024 << " KB)" << std::endl;
+        return model;
+    }
+
+    std::future<ModelLoader::AsyncResult> ModelLoader::loadModelDataAsync(const std::string &filePath,
+                                                                          const std::string &modelName,
+                                                                          const LoadOptions &options)
+    {
+        // Parâmetros copiados: a chamada pode retornar antes de o carregamento começar
+        auto task = [filePath, modelName, options]()
+        {
+            AsyncResult result;
+            result.data = loadModelData(filePath, modelName, options, &result.stats);
+            return result;
+        };
+        return std::async(std::launch::async, std::move(task));
+    }
+
+    std::unique_ptr<Model> ModelLoader::uploadModel(ModelData &&data, VertexFormat format, CpuResidency residency)
+    {
+        auto model = std::make_unique<Model>(data.name);
+        for (MeshData &meshData : data.meshes)
+        {
+            // As meshes entram no modelo na ordem de data, então o índice da geometria vale nos dois
+            if (meshData.sharedGeometry >= 0)
+            {
+                const Mesh &geometry = *model->getMeshes()[static_cast<size_t>(meshData.sharedGeometry)];
+                model->addMesh(std::make_unique<Mesh>(std::move(meshData), geometry, residency));
+            }
+            else
+            {
+                model->addMesh(std::make_unique<Mesh>(std::move(meshData), format, residency));
+            }
+        }
+        data.meshes.clear();
+        return model;
+    }
+
+    std::unique_ptr<ModelData> ModelLoader::loadModelData(const std::string &filePath, const std::string &modelName,
+                                                          const LoadOptions &options, LoadStats *stats)
     {
         auto startTime = std::chrono::high_resolution_clock::now();
 
-        // Reseta estatísticas
-        sLastStats = LoadStats{};
+        // Estatísticas locais: loadModelData pode rodar em várias threads ao mesmo tempo
+        LoadStats loadStats;
+        if (stats)
+            *stats = loadStats;
 
         std::cout << "Carregando modelo OBJ: " << filePath << std::endl;
 
         // =================== ABERTURA DO ARQUIVO ===================
-        std::ifstream file(filePath);
-        if (!file.is_open())
+        // Preferência: mapear o arquivo inteiro em memória e tokenizar direto dos bytes.
+        // Se o mapeamento não estiver disponível, recorre à leitura com std::getline.
+        MappedFile mapped;
+        std::ifstream file;
+        bool useMapped = options.useMemoryMap && mapped.open(filePath);
+        if (!useMapped)
         {
-            std::cerr << "ERRO: Não foi possível abrir o arquivo: " << filePath << std::endl;
-            return nullptr;
+            file.open(filePath);
+            if (!file.is_open())
+            {
+                std::cerr << "ERRO: Não foi possível abrir o arquivo: " << filePath << std::endl;
+                return nullptr;
+            }
         }
 
         // =================== CRIAÇÃO DO MODELO ===================
@@ -49,14 +277,55 @@ namespace cg
             finalName = path.stem().string();
         }
 
-        auto model = std::make_unique<Model>(finalName);
+        // Threads do parsing e do pós-processamento das meshes
+        unsigned workerCount = options.workerCount;
+        if (workerCount == 0)
+        {
+            workerCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // =================== CACHE BINÁRIO ===================
+        // Se existir um cache válido para este arquivo, as meshes vêm direto dele
+        MeshCache::SourceKey cacheKey;
+        std::string cachePath;
+        bool cacheUsable = options.useCache && useMapped && MeshCache::makeSourceKey(filePath, mapped.view(), cacheKey);
+        if (cacheUsable)
+        {
+            cachePath = MeshCache::cachePathFor(filePath);
+            if (auto cached = MeshCache::load(cachePath, cacheKey, kLoaderVersion, processingFlags(options), finalName))
+            {
+                computeBounds(*cached, workerCount);
+                if (options.shareDuplicateGeometry)
+                {
+                    shareDuplicateGeometry(*cached, workerCount, options.vertexFormat, loadStats);
+                }
+
+                auto endTime = std::chrono::high_resolution_clock::now();
+                auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+
+                loadStats.totalMeshes = cached->getMeshCount();
+                loadStats.totalVertices = cached->getTotalVertexCount();
+                loadStats.totalTriangles = cached->getTotalTriangleCount();
+                loadStats.loadTimeMs = duration.count() / 1000.0f;
+                loadStats.fromCache = true;
+
+                std::cout << "Modelo carregado do cache: " << cachePath << std::endl;
+                loadStats.print();
+                if (stats)
+                    *stats = loadStats;
+                return cached;
+            }
+        }
+
+        auto model = std::make_unique<ModelData>();
+        model->name = finalName;
         ParseData data;
 
         // =================== PARSING LINHA POR LINHA ===================
-        std::string line;
         size_t lineNumber = 0;
+        auto parseStart = std::chrono::high_resolution_clock::now();
 
-        while (std::getline(file, line))
+        auto processLine = [&](std::string_view line)
         {
             lineNumber++;
 
@@ -66,115 +335,457 @@ namespace cg
                 std::cout << "Processando linha " << lineNumber << "..." << std::endl;
             }
 
-            try
-            {
-                parseLine(line, data, *model, filePath);
-            }
-            catch (const std::exception &e)
+            if (!parseLine(line, data, *model, filePath))
             {
-                std::cerr << "ERRO na linha " << lineNumber << ": " << e.what() << std::endl;
+                std::cerr << "ERRO na linha " << lineNumber << ": " << data.lastError << std::endl;
                 std::cerr << "Linha: " << line << std::endl;
                 // Continua o processamento mesmo com erros
             }
+        };
+
+        if (useMapped && workerCount > 1)
+        {
+            // Modo paralelo: blocos processados por workers + merge determinístico
+            lineNumber = parseParallel(mapped.view(), data, *model, filePath, workerCount);
+            loadStats.workerThreads = workerCount;
         }
+        else if (useMapped)
+        {
+            // Tabela de deduplicação reservada pelos cantos de face de cada objeto
+            std::vector<const char *> objectLines;
+            std::vector<size_t> objectCorners = countObjectCorners(mapped.view(), objectLines);
+            size_t nextObject = 0;
+            data.vertexMap.reserve(objectCorners[0]);
+
+            // Percorre o buffer mapeado separando linhas por '\n' (sem cópias)
+            const char *cursor = mapped.data();
+            const char *end = cursor + mapped.size();
+            while (cursor < end)
+            {
+                const char *newline = static_cast<const char *>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+                const char *lineEnd = newline ? newline : end;
+                processLine(std::string_view(cursor, static_cast<size_t>(lineEnd - cursor)));
+                if (nextObject < objectLines.size() && cursor == objectLines[nextObject])
+                {
+                    data.vertexMap.reserve(objectCorners[++nextObject]);
+                }
+                cursor = newline ? newline + 1 : end;
+            }
+        }
+        else
+        {
+            std::string line;
+            while (std::getline(file, line))
+            {
+                processLine(line);
+            }
+        }
+
+        auto parseEnd = std::chrono::high_resolution_clock::now();
 
         // =================== FINALIZAÇÃO ===================
         // Finaliza a mesh atual se houver dados pendentes
         finalizeMesh(data, *model);
 
-        file.close();
+        mapped.close();
+        if (file.is_open())
+            file.close();
+
+        // =================== OTIMIZAÇÃO DAS MESHES ===================
+        if (options.optimizeMeshes)
+        {
+            optimizeMeshes(*model, workerCount, loadStats);
+        }
+
+        // =================== NÍVEIS DE DETALHE ===================
+        // Depois da otimização: os LODs referenciam a ordem final dos vértices
+        if (options.generateLods)
+        {
+            generateLods(*model, workerCount, options.optimizeMeshes, loadStats);
+        }
+
+        // =================== VOLUMES ENVOLVENTES ===================
+        computeBounds(*model, workerCount);
+
+        // =================== GEOMETRIA DUPLICADA ===================
+        // Só marca as duplicatas: os arrays continuam completos (e o cache binário também)
+        if (options.shareDuplicateGeometry)
+        {
+            shareDuplicateGeometry(*model, workerCount, options.vertexFormat, loadStats);
+        }
 
         // =================== CÁLCULO DE ESTATÍSTICAS ===================
         auto endTime = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-
-        sLastStats.totalMeshes = model->getMeshCount();
-        sLastStats.totalVertices = model->getTotalVertexCount();
-        sLastStats.totalTriangles = model->getTotalTriangleCount();
-        sLastStats.loadTimeMs = duration.count() / 1000.0f;
+        auto parseDuration = std::chrono::duration_cast<std::chrono::microseconds>(parseEnd - parseStart);
+
+        loadStats.totalMeshes = model->getMeshCount();
+        loadStats.totalVertices = model->getTotalVertexCount();
+        loadStats.totalTriangles = model->getTotalTriangleCount();
+        loadStats.totalLines = lineNumber;
+        loadStats.loadTimeMs = duration.count() / 1000.0f;
+        loadStats.parseTimeMs = parseDuration.count() / 1000.0f;
+        if (parseDuration.count() > 0)
+        {
+            loadStats.linesPerSecond = static_cast<double>(lineNumber) * 1.0e6 / static_cast<double>(parseDuration.count());
+        }
 
         std::cout << "Modelo carregado com sucesso!" << std::endl;
-        sLastStats.print();
+        loadStats.print();
+        if (stats)
+            *stats = loadStats;
 
         // Verifica se o modelo está vazio
-        if (model->isEmpty())
+        if (model->meshes.empty())
         {
             std::cerr << "AVISO: Modelo carregado está vazio (nenhuma mesh válida)" << std::endl;
         }
+        else if (cacheUsable)
+        {
+            // Grava (ou reconstrói) o cache para os próximos carregamentos, junto com o
+            // estado das bibliotecas .mtl de onde vieram os materiais
+            std::vector<MeshCache::Dependency> dependencies;
+            for (const std::string &library : data.materialLibraries)
+            {
+                bool seen = std::any_of(dependencies.begin(), dependencies.end(),
+                                        [&](const MeshCache::Dependency &dependency)
+                                        { return dependency.path == library; });
+                if (!seen)
+                    dependencies.push_back(MeshCache::makeDependency(library));
+            }
+            MeshCache::write(cachePath, cacheKey, dependencies, kLoaderVersion, processingFlags(options), *model);
+        }
 
         return model;
     }
 
-    void ModelLoader::parseLine(const std::string &line, ParseData &data, Model &model, const std::string &objFilePath)
+    bool ModelLoader::parseLine(std::string_view line, ParseData &data, ModelData &model, const std::string &objFilePath)
     {
-        std::string trimmedLine = trim(line);
+        std::string_view trimmedLine = trimView(line);
 
+        switch (classifyLine(trimmedLine))
+        {
+        case LineType::Vertex:
+            return parseVertex(trimmedLine, data);
+        case LineType::Normal:
+            return parseNormal(trimmedLine, data);
+        case LineType::TexCoord:
+            return parseTexCoord(trimmedLine, data);
+        case LineType::Face:
+            return parseFace(trimmedLine, data);
+        case LineType::Object:
+            parseObject(trimmedLine, data, model);
+            break;
+        case LineType::MaterialLib:
+            parseMaterialLib(trimmedLine, data, objFilePath);
+            break;
+        case LineType::UseMaterial:
+            parseUseMaterial(trimmedLine, data);
+            break;
+        case LineType::Ignored:
+            break;
+        }
+        return true;
+    }
+
+    ModelLoader::LineType ModelLoader::classifyLine(std::string_view trimmedLine)
+    {
         // Ignora linhas vazias e comentários
         if (trimmedLine.empty() || trimmedLine[0] == '#')
         {
-            return;
+            return LineType::Ignored;
         }
 
         // Identifica o tipo de linha baseado no primeiro token
         if (trimmedLine.size() >= 2)
         {
             if (trimmedLine[0] == 'v' && trimmedLine[1] == ' ')
+                return LineType::Vertex;
+            if (startsWith(trimmedLine, "vn"))
+                return LineType::Normal;
+            if (startsWith(trimmedLine, "vt"))
+                return LineType::TexCoord;
+            if (trimmedLine[0] == 'f' && trimmedLine[1] == ' ')
+                return LineType::Face;
+            if (trimmedLine[0] == 'o' && trimmedLine[1] == ' ')
+                return LineType::Object;
+            if (startsWith(trimmedLine, "mtllib"))
+                return LineType::MaterialLib;
+            if (startsWith(trimmedLine, "usemtl"))
+                return LineType::UseMaterial;
+        }
+
+        // Ignora outras linhas (s, g, etc.)
+        return LineType::Ignored;
+    }
+
+    size_t ModelLoader::parseParallel(std::string_view buffer, ParseData &data, ModelData &model,
+                                      const std::string &objFilePath, unsigned workerCount)
+    {
+        // =================== DIVISÃO EM BLOCOS ===================
+        // Alguns blocos por worker equilibram a carga quando objetos têm tamanhos diferentes
+        size_t chunkCount = std::max<size_t>(1, std::min<size_t>(static_cast<size_t>(workerCount) * 4,
+                                                                 buffer.size() / (64 * 1024) + 1));
+        std::vector<ParseChunk> chunks(chunkCount);
+
+        size_t begin = 0;
+        for (size_t i = 0; i < chunkCount; ++i)
+        {
+            size_t end = (i + 1 == chunkCount) ? buffer.size() : buffer.size() * (i + 1) / chunkCount;
+            if (end < begin)
+                end = begin;
+
+            // Avança até depois da próxima quebra de linha para não cortar linhas
+            if (end < buffer.size())
             {
-                parseVertex(trimmedLine, data);
+                size_t newline = buffer.find('\n', end);
+                end = (newline == std::string_view::npos) ? buffer.size() : newline + 1;
             }
-            else if (trimmedLine.substr(0, 2) == "vn")
+
+            chunks[i].text = buffer.substr(begin, end - begin);
+            begin = end;
+        }
+
+        // =================== PARSING DOS BLOCOS (WORKERS) ===================
+        std::atomic<size_t> nextChunk{0};
+        auto worker = [&]()
+        {
+            for (size_t i = nextChunk++; i < chunkCount; i = nextChunk++)
             {
-                parseNormal(trimmedLine, data);
+                parseChunk(chunks[i]);
             }
-            else if (trimmedLine.substr(0, 2) == "vt")
+        };
+
+        std::vector<std::thread> threads;
+        unsigned threadCount = static_cast<unsigned>(std::min<size_t>(workerCount, chunkCount));
+        for (unsigned t = 1; t < threadCount; ++t)
+        {
+            threads.emplace_back(worker);
+        }
+        worker(); // a thread atual também processa blocos
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        // =================== RESERVA DA TABELA DE VÉRTICES ===================
+        // Conta os cantos de face de cada objeto para reservar a tabela de deduplicação
+        // uma única vez por objeto (a tabela é reaproveitada entre finalizeMesh)
+        std::vector<size_t> objectCorners(1, 0);
+        for (const ParseChunk &chunk : chunks)
+        {
+            for (const ChunkEvent &event : chunk.events)
             {
-                parseTexCoord(trimmedLine, data);
+                if (event.error)
+                    continue;
+                if (event.type == LineType::Object)
+                    objectCorners.push_back(0);
+                else if (event.type == LineType::Face)
+                    objectCorners.back() += event.faceIndexCount;
             }
-            else if (trimmedLine[0] == 'f' && trimmedLine[1] == ' ')
+        }
+        size_t currentObject = 0;
+        data.vertexMap.reserve(objectCorners[0]);
+
+        // =================== MERGE DETERMINÍSTICO ===================
+        // Reproduz os eventos na ordem do arquivo. Os arrays globais de v/vn/vt crescem
+        // até a contagem registrada em cada evento, de modo que índices relativos
+        // (negativos) e validações de limite enxergam exatamente o mesmo estado do modo serial.
+        size_t lineOffset = 0;
+        for (ParseChunk &chunk : chunks)
+        {
+            size_t appendedPositions = 0;
+            size_t appendedTexCoords = 0;
+            size_t appendedNormals = 0;
+
+            auto appendUpTo = [&](size_t positions, size_t texCoords, size_t normals)
+            {
+                data.positions.insert(data.positions.end(),
+                                      chunk.data.positions.begin() + appendedPositions,
+                                      chunk.data.positions.begin() + positions);
+                data.texCoords.insert(data.texCoords.end(),
+                                      chunk.data.texCoords.begin() + appendedTexCoords,
+                                      chunk.data.texCoords.begin() + texCoords);
+                data.normals.insert(data.normals.end(),
+                                    chunk.data.normals.begin() + appendedNormals,
+                                    chunk.data.normals.begin() + normals);
+                appendedPositions = positions;
+                appendedTexCoords = texCoords;
+                appendedNormals = normals;
+            };
+
+            for (const ChunkEvent &event : chunk.events)
             {
-                parseFace(trimmedLine, data);
+                appendUpTo(event.positionCount, event.texCoordCount, event.normalCount);
+
+                if (event.error)
+                {
+                    std::cerr << "ERRO na linha " << lineOffset + event.lineNumber << ": " << event.error << std::endl;
+                    std::cerr << "Linha: " << event.line << std::endl;
+                    continue;
+                }
+
+                switch (event.type)
+                {
+                case LineType::Face:
+                    data.faceScratch.assign(chunk.faceIndices.begin() + event.firstFaceIndex,
+                                            chunk.faceIndices.begin() + event.firstFaceIndex + event.faceIndexCount);
+                    emitFace(data);
+                    break;
+                case LineType::Object:
+                    parseObject(event.line, data, model);
+                    data.vertexMap.reserve(objectCorners[++currentObject]);
+                    break;
+                case LineType::MaterialLib:
+                    parseMaterialLib(event.line, data, objFilePath);
+                    break;
+                case LineType::UseMaterial:
+                    parseUseMaterial(event.line, data);
+                    break;
+                default:
+                    break;
+                }
             }
-            else if (trimmedLine[0] == 'o' && trimmedLine[1] == ' ')
+
+            appendUpTo(chunk.data.positions.size(), chunk.data.texCoords.size(), chunk.data.normals.size());
+            lineOffset += chunk.lineCount;
+
+            // Libera a memória do bloco assim que ele foi incorporado
+            chunk = ParseChunk{};
+        }
+
+        return lineOffset;
+    }
+
+    std::vector<size_t> ModelLoader::countObjectCorners(std::string_view buffer, std::vector<const char *> &objectLines)
+    {
+        std::vector<size_t> objectCorners(1, 0);
+        const char *cursor = buffer.data();
+        const char *end = cursor + buffer.size();
+        while (cursor < end)
+        {
+            const char *newline = static_cast<const char *>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+            const char *lineEnd = newline ? newline : end;
+            std::string_view trimmedLine = trimView(std::string_view(cursor, static_cast<size_t>(lineEnd - cursor)));
+
+            // Só "f " e "o " interessam: decide pelo primeiro caractere, sem classifyLine
+            if (trimmedLine.size() >= 2 && (trimmedLine[1] == ' ' || trimmedLine[1] == '\t'))
             {
-                parseObject(trimmedLine, data, model);
+                if (trimmedLine[0] == 'f')
+                {
+                    // Um canto por separador depois de "f" (espaços repetidos só superestimam a reserva)
+                    objectCorners.back() += static_cast<size_t>(
+                        std::count_if(trimmedLine.begin() + 1, trimmedLine.end(), [](char c)
+                                      { return c == ' ' || c == '\t'; }));
+                }
+                else if (trimmedLine[0] == 'o')
+                {
+                    objectLines.push_back(cursor);
+                    objectCorners.push_back(0);
+                }
             }
-            else if (trimmedLine.substr(0, 6) == "mtllib")
+            cursor = newline ? newline + 1 : end;
+        }
+        return objectCorners;
+    }
+
+    void ModelLoader::parseChunk(ParseChunk &chunk)
+    {
+        const char *cursor = chunk.text.data();
+        const char *end = cursor + chunk.text.size();
+
+        while (cursor < end)
+        {
+            const char *newline = static_cast<const char *>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+            const char *lineEnd = newline ? newline : end;
+            std::string_view line(cursor, static_cast<size_t>(lineEnd - cursor));
+            cursor = newline ? newline + 1 : end;
+
+            chunk.lineCount++;
+            std::string_view trimmedLine = trimView(line);
+            LineType type = classifyLine(trimmedLine);
+
+            bool ok = true;
+            switch (type)
+            {
+            case LineType::Vertex:
+                ok = parseVertex(trimmedLine, chunk.data);
+                break;
+            case LineType::Normal:
+                ok = parseNormal(trimmedLine, chunk.data);
+                break;
+            case LineType::TexCoord:
+                ok = parseTexCoord(trimmedLine, chunk.data);
+                break;
+            case LineType::Ignored:
+                break;
+            default:
             {
-                parseMaterialLib(trimmedLine, data, objFilePath);
+                // f/o/mtllib/usemtl dependem do estado global: registra para o merge
+                ChunkEvent event;
+                event.type = type;
+                event.line = trimmedLine;
+                event.lineNumber = chunk.lineCount;
+                event.positionCount = chunk.data.positions.size();
+                event.texCoordCount = chunk.data.texCoords.size();
+                event.normalCount = chunk.data.normals.size();
+
+                if (type == LineType::Face)
+                {
+                    event.firstFaceIndex = chunk.faceIndices.size();
+                    if (tokenizeFace(trimmedLine, chunk.faceIndices))
+                    {
+                        event.faceIndexCount = chunk.faceIndices.size() - event.firstFaceIndex;
+                    }
+                    else
+                    {
+                        chunk.faceIndices.resize(event.firstFaceIndex);
+                        event.line = line;
+                        event.error = "Índice de face inválido";
+                    }
+                }
+                chunk.events.push_back(event);
+                break;
             }
-            else if (trimmedLine.substr(0, 6) == "usemtl")
+            }
+
+            if (!ok)
             {
-                parseUseMaterial(trimmedLine, data);
+                // Erros de v/vn/vt também viram eventos para serem reportados em ordem
+                ChunkEvent event;
+                event.type = type;
+                event.line = line;
+                event.lineNumber = chunk.lineCount;
+                event.positionCount = chunk.data.positions.size();
+                event.texCoordCount = chunk.data.texCoords.size();
+                event.normalCount = chunk.data.normals.size();
+                event.error = chunk.data.lastError;
+                chunk.events.push_back(event);
             }
-            // Ignora outras linhas (s, g, etc.)
         }
     }
 
-    void ModelLoader::parseVertex(const std::string &line, ParseData &data)
+    bool ModelLoader::parseVertex(std::string_view line, ParseData &data)
     {
-        std::istringstream iss(line);
-        std::string token;
-        iss >> token; // consome o 'v'
+        nextToken(line); // consome o 'v'
 
         float x, y, z;
-        if (iss >> x >> y >> z)
+        if (parseFloat(line, x) && parseFloat(line, y) && parseFloat(line, z))
         {
             data.positions.emplace_back(x, y, z);
+            return true;
         }
-        else
-        {
-            throw std::runtime_error("Formato inválido para vértice");
-        }
+
+        data.lastError = "Formato inválido para vértice";
+        return false;
     }
 
-    void ModelLoader::parseNormal(const std::string &line, ParseData &data)
+    bool ModelLoader::parseNormal(std::string_view line, ParseData &data)
     {
-        std::istringstream iss(line);
-        std::string token;
-        iss >> token; // consome o 'vn'
+        nextToken(line); // consome o 'vn'
 
         float x, y, z;
-        if (iss >> x >> y >> z)
+        if (parseFloat(line, x) && parseFloat(line, y) && parseFloat(line, z))
         {
             // Normaliza o vetor (alguns arquivos OBJ têm normais não-normalizadas)
             glm::vec3 normal(x, y, z);
@@ -184,44 +795,63 @@ namespace cg
                 normal /= length;
             }
             data.normals.push_back(normal);
+            return true;
         }
-        else
-        {
-            throw std::runtime_error("Formato inválido para normal");
-        }
+
+        data.lastError = "Formato inválido para normal";
+        return false;
     }
 
-    void ModelLoader::parseTexCoord(const std::string &line, ParseData &data)
+    bool ModelLoader::parseTexCoord(std::string_view line, ParseData &data)
     {
-        std::istringstream iss(line);
-        std::string token;
-        iss >> token; // consome o 'vt'
+        nextToken(line); // consome o 'vt'
 
         float u, v = 0.0f;
-        if (iss >> u)
+        if (parseFloat(line, u))
         {
-            iss >> v; // v é opcional em alguns arquivos
+            if (!parseFloat(line, v)) // v é opcional em alguns arquivos
+                v = 0.0f;
             data.texCoords.emplace_back(u, v);
+            return true;
         }
-        else
+
+        data.lastError = "Formato inválido para coordenada de textura";
+        return false;
+    }
+
+    bool ModelLoader::parseFace(std::string_view line, ParseData &data)
+    {
+        data.faceScratch.clear();
+        if (!tokenizeFace(line, data.faceScratch))
         {
-            throw std::runtime_error("Formato inválido para coordenada de textura");
+            data.lastError = "Índice de face inválido";
+            return false;
         }
+
+        emitFace(data);
+        return true;
     }
 
-    void ModelLoader::parseFace(const std::string &line, ParseData &data)
+    bool ModelLoader::tokenizeFace(std::string_view line, std::vector<FaceIndex> &out)
     {
-        std::istringstream iss(line);
-        std::string token;
-        iss >> token; // consome o 'f'
-
-        std::vector<FaceIndex> faceIndices;
+        nextToken(line); // consome o 'f'
 
         // Lê todos os índices da face
-        while (iss >> token)
+        for (std::string_view token = nextToken(line); !token.empty(); token = nextToken(line))
         {
-            faceIndices.push_back(parseFaceIndex(token));
+            FaceIndex faceIndex;
+            if (!parseFaceIndex(token, faceIndex))
+            {
+                return false;
+            }
+            out.push_back(faceIndex);
         }
+        return true;
+    }
+
+    void ModelLoader::emitFace(ParseData &data)
+    {
+        std::vector<FaceIndex> &faceIndices = data.faceScratch;
 
         // Converte índices relativos para absolutos
         for (auto &faceIndex : faceIndices)
@@ -243,16 +873,16 @@ namespace cg
         }
     }
 
-    void ModelLoader::parseObject(const std::string &line, ParseData &data, Model &model)
+    void ModelLoader::parseObject(std::string_view line, ParseData &data, ModelData &model)
     {
         // Finaliza a mesh atual antes de começar uma nova
         finalizeMesh(data, model);
 
         // Extrai o nome do objeto
         size_t spacePos = line.find(' ');
-        if (spacePos != std::string::npos && spacePos + 1 < line.size())
+        if (spacePos != std::string_view::npos && spacePos + 1 < line.size())
         {
-            data.currentObjectName = trim(line.substr(spacePos + 1));
+            data.currentObjectName = std::string(trimView(line.substr(spacePos + 1)));
         }
         else
         {
@@ -262,7 +892,7 @@ namespace cg
         std::cout << "Iniciando objeto: " << data.currentObjectName << std::endl;
     }
 
-    void ModelLoader::finalizeMesh(ParseData &data, Model &model)
+    void ModelLoader::finalizeMesh(ParseData &data, ModelData &model)
     {
         if (!data.currentVertices.empty() && !data.currentIndices.empty())
         {
@@ -287,8 +917,12 @@ namespace cg
                 material = detectMaterialFromName(meshName);
             }
 
-            auto mesh = std::make_unique<Mesh>(data.currentVertices, data.currentIndices, meshName, material);
-            model.addMesh(std::move(mesh));
+            // Os arrays da mesh atual são movidos para o ModelData (sem cópia)
+            MeshData &mesh = model.meshes.emplace_back();
+            mesh.vertices = std::move(data.currentVertices);
+            mesh.indices = std::move(data.currentIndices);
+            mesh.name = std::move(meshName);
+            mesh.material = std::move(material);
 
             // Limpa dados da mesh atual
             data.currentVertices.clear();
@@ -299,28 +933,27 @@ namespace cg
         }
     }
 
-    ModelLoader::FaceIndex ModelLoader::parseFaceIndex(const std::string &indexStr)
+    bool ModelLoader::parseFaceIndex(std::string_view indexStr, FaceIndex &faceIndex)
     {
-        FaceIndex faceIndex;
+        // Percorre as partes separadas por '/' (v, vt, vn); partes vazias são ignoradas
+        int *targets[3] = {&faceIndex.positionIndex, &faceIndex.texCoordIndex, &faceIndex.normalIndex};
 
-        std::vector<std::string> parts = split(indexStr, '/');
-
-        if (!parts.empty() && !parts[0].empty())
+        for (int part = 0; part < 3 && !indexStr.empty(); ++part)
         {
-            faceIndex.positionIndex = std::stoi(parts[0]);
-        }
+            size_t slash = indexStr.find('/');
+            std::string_view component = indexStr.substr(0, slash);
 
-        if (parts.size() > 1 && !parts[1].empty())
-        {
-            faceIndex.texCoordIndex = std::stoi(parts[1]);
-        }
+            if (!component.empty() && !parseInt(component, *targets[part]))
+            {
+                return false;
+            }
 
-        if (parts.size() > 2 && !parts[2].empty())
-        {
-            faceIndex.normalIndex = std::stoi(parts[2]);
+            if (slash == std::string_view::npos)
+                break;
+            indexStr.remove_prefix(slash + 1);
         }
 
-        return faceIndex;
+        return true;
     }
 
     void ModelLoader::FaceIndex::makeAbsolute(size_t posCount, size_t texCount, size_t normCount)
@@ -348,22 +981,110 @@ namespace cg
             normalIndex--;
     }
 
-    std::string ModelLoader::FaceIndex::getKey() const
+    // =================== DEDUPLICAÇÃO DE VÉRTICES ===================
+
+    namespace
+    {
+        // Mistura a tripla de índices em um hash de 64 bits (multiplicação + xorshift)
+        uint64_t hashFaceIndex(int p, int t, int n)
+        {
+            uint64_t h = static_cast<uint32_t>(p);
+            h = h * 0x9E3779B97F4A7C15ull ^ static_cast<uint32_t>(t);
+            h = h * 0xC2B2AE3D27D4EB4Full ^ static_cast<uint32_t>(n);
+            h ^= h >> 29;
+            h *= 0xBF58476D1CE4E5B9ull;
+            h ^= h >> 32;
+            return h;
+        }
+    } // namespace
+
+    void ModelLoader::VertexDedupTable::reserve(size_t expectedKeys)
     {
-        return std::to_string(positionIndex) + "/" +
-               std::to_string(texCoordIndex) + "/" +
-               std::to_string(normalIndex);
+        // Mantém fator de carga <= 0.5
+        size_t needed = 16;
+        while (needed < expectedKeys * 2)
+            needed <<= 1;
+
+        if (needed > mSlots.size())
+            rehash(needed);
     }
 
-    GLuint ModelLoader::getOrCreateVertex(const FaceIndex &faceIndex, ParseData &data)
+    void ModelLoader::VertexDedupTable::clear()
     {
-        std::string key = faceIndex.getKey();
+        mSize = 0;
+        if (++mGeneration == 0)
+        {
+            // Contador de gerações deu a volta: zera os slots de fato
+            for (Slot &slot : mSlots)
+                slot.generation = 0;
+            mGeneration = 1;
+        }
+    }
 
-        // Verifica se já existe um vértice com estes índices
-        auto it = data.vertexMap.find(key);
-        if (it != data.vertexMap.end())
+    GLuint ModelLoader::VertexDedupTable::findOrInsert(const FaceIndex &key, GLuint value, bool &inserted)
+    {
+        if ((mSize + 1) * 2 > mSlots.size())
+            rehash(mSlots.empty() ? 1024 : mSlots.size() * 2);
+
+        size_t mask = mSlots.size() - 1;
+        size_t i = static_cast<size_t>(hashFaceIndex(key.positionIndex, key.texCoordIndex, key.normalIndex)) & mask;
+
+        // Sondagem linear até achar a chave ou um slot livre
+        while (true)
         {
-            return it->second;
+            Slot &slot = mSlots[i];
+            if (slot.generation != mGeneration)
+            {
+                slot = Slot{key.positionIndex, key.texCoordIndex, key.normalIndex, value, mGeneration};
+                ++mSize;
+                inserted = true;
+                return value;
+            }
+            if (slot.positionIndex == key.positionIndex &&
+                slot.texCoordIndex == key.texCoordIndex &&
+                slot.normalIndex == key.normalIndex)
+            {
+                inserted = false;
+                return slot.value;
+            }
+            i = (i + 1) & mask;
+        }
+    }
+
+    void ModelLoader::VertexDedupTable::rehash(size_t newCapacity)
+    {
+        std::vector<Slot> oldSlots(newCapacity, Slot{0, 0, 0, 0, 0});
+        oldSlots.swap(mSlots);
+
+        uint32_t oldGeneration = mGeneration;
+        mGeneration = 1;
+        mSize = 0;
+
+        size_t mask = mSlots.size() - 1;
+        for (const Slot &slot : oldSlots)
+        {
+            if (slot.generation != oldGeneration)
+                continue;
+
+            size_t i = static_cast<size_t>(hashFaceIndex(slot.positionIndex, slot.texCoordIndex, slot.normalIndex)) & mask;
+            while (mSlots[i].generation == mGeneration)
+                i = (i + 1) & mask;
+
+            mSlots[i] = slot;
+            mSlots[i].generation = mGeneration;
+            ++mSize;
+        }
+    }
+
+    GLuint ModelLoader::getOrCreateVertex(const FaceIndex &faceIndex, ParseData &data)
+    {
+        // Verifica se já existe um vértice com estes índices (insere o próximo índice se não existir)
+        GLuint vertexIndex = static_cast<GLuint>(data.currentVertices.size());
+        bool inserted = false;
+        GLuint existing = data.vertexMap.findOrInsert(faceIndex, vertexIndex, inserted);
+        if (!inserted)
+        {
+            return existing;
         }
 
         // Cria novo vértice
@@ -387,13 +1108,209 @@ namespace cg
             vertex.normal = data.normals[faceIndex.normalIndex];
         }
 
-        GLuint vertexIndex = static_cast<GLuint>(data.currentVertices.size());
         data.currentVertices.push_back(vertex);
-        data.vertexMap[key] = vertexIndex;
 
         return vertexIndex;
     }
 
+    void ModelLoader::optimizeMeshes(ModelData &model, unsigned workerCount, LoadStats &stats)
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        std::vector<MeshOptimizer::CacheStats> before(model.meshes.size());
+        std::vector<MeshOptimizer::CacheStats> after(model.meshes.size());
+
+        forEachMeshParallel(model.meshes, workerCount, [&](size_t index, MeshData &mesh)
+                            {
+                                before[index] = MeshOptimizer::analyzeVertexCache(mesh.indices, mesh.vertices.size());
+                                MeshOptimizer::optimize(mesh);
+                                after[index] = MeshOptimizer::analyzeVertexCache(mesh.indices, mesh.vertices.size());
+                            });
+
+        // Métricas agregadas do modelo (ponderadas pelo tamanho de cada mesh)
+        MeshOptimizer::CacheStats totalBefore;
+        MeshOptimizer::CacheStats totalAfter;
+        for (size_t i = 0; i < model.meshes.size(); ++i)
+        {
+            totalBefore.triangles += before[i].triangles;
+            totalBefore.vertices += before[i].vertices;
+            totalBefore.misses += before[i].misses;
+            totalAfter.triangles += after[i].triangles;
+            totalAfter.vertices += after[i].vertices;
+            totalAfter.misses += after[i].misses;
+        }
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        stats.optimizeTimeMs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() / 1000.0f;
+        stats.acmrBefore = totalBefore.acmr();
+        stats.acmrAfter = totalAfter.acmr();
+        stats.atvrBefore = totalBefore.atvr();
+        stats.atvrAfter = totalAfter.atvr();
+    }
+
+    void ModelLoader::generateLods(ModelData &model, unsigned workerCount, bool optimizeLods, LoadStats &stats)
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        forEachMeshParallel(model.meshes, workerCount, [optimizeLods](size_t, MeshData &mesh)
+                            {
+                                MeshSimplifier::generateLods(mesh);
+                                if (optimizeLods)
+                                {
+                                    // Os níveis mantêm a ordem do LOD 0, mas perdem triângulos: reordena para o cache
+                                    for (MeshLod &lod : mesh.lods)
+                                        MeshOptimizer::optimizeVertexCache(lod.indices, mesh.vertices.size());
+                                }
+                            });
+
+        stats.lodMeshes = 0;
+        stats.lodLevels = 0;
+        for (const MeshData &mesh : model.meshes)
+        {
+            stats.lodMeshes += mesh.lods.empty() ? 0 : 1;
+            stats.lodLevels += mesh.lods.size();
+        }
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        stats.lodTimeMs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() / 1000.0f;
+    }
+
+    void ModelLoader::computeBounds(ModelData &model, unsigned workerCount)
+    {
+        forEachMeshParallel(model.meshes, workerCount, [](size_t, MeshData &mesh)
+                            { mesh.bounds = computeMeshBounds(mesh.vertices.data(), mesh.vertices.size()); });
+    }
+
+    void ModelLoader::shareDuplicateGeometry(ModelData &model, unsigned workerCount, VertexFormat format,
+                                             LoadStats &stats)
+    {
+        // Tolerâncias da comparação (unidades do modelo e unidades de normal/UV); o hash
+        // arredonda as posições na mesma grade, então cópias transladadas caem no mesmo balde
+        // salvo quando o erro de arredondamento cruza uma fronteira da grade (duplicata perdida)
+        constexpr float kPositionTolerance = 1.0e-4f;
+        constexpr float kAttributeTolerance = 1.0e-3f;
+
+        auto quantize = [](float value, float step)
+        { return static_cast<int64_t>(std::floor(value / step + 0.5f)); };
+
+        auto centerOf = [](const MeshData &mesh)
+        { return (mesh.bounds.box.min + mesh.bounds.box.max) * 0.5f; };
+
+        // =================== HASH NO REFERENCIAL CANÔNICO ===================
+        // FNV-1a sobre as posições relativas ao centro da AABB, os índices e os LODs
+        std::vector<uint64_t> hashes(model.meshes.size(), 0);
+        forEachMeshParallel(model.meshes, workerCount, [&](size_t index, MeshData &mesh)
+                            {
+                                uint64_t hash = 14695981039346656037ull;
+                                auto mix = [&hash](uint64_t value)
+                                {
+                                    for (int byte = 0; byte < 8; ++byte)
+                                    {
+                                        hash ^= (value >> (byte * 8)) & 0xFFu;
+                                        hash *= 1099511628211ull;
+                                    }
+                                };
+
+                                glm::vec3 center = centerOf(mesh);
+                                mix(mesh.vertices.size());
+                                for (const Vertex &vertex : mesh.vertices)
+                                {
+                                    glm::vec3 local = vertex.position - center;
+                                    mix(static_cast<uint64_t>(quantize(local.x, kPositionTolerance)));
+                                    mix(static_cast<uint64_t>(quantize(local.y, kPositionTolerance)));
+                                    mix(static_cast<uint64_t>(quantize(local.z, kPositionTolerance)));
+                                }
+                                mix(mesh.indices.size());
+                                for (GLuint vertexIndex : mesh.indices)
+                                    mix(vertexIndex);
+                                mix(mesh.lods.size());
+                                for (const MeshLod &lod : mesh.lods)
+                                {
+                                    mix(lod.indices.size());
+                                    for (GLuint vertexIndex : lod.indices)
+                                        mix(vertexIndex);
+                                }
+                                hashes[index] = hash;
+                            });
+
+        // =================== CONFIRMAÇÃO ===================
+        auto sameGeometry = [&](const MeshData &a, const MeshData &b)
+        {
+            if (a.vertices.size() != b.vertices.size() || a.indices != b.indices || a.lods.size() != b.lods.size())
+                return false;
+            for (size_t lod = 0; lod < a.lods.size(); ++lod)
+            {
+                if (a.lods[lod].indices != b.lods[lod].indices)
+                    return false;
+            }
+
+            glm::vec3 centerA = centerOf(a);
+            glm::vec3 centerB = centerOf(b);
+            for (size_t i = 0; i < a.vertices.size(); ++i)
+            {
+                const Vertex &va = a.vertices[i];
+                const Vertex &vb = b.vertices[i];
+                glm::vec3 positionA = va.position - centerA;
+                glm::vec3 positionB = vb.position - centerB;
+                for (int c = 0; c < 3; ++c)
+                {
+                    if (std::abs(positionA[c] - positionB[c]) > kPositionTolerance ||
+                        std::abs(va.normal[c] - vb.normal[c]) > kAttributeTolerance)
+                        return false;
+                }
+                if (std::abs(va.texCoords.x - vb.texCoords.x) > kAttributeTolerance ||
+                    std::abs(va.texCoords.y - vb.texCoords.y) > kAttributeTolerance)
+                    return false;
+            }
+            return true;
+        };
+
+        // A primeira ocorrência de cada geometria fica com os buffers; as seguintes apontam para ela
+        std::unordered_map<uint64_t, std::vector<size_t>> ownersByHash;
+        size_t vertexStride = getVertexLayout(format).stride;
+        stats.sharedGeometryMeshes = 0;
+        stats.sharedGeometryBytes = 0;
+
+        for (size_t i = 0; i < model.meshes.size(); ++i)
+        {
+            MeshData &mesh = model.meshes[i];
+            mesh.sharedGeometry = -1;
+            mesh.geometryOffset = glm::vec3(0.0f);
+            if (mesh.vertices.empty() || mesh.indices.empty())
+                continue;
+
+            std::vector<size_t> &owners = ownersByHash[hashes[i]];
+            auto owner = std::find_if(owners.begin(), owners.end(), [&](size_t candidate)
+                                      { return sameGeometry(model.meshes[candidate], mesh); });
+            if (owner == owners.end())
+            {
+                owners.push_back(i);
+                continue;
+            }
+
+            mesh.sharedGeometry = static_cast<int32_t>(*owner);
+            mesh.geometryOffset = centerOf(mesh) - centerOf(model.meshes[*owner]);
+
+            size_t indexCount = mesh.indices.size();
+            for (const MeshLod &lod : mesh.lods)
+                indexCount += lod.indices.size();
+            size_t indexSize = getIndexType(mesh.vertices.size()) == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(GLuint);
+
+            stats.sharedGeometryMeshes++;
+            stats.sharedGeometryBytes += mesh.vertices.size() * vertexStride + indexCount * indexSize;
+        }
+    }
+
+    uint32_t ModelLoader::processingFlags(const LoadOptions &options)
+    {
+        uint32_t flags = 0;
+        if (options.optimizeMeshes)
+            flags |= kProcessOptimizeMeshes;
+        if (options.generateLods)
+            flags |= kProcessGenerateLods;
+        return flags;
+    }
+
     void ModelLoader::calculateNormals(ParseData &data)
     {
         // Calcula normais por triângulo se não existirem normais no arquivo
@@ -437,34 +1354,19 @@ namespace cg
         return str.substr(start, end - start + 1);
     }
 
-    std::vector<std::string> ModelLoader::split(const std::string &str, char delimiter)
+    void ModelLoader::parseMaterialLib(std::string_view line, ParseData &data, const std::string &objFilePath)
     {
-        std::vector<std::string> tokens;
-        std::istringstream iss(str);
-        std::string token;
+        nextToken(line); // consome o 'mtllib'
 
-        while (std::getline(iss, token, delimiter))
-        {
-            tokens.push_back(token);
-        }
-
-        return tokens;
-    }
-
-    void ModelLoader::parseMaterialLib(const std::string &line, ParseData &data, const std::string &objFilePath)
-    {
-        std::istringstream iss(line);
-        std::string token;
-        iss >> token; // consome o 'mtllib'
-
-        std::string mtlFile;
-        if (iss >> mtlFile)
+        std::string_view mtlFile = nextToken(line);
+        if (!mtlFile.empty())
         {
             // Resolve o caminho relativo
             std::filesystem::path objPath(objFilePath);
-            std::filesystem::path mtlPath = objPath.parent_path() / mtlFile;
+            std::filesystem::path mtlPath = objPath.parent_path() / std::filesystem::path(mtlFile);
 
             std::cout << "Carregando biblioteca de materiais: " << mtlPath << std::endl;
+            data.materialLibraries.push_back(mtlPath.string());
 
             auto materials = loadMaterials(mtlPath.string());
 
@@ -478,14 +1380,12 @@ namespace cg
         }
     }
 
-    void ModelLoader::parseUseMaterial(const std::string &line, ParseData &data)
+    void ModelLoader::parseUseMaterial(std::string_view line, ParseData &data)
     {
-        std::istringstream iss(line);
-        std::string token;
-        iss >> token; // consome o 'usemtl'
+        nextToken(line); // consome o 'usemtl'
 
-        std::string materialName;
-        if (iss >> materialName)
+        std::string materialName(nextToken(line));
+        if (!materialName.empty())
         {
             auto it = data.materials.find(materialName);
             if (it != data.materials.end())
@@ -0,0 +1,133 @@
+#include "render/ModelStreamer.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+namespace cg
+{
+
+    std::shared_ptr<const ModelStreamer::Handle> ModelStreamer::load(const std::string &filePath,
+                                                                     const std::string &modelName,
+                                                                     const ModelLoader::LoadOptions &options,
+                                                                     ReadyCallback onReady,
+                                                                     FailedCallback onFailed)
+    {
+        std::cout << "Carregamento em background iniciado: " << filePath << std::endl;
+
+        PendingLoad pending;
+        pending.handle = std::make_shared<Handle>();
+        pending.handle->mFilePath = filePath;
+        pending.future = ModelLoader::loadModelDataAsync(filePath, modelName, options);
+        pending.vertexFormat = options.vertexFormat;
+        pending.cpuResidency = options.cpuResidency;
+        pending.onReady = std::move(onReady);
+        pending.onFailed = std::move(onFailed);
+
+        mPending.push_back(std::move(pending));
+        return mPending.back().handle;
+    }
+
+    void ModelStreamer::update()
+    {
+        mFrameStats = FrameStats{};
+        if (mPending.empty())
+            return;
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        size_t budget = mUploadBudget ? mUploadBudget : SIZE_MAX;
+
+        for (size_t i = 0; i < mPending.size();)
+        {
+            PendingLoad &pending = mPending[i];
+            Handle &handle = *pending.handle;
+
+            // =================== PARSING CONCLUÍDO? ===================
+            if (handle.mState == LoadState::Parsing)
+            {
+                if (pending.future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                {
+                    ++i;
+                    continue;
+                }
+
+                ModelLoader::AsyncResult result = pending.future.get();
+                handle.mLoadStats = result.stats;
+                if (!result.data)
+                {
+                    std::cerr << "ERRO: Falha no carregamento em background: " << handle.mFilePath << std::endl;
+                    handle.mState = LoadState::Failed;
+                    FailedCallback onFailed = std::move(pending.onFailed);
+                    mPending.erase(mPending.begin() + static_cast<std::ptrdiff_t>(i));
+                    if (onFailed)
+                        onFailed();
+                    continue;
+                }
+
+                pending.data = std::move(result.data);
+                for (const MeshData &mesh : pending.data->meshes)
+                    handle.mTotalBytes += meshBytes(mesh, pending.vertexFormat);
+                handle.mState = LoadState::Uploading;
+            }
+
+            // =================== UPLOAD DENTRO DO ORÇAMENTO ===================
+            if (!pending.model)
+                pending.model = std::make_unique<Model>(pending.data->name);
+
+            std::vector<MeshData> &meshes = pending.data->meshes;
+            while (pending.nextMesh < meshes.size() &&
+                   (mFrameStats.uploadedBytes < budget || mFrameStats.uploadedMeshes == 0))
+            {
+                MeshData &meshData = meshes[pending.nextMesh];
+                size_t bytes = meshBytes(meshData, pending.vertexFormat);
+                if (meshData.sharedGeometry >= 0)
+                {
+                    // A mesh dona da geometria vem antes no arquivo, então já está no modelo
+                    const Mesh &geometry = *pending.model->getMeshes()[static_cast<size_t>(meshData.sharedGeometry)];
+                    pending.model->addMesh(std::make_unique<Mesh>(std::move(meshData), geometry, pending.cpuResidency));
+                }
+                else
+                {
+                    pending.model->addMesh(std::make_unique<Mesh>(std::move(meshData), pending.vertexFormat,
+                                                                  pending.cpuResidency));
+                }
+                pending.nextMesh++;
+
+                handle.mUploadedBytes += bytes;
+                mFrameStats.uploadedBytes += bytes;
+                mFrameStats.uploadedMeshes++;
+            }
+
+            if (pending.nextMesh < meshes.size())
+                break; // orçamento esgotado; continua no próximo frame
+
+            // =================== MODELO COMPLETO NA GPU ===================
+            handle.mState = LoadState::Ready;
+            std::cout << "Modelo carregado em background: " << handle.mFilePath
+                      << " (" << handle.mUploadedBytes / 1024 << " KB enviados)" << std::endl;
+
+            std::unique_ptr<Model> model = std::move(pending.model);
+            ReadyCallback onReady = std::move(pending.onReady);
+            mPending.erase(mPending.begin() + static_cast<std::ptrdiff_t>(i));
+            if (onReady)
+                onReady(std::move(model));
+        }
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        mFrameStats.pendingLoads = mPending.size();
+        mFrameStats.uploadTimeMs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() / 1000.0f;
+    }
+
+    size_t ModelStreamer::meshBytes(const MeshData &mesh, VertexFormat format)
+    {
+        if (mesh.sharedGeometry >= 0)
+            return 0; // reutiliza os buffers de outra mesh: nada a enviar
+
+        size_t indexCount = mesh.indices.size();
+        for (const MeshLod &lod : mesh.lods)
+            indexCount += lod.indices.size();
+
+        size_t indexSize = getIndexType(mesh.vertices.size()) == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(GLuint);
+        return mesh.vertices.size() * getVertexLayout(format).stride + indexCount * indexSize;
+    }
+
+} // namespace cg
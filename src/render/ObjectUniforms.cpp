@@ -0,0 +1,172 @@
+#include "render/ObjectUniforms.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <iostream>
+
+namespace cg
+{
+
+    namespace
+    {
+        // Mesma ordem e tipos de ObjectUniforms::Data
+        const char *kObjectBlockSource = R"GLSL(
+        layout(std140) uniform ObjectUniforms {
+            mat4 uModel;
+            mat3 uNormalMatrix;
+            vec4 uObjectColor;
+            vec4 uSpecular;
+            vec4 uPosOffset;
+            vec4 uPosScale;
+        };
+    )GLSL";
+
+        static_assert(sizeof(ObjectUniforms::Data) == 64 + 48 + 4 * 16, "ObjectUniforms::Data deve seguir o layout std140");
+
+        // Capacidade inicial (slots por região)
+        constexpr size_t kInitialCapacity = 256;
+
+        // Tempo máximo de uma espera pela GPU antes de tentar de novo (1 s)
+        constexpr GLuint64 kFenceTimeoutNs = 1000000000ull;
+    } // namespace
+
+    ObjectUniforms::~ObjectUniforms()
+    {
+        cleanup();
+    }
+
+    const char *ObjectUniforms::glslBlock()
+    {
+        return kObjectBlockSource;
+    }
+
+    bool ObjectUniforms::init()
+    {
+        GLint alignment = 256;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        alignment = std::max(alignment, 1);
+        mStride = (sizeof(Data) + alignment - 1) / alignment * alignment;
+
+        if (mBuffer == 0)
+        {
+            glGenBuffers(1, &mBuffer);
+        }
+        reallocate(kInitialCapacity);
+        return mBuffer != 0;
+    }
+
+    void ObjectUniforms::reallocate(size_t capacity)
+    {
+        // O armazenamento antigo continua válido para os draws já enviados; as
+        // fences dele não dizem mais nada sobre o novo
+        for (uint32_t region = 0; region < kFrameCount; ++region)
+        {
+            if (mFences[region])
+            {
+                glDeleteSync(static_cast<GLsync>(mFences[region]));
+                mFences[region] = nullptr;
+            }
+        }
+
+        mCapacity = capacity;
+        glBindBuffer(GL_UNIFORM_BUFFER, mBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(mStride * mCapacity * kFrameCount), nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    void ObjectUniforms::waitRegion(uint32_t region)
+    {
+        GLsync fence = static_cast<GLsync>(mFences[region]);
+        if (!fence)
+        {
+            return;
+        }
+
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED)
+        {
+            ++mStallCount;
+            do
+            {
+                result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, kFenceTimeoutNs);
+            } while (result == GL_TIMEOUT_EXPIRED);
+        }
+
+        glDeleteSync(fence);
+        mFences[region] = nullptr;
+    }
+
+    bool ObjectUniforms::beginFrame(size_t count)
+    {
+        mRegion = (mRegion + 1) % kFrameCount;
+
+        if (count > mCapacity)
+        {
+            reallocate(std::max(count, mCapacity * 2));
+        }
+        waitRegion(mRegion);
+
+        if (count == 0)
+        {
+            return true;
+        }
+
+        glBindBuffer(GL_UNIFORM_BUFFER, mBuffer);
+        mMapped = static_cast<uint8_t *>(glMapBufferRange(GL_UNIFORM_BUFFER,
+                                                          static_cast<GLintptr>(mStride * mCapacity * mRegion),
+                                                          static_cast<GLsizeiptr>(mStride * count),
+                                                          GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        if (!mMapped)
+        {
+            std::cerr << "ERRO: Falha ao mapear o buffer de uniforms por objeto" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void ObjectUniforms::endWrites()
+    {
+        if (!mMapped)
+        {
+            return;
+        }
+
+        glBindBuffer(GL_UNIFORM_BUFFER, mBuffer);
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        mMapped = nullptr;
+    }
+
+    void ObjectUniforms::bind(uint32_t index) const
+    {
+        glBindBufferRange(GL_UNIFORM_BUFFER, kBindingPoint, mBuffer,
+                          static_cast<GLintptr>(mStride * (mCapacity * mRegion + index)),
+                          static_cast<GLsizeiptr>(sizeof(Data)));
+    }
+
+    void ObjectUniforms::endFrame()
+    {
+        mFences[mRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    void ObjectUniforms::cleanup()
+    {
+        endWrites();
+        for (uint32_t region = 0; region < kFrameCount; ++region)
+        {
+            if (mFences[region])
+            {
+                glDeleteSync(static_cast<GLsync>(mFences[region]));
+                mFences[region] = nullptr;
+            }
+        }
+        if (mBuffer)
+        {
+            glDeleteBuffers(1, &mBuffer);
+            mBuffer = 0;
+        }
+        mCapacity = 0;
+    }
+
+} // namespace cg
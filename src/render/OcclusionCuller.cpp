@@ -0,0 +1,485 @@
+#include "render/OcclusionCuller.h"
+#include "core/Simd.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace cg
+{
+
+    namespace
+    {
+        // Margem relativa do teste de caixas: evita que uma mesh seja escondida
+        // pela própria superfície (caixa e oclusor no mesmo plano) por arredondamento
+        constexpr float kDepthBias = 1e-4f;
+
+        int roundUp(int value, int multiple)
+        {
+            return std::max(multiple, (value + multiple - 1) / multiple * multiple);
+        }
+
+        // Distância ao plano perto no espaço de recorte (z >= -w é visível)
+        float nearDistance(const glm::vec4 &v)
+        {
+            return v.z + v.w;
+        }
+    } // namespace
+
+    // =================== CONSTRUÇÃO ===================
+
+    OcclusionCuller::OcclusionCuller(int width, int height, unsigned threadCount)
+    {
+        mWidth = roundUp(width, kTileWidth);
+        mHeight = roundUp(height, kTileHeight);
+        mTilesX = mWidth / kTileWidth;
+        mTilesY = mHeight / kTileHeight;
+        mBlocksX = mWidth / kBlockWidth;
+        mBlocksY = mHeight / kBlockHeight;
+
+        mDepth.assign(static_cast<size_t>(mWidth) * mHeight, 0.0f);
+        mHiZ.assign(static_cast<size_t>(mBlocksX) * mBlocksY, 0.0f);
+        mTileBins.resize(static_cast<size_t>(mTilesX) * mTilesY);
+
+        if (threadCount == 0)
+        {
+            threadCount = std::min(4u, std::max(1u, std::thread::hardware_concurrency()));
+        }
+        for (unsigned t = 1; t < threadCount; ++t)
+        {
+            mWorkers.emplace_back(&OcclusionCuller::workerLoop, this);
+        }
+    }
+
+    OcclusionCuller::~OcclusionCuller()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+        mWake.notify_all();
+        for (auto &worker : mWorkers)
+        {
+            worker.join();
+        }
+    }
+
+    // =================== OCLUSORES ===================
+
+    void OcclusionCuller::beginFrame(const glm::mat4 &viewProjection)
+    {
+        mViewProjection = viewProjection;
+        mStats = Stats{};
+        mTriangles.clear();
+        for (auto &bin : mTileBins)
+        {
+            bin.clear();
+        }
+        std::fill(mDepth.begin(), mDepth.end(), 0.0f);
+        std::fill(mHiZ.begin(), mHiZ.end(), 0.0f);
+    }
+
+    void OcclusionCuller::addOccluder(const glm::mat4 &world, const glm::vec3 *positions, size_t stride, size_t vertexCount,
+                                      const uint32_t *indices, size_t indexCount)
+    {
+        ++mStats.occluders;
+
+        // Todos os vértices no espaço de recorte de uma vez (compartilhados entre triângulos)
+        const glm::mat4 matrix = mViewProjection * world;
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(positions);
+        mClipScratch.resize(vertexCount);
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            const glm::vec3 &position = *reinterpret_cast<const glm::vec3 *>(bytes + i * stride);
+            mClipScratch[i] = matrix * glm::vec4(position, 1.0f);
+        }
+
+        for (size_t i = 0; i + 2 < indexCount; i += 3)
+        {
+            const glm::vec4 v[3] = {mClipScratch[indices[i]], mClipScratch[indices[i + 1]], mClipScratch[indices[i + 2]]};
+            const float d[3] = {nearDistance(v[0]), nearDistance(v[1]), nearDistance(v[2])};
+
+            // Fora do frustum por um mesmo plano lateral: nenhum pixel a cobrir
+            if ((v[0].x > v[0].w && v[1].x > v[1].w && v[2].x > v[2].w) ||
+                (v[0].x < -v[0].w && v[1].x < -v[1].w && v[2].x < -v[2].w) ||
+                (v[0].y > v[0].w && v[1].y > v[1].w && v[2].y > v[2].w) ||
+                (v[0].y < -v[0].w && v[1].y < -v[1].w && v[2].y < -v[2].w))
+            {
+                ++mStats.trianglesRejected;
+                continue;
+            }
+
+            if (d[0] >= 0.0f && d[1] >= 0.0f && d[2] >= 0.0f)
+            {
+                setupTriangle(v[0], v[1], v[2]);
+                continue;
+            }
+            if (d[0] < 0.0f && d[1] < 0.0f && d[2] < 0.0f)
+            {
+                ++mStats.trianglesRejected;
+                continue;
+            }
+
+            // =================== RECORTE PELO PLANO PERTO ===================
+            // Sutherland-Hodgman com um plano: o polígono resultante tem 3 ou 4 vértices
+            glm::vec4 polygon[4];
+            int count = 0;
+            for (int e = 0; e < 3; ++e)
+            {
+                int next = (e + 1) % 3;
+                if (d[e] >= 0.0f)
+                {
+                    polygon[count++] = v[e];
+                }
+                if ((d[e] >= 0.0f) != (d[next] >= 0.0f))
+                {
+                    float t = d[e] / (d[e] - d[next]);
+                    polygon[count++] = v[e] + (v[next] - v[e]) * t;
+                }
+            }
+            ++mStats.trianglesClipped;
+            for (int k = 1; k + 1 < count; ++k)
+            {
+                setupTriangle(polygon[0], polygon[k], polygon[k + 1]);
+            }
+        }
+    }
+
+    void OcclusionCuller::setupTriangle(const glm::vec4 &v0, const glm::vec4 &v1, const glm::vec4 &v2)
+    {
+        const glm::vec4 *clip[3] = {&v0, &v1, &v2};
+
+        // Posições em pixels e 1/w; setup em double porque vértices perto do
+        // plano perto projetam muito longe da tela
+        double x[3], y[3], z[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            double w = clip[i]->w;
+            if (w <= 0.0)
+            {
+                ++mStats.trianglesRejected;
+                return;
+            }
+            x[i] = (clip[i]->x / w * 0.5 + 0.5) * mWidth;
+            y[i] = (clip[i]->y / w * 0.5 + 0.5) * mHeight;
+            z[i] = 1.0 / w;
+        }
+
+        // As duas faces são rasterizadas: a orientação só define o sinal das arestas
+        double area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+        if (std::abs(area) < 1e-8)
+        {
+            ++mStats.trianglesRejected;
+            return;
+        }
+        if (area < 0.0)
+        {
+            std::swap(x[1], x[2]);
+            std::swap(y[1], y[2]);
+            std::swap(z[1], z[2]);
+            area = -area;
+        }
+
+        // Pixels cujo centro (px + 0.5, py + 0.5) cai no retângulo do triângulo
+        Triangle triangle;
+        double minX = std::min({x[0], x[1], x[2]});
+        double maxX = std::max({x[0], x[1], x[2]});
+        double minY = std::min({y[0], y[1], y[2]});
+        double maxY = std::max({y[0], y[1], y[2]});
+        triangle.minX = static_cast<int>(std::max(0.0, std::ceil(minX - 0.5)));
+        triangle.maxX = static_cast<int>(std::min(mWidth - 1.0, std::floor(maxX - 0.5)));
+        triangle.minY = static_cast<int>(std::max(0.0, std::ceil(minY - 0.5)));
+        triangle.maxY = static_cast<int>(std::min(mHeight - 1.0, std::floor(maxY - 0.5)));
+        if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+        {
+            ++mStats.trianglesRejected;
+            return;
+        }
+
+        // Aresta de a para b: positiva à esquerda (interior de um triângulo anti-horário)
+        for (int e = 0; e < 3; ++e)
+        {
+            int a = e;
+            int b = (e + 1) % 3;
+            double edgeA = y[a] - y[b];
+            double edgeB = x[b] - x[a];
+            triangle.edgeA[e] = static_cast<float>(edgeA);
+            triangle.edgeB[e] = static_cast<float>(edgeB);
+            triangle.edgeC[e] = static_cast<float>(-(edgeA * x[a] + edgeB * y[a]));
+        }
+
+        // Plano de 1/w na tela (regra de Cramer)
+        double depthA = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) / area;
+        double depthB = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) / area;
+        triangle.depthA = static_cast<float>(depthA);
+        triangle.depthB = static_cast<float>(depthB);
+        triangle.depthC = static_cast<float>(z[0] - depthA * x[0] - depthB * y[0]);
+
+        // =================== DISTRIBUIÇÃO NOS TILES ===================
+        uint32_t index = static_cast<uint32_t>(mTriangles.size());
+        mTriangles.push_back(triangle);
+        ++mStats.trianglesRasterized;
+        for (int ty = triangle.minY / kTileHeight; ty <= triangle.maxY / kTileHeight; ++ty)
+        {
+            for (int tx = triangle.minX / kTileWidth; tx <= triangle.maxX / kTileWidth; ++tx)
+            {
+                mTileBins[static_cast<size_t>(ty) * mTilesX + tx].push_back(index);
+            }
+        }
+    }
+
+    // =================== RASTERIZAÇÃO ===================
+
+    void OcclusionCuller::rasterize()
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        if (!mTriangles.empty())
+        {
+            mNextTile = 0;
+            if (mWorkers.empty())
+            {
+                rasterizeTiles();
+            }
+            else
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    mActiveWorkers = static_cast<unsigned>(mWorkers.size());
+                    ++mGeneration;
+                }
+                mWake.notify_all();
+
+                // A thread atual também rasteriza tiles
+                rasterizeTiles();
+
+                std::unique_lock<std::mutex> lock(mMutex);
+                mDone.wait(lock, [this]
+                           { return mActiveWorkers == 0; });
+            }
+        }
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        mStats.rasterTimeMs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() / 1000.0f;
+    }
+
+    void OcclusionCuller::workerLoop()
+    {
+        uint64_t seenGeneration = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWake.wait(lock, [&]
+                           { return mStopping || mGeneration != seenGeneration; });
+                if (mStopping)
+                {
+                    return;
+                }
+                seenGeneration = mGeneration;
+            }
+
+            rasterizeTiles();
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (--mActiveWorkers == 0)
+            {
+                mDone.notify_one();
+            }
+        }
+    }
+
+    void OcclusionCuller::rasterizeTiles()
+    {
+        // Tiles cobrem pixels e blocos do Hi-Z disjuntos: nenhuma sincronização além do contador
+        const int tileCount = mTilesX * mTilesY;
+        for (int tile = mNextTile++; tile < tileCount; tile = mNextTile++)
+        {
+            rasterizeTile(tile);
+        }
+    }
+
+    void OcclusionCuller::rasterizeTile(int tile)
+    {
+        const std::vector<uint32_t> &bin = mTileBins[tile];
+        if (bin.empty())
+        {
+            return; // profundidade e Hi-Z já zerados em beginFrame
+        }
+
+        const int tileX0 = (tile % mTilesX) * kTileWidth;
+        const int tileY0 = (tile / mTilesX) * kTileHeight;
+        const int tileX1 = tileX0 + kTileWidth - 1;
+        const int tileY1 = tileY0 + kTileHeight - 1;
+
+        for (uint32_t index : bin)
+        {
+            const Triangle &t = mTriangles[index];
+            const int minX = std::max(t.minX, tileX0);
+            const int maxX = std::min(t.maxX, tileX1);
+            const int minY = std::max(t.minY, tileY0);
+            const int maxY = std::min(t.maxY, tileY1);
+
+            for (int y = minY; y <= maxY; ++y)
+            {
+                const float py = y + 0.5f;
+                float *row = &mDepth[static_cast<size_t>(y) * mWidth];
+
+                // Termos constantes na linha
+                const float rowC0 = t.edgeB[0] * py + t.edgeC[0];
+                const float rowC1 = t.edgeB[1] * py + t.edgeC[1];
+                const float rowC2 = t.edgeB[2] * py + t.edgeC[2];
+                const float rowDepth = t.depthB * py + t.depthC;
+
+                int x = minX;
+#if defined(CG_SIMD_AVX)
+                // Lotes de 8 pixels alinhados ao tile (a largura do tile é múltipla de 8); pixels
+                // fora do triângulo são mascarados pelas arestas
+                x = minX & ~7;
+                const __m256 laneOffsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+                const __m256 zero = _mm256_setzero_ps();
+                for (; x <= maxX; x += 8)
+                {
+                    __m256 px = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffsets);
+                    __m256 e0 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t.edgeA[0]), px), _mm256_set1_ps(rowC0));
+                    __m256 e1 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t.edgeA[1]), px), _mm256_set1_ps(rowC1));
+                    __m256 e2 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t.edgeA[2]), px), _mm256_set1_ps(rowC2));
+                    __m256 inside = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(e0, zero, _CMP_GE_OQ), _mm256_cmp_ps(e1, zero, _CMP_GE_OQ)),
+                                                  _mm256_cmp_ps(e2, zero, _CMP_GE_OQ));
+                    if (_mm256_movemask_ps(inside) == 0)
+                        continue;
+
+                    __m256 depth = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t.depthA), px), _mm256_set1_ps(rowDepth));
+                    __m256 current = _mm256_loadu_ps(row + x);
+                    _mm256_storeu_ps(row + x, _mm256_blendv_ps(current, _mm256_max_ps(current, depth), inside));
+                }
+#elif defined(CG_SIMD_SSE)
+                x = minX & ~3;
+                const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+                const __m128 zero = _mm_setzero_ps();
+                for (; x <= maxX; x += 4)
+                {
+                    __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+                    __m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.edgeA[0]), px), _mm_set1_ps(rowC0));
+                    __m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.edgeA[1]), px), _mm_set1_ps(rowC1));
+                    __m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.edgeA[2]), px), _mm_set1_ps(rowC2));
+                    __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+                    if (_mm_movemask_ps(inside) == 0)
+                        continue;
+
+                    // Sem blendv no SSE básico: seleção por máscara com and/andnot/or
+                    __m128 depth = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.depthA), px), _mm_set1_ps(rowDepth));
+                    __m128 current = _mm_loadu_ps(row + x);
+                    __m128 closer = _mm_max_ps(current, depth);
+                    _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closer), _mm_andnot_ps(inside, current)));
+                }
+#endif
+
+                // Versão escalar (sem SIMD, os lotes acima já cobrem a linha inteira)
+                for (; x <= maxX; ++x)
+                {
+                    const float px = x + 0.5f;
+                    if (t.edgeA[0] * px + rowC0 >= 0.0f && t.edgeA[1] * px + rowC1 >= 0.0f && t.edgeA[2] * px + rowC2 >= 0.0f)
+                    {
+                        row[x] = std::max(row[x], t.depthA * px + rowDepth);
+                    }
+                }
+            }
+        }
+
+        // =================== HI-Z ===================
+        // Por bloco, a profundidade mais distante (menor 1/w; 0 onde nenhum oclusor cobriu)
+        for (int by = tileY0 / kBlockHeight; by <= tileY1 / kBlockHeight; ++by)
+        {
+            for (int bx = tileX0 / kBlockWidth; bx <= tileX1 / kBlockWidth; ++bx)
+            {
+                float farthest = 1e30f;
+                for (int y = by * kBlockHeight; y < (by + 1) * kBlockHeight; ++y)
+                {
+                    const float *row = &mDepth[static_cast<size_t>(y) * mWidth + bx * kBlockWidth];
+                    for (int x = 0; x < kBlockWidth; ++x)
+                    {
+                        farthest = std::min(farthest, row[x]);
+                    }
+                }
+                mHiZ[static_cast<size_t>(by) * mBlocksX + bx] = farthest;
+            }
+        }
+    }
+
+    // =================== TESTE DE CAIXAS ===================
+
+    bool OcclusionCuller::isOccluded(const BoundingBox &worldBox)
+    {
+        ++mStats.boxesTested;
+        if (worldBox.isEmpty() || mTriangles.empty())
+        {
+            return false;
+        }
+
+        // Retângulo da caixa na tela e o seu ponto mais próximo (maior 1/w)
+        float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f;
+        float nearest = 0.0f;
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            glm::vec3 position((corner & 1) ? worldBox.max.x : worldBox.min.x,
+                               (corner & 2) ? worldBox.max.y : worldBox.min.y,
+                               (corner & 4) ? worldBox.max.z : worldBox.min.z);
+            glm::vec4 clip = mViewProjection * glm::vec4(position, 1.0f);
+
+            // A caixa cruza o plano perto (ou a câmera está dentro dela)
+            if (nearDistance(clip) < 0.0f || clip.w <= 0.0f)
+            {
+                return false;
+            }
+
+            float x = (clip.x / clip.w * 0.5f + 0.5f) * mWidth;
+            float y = (clip.y / clip.w * 0.5f + 0.5f) * mHeight;
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+            nearest = std::max(nearest, 1.0f / clip.w);
+        }
+
+        // Fora da tela: cabe ao frustum culling
+        if (maxX < 0.0f || maxY < 0.0f || minX >= mWidth || minY >= mHeight)
+        {
+            return false;
+        }
+
+        // Todos os pixels tocados pelo retângulo, arredondado para fora
+        const int pixelX0 = std::max(0, static_cast<int>(std::floor(minX)));
+        const int pixelX1 = std::min(mWidth - 1, static_cast<int>(std::floor(maxX)));
+        const int pixelY0 = std::max(0, static_cast<int>(std::floor(minY)));
+        const int pixelY1 = std::min(mHeight - 1, static_cast<int>(std::floor(maxY)));
+
+        const float threshold = nearest * (1.0f + kDepthBias);
+        for (int by = pixelY0 / kBlockHeight; by <= pixelY1 / kBlockHeight; ++by)
+        {
+            const float *row = &mHiZ[static_cast<size_t>(by) * mBlocksX];
+            for (int bx = pixelX0 / kBlockWidth; bx <= pixelX1 / kBlockWidth; ++bx)
+            {
+                // Algum ponto do bloco tem oclusor mais distante que a caixa (ou nenhum oclusor)
+                if (row[bx] <= threshold)
+                {
+                    return false;
+                }
+            }
+        }
+
+        ++mStats.boxesOccluded;
+        return true;
+    }
+
+    const char *OcclusionCuller::getPathName()
+    {
+#if defined(CG_SIMD_AVX)
+        return "AVX (8 pixels por lote)";
+#elif defined(CG_SIMD_SSE)
+        return "SSE (4 pixels por lote)";
+#else
+        return "escalar";
+#endif
+    }
+
+} // namespace cg
@@ -0,0 +1,236 @@
+#include "render/OcclusionQueries.h"
+#include "render/FrameUniforms.h"
+#include <iostream>
+#include <string>
+
+namespace cg
+{
+
+    namespace
+    {
+        // Câmera a menos disso de uma caixa: a face da frente pode ser cortada pelo
+        // plano perto, então a caixa é tratada como visível (sem query)
+        constexpr float kCameraMargin = 0.5f;
+
+        // Folga aplicada às caixas para que as faces não coincidam com a superfície
+        // da própria mesh (profundidade igual falharia o teste de forma instável)
+        constexpr float kBoxInflation = 0.01f;    // fração da extensão
+        constexpr float kBoxMinInflation = 0.001f; // em unidades do mundo
+
+        // Queries criadas de uma vez quando o pool esvazia
+        constexpr GLsizei kPoolGrowth = 64;
+
+        const char *kBoxVertexShaderBody = R"GLSL(
+        layout(location = 0) in vec3 aPosition; // Cubo unitário [0, 1]^3
+
+        uniform vec3 uBoxMin;
+        uniform vec3 uBoxSize;
+
+        void main() {
+            gl_Position = uViewProjection * vec4(uBoxMin + aPosition * uBoxSize, 1.0);
+        }
+    )GLSL";
+
+        const char *kBoxFragmentShaderSource = R"GLSL(
+        #version 330 core
+        out vec4 FragColor;
+
+        void main() {
+            FragColor = vec4(1.0); // escrita de cor desativada durante as queries
+        }
+    )GLSL";
+    } // namespace
+
+    OcclusionQueries::~OcclusionQueries()
+    {
+        if (!mAllQueries.empty())
+        {
+            glDeleteQueries(static_cast<GLsizei>(mAllQueries.size()), mAllQueries.data());
+        }
+        if (mEBO)
+        {
+            glDeleteBuffers(1, &mEBO);
+        }
+        if (mVBO)
+        {
+            glDeleteBuffers(1, &mVBO);
+        }
+        if (mVAO)
+        {
+            glDeleteVertexArrays(1, &mVAO);
+        }
+    }
+
+    bool OcclusionQueries::init()
+    {
+        // =================== PROGRAMA ===================
+        std::string vertexSource = std::string("#version 330 core\n") + FrameUniforms::glslBlock() + kBoxVertexShaderBody;
+        if (!mShader.compile(vertexSource.c_str(), kBoxFragmentShaderSource) || !FrameUniforms::attach(mShader))
+        {
+            std::cerr << "ERRO: Falha ao compilar o programa das occlusion queries" << std::endl;
+            return false;
+        }
+        mBoxMin = mShader.getUniform<glm::vec3>("uBoxMin");
+        mBoxSize = mShader.getUniform<glm::vec3>("uBoxSize");
+
+        // =================== CUBO UNITÁRIO ===================
+        // Vértice i = (bit 0, bit 1, bit 2); triângulos anti-horários vistos de fora
+        float vertices[8 * 3];
+        for (int i = 0; i < 8; ++i)
+        {
+            vertices[i * 3 + 0] = static_cast<float>(i & 1);
+            vertices[i * 3 + 1] = static_cast<float>((i >> 1) & 1);
+            vertices[i * 3 + 2] = static_cast<float>((i >> 2) & 1);
+        }
+        const GLubyte indices[36] = {
+            0, 4, 6, 0, 6, 2, // -X
+            1, 3, 7, 1, 7, 5, // +X
+            0, 1, 5, 0, 5, 4, // -Y
+            2, 6, 7, 2, 7, 3, // +Y
+            0, 2, 3, 0, 3, 1, // -Z
+            4, 5, 7, 4, 7, 6  // +Z
+        };
+
+        glGenVertexArrays(1, &mVAO);
+        glGenBuffers(1, &mVBO);
+        glGenBuffers(1, &mEBO);
+
+        glBindVertexArray(mVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
+        glEnableVertexAttribArray(0);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        return true;
+    }
+
+    void OcclusionQueries::reset(size_t itemCount)
+    {
+        for (const ItemQuery &item : mItems)
+        {
+            if (item.query)
+            {
+                mFreeQueries.push_back(item.query);
+            }
+        }
+        mItems.assign(itemCount, ItemQuery{});
+    }
+
+    void OcclusionQueries::beginFrame()
+    {
+        ++mFrame;
+        mStats = Stats{};
+    }
+
+    GLuint OcclusionQueries::acquireQuery()
+    {
+        if (mFreeQueries.empty())
+        {
+            size_t first = mAllQueries.size();
+            mAllQueries.resize(first + kPoolGrowth);
+            glGenQueries(kPoolGrowth, &mAllQueries[first]);
+            mFreeQueries.assign(mAllQueries.begin() + first, mAllQueries.end());
+        }
+        GLuint query = mFreeQueries.back();
+        mFreeQueries.pop_back();
+        return query;
+    }
+
+    // =================== RENDERIZAÇÃO CONDICIONAL ===================
+
+    bool OcclusionQueries::beginConditional(uint32_t item)
+    {
+        // Só vale o resultado do frame anterior: um item que voltou ao frustum
+        // teria um resultado antigo, possivelmente "oculto"
+        const ItemQuery &entry = mItems[item];
+        if (!entry.query || entry.frame + 1 != mFrame)
+        {
+            return false;
+        }
+
+        // Estatística sem espera: só lê o resultado se ele já chegou
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(entry.query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available)
+        {
+            GLuint samplesPassed = GL_TRUE;
+            glGetQueryObjectuiv(entry.query, GL_QUERY_RESULT, &samplesPassed);
+            if (!samplesPassed)
+            {
+                ++mStats.skipped;
+            }
+        }
+
+        glBeginConditionalRender(entry.query, GL_QUERY_NO_WAIT);
+        ++mStats.conditionalDraws;
+        return true;
+    }
+
+    void OcclusionQueries::endConditional()
+    {
+        glEndConditionalRender();
+    }
+
+    // =================== PASSE DE QUERIES ===================
+
+    void OcclusionQueries::beginQueries()
+    {
+        // Testa contra a profundidade do passe opaco sem alterá-la
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glDepthMask(GL_FALSE);
+        glDepthFunc(GL_LEQUAL);
+
+        mShader.bind();
+        glBindVertexArray(mVAO);
+    }
+
+    void OcclusionQueries::query(uint32_t item, const BoundingBox &worldBox, const glm::vec3 &cameraPosition)
+    {
+        if (worldBox.isEmpty())
+        {
+            return;
+        }
+
+        glm::vec3 inflation = worldBox.extents() * kBoxInflation + kBoxMinInflation;
+        glm::vec3 boxMin = worldBox.min - inflation;
+        glm::vec3 boxMax = worldBox.max + inflation;
+
+        glm::vec3 nearMin = boxMin - kCameraMargin;
+        glm::vec3 nearMax = boxMax + kCameraMargin;
+        if (cameraPosition.x >= nearMin.x && cameraPosition.y >= nearMin.y && cameraPosition.z >= nearMin.z &&
+            cameraPosition.x <= nearMax.x && cameraPosition.y <= nearMax.y && cameraPosition.z <= nearMax.z)
+        {
+            return;
+        }
+
+        ItemQuery &entry = mItems[item];
+        if (!entry.query)
+        {
+            entry.query = acquireQuery();
+        }
+
+        mShader.set(mBoxMin, boxMin);
+        mShader.set(mBoxSize, boxMax - boxMin);
+
+        glBeginQuery(GL_ANY_SAMPLES_PASSED, entry.query);
+        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_BYTE, nullptr);
+        glEndQuery(GL_ANY_SAMPLES_PASSED);
+
+        entry.frame = mFrame;
+        ++mStats.queries;
+    }
+
+    void OcclusionQueries::endQueries()
+    {
+        glBindVertexArray(0);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glDepthMask(GL_TRUE);
+        glDepthFunc(GL_LESS);
+    }
+
+} // namespace cg
@@ -0,0 +1,395 @@
+#include "render/PortalSystem.h"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <limits>
+
+namespace cg
+{
+
+    namespace
+    {
+        constexpr const char *kCellPrefix = "CELL_";
+        constexpr const char *kPortalPrefix = "PORTAL_";
+
+        // Folga (em unidades do mundo) nos testes de contenção e de contato
+        constexpr float kTolerance = 1e-3f;
+
+        // Câmera a menos disso do portal (no vão da porta): o portal é tratado
+        // como cobrindo a tela inteira, já que o quad pode estar de lado ou cortado
+        constexpr float kPortalNearDistance = 1.0f;
+
+        constexpr uint32_t kNoPortal = std::numeric_limits<uint32_t>::max();
+
+        // Nome sem o sufixo de duplicata do Blender (".001")
+        std::string baseName(const std::string &name)
+        {
+            size_t dot = name.rfind('.');
+            if (dot == std::string::npos || dot + 1 == name.size())
+                return name;
+            for (size_t i = dot + 1; i < name.size(); ++i)
+            {
+                if (!std::isdigit(static_cast<unsigned char>(name[i])))
+                    return name;
+            }
+            return name.substr(0, dot);
+        }
+
+        bool startsWith(const std::string &text, const char *prefix)
+        {
+            return text.rfind(prefix, 0) == 0;
+        }
+
+        bool contains(const BoundingBox &outer, const BoundingBox &inner)
+        {
+            return inner.min.x >= outer.min.x - kTolerance && inner.min.y >= outer.min.y - kTolerance &&
+                   inner.min.z >= outer.min.z - kTolerance && inner.max.x <= outer.max.x + kTolerance &&
+                   inner.max.y <= outer.max.y + kTolerance && inner.max.z <= outer.max.z + kTolerance;
+        }
+
+        bool overlaps(const BoundingBox &a, const BoundingBox &b)
+        {
+            return a.min.x <= b.max.x + kTolerance && a.max.x >= b.min.x - kTolerance &&
+                   a.min.y <= b.max.y + kTolerance && a.max.y >= b.min.y - kTolerance &&
+                   a.min.z <= b.max.z + kTolerance && a.max.z >= b.min.z - kTolerance;
+        }
+
+        bool containsPoint(const BoundingBox &box, const glm::vec3 &point)
+        {
+            return point.x >= box.min.x && point.y >= box.min.y && point.z >= box.min.z &&
+                   point.x <= box.max.x && point.y <= box.max.y && point.z <= box.max.z;
+        }
+
+        float distanceToBox(const BoundingBox &box, const glm::vec3 &point)
+        {
+            glm::vec3 closest = glm::clamp(point, box.min, box.max);
+            return glm::length(point - closest);
+        }
+    } // namespace
+
+    bool PortalSystem::isHelperName(const std::string &name)
+    {
+        return startsWith(name, kCellPrefix) || startsWith(name, kPortalPrefix);
+    }
+
+    // =================== CONSTRUÇÃO ===================
+
+    uint32_t PortalSystem::findOrAddCell(const std::string &name)
+    {
+        for (uint32_t i = 0; i < mCells.size(); ++i)
+        {
+            if (mCells[i].name == name)
+                return i;
+        }
+        mCells.push_back({name, BoundingBox{}, {}});
+        return static_cast<uint32_t>(mCells.size() - 1);
+    }
+
+    void PortalSystem::build(const std::vector<SceneMesh> &meshes)
+    {
+        mCells.clear();
+        mPortals.clear();
+        mCells.push_back({kExteriorName, BoundingBox{}, {}});
+
+        // =================== CÉLULAS ===================
+        // Várias meshes com o mesmo nome de célula são unidas num só volume
+        for (const SceneMesh &mesh : meshes)
+        {
+            std::string name = baseName(mesh.name);
+            if (startsWith(name, kCellPrefix) && !mesh.worldBox.isEmpty())
+            {
+                Cell &cell = mCells[findOrAddCell(name.substr(std::char_traits<char>::length(kCellPrefix)))];
+                cell.volume.expand(mesh.worldBox.min);
+                cell.volume.expand(mesh.worldBox.max);
+            }
+        }
+
+        // =================== PORTAIS ===================
+        for (const SceneMesh &mesh : meshes)
+        {
+            std::string name = baseName(mesh.name);
+            if (!startsWith(name, kPortalPrefix) || mesh.worldBox.isEmpty())
+                continue;
+
+            std::string cells = name.substr(std::char_traits<char>::length(kPortalPrefix));
+            size_t dash = cells.find('-');
+            if (dash == std::string::npos || dash == 0 || dash + 1 == cells.size())
+            {
+                std::cerr << "AVISO: Portal '" << mesh.name << "' não segue PORTAL_<célulaA>-<célulaB>" << std::endl;
+                continue;
+            }
+
+            Portal portal;
+            portal.name = name;
+            portal.cells[0] = findOrAddCell(cells.substr(0, dash));
+            portal.cells[1] = findOrAddCell(cells.substr(dash + 1));
+            portal.box = mesh.worldBox;
+
+            // Quad: face da AABB no meio do eixo mais fino
+            glm::vec3 size = mesh.worldBox.max - mesh.worldBox.min;
+            int thin = (size.x <= size.y && size.x <= size.z) ? 0 : (size.y <= size.z ? 1 : 2);
+            int u = (thin + 1) % 3;
+            int v = (thin + 2) % 3;
+            glm::vec3 center = mesh.worldBox.center();
+            const float us[4] = {mesh.worldBox.min[u], mesh.worldBox.max[u], mesh.worldBox.max[u], mesh.worldBox.min[u]};
+            const float vs[4] = {mesh.worldBox.min[v], mesh.worldBox.min[v], mesh.worldBox.max[v], mesh.worldBox.max[v]};
+            for (int corner = 0; corner < 4; ++corner)
+            {
+                portal.corners[corner] = center;
+                portal.corners[corner][u] = us[corner];
+                portal.corners[corner][v] = vs[corner];
+            }
+
+            uint32_t index = static_cast<uint32_t>(mPortals.size());
+            mCells[portal.cells[0]].portals.push_back(index);
+            mCells[portal.cells[1]].portals.push_back(index);
+            mPortals.push_back(std::move(portal));
+        }
+
+        if (mCells.size() > kMaxCells)
+        {
+            std::cerr << "AVISO: " << mCells.size() << " células (máximo " << kMaxCells
+                      << "); portal culling desativado" << std::endl;
+            mCells.resize(1);
+            mPortals.clear();
+        }
+
+        // =================== PORTAS ===================
+        for (const SceneMesh &mesh : meshes)
+        {
+            std::string name = baseName(mesh.name);
+            if (!mesh.opaque || mesh.worldBox.isEmpty() || mDoorStates.find(name) == mDoorStates.end())
+                continue;
+            for (Portal &portal : mPortals)
+            {
+                if (overlaps(portal.box, mesh.worldBox) &&
+                    std::find(portal.doors.begin(), portal.doors.end(), name) == portal.doors.end())
+                {
+                    portal.doors.push_back(name);
+                }
+            }
+        }
+
+        // =================== PERTINÊNCIA DAS MESHES ===================
+        mItemCells.assign(meshes.size(), 0);
+        for (size_t i = 0; i < meshes.size(); ++i)
+        {
+            // Auxiliares e entradas sem geometria ficam sem célula; meshes sem nome são comuns
+            const SceneMesh &mesh = meshes[i];
+            if (mesh.worldBox.isEmpty() || isHelperName(mesh.name))
+                continue;
+
+            uint64_t mask = 0;
+            bool inside = false;
+            for (uint32_t c = 1; c < mCells.size() && !inside; ++c)
+            {
+                const BoundingBox &volume = mCells[c].volume;
+                if (volume.isEmpty())
+                    continue;
+                if (contains(volume, mesh.worldBox))
+                {
+                    mask = uint64_t(1) << c;
+                    inside = true;
+                }
+                else if (overlaps(volume, mesh.worldBox))
+                {
+                    mask |= uint64_t(1) << c;
+                }
+            }
+            if (!inside)
+            {
+                mask |= 1; // Exterior
+            }
+            mItemCells[i] = mask;
+        }
+
+        mCellRects.assign(mCells.size(), Rect{});
+        mStats = Stats{};
+        mStats.cells = mCells.size();
+        mStats.portals = mPortals.size();
+    }
+
+    void PortalSystem::setDoorOpen(const std::string &doorName, bool open)
+    {
+        mDoorStates[baseName(doorName)] = open;
+    }
+
+    bool PortalSystem::isPortalOpen(const Portal &portal) const
+    {
+        if (portal.doors.empty())
+            return true;
+        for (const std::string &door : portal.doors)
+        {
+            auto it = mDoorStates.find(door);
+            if (it != mDoorStates.end() && it->second)
+                return true;
+        }
+        return false;
+    }
+
+    // =================== PROJEÇÃO ===================
+
+    PortalSystem::Rect PortalSystem::projectPortal(const Portal &portal) const
+    {
+        glm::vec4 clip[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            clip[i] = mViewProjection * glm::vec4(portal.corners[i], 1.0f);
+        }
+
+        // Recorte pelo plano perto (z >= -w): o polígono pode ganhar um vértice
+        glm::vec4 polygon[5];
+        int count = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            const glm::vec4 &a = clip[i];
+            const glm::vec4 &b = clip[(i + 1) % 4];
+            float da = a.z + a.w;
+            float db = b.z + b.w;
+            if (da >= 0.0f)
+                polygon[count++] = a;
+            if ((da >= 0.0f) != (db >= 0.0f))
+                polygon[count++] = a + (b - a) * (da / (da - db));
+        }
+
+        Rect rect;
+        if (count < 3)
+            return rect;
+
+        rect.min = glm::vec2(std::numeric_limits<float>::max());
+        rect.max = glm::vec2(std::numeric_limits<float>::lowest());
+        for (int i = 0; i < count; ++i)
+        {
+            if (polygon[i].w <= 0.0f)
+                return Rect{{-1.0f, -1.0f}, {1.0f, 1.0f}};
+            glm::vec2 ndc(polygon[i].x / polygon[i].w, polygon[i].y / polygon[i].w);
+            rect.min = glm::min(rect.min, ndc);
+            rect.max = glm::max(rect.max, ndc);
+        }
+        rect.min = glm::max(rect.min, glm::vec2(-1.0f));
+        rect.max = glm::min(rect.max, glm::vec2(1.0f));
+        return rect;
+    }
+
+    PortalSystem::Rect PortalSystem::projectBox(const BoundingBox &box) const
+    {
+        Rect rect;
+        rect.min = glm::vec2(std::numeric_limits<float>::max());
+        rect.max = glm::vec2(std::numeric_limits<float>::lowest());
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            glm::vec3 position((corner & 1) ? box.max.x : box.min.x,
+                               (corner & 2) ? box.max.y : box.min.y,
+                               (corner & 4) ? box.max.z : box.min.z);
+            glm::vec4 clip = mViewProjection * glm::vec4(position, 1.0f);
+            if (clip.z + clip.w < 0.0f || clip.w <= 0.0f)
+                return Rect{{-1.0f, -1.0f}, {1.0f, 1.0f}};
+            glm::vec2 ndc(clip.x / clip.w, clip.y / clip.w);
+            rect.min = glm::min(rect.min, ndc);
+            rect.max = glm::max(rect.max, ndc);
+        }
+        return rect;
+    }
+
+    // =================== TRAVESSIA ===================
+
+    void PortalSystem::traverse(const glm::mat4 &viewProjection, const glm::vec3 &cameraPosition)
+    {
+        mViewProjection = viewProjection;
+        mCellRects.assign(mCells.size(), Rect{});
+        mStats.cellsVisible = 0;
+        mStats.portalsTraversed = 0;
+
+        // Célula da câmera: o primeiro volume que a contém (senão, o Exterior)
+        uint32_t cameraCell = 0;
+        for (uint32_t c = 1; c < mCells.size(); ++c)
+        {
+            if (!mCells[c].volume.isEmpty() && containsPoint(mCells[c].volume, cameraPosition))
+            {
+                cameraCell = c;
+                break;
+            }
+        }
+        mStats.cameraCell = cameraCell;
+
+        visit(cameraCell, Rect{{-1.0f, -1.0f}, {1.0f, 1.0f}}, kNoPortal, 0, cameraPosition);
+
+        for (const Rect &rect : mCellRects)
+        {
+            if (!rect.isEmpty())
+                ++mStats.cellsVisible;
+        }
+    }
+
+    void PortalSystem::visit(uint32_t cell, const Rect &rect, uint32_t arrivalPortal, int depth, const glm::vec3 &cameraPosition)
+    {
+        Rect &seen = mCellRects[cell];
+        if (seen.isEmpty())
+        {
+            seen = rect;
+        }
+        else
+        {
+            seen.min = glm::min(seen.min, rect.min);
+            seen.max = glm::max(seen.max, rect.max);
+        }
+
+        if (depth >= kMaxDepth)
+            return;
+
+        for (uint32_t index : mCells[cell].portals)
+        {
+            const Portal &portal = mPortals[index];
+            if (index == arrivalPortal || !isPortalOpen(portal))
+                continue;
+
+            uint32_t other = portal.cells[0] == cell ? portal.cells[1] : portal.cells[0];
+            if (other == cell)
+                continue;
+
+            // O que se vê da outra célula fica limitado ao retângulo do portal
+            Rect through = rect;
+            if (distanceToBox(portal.box, cameraPosition) > kPortalNearDistance)
+            {
+                Rect portalRect = projectPortal(portal);
+                through.min = glm::max(through.min, portalRect.min);
+                through.max = glm::min(through.max, portalRect.max);
+                if (portalRect.isEmpty() || through.isEmpty())
+                    continue;
+            }
+
+            ++mStats.portalsTraversed;
+            visit(other, through, index, depth + 1, cameraPosition);
+        }
+    }
+
+    bool PortalSystem::isVisible(uint32_t item, const BoundingBox &worldBox) const
+    {
+        if (item >= mItemCells.size())
+            return true;
+
+        uint64_t mask = mItemCells[item];
+        if (mask == 0)
+            return false; // Auxiliar (CELL_/PORTAL_) ou sem geometria
+
+        Rect boxRect;
+        bool projected = false;
+        for (uint32_t c = 0; c < mCells.size(); ++c)
+        {
+            const Rect &seen = mCellRects[c];
+            if (!(mask & (uint64_t(1) << c)) || seen.isEmpty())
+                continue;
+
+            if (!projected)
+            {
+                boxRect = projectBox(worldBox);
+                projected = true;
+            }
+            if (boxRect.min.x <= seen.max.x && boxRect.max.x >= seen.min.x &&
+                boxRect.min.y <= seen.max.y && boxRect.max.y >= seen.min.y)
+                return true;
+        }
+        return false;
+    }
+
+} // namespace cg
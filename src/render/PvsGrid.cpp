@@ -0,0 +1,572 @@
+#include "render/PvsGrid.h"
+#include "render/Bvh.h"
+#include "render/MeshCache.h"
+#include "render/Model.h"
+#include "render/PortalSystem.h"
+#include "core/MappedFile.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <utility>
+
+namespace cg
+{
+
+    namespace
+    {
+        // =================== LAYOUT DO ARQUIVO ===================
+        // [PvsHeader][início das células por coluna][caixas das células][bitsets]
+
+        constexpr char kMagic[4] = {'C', 'G', 'P', 'V'};
+        constexpr uint32_t kEndianMarker = 0x01020304u;
+
+        struct PvsHeader
+        {
+            char magic[4];
+            uint32_t endianMarker;
+            uint32_t formatVersion;
+            uint32_t columnsX;
+            uint32_t columnsZ;
+            float cellSize;
+            float originX;
+            float originZ;
+            uint64_t signature;
+            uint64_t meshCount;
+            uint64_t cellCount;
+            uint64_t payloadHash;
+        };
+
+        // Colunas no máximo; acima disso o lado da coluna é dobrado
+        constexpr size_t kMaxColumns = 512 * 512;
+
+        // Pisos (células) no máximo por coluna
+        constexpr int kMaxFloorsPerColumn = 16;
+
+        // Afastamento das superfícies ao relançar raios a partir de um acerto
+        constexpr float kSurfaceOffset = 0.01f;
+
+        // Möller–Trumbore sem descarte de faces; distância ou negativo se não há acerto
+        float intersectTriangle(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c,
+                                const glm::vec3 &origin, const glm::vec3 &direction)
+        {
+            glm::vec3 edge1 = b - a;
+            glm::vec3 edge2 = c - a;
+            glm::vec3 p = glm::cross(direction, edge2);
+            float determinant = glm::dot(edge1, p);
+            if (std::abs(determinant) < 1e-12f)
+                return -1.0f;
+
+            float inverse = 1.0f / determinant;
+            glm::vec3 s = origin - a;
+            float u = glm::dot(s, p) * inverse;
+            if (u < 0.0f || u > 1.0f)
+                return -1.0f;
+
+            glm::vec3 q = glm::cross(s, edge1);
+            float v = glm::dot(direction, q) * inverse;
+            if (v < 0.0f || u + v > 1.0f)
+                return -1.0f;
+
+            return glm::dot(edge2, q) * inverse;
+        }
+
+        bool overlaps(const BoundingBox &a, const BoundingBox &b)
+        {
+            return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+                   a.min.y <= b.max.y && a.max.y >= b.min.y &&
+                   a.min.z <= b.max.z && a.max.z >= b.min.z;
+        }
+
+        // Executa function(i) para i em [0, count) distribuindo os índices entre as threads
+        template <typename Function>
+        void parallelFor(size_t count, unsigned threadCount, Function &&function)
+        {
+            std::atomic<size_t> next{0};
+            auto worker = [&]()
+            {
+                for (size_t i = next++; i < count; i = next++)
+                    function(i);
+            };
+
+            std::vector<std::thread> threads;
+            for (unsigned t = 1; t < threadCount; ++t)
+                threads.emplace_back(worker);
+            worker();
+            for (std::thread &thread : threads)
+                thread.join();
+        }
+    } // namespace
+
+    std::string PvsGrid::cachePathFor(const std::string &objPath)
+    {
+        return objPath + ".pvs";
+    }
+
+    // =================== GEOMETRIA ===================
+
+    PvsGrid::Geometry PvsGrid::gather(const Model &model)
+    {
+        model.updateWorldMatrices();
+
+        const auto &meshes = model.getMeshes();
+        Geometry geometry;
+        geometry.meshBoxes.assign(meshes.size(), BoundingBox{});
+        geometry.roles.assign(meshes.size(), MeshRole::Ignored);
+
+        for (size_t i = 0; i < meshes.size(); ++i)
+        {
+            const Mesh *mesh = meshes[i].get();
+            if (!mesh || PortalSystem::isHelperName(mesh->name))
+                continue;
+
+            if (model.isInHierarchy(mesh))
+                geometry.roles[i] = MeshRole::Dynamic;
+            else if (mesh->isTransparent())
+                geometry.roles[i] = MeshRole::Transparent;
+            else
+                geometry.roles[i] = MeshRole::Occluder;
+
+            // Com KeepPositionsOnly as posições ficam num array próprio; senão, dentro de Vertex
+            size_t vertexCount = !mesh->positions.empty() ? mesh->positions.size() : mesh->vertices.size();
+            if (vertexCount == 0 || mesh->indices.empty())
+            {
+                geometry.roles[i] = MeshRole::Dynamic; // sem geometria na CPU: nunca descartada
+                continue;
+            }
+
+            const glm::mat4 &world = model.getWorldMatrix(i);
+            uint32_t base = static_cast<uint32_t>(geometry.positions.size());
+            for (size_t v = 0; v < vertexCount; ++v)
+            {
+                const glm::vec3 &local = !mesh->positions.empty() ? mesh->positions[v] : mesh->vertices[v].position;
+                glm::vec3 position = glm::vec3(world * glm::vec4(local, 1.0f));
+                geometry.positions.push_back(position);
+                geometry.meshBoxes[i].expand(position);
+            }
+            for (size_t t = 0; t + 2 < mesh->indices.size(); t += 3)
+            {
+                geometry.indices.push_back(base + mesh->indices[t]);
+                geometry.indices.push_back(base + mesh->indices[t + 1]);
+                geometry.indices.push_back(base + mesh->indices[t + 2]);
+                geometry.triangleMeshes.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        return geometry;
+    }
+
+    uint64_t PvsGrid::signature(const Geometry &geometry, const BakeOptions &options)
+    {
+        // threadCount fica de fora: o resultado não depende do número de threads
+        const float parameters[4] = {options.cellSize, options.eyeHeightMin, options.eyeHeightMax, options.minFloorNormalY};
+        const uint32_t counts[4] = {options.samplesPerCell, options.raysPerSample, options.dilate ? 1u : 0u,
+                                    static_cast<uint32_t>(geometry.roles.size())};
+
+        uint64_t hash = MeshCache::hashBytes(parameters, sizeof(parameters), kFormatVersion);
+        hash = MeshCache::hashBytes(counts, sizeof(counts), hash);
+        hash = MeshCache::hashBytes(geometry.positions.data(), geometry.positions.size() * sizeof(glm::vec3), hash);
+        hash = MeshCache::hashBytes(geometry.indices.data(), geometry.indices.size() * sizeof(uint32_t), hash);
+        hash = MeshCache::hashBytes(geometry.triangleMeshes.data(), geometry.triangleMeshes.size() * sizeof(uint32_t), hash);
+        hash = MeshCache::hashBytes(geometry.roles.data(), geometry.roles.size() * sizeof(MeshRole), hash);
+        return hash;
+    }
+
+    // =================== BAKE ===================
+
+    bool PvsGrid::bake(const Geometry &geometry, const BakeOptions &options)
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        mMeshCount = geometry.roles.size();
+        mWordsPerCell = (mMeshCount + 63) / 64;
+        mColumnFirst.clear();
+        mCellBoxes.clear();
+        mBits.clear();
+        mStats = Stats{};
+        mStats.meshes = mMeshCount;
+
+        unsigned threadCount = options.threadCount ? options.threadCount : std::max(1u, std::thread::hardware_concurrency());
+
+        // =================== BVH DOS TRIÂNGULOS ===================
+        const size_t triangleCount = geometry.triangleMeshes.size();
+        std::vector<BoundingBox> triangleBoxes(triangleCount);
+        BoundingBox sceneBox;
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            if (geometry.roles[geometry.triangleMeshes[t]] == MeshRole::Ignored)
+                continue; // caixa vazia: nunca retornada pela BVH
+            for (int corner = 0; corner < 3; ++corner)
+                triangleBoxes[t].expand(geometry.positions[geometry.indices[t * 3 + corner]]);
+            sceneBox.expand(triangleBoxes[t].min);
+            sceneBox.expand(triangleBoxes[t].max);
+        }
+        if (sceneBox.isEmpty())
+            return false;
+
+        Bvh bvh;
+        bvh.build(triangleBoxes);
+
+        auto triangleDistance = [&](uint32_t t, const glm::vec3 &origin, const glm::vec3 &direction)
+        {
+            const uint32_t *corners = &geometry.indices[static_cast<size_t>(t) * 3];
+            return intersectTriangle(geometry.positions[corners[0]], geometry.positions[corners[1]],
+                                     geometry.positions[corners[2]], origin, direction);
+        };
+
+        // Primeiro triângulo opaco atingido (pisos, tetos e oclusão)
+        auto castOpaque = [&](const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, float &distance)
+        {
+            return bvh.closestHit(origin, direction, maxDistance, [&](uint32_t t, float)
+                                  { return geometry.roles[geometry.triangleMeshes[t]] == MeshRole::Occluder
+                                               ? triangleDistance(t, origin, direction)
+                                               : -1.0f; },
+                                  &distance);
+        };
+
+        // =================== CÉLULAS CAMINHÁVEIS ===================
+        // Colunas verticais; cada piso com altura livre para a câmera vira uma célula
+        mCellSize = std::max(options.cellSize, 0.01f);
+        glm::vec3 extent = sceneBox.max - sceneBox.min;
+        auto columnsFor = [&](float extentAxis)
+        { return std::max(1u, static_cast<uint32_t>(std::ceil(extentAxis / mCellSize))); };
+        while (static_cast<size_t>(columnsFor(extent.x)) * columnsFor(extent.z) > kMaxColumns)
+        {
+            mCellSize *= 2.0f;
+        }
+        mColumnsX = columnsFor(extent.x);
+        mColumnsZ = columnsFor(extent.z);
+        mOrigin = glm::vec2(sceneBox.min.x, sceneBox.min.z);
+
+        std::vector<std::vector<BoundingBox>> columnCells(static_cast<size_t>(mColumnsX) * mColumnsZ);
+        parallelFor(columnCells.size(), threadCount, [&](size_t column)
+                    {
+            uint32_t ix = static_cast<uint32_t>(column % mColumnsX);
+            uint32_t iz = static_cast<uint32_t>(column / mColumnsX);
+            glm::vec2 cellMin(mOrigin.x + ix * mCellSize, mOrigin.y + iz * mCellSize);
+            glm::vec3 origin(cellMin.x + mCellSize * 0.5f, sceneBox.max.y + 1.0f, cellMin.y + mCellSize * 0.5f);
+
+            for (int floor = 0; floor < kMaxFloorsPerColumn; ++floor)
+            {
+                float distance = 0.0f;
+                uint32_t hit = castOpaque(origin, glm::vec3(0.0f, -1.0f, 0.0f), origin.y - sceneBox.min.y + 1.0f, distance);
+                if (hit == Bvh::kNoItem)
+                    break;
+
+                float floorHeight = origin.y - distance;
+                const uint32_t *corners = &geometry.indices[static_cast<size_t>(hit) * 3];
+                glm::vec3 normal = glm::cross(geometry.positions[corners[1]] - geometry.positions[corners[0]],
+                                              geometry.positions[corners[2]] - geometry.positions[corners[0]]);
+                float normalLength = glm::length(normal);
+
+                // Sem teto abaixo da altura máxima dos olhos (a face de baixo de uma laje falha aqui)
+                float ceilingDistance = 0.0f;
+                if (normalLength > 0.0f && std::abs(normal.y) / normalLength >= options.minFloorNormalY &&
+                    castOpaque(glm::vec3(origin.x, floorHeight + kSurfaceOffset, origin.z), glm::vec3(0.0f, 1.0f, 0.0f),
+                               options.eyeHeightMax, ceilingDistance) == Bvh::kNoItem)
+                {
+                    BoundingBox cell;
+                    cell.min = glm::vec3(cellMin.x, floorHeight + options.eyeHeightMin, cellMin.y);
+                    cell.max = glm::vec3(cellMin.x + mCellSize, floorHeight + options.eyeHeightMax, cellMin.y + mCellSize);
+                    columnCells[column].push_back(cell);
+                }
+                origin.y = floorHeight - kSurfaceOffset;
+            } });
+
+        mColumnFirst.reserve(columnCells.size() + 1);
+        for (std::vector<BoundingBox> &cells : columnCells)
+        {
+            mColumnFirst.push_back(static_cast<uint32_t>(mCellBoxes.size()));
+            mCellBoxes.insert(mCellBoxes.end(), cells.begin(), cells.end());
+        }
+        mColumnFirst.push_back(static_cast<uint32_t>(mCellBoxes.size()));
+        if (mCellBoxes.empty())
+        {
+            std::cerr << "AVISO: PVS sem células caminháveis (nenhum piso encontrado)" << std::endl;
+            mColumnFirst.clear();
+            return false;
+        }
+
+        // =================== VISIBILIDADE POR CÉLULA ===================
+        mBits.assign(mCellBoxes.size() * mWordsPerCell, 0);
+        const float maxRayDistance = glm::length(extent) + 1.0f;
+        const uint32_t raysPerSample = std::max(1u, options.raysPerSample);
+        const uint32_t samplesPerCell = std::max(1u, options.samplesPerCell);
+        const float goldenAngle = 3.14159265f * (3.0f - std::sqrt(5.0f));
+
+        parallelFor(mCellBoxes.size(), threadCount, [&](size_t cell)
+                    {
+            const BoundingBox &box = mCellBoxes[cell];
+            uint64_t *bits = &mBits[cell * mWordsPerCell];
+            auto mark = [bits](uint32_t mesh)
+            { bits[mesh / 64] |= uint64_t(1) << (mesh % 64); };
+
+            // Dinâmicas e meshes que tocam a célula (a câmera pode estar dentro delas)
+            for (uint32_t mesh = 0; mesh < mMeshCount; ++mesh)
+            {
+                MeshRole role = geometry.roles[mesh];
+                if (role == MeshRole::Dynamic || (role != MeshRole::Ignored && overlaps(geometry.meshBoxes[mesh], box)))
+                    mark(mesh);
+            }
+
+            // Semente por célula: o resultado não depende da ordem das threads
+            std::mt19937 rng(static_cast<uint32_t>(cell) * 2654435761u + 1u);
+            std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+            std::vector<std::pair<float, uint32_t>> crossed; // Transparentes atravessadas pelo raio atual
+
+            for (uint32_t sample = 0; sample < samplesPerCell; ++sample)
+            {
+                glm::vec3 eye = sample == 0 ? box.center()
+                                            : box.min + (box.max - box.min) * glm::vec3(unit(rng), unit(rng), unit(rng));
+                float phase = unit(rng) * 2.0f * 3.14159265f;
+
+                // Direções numa espiral de Fibonacci (quase uniformes na esfera), girada por amostra
+                for (uint32_t ray = 0; ray < raysPerSample; ++ray)
+                {
+                    float y = 1.0f - 2.0f * (ray + 0.5f) / raysPerSample;
+                    float radius = std::sqrt(std::max(0.0f, 1.0f - y * y));
+                    float angle = goldenAngle * ray + phase;
+                    glm::vec3 direction(std::cos(angle) * radius, y, std::sin(angle) * radius);
+
+                    crossed.clear();
+                    float distance = maxRayDistance;
+                    uint32_t hit = bvh.closestHit(eye, direction, maxRayDistance, [&](uint32_t t, float)
+                                                  {
+                        MeshRole role = geometry.roles[geometry.triangleMeshes[t]];
+                        if (role == MeshRole::Ignored)
+                            return -1.0f;
+                        float d = triangleDistance(t, eye, direction);
+                        if (d >= 0.0f && role != MeshRole::Occluder)
+                        {
+                            crossed.emplace_back(d, geometry.triangleMeshes[t]);
+                            return -1.0f;
+                        }
+                        return d; },
+                                                  &distance);
+
+                    if (hit != Bvh::kNoItem)
+                        mark(geometry.triangleMeshes[hit]);
+                    for (const auto &[d, mesh] : crossed)
+                    {
+                        if (d <= distance)
+                            mark(mesh);
+                    }
+                }
+            } });
+        mStats.rays = mCellBoxes.size() * samplesPerCell * raysPerSample;
+
+        // =================== DILATAÇÃO ===================
+        // Cada conjunto recebe os das células vizinhas (colunas adjacentes, alturas próximas)
+        if (options.dilate)
+        {
+            std::vector<uint64_t> original = mBits;
+            for (uint32_t iz = 0; iz < mColumnsZ; ++iz)
+            {
+                for (uint32_t ix = 0; ix < mColumnsX; ++ix)
+                {
+                    uint32_t column = iz * mColumnsX + ix;
+                    for (uint32_t cell = mColumnFirst[column]; cell < mColumnFirst[column + 1]; ++cell)
+                    {
+                        const BoundingBox &box = mCellBoxes[cell];
+                        for (int dz = -1; dz <= 1; ++dz)
+                        {
+                            for (int dx = -1; dx <= 1; ++dx)
+                            {
+                                int nx = static_cast<int>(ix) + dx;
+                                int nz = static_cast<int>(iz) + dz;
+                                if (nx < 0 || nz < 0 || nx >= static_cast<int>(mColumnsX) || nz >= static_cast<int>(mColumnsZ))
+                                    continue;
+
+                                uint32_t neighborColumn = static_cast<uint32_t>(nz) * mColumnsX + static_cast<uint32_t>(nx);
+                                for (uint32_t neighbor = mColumnFirst[neighborColumn]; neighbor < mColumnFirst[neighborColumn + 1]; ++neighbor)
+                                {
+                                    const BoundingBox &other = mCellBoxes[neighbor];
+                                    if (neighbor == cell || other.min.y > box.max.y + mCellSize || other.max.y < box.min.y - mCellSize)
+                                        continue;
+                                    for (size_t word = 0; word < mWordsPerCell; ++word)
+                                        mBits[cell * mWordsPerCell + word] |= original[neighbor * mWordsPerCell + word];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        computeAverage();
+        auto endTime = std::chrono::high_resolution_clock::now();
+        mStats.bakeTimeMs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() / 1000.0f;
+        return true;
+    }
+
+    void PvsGrid::computeAverage()
+    {
+        mStats.cells = mCellBoxes.size();
+        mStats.meshes = mMeshCount;
+        size_t total = 0;
+        for (uint64_t word : mBits)
+            total += static_cast<size_t>(std::popcount(word));
+        mStats.averageVisible = mCellBoxes.empty() ? 0.0f : static_cast<float>(total) / mCellBoxes.size();
+    }
+
+    // =================== CONSULTA ===================
+
+    int32_t PvsGrid::findCell(const glm::vec3 &position) const
+    {
+        if (mCellBoxes.empty())
+            return kNoCell;
+
+        float fx = std::floor((position.x - mOrigin.x) / mCellSize);
+        float fz = std::floor((position.z - mOrigin.y) / mCellSize);
+        if (fx < 0.0f || fz < 0.0f || fx >= static_cast<float>(mColumnsX) || fz >= static_cast<float>(mColumnsZ))
+            return kNoCell;
+
+        uint32_t column = static_cast<uint32_t>(fz) * mColumnsX + static_cast<uint32_t>(fx);
+        for (uint32_t cell = mColumnFirst[column]; cell < mColumnFirst[column + 1]; ++cell)
+        {
+            if (position.y >= mCellBoxes[cell].min.y && position.y <= mCellBoxes[cell].max.y)
+                return static_cast<int32_t>(cell);
+        }
+        return kNoCell;
+    }
+
+    // =================== ARQUIVO ===================
+
+    bool PvsGrid::load(const std::string &path, uint64_t expectedSignature)
+    {
+        MappedFile file;
+        if (!file.open(path))
+            return false; // ainda não existe
+
+        PvsHeader header{};
+        if (file.size() < sizeof(PvsHeader))
+        {
+            std::cerr << "AVISO: Arquivo de PVS corrompido (cabeçalho truncado): " << path << std::endl;
+            return false;
+        }
+        std::memcpy(&header, file.data(), sizeof(PvsHeader));
+
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.endianMarker != kEndianMarker)
+        {
+            std::cerr << "AVISO: Arquivo de PVS inválido: " << path << std::endl;
+            return false;
+        }
+        if (header.formatVersion != kFormatVersion || header.signature != expectedSignature)
+        {
+            std::cout << "PVS desatualizado, será recalculado: " << path << std::endl;
+            return false;
+        }
+
+        size_t columnCount = static_cast<size_t>(header.columnsX) * header.columnsZ;
+        size_t wordsPerCell = (header.meshCount + 63) / 64;
+        size_t payloadSize = file.size() - sizeof(PvsHeader);
+        if (header.cellSize <= 0.0f || header.cellCount > payloadSize || columnCount > payloadSize ||
+            payloadSize != (columnCount + 1) * sizeof(uint32_t) + header.cellCount * sizeof(BoundingBox) +
+                               header.cellCount * wordsPerCell * sizeof(uint64_t))
+        {
+            std::cerr << "AVISO: Arquivo de PVS corrompido (tamanho): " << path << std::endl;
+            return false;
+        }
+
+        const char *payload = file.data() + sizeof(PvsHeader);
+        if (MeshCache::hashBytes(payload, payloadSize) != header.payloadHash)
+        {
+            std::cerr << "AVISO: Arquivo de PVS corrompido (checksum inválido): " << path << std::endl;
+            return false;
+        }
+
+        mOrigin = glm::vec2(header.originX, header.originZ);
+        mCellSize = header.cellSize;
+        mColumnsX = header.columnsX;
+        mColumnsZ = header.columnsZ;
+        mMeshCount = header.meshCount;
+        mWordsPerCell = wordsPerCell;
+
+        mColumnFirst.resize(columnCount + 1);
+        mCellBoxes.resize(header.cellCount);
+        mBits.resize(header.cellCount * wordsPerCell);
+        std::memcpy(mColumnFirst.data(), payload, mColumnFirst.size() * sizeof(uint32_t));
+        payload += mColumnFirst.size() * sizeof(uint32_t);
+        std::memcpy(mCellBoxes.data(), payload, mCellBoxes.size() * sizeof(BoundingBox));
+        payload += mCellBoxes.size() * sizeof(BoundingBox);
+        std::memcpy(mBits.data(), payload, mBits.size() * sizeof(uint64_t));
+
+        if (mColumnFirst.back() != header.cellCount || !std::is_sorted(mColumnFirst.begin(), mColumnFirst.end()))
+        {
+            std::cerr << "AVISO: Arquivo de PVS corrompido (colunas): " << path << std::endl;
+            *this = PvsGrid{};
+            return false;
+        }
+
+        mStats = Stats{};
+        computeAverage();
+        return true;
+    }
+
+    bool PvsGrid::write(const std::string &path, uint64_t signature) const
+    {
+        std::vector<char> payload;
+        auto append = [&payload](const void *data, size_t size)
+        {
+            const char *bytes = static_cast<const char *>(data);
+            payload.insert(payload.end(), bytes, bytes + size);
+        };
+        append(mColumnFirst.data(), mColumnFirst.size() * sizeof(uint32_t));
+        append(mCellBoxes.data(), mCellBoxes.size() * sizeof(BoundingBox));
+        append(mBits.data(), mBits.size() * sizeof(uint64_t));
+
+        PvsHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.endianMarker = kEndianMarker;
+        header.formatVersion = kFormatVersion;
+        header.columnsX = mColumnsX;
+        header.columnsZ = mColumnsZ;
+        header.cellSize = mCellSize;
+        header.originX = mOrigin.x;
+        header.originZ = mOrigin.y;
+        header.signature = signature;
+        header.meshCount = mMeshCount;
+        header.cellCount = mCellBoxes.size();
+        header.payloadHash = MeshCache::hashBytes(payload.data(), payload.size());
+
+        // Grava em arquivo temporário e renomeia, para nunca deixar um arquivo pela metade
+        std::string tempPath = path + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open())
+            {
+                std::cerr << "AVISO: Não foi possível criar o arquivo de PVS: " << tempPath << std::endl;
+                return false;
+            }
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+            if (!out)
+            {
+                std::cerr << "AVISO: Falha ao escrever o arquivo de PVS: " << tempPath << std::endl;
+                out.close();
+                std::error_code ec;
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, path, ec);
+        if (ec)
+        {
+            std::cerr << "AVISO: Falha ao gravar o arquivo de PVS: " << path << " (" << ec.message() << ")" << std::endl;
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        std::cout << "PVS gravado: " << path << " (" << (sizeof(header) + payload.size()) / 1024 << " KB)" << std::endl;
+        return true;
+    }
+
+} // namespace cg
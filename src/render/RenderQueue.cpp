@@ -0,0 +1,101 @@
+#include "render/RenderQueue.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace cg
+{
+
+    namespace
+    {
+        constexpr int kDepthBits = 22;
+        constexpr uint64_t kDepthMask = (1ull << kDepthBits) - 1;
+
+        // Floats positivos mantêm a ordem quando lidos como inteiros; os bits mais
+        // altos (expoente + início da mantissa) bastam para ordenar por distância
+        inline uint64_t quantizeDepth(float viewDistance)
+        {
+            float distance = viewDistance > 0.0f ? viewDistance : 0.0f; // também descarta NaN
+            uint32_t bits;
+            std::memcpy(&bits, &distance, sizeof(bits));
+            return (bits >> (32 - 1 - kDepthBits)) & kDepthMask; // ignora o bit de sinal (sempre 0)
+        }
+
+        // Abaixo disso a ordenação por comparação é mais barata que as passadas do radix
+        constexpr size_t kRadixThreshold = 64;
+    } // namespace
+
+    uint64_t RenderQueue::makeOpaqueKey(uint32_t shader, uint32_t material, uint32_t vertexArray, float viewDistance)
+    {
+        return (static_cast<uint64_t>(Pass::Opaque) << 62) |
+               (static_cast<uint64_t>(shader & 0xFF) << 54) |
+               (static_cast<uint64_t>(material & 0xFFFF) << 38) |
+               (static_cast<uint64_t>(vertexArray & 0xFFFF) << 22) |
+               quantizeDepth(viewDistance);
+    }
+
+    uint64_t RenderQueue::makeTransparentKey(uint32_t shader, uint32_t material, uint32_t vertexArray, float viewDistance)
+    {
+        return (static_cast<uint64_t>(Pass::Transparent) << 62) |
+               ((kDepthMask - quantizeDepth(viewDistance)) << 40) |
+               (static_cast<uint64_t>(shader & 0xFF) << 32) |
+               (static_cast<uint64_t>(material & 0xFFFF) << 16) |
+               static_cast<uint64_t>(vertexArray & 0xFFFF);
+    }
+
+    void RenderQueue::sort()
+    {
+        const size_t count = mPackets.size();
+        if (count < kRadixThreshold)
+        {
+            std::stable_sort(mPackets.begin(), mPackets.end(), [](const Packet &a, const Packet &b)
+                             { return a.key < b.key; });
+            return;
+        }
+
+        // Histogramas dos 8 bytes numa única passada
+        std::array<std::array<uint32_t, 256>, 8> histograms{};
+        for (const Packet &packet : mPackets)
+        {
+            for (int digit = 0; digit < 8; ++digit)
+            {
+                ++histograms[digit][(packet.key >> (digit * 8)) & 0xFF];
+            }
+        }
+
+        mScratch.resize(count);
+        Packet *source = mPackets.data();
+        Packet *target = mScratch.data();
+        for (int digit = 0; digit < 8; ++digit)
+        {
+            std::array<uint32_t, 256> &histogram = histograms[digit];
+            const int shift = digit * 8;
+
+            // Byte igual em todas as chaves: a passada não mudaria a ordem
+            if (histogram[(source[0].key >> shift) & 0xFF] == count)
+            {
+                continue;
+            }
+
+            uint32_t offset = 0;
+            for (uint32_t &bucket : histogram)
+            {
+                uint32_t bucketCount = bucket;
+                bucket = offset;
+                offset += bucketCount;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                target[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+            }
+            std::swap(source, target);
+        }
+
+        if (source != mPackets.data())
+        {
+            std::copy(source, source + count, mPackets.data());
+        }
+    }
+
+} // namespace cg
@@ -1,109 +1,114 @@
 #include "render/Renderer.h"
 #include <iostream>
+#include <string>
 #include <glad/glad.h>
 #include <algorithm>
+#include <chrono>
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace cg
 {
 
-    Renderer::Renderer() = default;
-
-    bool Renderer::init()
+    namespace
     {
-        std::cout << "Inicializando sistema de renderização..." << std::endl;
-
         // =================== SHADER BÁSICO PARA MODELOS 3D ===================
-        // Shader vertex mais avançado que suporta normais e iluminação básica
-        const char *vertexShaderSource = R"GLSL(
-        #version 330 core
-        
-        // Atributos de entrada
-        layout(location = 0) in vec3 aPosition;  // Posição do vértice
-        layout(location = 1) in vec3 aNormal;    // Normal do vértice
-        layout(location = 2) in vec2 aTexCoord;  // Coordenada de textura
+        // Corpo do vertex shader; a versão, os blocos FrameUniforms e ObjectUniforms
+        // e as entradas vêm de Renderer::getSceneShaders
+        const char *kSceneVertexShaderBody = R"GLSL(
+        // Atributos de entrada: declarados pelo layout de vértice (VertexLayoutInfo::glslPrelude),
+        // junto com decodePosition(), decodeNormal() e decodeTexCoord()
         
-        // Matrizes de transformação
-        uniform mat4 uModel;       // Matriz do modelo (posição, rotação, escala)
-        uniform mat4 uView;        // Matriz de visualização (câmera)
-        uniform mat4 uProjection;  // Matriz de projeção (perspectiva)
-        uniform mat3 uNormalMatrix; // Matriz para transformar normais
+        // Matrizes por objeto (uModel, uNormalMatrix) em ObjectUniforms; câmera em FrameUniforms
         
         // Dados para o fragment shader
         out vec3 FragPos;    // Posição do fragmento no espaço mundial
         out vec3 Normal;     // Normal transformada
         out vec2 TexCoord;   // Coordenada de textura
+        out vec3 ObjectColor; // Cor base (do material; por instância no shader instanciado)
         
         void main() {
             // Calcula posição final do vértice
-            vec4 worldPos = uModel * vec4(aPosition, 1.0);
+            vec4 worldPos = uModel * vec4(decodePosition(), 1.0);
             FragPos = worldPos.xyz;
             
-            // Transforma a normal para o espaço mundial
-            Normal = normalize(uNormalMatrix * aNormal);
+            // Transforma a normal para o espaço mundial (normais quantizadas chegam sem normalizar)
+            Normal = normalize(uNormalMatrix * decodeNormal());
             
             // Passa coordenada de textura inalterada
-            TexCoord = aTexCoord;
+            TexCoord = decodeTexCoord();
+            ObjectColor = uObjectColor.rgb;
             
             // Posição final na tela
-            gl_Position = uProjection * uView * worldPos;
+            gl_Position = uViewProjection * worldPos;
+        }
+    )GLSL";
+
+        // =================== SHADER INSTANCIADO ===================
+        // Mesmo fragment shader básico; matrizes e cor vêm do buffer de instâncias
+        // (InstancedModel::kTransformLocation / kColorLocation / kNormalMatrixLocation)
+        const char *kInstancedVertexShaderBody = R"GLSL(
+        layout(location = 3) in mat4 aInstanceModel;        // Ocupa os locais 3 a 6
+        layout(location = 7) in vec4 aInstanceColor;
+        layout(location = 8) in mat3 aInstanceNormalMatrix; // Ocupa os locais 8 a 10 (calculada na CPU)
+        
+        out vec3 FragPos;
+        out vec3 Normal;
+        out vec2 TexCoord;
+        out vec3 ObjectColor;
+        
+        void main() {
+            vec4 worldPos = aInstanceModel * vec4(decodePosition(), 1.0);
+            FragPos = worldPos.xyz;
+            
+            Normal = normalize(aInstanceNormalMatrix * decodeNormal());
+            
+            TexCoord = decodeTexCoord();
+            ObjectColor = uObjectColor.rgb * aInstanceColor.rgb;
+            gl_Position = uViewProjection * worldPos;
         }
     )GLSL";
 
-        // Shader fragment com iluminação básica
-        const char *fragmentShaderSource = R"GLSL(
-        #version 330 core
+        // Shader fragment com iluminação básica (câmera e luz em FrameUniforms, material em ObjectUniforms)
+        const char *kBasicFragmentShaderSource = R"GLSL(
         
         // Dados de entrada do vertex shader
         in vec3 FragPos;   // Posição do fragmento
         in vec3 Normal;    // Normal do fragmento
         in vec2 TexCoord;  // Coordenada de textura
+        in vec3 ObjectColor; // Cor base do objeto
         
         // Cor final de saída
         out vec4 FragColor;
         
-        // Configurações de iluminação
-        uniform vec3 uLightPos;     // Posição da luz
-        uniform vec3 uLightColor;   // Cor da luz
-        uniform vec3 uViewPos;      // Posição da câmera
-        uniform vec3 uObjectColor;  // Cor base do objeto
-        
         void main() {
+            vec3 lightColor = uLightColor.rgb;
+            vec3 objectColor = ObjectColor;
+            
             // =================== ILUMINAÇÃO AMBIENTE ===================
             float ambientStrength = 0.3;
-            vec3 ambient = ambientStrength * uLightColor;
+            vec3 ambient = ambientStrength * lightColor;
             
             // =================== ILUMINAÇÃO DIFUSA ===================
-            vec3 lightDir = normalize(uLightPos - FragPos);
+            vec3 lightDir = normalize(uLightPos.xyz - FragPos);
             float diff = max(dot(Normal, lightDir), 0.0);
-            vec3 diffuse = diff * uLightColor;
+            vec3 diffuse = diff * lightColor;
             
             // =================== ILUMINAÇÃO ESPECULAR ===================
             float specularStrength = 0.5;
-            vec3 viewDir = normalize(uViewPos - FragPos);
+            vec3 viewDir = normalize(uCameraPos.xyz - FragPos);
             vec3 reflectDir = reflect(-lightDir, Normal);
             float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
-            vec3 specular = specularStrength * spec * uLightColor;
+            vec3 specular = specularStrength * spec * lightColor;
             
             // =================== COR FINAL ===================
-            vec3 result = (ambient + diffuse + specular) * uObjectColor;
+            vec3 result = (ambient + diffuse + specular) * objectColor;
             FragColor = vec4(result, 1.0);
         }
     )GLSL";
 
-        // Compila o shader
-        if (!mBasicShader.compile(vertexShaderSource, fragmentShaderSource))
-        {
-            std::cerr << "ERRO: Falha ao compilar shader básico do renderer" << std::endl;
-            return false;
-        }
-
-        std::cout << "Shader básico compilado com sucesso" << std::endl;
-
         // =================== SHADER PARA TRANSPARÊNCIA ===================
         // Mesmo vertex shader
-        const char *transparentFragmentShaderSource = R"GLSL(
-        #version 330 core
+        const char *kTransparentFragmentShaderSource = R"GLSL(
         
         // Dados de entrada do vertex shader
         in vec3 FragPos;   // Posição do fragmento
@@ -113,45 +118,100 @@ namespace cg
         // Cor final de saída
         out vec4 FragColor;
         
-        // Configurações de iluminação
-        uniform vec3 uLightPos;     // Posição da luz
-        uniform vec3 uLightColor;   // Cor da luz
-        uniform vec3 uViewPos;      // Posição da câmera
-        uniform vec3 uObjectColor;  // Cor base do objeto
-        uniform float uAlpha;       // Transparência do material
-        uniform float uShininess;   // Brilho especular
-        uniform vec3 uSpecularColor; // Cor especular
-        
         void main() {
+            vec3 lightColor = uLightColor.rgb;
+            vec3 objectColor = uObjectColor.rgb; // Alpha em uObjectColor.a
+            float shininess = uSpecular.a;       // Cor especular em uSpecular.rgb
+            
             // =================== ILUMINAÇÃO AMBIENTE ===================
             float ambientStrength = 0.2;
-            vec3 ambient = ambientStrength * uLightColor;
+            vec3 ambient = ambientStrength * lightColor;
             
             // =================== ILUMINAÇÃO DIFUSA ===================
-            vec3 lightDir = normalize(uLightPos - FragPos);
+            vec3 lightDir = normalize(uLightPos.xyz - FragPos);
             float diff = max(dot(Normal, lightDir), 0.0);
-            vec3 diffuse = diff * uLightColor;
+            vec3 diffuse = diff * lightColor;
             
             // =================== ILUMINAÇÃO ESPECULAR ===================
-            vec3 viewDir = normalize(uViewPos - FragPos);
+            vec3 viewDir = normalize(uCameraPos.xyz - FragPos);
             vec3 reflectDir = reflect(-lightDir, Normal);
-            float spec = pow(max(dot(viewDir, reflectDir), 0.0), uShininess);
-            vec3 specular = spec * uSpecularColor * uLightColor;
+            float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+            vec3 specular = spec * uSpecular.rgb * lightColor;
             
             // =================== COR FINAL COM TRANSPARÊNCIA ===================
-            vec3 result = (ambient + diffuse + specular) * uObjectColor;
-            FragColor = vec4(result, uAlpha);
+            vec3 result = (ambient + diffuse + specular) * objectColor;
+            FragColor = vec4(result, uObjectColor.a);
         }
     )GLSL";
 
-        // Compila o shader de transparência
-        if (!mTransparentShader.compile(vertexShaderSource, transparentFragmentShaderSource))
+        // Compila um programa da cena e liga os blocos de uniforms aos pontos fixos
+        bool compileSceneProgram(Shader &shader, const char *vertexSource, const char *fragmentSource)
+        {
+            if (!shader.compile(vertexSource, fragmentSource))
+            {
+                return false;
+            }
+            FrameUniforms::attach(shader);
+            ObjectUniforms::attach(shader);
+            return true;
+        }
+
+        // Matrizes e material de um objeto no formato do slot do ring buffer
+        // (a matriz de normais vem pronta do cache do Model)
+        void writeObjectData(ObjectUniforms::Data &data, const glm::mat4 &modelMatrix, const glm::mat3 &normalMatrix,
+                             const QuantizationParams &quantization, const Mesh &mesh)
+        {
+            data.model = modelMatrix;
+
+            data.normalMatrix[0] = glm::vec4(normalMatrix[0], 0.0f);
+            data.normalMatrix[1] = glm::vec4(normalMatrix[1], 0.0f);
+            data.normalMatrix[2] = glm::vec4(normalMatrix[2], 0.0f);
+
+            // Dequantização das posições (relativas à AABB da mesh ou do grupo do lote estático)
+            data.positionOffset = glm::vec4(quantization.positionOffset, 0.0f);
+            data.positionScale = glm::vec4(quantization.positionScale, 0.0f);
+
+            const Material *material = mesh.getMaterial().get();
+            if (!mesh.isTransparent())
+            {
+                // Cor do material ou cor padrão
+                data.color = glm::vec4(material ? material->getAlbedo() : glm::vec3(0.7f, 0.7f, 0.8f), 1.0f);
+                data.specular = glm::vec4(0.0f);
+            }
+            else if (material)
+            {
+                // Material de vidro
+                data.color = glm::vec4(material->getAlbedo(), material->getAlpha());
+                data.specular = glm::vec4(material->getSpecular(), material->getShininess());
+            }
+            else
+            {
+                // Valores padrão para vidro
+                data.color = glm::vec4(0.9f, 0.95f, 1.0f, 0.4f);
+                data.specular = glm::vec4(1.0f, 1.0f, 1.0f, 128.0f);
+            }
+        }
+    } // namespace
+
+    Renderer::Renderer() = default;
+
+    bool Renderer::init()
+    {
+        std::cout << "Inicializando sistema de renderização..." << std::endl;
+
+        // =================== UNIFORM BUFFERS ===================
+        if (!mFrameUniforms.init() || !mObjectUniforms.init())
         {
-            std::cerr << "ERRO: Falha ao compilar shader de transparência do renderer" << std::endl;
+            std::cerr << "ERRO: Falha ao criar os uniform buffers do renderer" << std::endl;
             return false;
         }
 
-        std::cout << "Shader de transparência compilado com sucesso" << std::endl;
+        // =================== SHADERS DA CENA ===================
+        // Variantes para os layouts mais usados; as demais são compiladas no primeiro uso
+        if (!getSceneShaders(StandardVertexLayout::info()) || !getSceneShaders(CompactVertexLayout::info()))
+        {
+            return false;
+        }
 
         // Configura estado inicial do OpenGL
         setupRenderState();
@@ -164,6 +224,12 @@ namespace cg
         }
         std::cout << "Skybox inicializado com sucesso" << std::endl;
 
+        // =================== OCCLUSION QUERIES ===================
+        if (!mOcclusionQueries.init())
+        {
+            return false;
+        }
+
         std::cout << "Sistema de renderização inicializado com sucesso" << std::endl;
         return true;
     }
@@ -183,9 +249,14 @@ namespace cg
         }
 
         // Verifica se o ID já existe
-        if (mModels.find(finalId) != mModels.end())
+        auto existing = mModels.find(finalId);
+        if (existing != mModels.end())
         {
             std::cerr << "AVISO: Substituindo modelo existente com ID: " << finalId << std::endl;
+            // O PVS era do modelo antigo; bakes dele em andamento não passam na
+            // verificação do ponteiro em pollPendingPvs (o do novo já pode estar na fila)
+            mPvs.erase(finalId);
+            mMovedStaticModels.erase(existing->second.get());
             // Remove da ordem de renderização
             auto it = std::find(mModelOrder.begin(), mModelOrder.end(), finalId);
             if (it != mModelOrder.end())
@@ -198,6 +269,27 @@ namespace cg
 
         mModels[finalId] = std::move(model);
         mModelOrder.push_back(finalId);
+        mSceneDirty = true;
+    }
+
+    std::shared_ptr<const ModelStreamer::Handle> Renderer::loadModelAsync(const std::string &filePath,
+                                                                          const std::string &id,
+                                                                          const std::string &modelName,
+                                                                          const ModelLoader::LoadOptions &options,
+                                                                          std::function<void(Model &)> onReady,
+                                                                          std::function<void()> onFailed)
+    {
+        auto addToScene = [this, id, onReady = std::move(onReady)](std::unique_ptr<Model> model)
+        {
+            if (onReady)
+            {
+                onReady(*model);
+            }
+            addModel(std::move(model), id);
+            printStats();
+        };
+
+        return mStreamer.load(filePath, modelName, options, std::move(addToScene), std::move(onFailed));
     }
 
     bool Renderer::removeModel(const std::string &id)
@@ -214,7 +306,11 @@ namespace cg
                 mModelOrder.erase(orderIt);
             }
 
+            mMovedStaticModels.erase(it->second.get());
             mModels.erase(it);
+            mPvs.erase(id);
+            discardPendingPvs(id);
+            mSceneDirty = true;
             return true;
         }
 
@@ -232,49 +328,98 @@ namespace cg
         return nullptr;
     }
 
-    void Renderer::render(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix)
+    InstancedModel *Renderer::addInstancedModel(std::unique_ptr<InstancedModel> model, const std::string &id)
     {
-        // =================== PREPARAÇÃO ===================
-        setupRenderState();
-        clearBuffers();
+        if (!model)
+        {
+            std::cerr << "ERRO: Tentativa de adicionar modelo instanciado nulo" << std::endl;
+            return nullptr;
+        }
 
-        // =================== RENDERIZAÇÃO DO SKYBOX ===================
-        // Renderiza o skybox primeiro (no fundo)
-        if (mSkyboxEnabled)
+        std::string finalId = id.empty() ? generateAutoId() : id;
+        auto it = mInstancedModels.find(finalId);
+        if (it != mInstancedModels.end())
         {
-            mSkybox.render(viewMatrix, projectionMatrix);
+            std::cerr << "AVISO: Substituindo modelo instanciado existente com ID: " << finalId << std::endl;
+            mInstancedOrder.erase(std::find(mInstancedOrder.begin(), mInstancedOrder.end(), finalId));
         }
 
-        // =================== RENDERIZAÇÃO DE OBJETOS OPACOS ===================
-        // Primeiro renderiza todos os objetos opacos
-        for (const std::string &modelId : mModelOrder)
+        std::cout << "Adicionando modelo instanciado '" << model->getName() << "' com ID: " << finalId << std::endl;
+
+        InstancedModel *result = model.get();
+        mInstancedModels[finalId] = std::move(model);
+        mInstancedOrder.push_back(finalId);
+        return result;
+    }
+
+    bool Renderer::removeInstancedModel(const std::string &id)
+    {
+        auto it = mInstancedModels.find(id);
+        if (it == mInstancedModels.end())
         {
-            auto it = mModels.find(modelId);
-            if (it != mModels.end() && it->second)
-            {
-                renderModelOpaque(*it->second, viewMatrix, projectionMatrix);
-            }
+            std::cerr << "AVISO: Modelo instanciado com ID '" << id << "' não encontrado para remoção" << std::endl;
+            return false;
         }
 
-        // =================== CONFIGURAÇÃO PARA TRANSPARÊNCIA ===================
-        // Ativa blending para transparência
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        mInstancedOrder.erase(std::find(mInstancedOrder.begin(), mInstancedOrder.end(), id));
+        mInstancedModels.erase(it);
+        return true;
+    }
 
-        // Desativa escrita no buffer de profundidade para objetos transparentes
-        glDepthMask(GL_FALSE);
+    InstancedModel *Renderer::getInstancedModel(const std::string &id)
+    {
+        auto it = mInstancedModels.find(id);
+        return it != mInstancedModels.end() ? it->second.get() : nullptr;
+    }
 
-        // =================== RENDERIZAÇÃO DE OBJETOS TRANSPARENTES ===================
-        // Renderiza objetos transparentes por último
-        for (const std::string &modelId : mModelOrder)
+    void Renderer::render(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix)
+    {
+        // =================== CARREGAMENTOS EM BACKGROUND ===================
+        // Envia à GPU parte das meshes pendentes (limitado pelo orçamento por frame)
+        mStreamer.update();
+
+        // =================== PREPARAÇÃO ===================
+        setupRenderState();
+        clearBuffers();
+
+        ++mFrameIndex;
+        Shader::resetUploadStats();
+        mOcclusionQueries.beginFrame();
+
+        // Dados usados na seleção de LOD de todas as meshes deste frame
+        mCameraPosition = glm::vec3(glm::inverse(viewMatrix)[3]);
+        mLodPixelScale = 0.5f * mViewportHeight * projectionMatrix[1][1];
+
+        // =================== UNIFORMS DO FRAME ===================
+        // Câmera e luz num único buffer lido por todos os programas (cena e skybox)
+        FrameUniforms::Data frameData;
+        frameData.view = viewMatrix;
+        frameData.projection = projectionMatrix;
+        frameData.viewProjection = projectionMatrix * viewMatrix;
+        frameData.cameraPosition = glm::vec4(mCameraPosition, 1.0f);
+        frameData.lightPosition = glm::vec4(mSettings.lightPosition, 1.0f);
+        frameData.lightColor = glm::vec4(mSettings.lightColor, 1.0f);
+        mFrameUniforms.update(frameData);
+
+        // =================== CULLING ===================
+        // Lista de meshes visíveis, compartilhada pelos passes opaco e transparente
+        cullScene(viewMatrix, projectionMatrix);
+
+        // =================== FILA DE DESENHO ===================
+        // Um pacote por mesh visível, ordenado por estado (e profundidade)
+        buildRenderQueue();
+
+        // =================== RENDERIZAÇÃO DO SKYBOX ===================
+        // Renderiza o skybox primeiro (no fundo)
+        if (mSkyboxEnabled)
         {
-            auto it = mModels.find(modelId);
-            if (it != mModels.end() && it->second)
-            {
-                renderModelTransparent(*it->second, viewMatrix, projectionMatrix);
-            }
+            mSkybox.render();
         }
 
+        // =================== RENDERIZAÇÃO DA FILA ===================
+        // Opacos primeiro, depois transparentes (o passe está nos bits mais altos da chave)
+        submitRenderQueue();
+
         // =================== RESTAURAÇÃO DO ESTADO ===================
         // Restaura estado padrão
         glDepthMask(GL_TRUE);
@@ -282,6 +427,10 @@ namespace cg
 
         // =================== FINALIZAÇÃO ===================
         Shader::unbind();
+
+        // glUniform* realmente emitidos (o cache de valores do Shader ignora repetições)
+        mFrameStats.uniformUploads = Shader::getUploadStats().uploads;
+        mFrameStats.uniformsSkipped = Shader::getUploadStats().skipped;
     }
 
     void Renderer::clear()
@@ -289,11 +438,24 @@ namespace cg
         std::cout << "Limpando todos os modelos da cena (" << mModels.size() << " modelos)" << std::endl;
         mModels.clear();
         mModelOrder.clear();
+        mInstancedModels.clear();
+        mInstancedOrder.clear();
+        mMovedStaticModels.clear();
+        mPvs.clear();
+        for (PendingPvs &pending : mPendingPvs)
+        {
+            pending.model = nullptr; // Bakes em andamento: resultado descartado (ver discardPendingPvs)
+        }
         mNextAutoId = 0;
+        mSceneDirty = true;
     }
 
     void Renderer::setRenderSettings(const RenderSettings &settings)
     {
+        if (settings.enableStaticBatching != mSettings.enableStaticBatching)
+        {
+            mStaticBatchDirty = true;
+        }
         mSettings = settings;
         setupRenderState();
     }
@@ -310,8 +472,42 @@ namespace cg
                 stats.totalMeshes += pair.second->getMeshCount();
                 stats.totalTriangles += pair.second->getTotalTriangleCount();
                 stats.totalVertices += pair.second->getTotalVertexCount();
+                stats.gpuMemoryBytes += pair.second->getTotalGpuMemoryBytes();
+                stats.cpuMemoryBytes += pair.second->getTotalCpuMemoryBytes();
             }
         }
+        stats.meshesSubmitted = mFrameStats.meshesSubmitted;
+        stats.meshesCulled = mFrameStats.meshesCulled;
+        stats.meshesPvsCulled = mFrameStats.meshesPvsCulled;
+        for (const auto &pair : mPvs)
+        {
+            stats.pvsCells += pair.second->getCellCount();
+        }
+        stats.meshesPortalCulled = mFrameStats.meshesPortalCulled;
+        stats.cells = mPortals.getStats().cells;
+        stats.portals = mPortals.getStats().portals;
+        stats.cellsVisible = mFrameStats.cellsVisible;
+        stats.meshesOccluded = mFrameStats.meshesOccluded;
+        stats.occlusionQueries = mFrameStats.occlusionQueries;
+        stats.conditionalSkips = mFrameStats.conditionalSkips;
+        stats.occlusionQueryPool = mOcclusionQueries.getPoolSize();
+        stats.batchedMeshes = mFrameStats.batchedMeshes;
+        stats.instancesDrawn = mFrameStats.instancesDrawn;
+        stats.instancesCulled = mFrameStats.instancesCulled;
+        stats.instancedModels = mInstancedModels.size();
+        for (const auto &pair : mInstancedModels)
+        {
+            stats.gpuMemoryBytes += pair.second->getMesh().getGpuMemoryBytes() + pair.second->getInstanceBufferBytes();
+        }
+        stats.staticBatchGroups = mStaticBatch.getGroups().size();
+        stats.staticBatchBytes = mStaticBatch.getGpuMemoryBytes();
+        stats.gpuMemoryBytes += stats.staticBatchBytes;
+        stats.bvhNodes = mBvh.getNodeCount();
+        stats.drawCalls = mFrameStats.drawCalls;
+        stats.programChanges = mFrameStats.programChanges;
+        stats.vertexArrayChanges = mFrameStats.vertexArrayChanges;
+        stats.uniformUploads = mFrameStats.uniformUploads;
+        stats.uniformsSkipped = mFrameStats.uniformsSkipped;
 
         return stats;
     }
@@ -325,6 +521,26 @@ namespace cg
         std::cout << "Meshes: " << stats.totalMeshes << std::endl;
         std::cout << "Triângulos: " << stats.totalTriangles << std::endl;
         std::cout << "Vértices: " << stats.totalVertices << std::endl;
+        std::cout << "Memória de geometria na GPU: " << (stats.gpuMemoryBytes / (1024.0 * 1024.0)) << " MB" << std::endl;
+        std::cout << "Memória de geometria na CPU: " << (stats.cpuMemoryBytes / (1024.0 * 1024.0)) << " MB" << std::endl;
+        std::cout << "Último frame: " << stats.meshesSubmitted << " meshes desenhadas, "
+                  << stats.meshesCulled << " descartadas pelo frustum, " << stats.meshesPvsCulled << " pelo PVS, "
+                  << stats.meshesPortalCulled << " pelos portais, " << stats.meshesOccluded
+                  << " escondidas por oclusores" << std::endl;
+        std::cout << "PVS: " << stats.pvsCells << " células de vista" << std::endl;
+        std::cout << "Células: " << stats.cells << " (" << stats.portals << " portais, " << stats.cellsVisible
+                  << " visíveis no último frame)" << std::endl;
+        std::cout << "Nós da BVH: " << stats.bvhNodes << std::endl;
+        std::cout << "Occlusion queries: " << stats.occlusionQueries << " no último frame, " << stats.conditionalSkips
+                  << " draws descartados pela GPU (" << stats.occlusionQueryPool << " queries no pool)" << std::endl;
+        std::cout << "Lote estático: " << stats.staticBatchGroups << " grupos, "
+                  << (stats.staticBatchBytes / (1024.0 * 1024.0)) << " MB na GPU, "
+                  << stats.batchedMeshes << " meshes desenhadas por ele no último frame" << std::endl;
+        std::cout << "Modelos instanciados: " << stats.instancedModels << " (" << stats.instancesDrawn
+                  << " instâncias desenhadas, " << stats.instancesCulled << " descartadas)" << std::endl;
+        std::cout << "Último frame: " << stats.drawCalls << " draws, " << stats.programChanges << " trocas de programa, "
+                  << stats.vertexArrayChanges << " de VAO, " << stats.uniformUploads << " uniforms enviados ("
+                  << stats.uniformsSkipped << " repetidos ignorados)" << std::endl;
         std::cout << "=============================" << std::endl;
     }
 
@@ -385,109 +601,940 @@ namespace cg
         glClear(clearMask);
     }
 
-    void Renderer::renderModelOpaque(const Model &model, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix)
+    Renderer::SceneShaders *Renderer::getSceneShaders(const VertexLayoutInfo &layout)
+    {
+        auto it = mSceneShaders.find(layout.id);
+        if (it != mSceneShaders.end())
+        {
+            return it->second.get(); // nullptr se a compilação já falhou antes
+        }
+
+        // Entradas e decodificação dos atributos vêm do próprio layout; câmera e luz, do bloco do
+        // frame; matrizes e material, do slot do objeto
+        const std::string header = std::string("#version 330 core\n") + FrameUniforms::glslBlock() + ObjectUniforms::glslBlock();
+        std::string vertexSource = header + layout.glslPrelude() + kSceneVertexShaderBody;
+        std::string instancedVertexSource = header + layout.glslPrelude() + kInstancedVertexShaderBody;
+        std::string basicFragmentSource = header + kBasicFragmentShaderSource;
+        std::string transparentFragmentSource = header + kTransparentFragmentShaderSource;
+
+        auto shaders = std::make_unique<SceneShaders>();
+        if (!compileSceneProgram(shaders->basic, vertexSource.c_str(), basicFragmentSource.c_str()))
+        {
+            std::cerr << "ERRO: Falha ao compilar shader básico do renderer (layout " << layout.id << ")" << std::endl;
+            shaders.reset();
+        }
+        else if (!compileSceneProgram(shaders->transparent, vertexSource.c_str(), transparentFragmentSource.c_str()))
+        {
+            std::cerr << "ERRO: Falha ao compilar shader de transparência do renderer (layout " << layout.id << ")" << std::endl;
+            shaders.reset();
+        }
+        else if (!compileSceneProgram(shaders->instanced, instancedVertexSource.c_str(), basicFragmentSource.c_str()))
+        {
+            std::cerr << "ERRO: Falha ao compilar shader instanciado do renderer (layout " << layout.id << ")" << std::endl;
+            shaders.reset();
+        }
+        else
+        {
+            std::cout << "Shaders da cena compilados para o layout " << layout.id
+                      << " (" << layout.stride << " bytes por vértice)" << std::endl;
+        }
+
+        if (shaders)
+        {
+            shaders->sortIndex = mNextShaderSortIndex++;
+            shaders->instancedSortIndex = mNextShaderSortIndex++;
+        }
+
+        SceneShaders *result = shaders.get();
+        mSceneShaders.emplace(layout.id, std::move(shaders));
+        return result;
+    }
+
+    size_t Renderer::selectLod(const Mesh &mesh, const glm::mat4 &modelMatrix) const
     {
-        // =================== CONFIGURAÇÃO DO SHADER BÁSICO ===================
-        mBasicShader.bind();
+        if (!mSettings.enableLod)
+        {
+            return 0;
+        }
 
-        // Define matrizes
-        mBasicShader.setMat4("uView", viewMatrix);
-        mBasicShader.setMat4("uProjection", projectionMatrix);
+        // Escala máxima da transformação: converte erro e raio para o espaço do mundo
+        float worldScale = std::max({glm::length(glm::vec3(modelMatrix[0])),
+                                     glm::length(glm::vec3(modelMatrix[1])),
+                                     glm::length(glm::vec3(modelMatrix[2]))});
 
-        // Define parâmetros de iluminação
-        mBasicShader.setVec3("uLightPos", glm::vec3(10.0f, 10.0f, 10.0f));
-        mBasicShader.setVec3("uLightColor", glm::vec3(1.0f, 1.0f, 1.0f));
+        // Distância da câmera até a superfície da esfera envolvente
+        const BoundingSphere &sphere = mesh.getBoundingSphere();
+        glm::vec3 center = glm::vec3(modelMatrix * glm::vec4(sphere.center, 1.0f));
+        float distance = glm::length(center - mCameraPosition) - sphere.radius * worldScale;
+        if (distance <= 0.0f)
+        {
+            return 0; // câmera dentro da esfera: detalhe máximo
+        }
+
+        float pixelsPerUnit = mLodPixelScale * worldScale / distance;
+        auto projectedError = [&](size_t lod)
+        { return mesh.getLodError(lod) * pixelsPerUnit; };
+
+        // Simplifica apenas abaixo da faixa de histerese; volta a detalhar assim que passar do limite
+        size_t lod = mesh.getActiveLod();
+        float coarsenThreshold = mSettings.lodPixelError * (1.0f - kLodHysteresis);
+        while (lod + 1 < mesh.getLodCount() && projectedError(lod + 1) <= coarsenThreshold)
+        {
+            lod++;
+        }
+        while (lod > 0 && projectedError(lod) > mSettings.lodPixelError)
+        {
+            lod--;
+        }
+        return lod;
+    }
 
-        // Extrai posição da câmera
-        glm::mat4 invView = glm::inverse(viewMatrix);
-        glm::vec3 cameraPos = glm::vec3(invView[3]);
-        mBasicShader.setVec3("uViewPos", cameraPos);
+    void Renderer::updateScene()
+    {
+        // =================== MODELOS ADICIONADOS/REMOVIDOS ===================
+        // Reconstrói a lista de meshes se a cena mudou ou se algum modelo ganhou meshes
+        if (!mSceneDirty)
+        {
+            for (const SceneModel &entry : mSceneModels)
+            {
+                if (entry.model->getMeshCount() != entry.itemCount)
+                {
+                    mSceneDirty = true;
+                    break;
+                }
+            }
+        }
 
-        // =================== RENDERIZAÇÃO APENAS MESHES OPACAS ===================
-        // Cada mesh pode ter uma transformação local própria
-        for (const auto &mesh : model.getMeshes())
+        if (mSceneDirty)
         {
-            if (mesh && !mesh->isTransparent())
+            mSceneModels.clear();
+            mDrawItems.clear();
+            mCuller.clear();
+
+            for (const std::string &modelId : mModelOrder)
             {
-                // Configuração das matrizes por mesh (modelo + hierarquia pai-filho)
-                glm::mat4 modelMatrix = model.getWorldMatrixForMesh(mesh.get());
-                mBasicShader.setMat4("uModel", modelMatrix);
+                auto it = mModels.find(modelId);
+                if (it == mModels.end() || !it->second)
+                {
+                    continue;
+                }
+
+                Model &model = *it->second;
+                model.updateWorldMatrices();
 
-                glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelMatrix)));
-                mBasicShader.setMat3("uNormalMatrix", normalMatrix);
+                SceneModel entry;
+                entry.model = &model;
+                entry.worldVersion = model.getWorldVersion();
+                entry.firstItem = static_cast<uint32_t>(mDrawItems.size());
+                entry.itemCount = static_cast<uint32_t>(model.getMeshCount());
 
-                // Configura material se disponível
-                if (mesh->hasMaterial())
+                auto pvsIt = mPvs.find(modelId);
+                if (pvsIt != mPvs.end())
                 {
-                    auto material = mesh->getMaterial();
-                    mBasicShader.setVec3("uObjectColor", material->getAlbedo());
+                    if (pvsIt->second->getMeshCount() == entry.itemCount)
+                    {
+                        entry.pvs = pvsIt->second.get();
+                    }
+                    else
+                    {
+                        std::cerr << "AVISO: PVS de '" << modelId << "' tem " << pvsIt->second->getMeshCount()
+                                  << " meshes, o modelo tem " << entry.itemCount << "; ignorado" << std::endl;
+                    }
                 }
-                else
+
+                // Meshes nulas também ocupam uma entrada (caixa vazia), mantendo a faixa alinhada com getMeshes()
+                const auto &meshes = model.getMeshes();
+                for (size_t meshIndex = 0; meshIndex < meshes.size(); ++meshIndex)
                 {
-                    mBasicShader.setVec3("uObjectColor", glm::vec3(0.7f, 0.7f, 0.8f));
+                    Mesh *mesh = meshes[meshIndex].get();
+                    DrawItem item;
+                    item.model = &model;
+                    // Meshes auxiliares de células e portais nunca são desenhadas
+                    item.mesh = (mesh && !PortalSystem::isHelperName(mesh->name)) ? mesh : nullptr;
+                    if (item.mesh)
+                    {
+                        item.modelMatrix = model.getWorldMatrix(meshIndex);
+                        item.normalMatrix = model.getNormalMatrix(meshIndex);
+                        item.worldBox = transformBox(mesh->getBoundingBox(), item.modelMatrix);
+                    }
+                    mCuller.add(item.worldBox);
+                    mDrawItems.push_back(item);
                 }
+                entry.isStatic = model.isStatic();
+                mSceneModels.push_back(entry);
+            }
 
-                mesh->draw();
+            std::vector<BoundingBox> boxes(mDrawItems.size());
+            for (size_t i = 0; i < mDrawItems.size(); ++i)
+            {
+                boxes[i] = mDrawItems[i].worldBox;
+            }
+            mBvh.build(boxes);
+            mSceneDirty = false;
+
+            // Índices dos itens mudaram: as queries voltam ao pool
+            mOcclusionQueries.reset(mDrawItems.size());
+            mPortalsDirty = true;
+
+            // Os ponteiros das meshes podem ter mudado: o lote é sempre refeito
+            rebuildStaticBatch();
+            return;
+        }
+
+        // =================== TRANSFORMAÇÕES ALTERADAS ===================
+        // Apenas os modelos cuja versão mudou (ex.: portas abrindo) são recalculados
+        bool changed = false;
+        for (SceneModel &entry : mSceneModels)
+        {
+            if (entry.model->isStatic() != entry.isStatic)
+            {
+                entry.isStatic = entry.model->isStatic();
+                mStaticBatchDirty = true;
+            }
+
+            // Passada linear do modelo: só as subárvores alteradas são recalculadas
+            const Model &model = *entry.model;
+            model.updateWorldMatrices();
+            uint64_t seenVersion = entry.worldVersion;
+            if (model.getWorldVersion() == seenVersion)
+            {
+                continue;
+            }
+            entry.worldVersion = model.getWorldVersion();
+            mPortalsDirty = true; // portas e volumes podem ter se movido
+
+            for (uint32_t i = entry.firstItem; i < entry.firstItem + entry.itemCount; ++i)
+            {
+                DrawItem &item = mDrawItems[i];
+                size_t meshIndex = i - entry.firstItem;
+                if (!item.mesh || model.getWorldStamp(meshIndex) <= seenVersion)
+                {
+                    continue;
+                }
+
+                const glm::mat4 &modelMatrix = model.getWorldMatrix(meshIndex);
+                if (modelMatrix == item.modelMatrix)
+                {
+                    continue;
+                }
+
+                item.modelMatrix = modelMatrix;
+                item.normalMatrix = model.getNormalMatrix(meshIndex);
+                item.worldBox = transformBox(item.mesh->getBoundingBox(), modelMatrix);
+                mBvh.update(i, item.worldBox);
+                mCuller.set(i, item.worldBox);
+                changed = true;
+
+                // Um modelo "estático" que se moveu sai do lote de vez: os vértices
+                // do lote já estão no mundo e não são transformados de novo
+                if (item.batchEntry >= 0)
+                {
+                    mStaticBatchDirty = true;
+                    if (mMovedStaticModels.insert(item.model).second)
+                    {
+                        std::cout << "AVISO: Modelo estático movido; suas meshes saem do lote estático" << std::endl;
+                    }
+                }
+            }
+        }
+
+        if (mStaticBatchDirty)
+        {
+            rebuildStaticBatch();
+        }
+
+        if (changed)
+        {
+            mFrameStats.bvhNodesRefit = mBvh.refit();
+            if (mBvh.needsRebuild())
+            {
+                std::vector<BoundingBox> boxes(mDrawItems.size());
+                for (size_t i = 0; i < mDrawItems.size(); ++i)
+                {
+                    boxes[i] = mDrawItems[i].worldBox;
+                }
+                mBvh.build(boxes);
             }
         }
     }
 
-    void Renderer::renderModelTransparent(const Model &model, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix)
+    void Renderer::rebuildStaticBatch()
     {
-        // =================== CONFIGURAÇÃO DO SHADER DE TRANSPARÊNCIA ===================
-        mTransparentShader.bind();
+        mStaticBatchDirty = false;
+        for (DrawItem &item : mDrawItems)
+        {
+            item.batchEntry = -1;
+        }
 
-        // Define matrizes
-        mTransparentShader.setMat4("uView", viewMatrix);
-        mTransparentShader.setMat4("uProjection", projectionMatrix);
+        // Meshes opacas de modelos estáticos; as da hierarquia (portas) e as de
+        // modelos que se moveram depois de entrar no lote continuam dinâmicas
+        std::vector<StaticBatch::Source> sources;
+        std::vector<char> inBatch(mDrawItems.size(), 0);
+        if (mSettings.enableStaticBatching)
+        {
+            for (size_t i = 0; i < mDrawItems.size(); ++i)
+            {
+                const DrawItem &item = mDrawItems[i];
+                if (item.mesh && item.model->isStatic() && !item.mesh->isTransparent() &&
+                    !item.model->isInHierarchy(item.mesh) && mMovedStaticModels.count(item.model) == 0 &&
+                    getSceneShaders(item.mesh->getVertexLayout()))
+                {
+                    sources.push_back({item.mesh, item.mesh->getDrawMatrix(item.modelMatrix)});
+                    inBatch[i] = 1;
+                }
+            }
+        }
 
-        // Define parâmetros de iluminação
-        mTransparentShader.setVec3("uLightPos", glm::vec3(10.0f, 10.0f, 10.0f));
-        mTransparentShader.setVec3("uLightColor", glm::vec3(1.0f, 1.0f, 1.0f));
+        // Meshes que saem do lote (lote desligado, modelo dinâmico) tinham entregado
+        // seus buffers a ele: recuperam buffers próprios antes que ele seja refeito
+        for (size_t i = 0; i < mDrawItems.size(); ++i)
+        {
+            Mesh *mesh = mDrawItems[i].mesh;
+            if (mesh && !inBatch[i] && !mesh->hasGpuGeometry())
+            {
+                mStaticBatch.restoreGeometry(mesh);
+            }
+        }
 
-        // Extrai posição da câmera
-        glm::mat4 invView = glm::inverse(viewMatrix);
-        glm::vec3 cameraPos = glm::vec3(invView[3]);
-        mTransparentShader.setVec3("uViewPos", cameraPos);
+        if (sources.empty())
+        {
+            mStaticBatch.clear();
+            return;
+        }
+        if (!mStaticBatch.build(sources))
+        {
+            return;
+        }
 
-        // Propriedades do material de vidro padrão
-        mTransparentShader.setVec3("uObjectColor", glm::vec3(0.9f, 0.95f, 1.0f));  // Azul claro
-        mTransparentShader.setFloat("uAlpha", 0.4f);                               // Transparência
-        mTransparentShader.setFloat("uShininess", 128.0f);                         // Brilho alto
-        mTransparentShader.setVec3("uSpecularColor", glm::vec3(1.0f, 1.0f, 1.0f)); // Reflexo branco
+        for (DrawItem &item : mDrawItems)
+        {
+            if (item.mesh)
+            {
+                item.batchEntry = mStaticBatch.findEntry(item.mesh);
+            }
+        }
+
+        std::cout << "Lote estático: " << mStaticBatch.getEntries().size() << " meshes em "
+                  << mStaticBatch.getGroups().size() << " grupos ("
+                  << (mStaticBatch.getGpuMemoryBytes() / (1024.0 * 1024.0)) << " MB)" << std::endl;
+    }
 
-        // =================== RENDERIZAÇÃO APENAS MESHES TRANSPARENTES ===================
-        for (const auto &mesh : model.getMeshes())
+    void Renderer::cullScene(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix)
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        mFrameStats = FrameStats{};
+
+        // =================== MESHES DA CENA ===================
+        // Matrizes e AABBs de mundo ficam em cache entre frames; só mudanças são recalculadas
+        pollPendingPvs();
+        updateScene();
+
+        // =================== TESTE CONTRA O FRUSTUM ===================
+        if (mSettings.enableFrustumCulling && mSettings.enableBvhCulling)
         {
-            if (mesh && mesh->isTransparent())
+            mBvh.cullFrustum(Frustum::fromMatrix(projectionMatrix * viewMatrix), mVisibleItems, &mFrameStats.bvhNodesVisited);
+            // A BVH devolve na ordem da árvore; os passes desenham na ordem da cena
+            std::sort(mVisibleItems.begin(), mVisibleItems.end());
+        }
+        else if (mSettings.enableFrustumCulling)
+        {
+            mCuller.cull(Frustum::fromMatrix(projectionMatrix * viewMatrix), mVisibleItems);
+        }
+        else
+        {
+            mVisibleItems.clear();
+            for (uint32_t i = 0; i < mDrawItems.size(); ++i)
             {
-                // Configuração das matrizes por mesh (modelo + hierarquia pai-filho)
-                glm::mat4 modelMatrix = model.getWorldMatrixForMesh(mesh.get());
-                mTransparentShader.setMat4("uModel", modelMatrix);
+                if (mDrawItems[i].mesh)
+                {
+                    mVisibleItems.push_back(i);
+                }
+            }
+        }
+
+        // =================== PVS PRÉ-CALCULADO ===================
+        if (mSettings.enablePvsCulling)
+        {
+            cullPvs();
+        }
+
+        // =================== CÉLULAS E PORTAIS ===================
+        if (mSettings.enablePortalCulling)
+        {
+            cullPortals(projectionMatrix * viewMatrix);
+        }
+
+        // =================== TESTE DE OCLUSÃO ===================
+        if (mSettings.enableOcclusionCulling)
+        {
+            cullOccluded(projectionMatrix * viewMatrix);
+        }
+
+        // =================== INSTÂNCIAS ===================
+        // Cada modelo instanciado descarta e compacta as próprias instâncias
+        Frustum frustum = Frustum::fromMatrix(projectionMatrix * viewMatrix);
+        for (const std::string &id : mInstancedOrder)
+        {
+            InstancedModel &model = *mInstancedModels[id];
+            size_t visible = model.cullAndUpload(mSettings.enableFrustumCulling ? &frustum : nullptr, mCameraPosition);
+            mFrameStats.instancesDrawn += visible;
+            mFrameStats.instancesCulled += model.getInstanceCount() - visible;
+        }
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        mFrameStats.meshesTested = mDrawItems.size();
+        mFrameStats.meshesSubmitted = mVisibleItems.size();
+        mFrameStats.meshesCulled = mDrawItems.size() - mVisibleItems.size() - mFrameStats.meshesPvsCulled -
+                                    mFrameStats.meshesPortalCulled - mFrameStats.meshesOccluded;
+        mFrameStats.cullTimeMs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() / 1000.0f;
+    }
+
+    void Renderer::loadPvsAsync(const std::string &modelId, const Model &model, const std::string &objPath,
+                                const PvsGrid::BakeOptions &options)
+    {
+        PendingPvs pending;
+        pending.modelId = modelId;
+        pending.model = &model;
+        pending.future = std::async(std::launch::async,
+                                    [geometry = PvsGrid::gather(model), path = PvsGrid::cachePathFor(objPath), options]()
+                                        -> std::shared_ptr<const PvsGrid>
+                                    {
+            auto pvs = std::make_shared<PvsGrid>();
+            uint64_t signature = PvsGrid::signature(geometry, options);
+            if (pvs->load(path, signature))
+            {
+                std::cout << "PVS carregado: " << path << " (" << pvs->getCellCount() << " células)" << std::endl;
+                return pvs;
+            }
+
+            std::cout << "Calculando PVS (" << geometry.triangleMeshes.size() << " triângulos)..." << std::endl;
+            if (!pvs->bake(geometry, options))
+            {
+                return nullptr;
+            }
+            const PvsGrid::Stats &stats = pvs->getStats();
+            std::cout << "PVS calculado em " << stats.bakeTimeMs << " ms: " << stats.cells << " células, "
+                      << stats.rays << " raios, " << stats.averageVisible << " de " << stats.meshes
+                      << " meshes por célula em média" << std::endl;
+            pvs->write(path, signature);
+            return pvs; });
+        mPendingPvs.push_back(std::move(pending));
+    }
+
+    const PvsGrid *Renderer::getPvs(const std::string &modelId) const
+    {
+        auto it = mPvs.find(modelId);
+        return it != mPvs.end() ? it->second.get() : nullptr;
+    }
+
+    void Renderer::discardPendingPvs(const std::string &modelId)
+    {
+        // Destruir o future de std::async esperaria o fim do bake: o cálculo
+        // termina em background e o resultado é descartado em pollPendingPvs
+        for (PendingPvs &pending : mPendingPvs)
+        {
+            if (pending.modelId == modelId)
+            {
+                pending.model = nullptr;
+            }
+        }
+    }
+
+    void Renderer::pollPendingPvs()
+    {
+        for (size_t i = 0; i < mPendingPvs.size();)
+        {
+            PendingPvs &pending = mPendingPvs[i];
+            if (pending.future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                ++i;
+                continue;
+            }
+
+            // O ID pode ter sido reutilizado por outro modelo desde o início do bake
+            std::shared_ptr<const PvsGrid> pvs = pending.future.get();
+            auto modelIt = mModels.find(pending.modelId);
+            if (pvs && pending.model && modelIt != mModels.end() && modelIt->second.get() == pending.model)
+            {
+                mPvs[pending.modelId] = std::move(pvs);
+                mSceneDirty = true; // SceneModel::pvs é preenchido na reconstrução
+            }
+            mPendingPvs.erase(mPendingPvs.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+    }
 
-                glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelMatrix)));
-                mTransparentShader.setMat3("uNormalMatrix", normalMatrix);
+    void Renderer::cullPvs()
+    {
+        // Célula da câmera em cada modelo; a geometria do bake só vale enquanto o modelo é estático
+        bool restricted = false;
+        mPvsCells.assign(mSceneModels.size(), PvsGrid::kNoCell);
+        for (size_t i = 0; i < mSceneModels.size(); ++i)
+        {
+            const SceneModel &entry = mSceneModels[i];
+            if (entry.pvs && entry.model->isStatic())
+            {
+                mPvsCells[i] = entry.pvs->findCell(mCameraPosition);
+                restricted |= mPvsCells[i] != PvsGrid::kNoCell;
+            }
+        }
+        if (!restricted)
+        {
+            return;
+        }
 
-                // Configura material de vidro
-                if (mesh->hasMaterial())
+        // mVisibleItems está em ordem crescente: os modelos são percorridos junto
+        size_t kept = 0;
+        size_t model = 0;
+        for (uint32_t index : mVisibleItems)
+        {
+            while (index >= mSceneModels[model].firstItem + mSceneModels[model].itemCount)
+            {
+                ++model;
+            }
+            const SceneModel &entry = mSceneModels[model];
+            int32_t cell = mPvsCells[model];
+            if (cell == PvsGrid::kNoCell || entry.pvs->isVisible(cell, index - entry.firstItem))
+            {
+                mVisibleItems[kept++] = index;
+            }
+        }
+        mFrameStats.meshesPvsCulled = mVisibleItems.size() - kept;
+        mVisibleItems.resize(kept);
+    }
+
+    void Renderer::setDoorOpen(const std::string &doorMeshName, bool open)
+    {
+        mPortals.setDoorOpen(doorMeshName, open);
+        mPortalsDirty = true; // a porta pode ainda não estar ligada a um portal
+    }
+
+    void Renderer::rebuildPortals()
+    {
+        mPortalsDirty = false;
+
+        std::vector<PortalSystem::SceneMesh> meshes(mDrawItems.size());
+        for (const SceneModel &entry : mSceneModels)
+        {
+            const auto &modelMeshes = entry.model->getMeshes();
+            for (uint32_t i = 0; i < entry.itemCount; ++i)
+            {
+                const Mesh *mesh = modelMeshes[i].get();
+                if (!mesh)
                 {
-                    auto material = mesh->getMaterial();
-                    mTransparentShader.setVec3("uObjectColor", material->getAlbedo());
-                    mTransparentShader.setFloat("uAlpha", material->getAlpha());
-                    mTransparentShader.setFloat("uShininess", material->getShininess());
-                    mTransparentShader.setVec3("uSpecularColor", material->getSpecular());
+                    continue;
                 }
-                else
+                PortalSystem::SceneMesh &sceneMesh = meshes[entry.firstItem + i];
+                sceneMesh.name = mesh->name;
+                sceneMesh.worldBox = transformBox(mesh->getBoundingBox(), entry.model->getWorldMatrix(i));
+                sceneMesh.opaque = !mesh->isTransparent();
+            }
+        }
+        mPortals.build(meshes);
+
+        if (mPortals.isActive())
+        {
+            std::cout << "Portais: " << mPortals.getStats().cells << " células, " << mPortals.getStats().portals
+                      << " portais" << std::endl;
+        }
+    }
+
+    void Renderer::cullPortals(const glm::mat4 &viewProjection)
+    {
+        if (mPortalsDirty)
+        {
+            rebuildPortals();
+        }
+        if (!mPortals.isActive())
+        {
+            return;
+        }
+
+        mPortals.traverse(viewProjection, mCameraPosition);
+
+        // Compacta mVisibleItems mantendo a ordem de desenho
+        size_t kept = 0;
+        for (uint32_t index : mVisibleItems)
+        {
+            if (mPortals.isVisible(index, mDrawItems[index].worldBox))
+            {
+                mVisibleItems[kept++] = index;
+            }
+        }
+        mFrameStats.meshesPortalCulled = mVisibleItems.size() - kept;
+        mFrameStats.cellsVisible = mPortals.getStats().cellsVisible;
+        mVisibleItems.resize(kept);
+    }
+
+    void Renderer::cullOccluded(const glm::mat4 &viewProjection)
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        // =================== ESCOLHA DOS OCLUSORES ===================
+        // Área das faces da AABB dividida pelo quadrado da distância: aproxima a
+        // fração da tela que a mesh pode cobrir
+        mOccluderCandidates.clear();
+        for (uint32_t index : mVisibleItems)
+        {
+            const DrawItem &item = mDrawItems[index];
+            const Mesh &mesh = *item.mesh;
+            if (mesh.isTransparent() || mesh.indices.empty() || (mesh.positions.empty() && mesh.vertices.empty()))
+            {
+                continue;
+            }
+
+            glm::vec3 extents = item.worldBox.extents();
+            glm::vec3 delta = item.worldBox.center() - mCameraPosition;
+            float distanceSquared = std::max(glm::dot(delta, delta), 1e-4f);
+            float area = extents.x * extents.y + extents.y * extents.z + extents.z * extents.x;
+            mOccluderCandidates.push_back({area / distanceSquared, index});
+        }
+        std::sort(mOccluderCandidates.begin(), mOccluderCandidates.end(),
+                  [](const OccluderCandidate &a, const OccluderCandidate &b)
+                  { return a.score > b.score; });
+
+        // =================== RASTERIZAÇÃO ===================
+        // A cópia na CPU é a do LOD 0 (os outros níveis existem apenas no EBO)
+        mOcclusionCuller.beginFrame(viewProjection);
+        size_t budget = mSettings.occluderTriangleBudget;
+        for (const OccluderCandidate &candidate : mOccluderCandidates)
+        {
+            const DrawItem &item = mDrawItems[candidate.item];
+            const Mesh &mesh = *item.mesh;
+            size_t triangles = mesh.indices.size() / 3;
+            if (triangles > budget)
+            {
+                continue; // uma mesh menor ainda pode caber no orçamento
+            }
+            budget -= triangles;
+
+            // Com KeepPositionsOnly as posições ficam num array próprio; senão, dentro de Vertex
+            if (!mesh.positions.empty())
+            {
+                mOcclusionCuller.addOccluder(item.modelMatrix, mesh.positions.data(), sizeof(glm::vec3), mesh.positions.size(),
+                                             mesh.indices.data(), mesh.indices.size());
+            }
+            else
+            {
+                mOcclusionCuller.addOccluder(item.modelMatrix, &mesh.vertices[0].position, sizeof(Vertex), mesh.vertices.size(),
+                                             mesh.indices.data(), mesh.indices.size());
+            }
+        }
+        mOcclusionCuller.rasterize();
+
+        // =================== TESTE DAS CAIXAS ===================
+        // Compacta mVisibleItems mantendo a ordem de desenho
+        size_t kept = 0;
+        for (uint32_t index : mVisibleItems)
+        {
+            if (!mOcclusionCuller.isOccluded(mDrawItems[index].worldBox))
+            {
+                mVisibleItems[kept++] = index;
+            }
+        }
+        mFrameStats.meshesOccluded = mVisibleItems.size() - kept;
+        mFrameStats.occluders = mOcclusionCuller.getStats().occluders;
+        mVisibleItems.resize(kept);
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        mFrameStats.occlusionTimeMs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() / 1000.0f;
+    }
+
+    std::vector<Renderer::SceneHit> Renderer::raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance)
+    {
+        updateScene();
+
+        std::vector<Bvh::RayHit> hits;
+        mBvh.queryRay(origin, direction, maxDistance, hits);
+
+        std::vector<SceneHit> result;
+        result.reserve(hits.size());
+        for (const Bvh::RayHit &hit : hits)
+        {
+            const DrawItem &item = mDrawItems[hit.item];
+            result.push_back({item.model, item.mesh, hit.distance});
+        }
+        return result;
+    }
+
+    std::vector<Renderer::SceneHit> Renderer::queryBox(const BoundingBox &box)
+    {
+        updateScene();
+
+        std::vector<uint32_t> items;
+        mBvh.queryBox(box, items);
+        std::sort(items.begin(), items.end());
+
+        std::vector<SceneHit> result;
+        result.reserve(items.size());
+        for (uint32_t index : items)
+        {
+            const DrawItem &item = mDrawItems[index];
+            result.push_back({item.model, item.mesh, 0.0f});
+        }
+        return result;
+    }
+
+    void Renderer::buildRenderQueue()
+    {
+        mRenderQueue.clear();
+        mRenderQueue.reserve(mVisibleItems.size());
+        mStaticBatch.beginFrame();
+
+        // Um slot do ring buffer por mesh visível e mais um por grupo do lote
+        // estático e por modelo instanciado (depois dos slots das meshes), escritos
+        // numa única passada
+        const std::vector<StaticBatch::Group> &batchGroups = mStaticBatch.getGroups();
+        mFirstBatchSlot = static_cast<uint32_t>(mVisibleItems.size());
+        mFirstInstancedSlot = mFirstBatchSlot + static_cast<uint32_t>(batchGroups.size());
+        mInstancedDraws.clear();
+        if (!mObjectUniforms.beginFrame(mFirstInstancedSlot + mInstancedOrder.size()))
+        {
+            return;
+        }
+
+        for (uint32_t slot = 0; slot < mVisibleItems.size(); ++slot)
+        {
+            DrawItem &item = mDrawItems[mVisibleItems[slot]];
+            Mesh *mesh = item.mesh;
+
+            // Nível de detalhe pela distância (erro projetado na tela)
+            if (mesh->getLodCount() > 1)
+            {
+                mesh->setActiveLod(selectLod(*mesh, item.modelMatrix));
+            }
+            mFrameStats.triangles += mesh->getLodTriangleCount(mesh->getActiveLod());
+
+            // Meshes do lote estático entram no draw do seu grupo
+            if (item.batchEntry >= 0)
+            {
+                mStaticBatch.addVisible(static_cast<uint32_t>(item.batchEntry), mesh->getActiveLod());
+                ++mFrameStats.batchedMeshes;
+                continue;
+            }
+
+            item.shaders = getSceneShaders(mesh->getVertexLayout());
+            if (!item.shaders)
+            {
+                continue;
+            }
+
+            writeObjectData(mObjectUniforms.at(slot), mesh->getDrawMatrix(item.modelMatrix), item.normalMatrix,
+                            mesh->getQuantization(), *mesh);
+
+            // Materiais agrupados pelo endereço (a ordem ainda aproxima draws do
+            // mesmo material, embora os parâmetros venham do slot de cada objeto)
+            uint32_t materialKey = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(mesh->getMaterial().get()) >> 4);
+            float viewDistance = glm::length(item.worldBox.center() - mCameraPosition);
+
+            uint64_t key = mesh->isTransparent()
+                               ? RenderQueue::makeTransparentKey(item.shaders->sortIndex, materialKey, mesh->getVertexArray(), viewDistance)
+                               : RenderQueue::makeOpaqueKey(item.shaders->sortIndex, materialKey, mesh->getVertexArray(), viewDistance);
+            mRenderQueue.push(key, slot);
+        }
+
+        // =================== LOTE ESTÁTICO ===================
+        // Um pacote por grupo com meshes visíveis; vértices já no mundo (matriz identidade),
+        // no layout do grupo e quantizados contra a AABB dele
+        for (uint32_t group = 0; group < batchGroups.size(); ++group)
+        {
+            const StaticBatch::Group &batchGroup = batchGroups[group];
+            const SceneShaders *shaders = getSceneShaders(*batchGroup.layout);
+            if (batchGroup.counts.empty() || !shaders)
+            {
+                continue;
+            }
+
+            const Mesh &representative = *batchGroup.representative;
+            uint32_t slot = mFirstBatchSlot + group;
+            writeObjectData(mObjectUniforms.at(slot), glm::mat4(1.0f), glm::mat3(1.0f), batchGroup.quantization, representative);
+
+            uint32_t materialKey = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(representative.getMaterial().get()) >> 4);
+            mRenderQueue.push(RenderQueue::makeOpaqueKey(shaders->sortIndex, materialKey, mStaticBatch.getVertexArray(group), 0.0f), slot);
+        }
+
+        // =================== MODELOS INSTANCIADOS ===================
+        // Um pacote (e um glDrawElementsInstanced) por modelo com instâncias visíveis
+        for (const std::string &id : mInstancedOrder)
+        {
+            InstancedModel *model = mInstancedModels[id].get();
+            Mesh &mesh = model->getMesh();
+            SceneShaders *shaders = getSceneShaders(mesh.getVertexLayout());
+            if (model->getVisibleCount() == 0 || !shaders)
+            {
+                continue;
+            }
+
+            // Um LOD para todas as instâncias, escolhido pela mais próxima
+            if (mesh.getLodCount() > 1)
+            {
+                mesh.setActiveLod(selectLod(mesh, model->getNearestVisibleTransform()));
+            }
+            mFrameStats.triangles += mesh.getLodTriangleCount(mesh.getActiveLod()) * model->getVisibleCount();
+
+            uint32_t slot = mFirstInstancedSlot + static_cast<uint32_t>(mInstancedDraws.size());
+            writeObjectData(mObjectUniforms.at(slot), glm::mat4(1.0f), glm::mat3(1.0f), mesh.getQuantization(), mesh);
+            mInstancedDraws.push_back({model, shaders});
+
+            uint32_t materialKey = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(mesh.getMaterial().get()) >> 4);
+            mRenderQueue.push(RenderQueue::makeOpaqueKey(shaders->instancedSortIndex, materialKey, model->getVertexArray(), 0.0f), slot);
+        }
+
+        mObjectUniforms.endWrites();
+        mRenderQueue.sort();
+    }
+
+    void Renderer::submitRenderQueue()
+    {
+        // Estado vinculado; cada pacote só troca o que difere do anterior
+        const Shader *program = nullptr;
+        GLuint boundVertexArray = 0;
+        bool transparentPass = false;
+
+        for (const RenderQueue::Packet &packet : mRenderQueue.getPackets())
+        {
+            const bool transparent = RenderQueue::passOf(packet.key) == RenderQueue::Pass::Transparent;
+
+            // =================== MODELO INSTANCIADO ===================
+            if (packet.item >= mFirstInstancedSlot)
+            {
+                const InstancedDraw &draw = mInstancedDraws[packet.item - mFirstInstancedSlot];
+                if (&draw.shaders->instanced != program)
+                {
+                    program = &draw.shaders->instanced;
+                    program->bind();
+                    ++mFrameStats.programChanges;
+                }
+                if (draw.model->getVertexArray() != boundVertexArray)
+                {
+                    boundVertexArray = draw.model->getVertexArray();
+                    glBindVertexArray(boundVertexArray);
+                    ++mFrameStats.vertexArrayChanges;
+                }
+
+                mObjectUniforms.bind(packet.item);
+                draw.model->drawElements();
+                ++mFrameStats.drawCalls;
+                continue;
+            }
+
+            // =================== GRUPO DO LOTE ESTÁTICO ===================
+            // Slots a partir de mFirstBatchSlot: um glMultiDrawElementsBaseVertex por grupo
+            if (packet.item >= mFirstBatchSlot)
+            {
+                uint32_t group = packet.item - mFirstBatchSlot;
+                const Shader &batchProgram = getSceneShaders(*mStaticBatch.getGroups()[group].layout)->basic;
+                if (&batchProgram != program)
                 {
-                    // Valores padrão para vidro
-                    mTransparentShader.setVec3("uObjectColor", glm::vec3(0.9f, 0.95f, 1.0f));
-                    mTransparentShader.setFloat("uAlpha", 0.4f);
-                    mTransparentShader.setFloat("uShininess", 128.0f);
-                    mTransparentShader.setVec3("uSpecularColor", glm::vec3(1.0f, 1.0f, 1.0f));
+                    program = &batchProgram;
+                    program->bind();
+                    ++mFrameStats.programChanges;
+                }
+                if (mStaticBatch.getVertexArray(group) != boundVertexArray)
+                {
+                    boundVertexArray = mStaticBatch.getVertexArray(group);
+                    glBindVertexArray(boundVertexArray);
+                    ++mFrameStats.vertexArrayChanges;
+                }
+
+                mObjectUniforms.bind(packet.item);
+                mStaticBatch.draw(group);
+                ++mFrameStats.drawCalls;
+                continue;
+            }
+
+            // packet.item é o slot do objeto no ring buffer (índice em mVisibleItems)
+            const DrawItem &item = mDrawItems[mVisibleItems[packet.item]];
+            Mesh *mesh = item.mesh;
+
+            // =================== TROCA DE PASSE ===================
+            if (transparent && !transparentPass)
+            {
+                // Caixas testadas contra a profundidade dos opacos (resultados usados no próximo frame)
+                if (mSettings.enableOcclusionQueries)
+                {
+                    issueOcclusionQueries();
+                    program = nullptr;
+                    boundVertexArray = 0;
                 }
 
-                mesh->draw();
+                // Ativa blending para transparência
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+                // Desativa escrita no buffer de profundidade para objetos transparentes
+                glDepthMask(GL_FALSE);
+                transparentPass = true;
             }
+
+            // =================== PROGRAMA ===================
+            const Shader &packetProgram = transparent ? item.shaders->transparent : item.shaders->basic;
+            if (&packetProgram != program)
+            {
+                program = &packetProgram;
+                program->bind();
+                ++mFrameStats.programChanges;
+            }
+
+            // =================== VAO ===================
+            if (mesh->getVertexArray() != boundVertexArray)
+            {
+                boundVertexArray = mesh->getVertexArray();
+                glBindVertexArray(boundVertexArray);
+                ++mFrameStats.vertexArrayChanges;
+            }
+
+            // =================== DADOS DO OBJETO ===================
+            // Matrizes e material já estão no slot; o draw só aponta o bloco para ele
+            mObjectUniforms.bind(packet.item);
+
+            // LOD escolhido em buildRenderQueue; descartado pela GPU se a caixa
+            // estava oculta no frame anterior
+            const bool conditional = mSettings.enableOcclusionQueries && mOcclusionQueries.beginConditional(mVisibleItems[packet.item]);
+            mesh->drawElements();
+            if (conditional)
+            {
+                mOcclusionQueries.endConditional();
+            }
+            ++mFrameStats.drawCalls;
+        }
+
+        // Cena sem transparentes: as queries vêm depois de todos os opacos
+        if (mSettings.enableOcclusionQueries && !transparentPass)
+        {
+            issueOcclusionQueries();
+        }
+
+        glBindVertexArray(0);
+
+        mFrameStats.occlusionQueries = mOcclusionQueries.getStats().queries;
+        mFrameStats.conditionalDraws = mOcclusionQueries.getStats().conditionalDraws;
+        mFrameStats.conditionalSkips = mOcclusionQueries.getStats().skipped;
+
+        // A região do ring só é reescrita quando a GPU terminar estes draws
+        mObjectUniforms.endFrame();
+    }
+
+    void Renderer::issueOcclusionQueries()
+    {
+        // Em wireframe as caixas seriam só arestas: as queries sempre rasterizam faces cheias
+        if (mSettings.enableWireframe)
+        {
+            glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        }
+        mOcclusionQueries.beginQueries();
+        for (uint32_t index : mVisibleItems)
+        {
+            const DrawItem &item = mDrawItems[index];
+            if (item.batchEntry >= 0)
+            {
+                continue; // desenhada pelo grupo do lote, sem draw próprio para condicionar
+            }
+            mOcclusionQueries.query(index, item.worldBox, mCameraPosition);
+        }
+        mOcclusionQueries.endQueries();
+        if (mSettings.enableWireframe)
+        {
+            glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
         }
     }
 
@@ -1,6 +1,8 @@
 #include "render/Shader.h"
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 namespace cg
@@ -41,6 +43,51 @@ namespace cg
         return true;
     }
 
+    Shader::UploadStats Shader::sUploadStats;
+
+    namespace
+    {
+        // Tamanho do valor guardado para comparação (0 = tipo sem setter, nunca comparado)
+        uint32_t shadowSizeOf(GLenum type)
+        {
+            switch (type)
+            {
+            case GL_FLOAT_MAT4:
+                return sizeof(glm::mat4);
+            case GL_FLOAT_MAT3:
+                return sizeof(glm::mat3);
+            case GL_FLOAT_VEC4:
+                return sizeof(glm::vec4);
+            case GL_FLOAT_VEC3:
+                return sizeof(glm::vec3);
+            case GL_FLOAT:
+                return sizeof(float);
+            default:
+                return sizeof(int); // int, bool e samplers usam glUniform1i
+            }
+        }
+
+        // Tipo GLSL esperado por cada tipo C++ dos handles
+        template <typename T>
+        bool matchesType(GLenum type);
+
+        template <>
+        bool matchesType<glm::mat4>(GLenum type) { return type == GL_FLOAT_MAT4; }
+        template <>
+        bool matchesType<glm::mat3>(GLenum type) { return type == GL_FLOAT_MAT3; }
+        template <>
+        bool matchesType<glm::vec4>(GLenum type) { return type == GL_FLOAT_VEC4; }
+        template <>
+        bool matchesType<glm::vec3>(GLenum type) { return type == GL_FLOAT_VEC3; }
+        template <>
+        bool matchesType<float>(GLenum type) { return type == GL_FLOAT; }
+        template <>
+        bool matchesType<int>(GLenum type)
+        {
+            return type == GL_INT || type == GL_BOOL || type == GL_SAMPLER_2D || type == GL_SAMPLER_CUBE;
+        }
+    } // namespace
+
     Shader::~Shader()
     {
         if (mProgram)
@@ -84,66 +131,210 @@ namespace cg
             mProgram = 0;
             return false;
         }
+
+        reflectUniforms();
+        return true;
+    }
+
+    bool Shader::compileFeedback(const char *vsSrc, const char *const *varyings, int varyingCount)
+    {
+        GLuint vs = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vs, 1, &vsSrc, nullptr);
+        glCompileShader(vs);
+        if (!checkCompile(vs, false, "VS"))
+        {
+            glDeleteShader(vs);
+            return false;
+        }
+
+        // As saídas capturadas precisam ser declaradas antes do link
+        mProgram = glCreateProgram();
+        glAttachShader(mProgram, vs);
+        glTransformFeedbackVaryings(mProgram, varyingCount, varyings, GL_INTERLEAVED_ATTRIBS);
+        glLinkProgram(mProgram);
+        bool okLink = checkCompile(mProgram, true, "Program");
+
+        glDeleteShader(vs);
+
+        if (!okLink)
+        {
+            glDeleteProgram(mProgram);
+            mProgram = 0;
+            return false;
+        }
+
+        reflectUniforms();
+        return true;
+    }
+
+    void Shader::reflectUniforms()
+    {
+        mUniforms.clear();
+        mShadow.clear();
+
+        GLint count = 0;
+        GLint maxLength = 0;
+        glGetProgramiv(mProgram, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(mProgram, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+        std::string buffer(static_cast<size_t>(std::max(maxLength, 1)), '\0');
+        for (GLint i = 0; i < count; ++i)
+        {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(mProgram, static_cast<GLuint>(i), maxLength, &length, &size, &type, buffer.data());
+
+            UniformSlot slot;
+            slot.name.assign(buffer.data(), static_cast<size_t>(length));
+            // Arrays aparecem como "nome[0]"; o setter usa o nome base
+            if (slot.name.size() > 3 && slot.name.compare(slot.name.size() - 3, 3, "[0]") == 0)
+            {
+                slot.name.resize(slot.name.size() - 3);
+            }
+
+            slot.location = glGetUniformLocation(mProgram, buffer.data());
+            if (slot.location < 0)
+            {
+                continue; // uniforms de blocos (UBO) não têm localização
+            }
+
+            slot.hash = hashUniformName(slot.name);
+            slot.type = type;
+            slot.shadowOffset = static_cast<uint32_t>(mShadow.size());
+            slot.shadowSize = shadowSizeOf(type);
+            mShadow.resize(mShadow.size() + slot.shadowSize);
+            mUniforms.push_back(std::move(slot));
+        }
+    }
+
+    int32_t Shader::findSlot(UniformName name) const
+    {
+        for (size_t i = 0; i < mUniforms.size(); ++i)
+        {
+            // O nome só é comparado quando o hash coincide (colisões continuam corretas)
+            if (mUniforms[i].hash == name.hash && mUniforms[i].name == name.name)
+            {
+                return static_cast<int32_t>(i);
+            }
+        }
+        return -1;
+    }
+
+    template <typename T>
+    Uniform<T> Shader::getUniform(UniformName name) const
+    {
+        Uniform<T> uniform;
+        int32_t slot = findSlot(name);
+        if (slot >= 0 && matchesType<T>(mUniforms[slot].type))
+        {
+            uniform.slot = slot;
+        }
+        return uniform;
+    }
+
+    template Uniform<glm::mat4> Shader::getUniform<glm::mat4>(UniformName) const;
+    template Uniform<glm::mat3> Shader::getUniform<glm::mat3>(UniformName) const;
+    template Uniform<glm::vec4> Shader::getUniform<glm::vec4>(UniformName) const;
+    template Uniform<glm::vec3> Shader::getUniform<glm::vec3>(UniformName) const;
+    template Uniform<float> Shader::getUniform<float>(UniformName) const;
+    template Uniform<int> Shader::getUniform<int>(UniformName) const;
+
+    bool Shader::updateShadow(int32_t slot, const void *data, size_t size) const
+    {
+        const UniformSlot &uniform = mUniforms[slot];
+        uint8_t *shadow = mShadow.data() + uniform.shadowOffset;
+        size = std::min<size_t>(size, uniform.shadowSize);
+        if (uniform.hasValue && std::memcmp(shadow, data, size) == 0)
+        {
+            ++sUploadStats.skipped;
+            return false;
+        }
+
+        std::memcpy(shadow, data, size);
+        uniform.hasValue = true;
+        ++sUploadStats.uploads;
+        return true;
+    }
+
+    bool Shader::bindUniformBlock(const char *blockName, unsigned int bindingPoint) const
+    {
+        GLuint blockIndex = glGetUniformBlockIndex(mProgram, blockName);
+        if (blockIndex == GL_INVALID_INDEX)
+        {
+            return false;
+        }
+        glUniformBlockBinding(mProgram, blockIndex, bindingPoint);
         return true;
     }
 
     void Shader::bind() const { glUseProgram(mProgram); }
     void Shader::unbind() { glUseProgram(0); }
 
-    // =================== IMPLEMENTAÇÃO DOS MÉTODOS PARA UNIFORMS ===================
+    // =================== ENVIO POR ÍNDICE ===================
 
-    void Shader::setMat4(const char *name, const glm::mat4 &m) const
+    void Shader::uploadMat4(int32_t slot, const glm::mat4 &m) const
     {
-        GLint loc = glGetUniformLocation(mProgram, name);
-        if (loc != -1)
+        if (slot >= 0 && updateShadow(slot, glm::value_ptr(m), sizeof(m)))
         {
-            glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(m));
+            glUniformMatrix4fv(mUniforms[slot].location, 1, GL_FALSE, glm::value_ptr(m));
         }
     }
 
-    void Shader::setMat3(const char *name, const glm::mat3 &m) const
+    void Shader::uploadMat3(int32_t slot, const glm::mat3 &m) const
     {
-        GLint loc = glGetUniformLocation(mProgram, name);
-        if (loc != -1)
+        if (slot >= 0 && updateShadow(slot, glm::value_ptr(m), sizeof(m)))
         {
-            glUniformMatrix3fv(loc, 1, GL_FALSE, glm::value_ptr(m));
+            glUniformMatrix3fv(mUniforms[slot].location, 1, GL_FALSE, glm::value_ptr(m));
         }
     }
 
-    void Shader::setVec3(const char *name, const glm::vec3 &v) const
+    void Shader::uploadVec3(int32_t slot, const glm::vec3 &v) const
     {
-        GLint loc = glGetUniformLocation(mProgram, name);
-        if (loc != -1)
+        if (slot >= 0 && updateShadow(slot, glm::value_ptr(v), sizeof(v)))
         {
-            glUniform3fv(loc, 1, glm::value_ptr(v));
+            glUniform3fv(mUniforms[slot].location, 1, glm::value_ptr(v));
         }
     }
 
-    void Shader::setVec4(const char *name, const glm::vec4 &v) const
+    void Shader::uploadVec4(int32_t slot, const glm::vec4 &v) const
     {
-        GLint loc = glGetUniformLocation(mProgram, name);
-        if (loc != -1)
+        if (slot >= 0 && updateShadow(slot, glm::value_ptr(v), sizeof(v)))
         {
-            glUniform4fv(loc, 1, glm::value_ptr(v));
+            glUniform4fv(mUniforms[slot].location, 1, glm::value_ptr(v));
         }
     }
 
-    void Shader::setFloat(const char *name, float value) const
+    void Shader::uploadFloat(int32_t slot, float value) const
     {
-        GLint loc = glGetUniformLocation(mProgram, name);
-        if (loc != -1)
+        if (slot >= 0 && updateShadow(slot, &value, sizeof(value)))
         {
-            glUniform1f(loc, value);
+            glUniform1f(mUniforms[slot].location, value);
         }
     }
 
-    void Shader::setInt(const char *name, int value) const
+    void Shader::uploadInt(int32_t slot, int value) const
     {
-        GLint loc = glGetUniformLocation(mProgram, name);
-        if (loc != -1)
+        if (slot >= 0 && updateShadow(slot, &value, sizeof(value)))
         {
-            glUniform1i(loc, value);
+            glUniform1i(mUniforms[slot].location, value);
         }
     }
 
+    // =================== IMPLEMENTAÇÃO DOS MÉTODOS PARA UNIFORMS ===================
+
+    void Shader::setMat4(UniformName name, const glm::mat4 &m) const { uploadMat4(findSlot(name), m); }
+    void Shader::setMat3(UniformName name, const glm::mat3 &m) const { uploadMat3(findSlot(name), m); }
+    void Shader::setVec3(UniformName name, const glm::vec3 &v) const { uploadVec3(findSlot(name), v); }
+    void Shader::setVec4(UniformName name, const glm::vec4 &v) const { uploadVec4(findSlot(name), v); }
+    void Shader::setFloat(UniformName name, float value) const { uploadFloat(findSlot(name), value); }
+    void Shader::setInt(UniformName name, int value) const { uploadInt(findSlot(name), value); }
+
+    void Shader::set(Uniform<glm::mat4> uniform, const glm::mat4 &m) const { uploadMat4(uniform.slot, m); }
+    void Shader::set(Uniform<glm::mat3> uniform, const glm::mat3 &m) const { uploadMat3(uniform.slot, m); }
+    void Shader::set(Uniform<glm::vec3> uniform, const glm::vec3 &v) const { uploadVec3(uniform.slot, v); }
+    void Shader::set(Uniform<glm::vec4> uniform, const glm::vec4 &v) const { uploadVec4(uniform.slot, v); }
+    void Shader::set(Uniform<float> uniform, float value) const { uploadFloat(uniform.slot, value); }
+    void Shader::set(Uniform<int> uniform, int value) const { uploadInt(uniform.slot, value); }
+
 } // namespace cg
@@ -1,7 +1,9 @@
 #include "render/Skybox.h"
+#include "render/FrameUniforms.h"
 #include <glad/glad.h>
 #include <iostream>
 #include <cmath>
+#include <string>
 
 namespace cg
 {
@@ -31,7 +33,7 @@ namespace cg
         return true;
     }
 
-    void Skybox::render(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix)
+    void Skybox::render()
     {
         // Debug: verificar se o skybox está sendo chamado
         // std::cout << "Renderizando skybox..." << std::endl;
@@ -46,12 +48,7 @@ namespace cg
         // Usar shader
         mShader.bind();
 
-        // Remover translação da matriz de view (apenas rotação)
-        glm::mat4 skyboxView = glm::mat4(glm::mat3(viewMatrix));
-
-        // Configurar uniforms
-        mShader.setMat4("view", skyboxView);
-        mShader.setMat4("projection", projectionMatrix);
+        // Configurar uniforms (câmera vem do bloco FrameUniforms)
         mShader.setVec3("skyColor", mConfig.skyColor);
         mShader.setVec3("horizonColor", mConfig.horizonColor);
         mShader.setVec3("sunColor", mConfig.sunColor);
@@ -142,20 +139,17 @@ namespace cg
     bool Skybox::compileShaders()
     {
         // Vertex shader
-        const char *vertexShaderSource = R"(
-#version 330 core
-
+        const char *vertexShaderBody = R"(
 layout (location = 0) in vec3 aPos;
 
 out vec3 TexCoords;
 
-uniform mat4 projection;
-uniform mat4 view;
-
 void main()
 {
     TexCoords = aPos;
-    vec4 pos = projection * view * vec4(aPos, 1.0);
+    // Remover translação da matriz de view (apenas rotação)
+    mat4 skyboxView = mat4(mat3(uView));
+    vec4 pos = uProjection * skyboxView * vec4(aPos, 1.0);
     gl_Position = pos.xyww; // Truque para garantir que o skybox fique sempre no fundo
 }
 )";
@@ -243,7 +237,12 @@ void main()
 }
 )";
 
-        return mShader.compile(vertexShaderSource, fragmentShaderSource);
+        std::string vertexShaderSource = std::string("#version 330 core\n") + FrameUniforms::glslBlock() + vertexShaderBody;
+        if (!mShader.compile(vertexShaderSource.c_str(), fragmentShaderSource))
+        {
+            return false;
+        }
+        return FrameUniforms::attach(mShader);
     }
 
     void Skybox::cleanup()
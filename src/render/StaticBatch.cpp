@@ -0,0 +1,492 @@
+#include "render/StaticBatch.h"
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+
+namespace cg
+{
+
+    namespace
+    {
+        // Decodifica os vértices de uma mesh (qualquer layout), leva posição e
+        // normal para o espaço de destino e grava o vértice em outro layout, em
+        // palavras de 32 bits; a declaração dos atributos vem de
+        // VertexLayoutInfo::glslPrelude e a codificação, de glslEncoder
+        const char *kTransformShaderHeader = R"GLSL(#version 330 core
+        uniform mat4 uModel;
+        uniform mat3 uNormalMatrix;
+        uniform int uRenormalize;
+        uniform vec4 uPosOffset; // Usados por decodePosition() em layouts quantizados
+        uniform vec4 uPosScale;
+        uniform vec4 uTargetOffset; // Quantização das posições gravadas
+        uniform vec4 uTargetScale;
+    )GLSL";
+
+        const char *kTransformShaderMain = R"GLSL(
+        void main() {
+            vec3 normal = uNormalMatrix * decodeNormal();
+            if (uRenormalize != 0) normal = normalize(normal);
+            uvec3 position = encodePosition((uModel * vec4(decodePosition(), 1.0)).xyz, uTargetOffset.xyz, uTargetScale.xyz);
+            uvec3 normalWords = encodeNormal(normal);
+            uvec3 texCoord = encodeTexCoord(decodeTexCoord());
+    )GLSL";
+
+        bool sameQuantization(const QuantizationParams &a, const QuantizationParams &b)
+        {
+            return a.positionOffset == b.positionOffset && a.positionScale == b.positionScale;
+        }
+
+        bool containsBox(const BoundingBox &outer, const BoundingBox &inner)
+        {
+            return inner.min.x >= outer.min.x && inner.min.y >= outer.min.y && inner.min.z >= outer.min.z &&
+                   inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+        }
+
+        bool isInvertible(const glm::mat4 &matrix)
+        {
+            return std::abs(glm::determinant(glm::mat3(matrix))) > 1e-12f; // falso também para NaN
+        }
+    } // namespace
+
+    StaticBatch::~StaticBatch()
+    {
+        clear();
+    }
+
+    void StaticBatch::clear()
+    {
+        for (VertexBuffer &buffer : mVertexBuffers)
+        {
+            glDeleteVertexArrays(1, &buffer.vao);
+            glDeleteBuffers(1, &buffer.vbo);
+        }
+        mVertexBuffers.clear();
+        if (mEBO)
+        {
+            glDeleteBuffers(1, &mEBO);
+            mEBO = 0;
+        }
+        mGpuMemoryBytes = 0;
+        mEntries.clear();
+        mGroups.clear();
+        mEntryByMesh.clear();
+    }
+
+    const Shader *StaticBatch::getTransformShader(const VertexLayoutInfo &source, const VertexLayoutInfo &target)
+    {
+        uint32_t key = source.id | (target.id << 16);
+        auto it = mTransformShaders.find(key);
+        if (it != mTransformShaders.end())
+        {
+            return it->second.get(); // nullptr se a compilação já falhou antes
+        }
+
+        // Uma saída uint por palavra do vértice de destino, na ordem do VBO
+        const uint32_t attributeWords[3] = {
+            (target.attributes[1].offset - target.attributes[0].offset) / 4,
+            (target.attributes[2].offset - target.attributes[1].offset) / 4,
+            (target.stride - target.attributes[2].offset) / 4};
+        const char *const attributeValues[3] = {"position", "normalWords", "texCoord"};
+        const char *const components = "xyz";
+
+        std::vector<std::string> varyings;
+        std::string outputs;
+        std::string assignments;
+        for (int attribute = 0; attribute < 3; ++attribute)
+        {
+            for (uint32_t word = 0; word < attributeWords[attribute]; ++word)
+            {
+                std::string name = "outWord" + std::to_string(varyings.size());
+                outputs += "flat out uint " + name + ";\n";
+                assignments += name + " = " + attributeValues[attribute] + "." + components[word] + ";\n";
+                varyings.push_back(std::move(name));
+            }
+        }
+
+        std::string shaderSource = std::string(kTransformShaderHeader) + source.glslPrelude() + target.glslEncoder() +
+                                   outputs + kTransformShaderMain + assignments + "}\n";
+        std::vector<const char *> varyingNames;
+        for (const std::string &name : varyings)
+        {
+            varyingNames.push_back(name.c_str());
+        }
+
+        auto shader = std::make_unique<Shader>();
+        if (!shader->compileFeedback(shaderSource.c_str(), varyingNames.data(), static_cast<int>(varyingNames.size())))
+        {
+            std::cerr << "ERRO: Falha ao compilar shader de transformação do lote estático (layout " << source.id
+                      << " -> " << target.id << ")" << std::endl;
+            shader.reset();
+        }
+
+        const Shader *result = shader.get();
+        mTransformShaders.emplace(key, std::move(shader));
+        return result;
+    }
+
+    bool StaticBatch::transformVertices(GLuint sourceVertexArray, GLint firstVertex, size_t vertexCount,
+                                        const VertexLayoutInfo &sourceLayout, const QuantizationParams &sourceQuantization,
+                                        const glm::mat4 &matrix, const VertexLayoutInfo &targetLayout,
+                                        const QuantizationParams &targetQuantization, GLuint target, size_t targetVertex)
+    {
+        const Shader *shader = getTransformShader(sourceLayout, targetLayout);
+        if (!shader)
+        {
+            return false;
+        }
+
+        // Com a identidade as normais são regravadas como estão (sem deriva a cada recodificação)
+        const size_t stride = targetLayout.stride;
+        shader->bind();
+        shader->setMat4("uModel", matrix);
+        shader->setMat3("uNormalMatrix", glm::transpose(glm::inverse(glm::mat3(matrix))));
+        shader->setInt("uRenormalize", matrix != glm::mat4(1.0f) ? 1 : 0);
+        shader->setVec4("uPosOffset", glm::vec4(sourceQuantization.positionOffset, 0.0f));
+        shader->setVec4("uPosScale", glm::vec4(sourceQuantization.positionScale, 0.0f));
+        shader->setVec4("uTargetOffset", glm::vec4(targetQuantization.positionOffset, 0.0f));
+        shader->setVec4("uTargetScale", glm::vec4(targetQuantization.positionScale, 0.0f));
+
+        glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, target,
+                          static_cast<GLintptr>(targetVertex * stride),
+                          static_cast<GLsizeiptr>(vertexCount * stride));
+        glBindVertexArray(sourceVertexArray);
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, firstVertex, static_cast<GLsizei>(vertexCount));
+        glEndTransformFeedback();
+        return true;
+    }
+
+    bool StaticBatch::build(const std::vector<Source> &sources)
+    {
+        // O lote anterior continua vivo até o fim do build: é a origem dos
+        // vértices e índices das meshes que já tinham entregado seus buffers a ele
+        StaticBatch previous;
+        previous.mVertexBuffers.swap(mVertexBuffers);
+        std::swap(previous.mEBO, mEBO);
+        previous.mEntries.swap(mEntries);
+        previous.mGroups.swap(mGroups);
+        previous.mEntryByMesh.swap(mEntryByMesh);
+        clear();
+
+        // =================== DISPOSIÇÃO NOS BUFFERS ===================
+        // Grupos por (layout, material, tipo de índice); um VBO por layout. O EBO de
+        // cada mesh é copiado inteiro (todos os LODs), alinhado em 4 bytes
+        using GroupKey = std::tuple<uint32_t, const Material *, GLenum>;
+        std::map<GroupKey, uint32_t> groupByKey;
+        std::map<uint32_t, uint32_t> vertexBufferByLayout;
+        std::vector<int32_t> previousEntries; // Entrada de origem no lote anterior (-1 = buffers da mesh)
+        size_t indexBytes = 0;
+
+        for (const Source &source : sources)
+        {
+            Mesh *mesh = source.mesh;
+            if (!mesh || mesh->getVertexCount() == 0 || mesh->getLodCount() == 0 || mesh->isGeometryShared() ||
+                !isInvertible(source.worldMatrix))
+            {
+                continue;
+            }
+
+            int32_t previousEntry = -1;
+            if (!mesh->hasGpuGeometry())
+            {
+                previousEntry = previous.findEntry(mesh);
+                if (previousEntry < 0)
+                {
+                    std::cerr << "ERRO: Mesh sem buffers na GPU fora do lote estático: " << mesh->name << std::endl;
+                    continue;
+                }
+                if (previous.mEntries[previousEntry].worldMatrix != source.worldMatrix)
+                {
+                    // Os vértices do lote já estão no mundo: não são transformados de novo
+                    std::cerr << "AVISO: Mesh movida depois de entrar no lote estático, mantida fora: " << mesh->name << std::endl;
+                    restoreFrom(previous, mesh);
+                    continue;
+                }
+            }
+
+            const VertexLayoutInfo &layout = mesh->getVertexLayout();
+            auto [bufferIt, newBuffer] = vertexBufferByLayout.emplace(layout.id, static_cast<uint32_t>(mVertexBuffers.size()));
+            if (newBuffer)
+            {
+                VertexBuffer buffer;
+                buffer.layout = &layout;
+                mVertexBuffers.push_back(buffer);
+            }
+
+            GroupKey key{layout.id, mesh->getMaterial().get(), mesh->getIndexType()};
+            auto [groupIt, inserted] = groupByKey.emplace(key, static_cast<uint32_t>(mGroups.size()));
+            if (inserted)
+            {
+                Group group;
+                group.representative = mesh;
+                group.material = mesh->getMaterial().get();
+                group.layout = &layout;
+                group.vertexBuffer = bufferIt->second;
+                group.indexType = mesh->getIndexType();
+                mGroups.push_back(std::move(group));
+            }
+
+            Entry entry;
+            entry.mesh = mesh;
+            entry.worldMatrix = source.worldMatrix;
+            entry.baseVertex = static_cast<GLint>(mVertexBuffers[bufferIt->second].vertexCount);
+            entry.indexOffset = indexBytes;
+            entry.group = groupIt->second;
+
+            Group &group = mGroups[entry.group];
+            BoundingBox worldBox = transformBox(mesh->getBoundingBox(), source.worldMatrix);
+            group.bounds.expand(worldBox.min);
+            group.bounds.expand(worldBox.max);
+            group.entries.push_back(static_cast<uint32_t>(mEntries.size()));
+            mEntryByMesh[mesh] = static_cast<uint32_t>(mEntries.size());
+            mEntries.push_back(entry);
+            previousEntries.push_back(previousEntry);
+
+            mVertexBuffers[bufferIt->second].vertexCount += mesh->getVertexCount();
+            indexBytes += (mesh->getIndexBufferBytes() + 3) & ~size_t(3);
+        }
+
+        if (mEntries.empty())
+        {
+            return false;
+        }
+
+        // =================== QUANTIZAÇÃO DOS GRUPOS ===================
+        // Posições quantizadas relativas à AABB de mundo do grupo. Um grupo que já
+        // existia e ainda cabe na AABB anterior mantém os parâmetros: os vértices
+        // vindos do lote anterior são copiados byte a byte, sem requantizar. As
+        // meshes do lote anterior podem não existir mais: só as chaves são usadas
+        std::map<GroupKey, const Group *> previousGroups;
+        for (const Group &group : previous.mGroups)
+        {
+            previousGroups.emplace(GroupKey{group.layout->id, group.material, group.indexType}, &group);
+        }
+        for (Group &group : mGroups)
+        {
+            if (!group.layout->quantizedPosition)
+            {
+                continue;
+            }
+            auto it = previousGroups.find(GroupKey{group.layout->id, group.material, group.indexType});
+            if (it != previousGroups.end() && containsBox(it->second->bounds, group.bounds))
+            {
+                group.bounds = it->second->bounds;
+                group.quantization = it->second->quantization;
+            }
+            else
+            {
+                group.quantization = QuantizationParams::fromBounds(group.bounds);
+            }
+        }
+
+        // =================== BUFFERS DO LOTE ===================
+        size_t vertexBytes = 0;
+        for (VertexBuffer &buffer : mVertexBuffers)
+        {
+            glGenVertexArrays(1, &buffer.vao);
+            glGenBuffers(1, &buffer.vbo);
+            glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+            glBufferData(GL_ARRAY_BUFFER, buffer.vertexCount * buffer.layout->stride, nullptr, GL_STATIC_DRAW);
+            vertexBytes += buffer.vertexCount * buffer.layout->stride;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glGenBuffers(1, &mEBO);
+
+        // =================== ÍNDICES ===================
+        // Cópia direta entre buffers: os índices continuam relativos à mesh (baseVertex no draw)
+        glBindBuffer(GL_COPY_WRITE_BUFFER, mEBO);
+        glBufferData(GL_COPY_WRITE_BUFFER, indexBytes, nullptr, GL_STATIC_DRAW);
+        for (size_t i = 0; i < mEntries.size(); ++i)
+        {
+            const Entry &entry = mEntries[i];
+            bool fromPrevious = previousEntries[i] >= 0;
+            glBindBuffer(GL_COPY_READ_BUFFER, fromPrevious ? previous.mEBO : entry.mesh->getIndexBuffer());
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                fromPrevious ? previous.mEntries[previousEntries[i]].indexOffset : 0,
+                                entry.indexOffset, entry.mesh->getIndexBufferBytes());
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        // =================== VÉRTICES (TRANSFORM FEEDBACK) ===================
+        // Cada mesh é desenhada como pontos, sem rasterização; o vertex shader grava
+        // o vértice já no mundo, no layout do grupo, na sua faixa do VBO do lote.
+        // Vértices vindos do lote anterior já estão no mundo com a mesma matriz:
+        // são copiados, ou só requantizados se a AABB do grupo cresceu
+        bool ok = true;
+        glEnable(GL_RASTERIZER_DISCARD);
+        for (size_t i = 0; i < mEntries.size() && ok; ++i)
+        {
+            const Entry &entry = mEntries[i];
+            const Mesh &mesh = *entry.mesh;
+            const Group &group = mGroups[entry.group];
+            const VertexBuffer &target = mVertexBuffers[group.vertexBuffer];
+            const size_t stride = group.layout->stride;
+            if (previousEntries[i] >= 0)
+            {
+                const Entry &old = previous.mEntries[previousEntries[i]];
+                const Group &oldGroup = previous.mGroups[old.group];
+                const VertexBuffer &source = previous.mVertexBuffers[oldGroup.vertexBuffer];
+                if (sameQuantization(oldGroup.quantization, group.quantization))
+                {
+                    glBindBuffer(GL_COPY_READ_BUFFER, source.vbo);
+                    glBindBuffer(GL_COPY_WRITE_BUFFER, target.vbo);
+                    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, old.baseVertex * stride,
+                                        entry.baseVertex * stride, mesh.getVertexCount() * stride);
+                }
+                else
+                {
+                    ok = transformVertices(source.vao, old.baseVertex, mesh.getVertexCount(), *oldGroup.layout,
+                                           oldGroup.quantization, glm::mat4(1.0f), *group.layout, group.quantization,
+                                           target.vbo, entry.baseVertex);
+                }
+            }
+            else
+            {
+                ok = transformVertices(mesh.getVertexArray(), 0, mesh.getVertexCount(), mesh.getVertexLayout(),
+                                       mesh.getQuantization(), entry.worldMatrix, *group.layout, group.quantization,
+                                       target.vbo, entry.baseVertex);
+            }
+        }
+        glDisable(GL_RASTERIZER_DISCARD);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        glBindVertexArray(0);
+        Shader::unbind();
+
+        if (!ok)
+        {
+            // As meshes que só existiam no lote anterior voltam a ter buffers próprios
+            for (size_t i = 0; i < mEntries.size(); ++i)
+            {
+                if (previousEntries[i] >= 0)
+                {
+                    restoreFrom(previous, mEntries[i].mesh);
+                }
+            }
+            clear();
+            return false;
+        }
+
+        // =================== VAOS ===================
+        for (const VertexBuffer &buffer : mVertexBuffers)
+        {
+            glBindVertexArray(buffer.vao);
+            glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
+            buffer.layout->setupAttributes();
+        }
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+        // =================== BUFFERS DAS MESHES ===================
+        // A geometria passa a existir só no lote
+        for (const Entry &entry : mEntries)
+        {
+            entry.mesh->releaseGpuGeometry();
+        }
+
+        mGpuMemoryBytes = vertexBytes + indexBytes;
+        return true;
+    }
+
+    bool StaticBatch::restoreGeometry(Mesh *mesh)
+    {
+        return restoreFrom(*this, mesh);
+    }
+
+    bool StaticBatch::restoreFrom(const StaticBatch &batch, Mesh *mesh)
+    {
+        int32_t entryIndex = batch.findEntry(mesh);
+        if (entryIndex < 0 || mesh->hasGpuGeometry())
+        {
+            return false;
+        }
+        const Entry &entry = batch.mEntries[entryIndex];
+        const Group &group = batch.mGroups[entry.group];
+        const VertexBuffer &source = batch.mVertexBuffers[group.vertexBuffer];
+        const VertexLayoutInfo &layout = mesh->getVertexLayout();
+
+        GLuint buffers[2] = {0, 0};
+        glGenBuffers(2, buffers);
+
+        // Índices: cópia da faixa da mesh no EBO do lote
+        size_t indexBytes = mesh->getIndexBufferBytes();
+        glBindBuffer(GL_COPY_READ_BUFFER, batch.mEBO);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffers[1]);
+        glBufferData(GL_COPY_WRITE_BUFFER, indexBytes, nullptr, GL_STATIC_DRAW);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, entry.indexOffset, 0, indexBytes);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        // Vértices: de volta ao espaço local pela inversa da matriz usada no build
+        // (invertível: matrizes singulares não entram no lote), no layout e com a
+        // quantização originais da mesh
+        glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+        glBufferData(GL_ARRAY_BUFFER, mesh->getVertexCount() * layout.stride, nullptr, GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glEnable(GL_RASTERIZER_DISCARD);
+        bool ok = transformVertices(source.vao, entry.baseVertex, mesh->getVertexCount(), *group.layout, group.quantization,
+                                    glm::inverse(entry.worldMatrix), layout, mesh->getQuantization(), buffers[0], 0);
+        glDisable(GL_RASTERIZER_DISCARD);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+        glBindVertexArray(0);
+        Shader::unbind();
+
+        if (!ok)
+        {
+            glDeleteBuffers(2, buffers);
+            std::cerr << "ERRO: Não foi possível recuperar a geometria de " << mesh->name << " do lote estático" << std::endl;
+            return false;
+        }
+
+        mesh->restoreGpuGeometry(buffers[0], buffers[1]);
+        return true;
+    }
+
+    int32_t StaticBatch::findEntry(const Mesh *mesh) const
+    {
+        auto it = mEntryByMesh.find(mesh);
+        return it != mEntryByMesh.end() ? static_cast<int32_t>(it->second) : -1;
+    }
+
+    void StaticBatch::beginFrame()
+    {
+        for (Group &group : mGroups)
+        {
+            group.counts.clear();
+            group.offsets.clear();
+            group.baseVertices.clear();
+        }
+    }
+
+    void StaticBatch::addVisible(uint32_t entryIndex, size_t lod)
+    {
+        const Entry &entry = mEntries[entryIndex];
+        Group &group = mGroups[entry.group];
+
+        group.counts.push_back(entry.mesh->getLodIndexCount(lod));
+        group.offsets.push_back(reinterpret_cast<const void *>(entry.indexOffset + entry.mesh->getLodIndexOffset(lod)));
+        group.baseVertices.push_back(entry.baseVertex);
+    }
+
+    void StaticBatch::draw(uint32_t groupIndex) const
+    {
+        const Group &group = mGroups[groupIndex];
+        if (group.counts.empty())
+        {
+            return;
+        }
+
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, group.counts.data(), group.indexType,
+                                      group.offsets.data(), static_cast<GLsizei>(group.counts.size()),
+                                      group.baseVertices.data());
+    }
+
+} // namespace cg
@@ -0,0 +1,342 @@
+#include "render/TransformKernel.h"
+#include "core/Simd.h"
+#include <cmath>
+
+namespace cg
+{
+
+    namespace
+    {
+        // =================== LANES ===================
+        // Operações mínimas usadas pelos kernels, para um registrador de kWidth floats
+
+        struct ScalarLanes
+        {
+            using Reg = float;
+            static constexpr size_t kWidth = 1;
+
+            static Reg load(const float *p) { return *p; }
+            static void store(float *p, Reg v) { *p = v; }
+            static Reg set1(float v) { return v; }
+            static Reg add(Reg a, Reg b) { return a + b; }
+            static Reg sub(Reg a, Reg b) { return a - b; }
+            static Reg mul(Reg a, Reg b) { return a * b; }
+            static Reg div(Reg a, Reg b) { return a / b; }
+            static Reg madd(Reg a, Reg b, Reg c) { return a * b + c; }
+        };
+
+#if defined(CG_SIMD_AVX)
+        struct WideLanes
+        {
+            using Reg = __m256;
+            static constexpr size_t kWidth = 8;
+
+            static Reg load(const float *p) { return _mm256_loadu_ps(p); }
+            static void store(float *p, Reg v) { _mm256_storeu_ps(p, v); }
+            static Reg set1(float v) { return _mm256_set1_ps(v); }
+            static Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+            static Reg mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+            static Reg div(Reg a, Reg b) { return _mm256_div_ps(a, b); }
+#if defined(CG_SIMD_AVX2)
+            static Reg madd(Reg a, Reg b, Reg c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+            static Reg madd(Reg a, Reg b, Reg c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+        };
+#define CG_TRANSFORM_WIDE_LANES 1
+#elif defined(CG_SIMD_SSE)
+        struct WideLanes
+        {
+            using Reg = __m128;
+            static constexpr size_t kWidth = 4;
+
+            static Reg load(const float *p) { return _mm_loadu_ps(p); }
+            static void store(float *p, Reg v) { _mm_storeu_ps(p, v); }
+            static Reg set1(float v) { return _mm_set1_ps(v); }
+            static Reg add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+            static Reg mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+            static Reg div(Reg a, Reg b) { return _mm_div_ps(a, b); }
+            static Reg madd(Reg a, Reg b, Reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+        };
+#define CG_TRANSFORM_WIDE_LANES 1
+#endif
+
+        // =================== KERNELS ===================
+        // Processam [first, count) em passos de L::kWidth e devolvem onde pararam
+
+        template <typename L>
+        size_t composeRange(const TrsArray &trs, Mat4Array &out, size_t first, size_t count)
+        {
+            using Reg = typename L::Reg;
+            const Reg zero = L::set1(0.0f);
+            const Reg one = L::set1(1.0f);
+
+            size_t i = first;
+            for (; i + L::kWidth <= count; i += L::kWidth)
+            {
+                // Senos e cossenos por lane (a única parte escalar)
+                float sines[3][L::kWidth];
+                float cosines[3][L::kWidth];
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    for (size_t lane = 0; lane < L::kWidth; ++lane)
+                    {
+                        float angle = trs.rotation[axis][i + lane];
+                        sines[axis][lane] = std::sin(angle);
+                        cosines[axis][lane] = std::cos(angle);
+                    }
+                }
+                Reg sa = L::load(sines[0]), ca = L::load(cosines[0]);
+                Reg sb = L::load(sines[1]), cb = L::load(cosines[1]);
+                Reg sc = L::load(sines[2]), cc = L::load(cosines[2]);
+
+                Reg sx = L::load(&trs.scale[0][i]);
+                Reg sy = L::load(&trs.scale[1][i]);
+                Reg sz = L::load(&trs.scale[2][i]);
+
+                // Rx(a) * Ry(b) * Rz(c), com cada coluna multiplicada pela escala do eixo
+                Reg sasb = L::mul(sa, sb);
+                Reg casb = L::mul(ca, sb);
+
+                L::store(out.element(0) + i, L::mul(L::mul(cb, cc), sx));
+                L::store(out.element(1) + i, L::mul(L::madd(sasb, cc, L::mul(ca, sc)), sx));
+                L::store(out.element(2) + i, L::mul(L::sub(L::mul(sa, sc), L::mul(casb, cc)), sx));
+                L::store(out.element(3) + i, zero);
+
+                L::store(out.element(4) + i, L::mul(L::sub(zero, L::mul(cb, sc)), sy));
+                L::store(out.element(5) + i, L::mul(L::sub(L::mul(ca, cc), L::mul(sasb, sc)), sy));
+                L::store(out.element(6) + i, L::mul(L::madd(casb, sc, L::mul(sa, cc)), sy));
+                L::store(out.element(7) + i, zero);
+
+                L::store(out.element(8) + i, L::mul(sb, sz));
+                L::store(out.element(9) + i, L::mul(L::sub(zero, L::mul(sa, cb)), sz));
+                L::store(out.element(10) + i, L::mul(L::mul(ca, cb), sz));
+                L::store(out.element(11) + i, zero);
+
+                L::store(out.element(12) + i, L::load(&trs.translation[0][i]));
+                L::store(out.element(13) + i, L::load(&trs.translation[1][i]));
+                L::store(out.element(14) + i, L::load(&trs.translation[2][i]));
+                L::store(out.element(15) + i, one);
+            }
+            return i;
+        }
+
+        template <typename L>
+        size_t multiplyRange(const Mat4Array &parents, const Mat4Array &locals, Mat4Array &out, size_t first, size_t count)
+        {
+            using Reg = typename L::Reg;
+
+            size_t i = first;
+            for (; i + L::kWidth <= count; i += L::kWidth)
+            {
+                Reg p[16];
+                for (int e = 0; e < 16; ++e)
+                {
+                    p[e] = L::load(parents.element(e) + i);
+                }
+
+                // Coluna c do resultado = pai * coluna c do local
+                for (int c = 0; c < 4; ++c)
+                {
+                    Reg l0 = L::load(locals.element(c * 4 + 0) + i);
+                    Reg l1 = L::load(locals.element(c * 4 + 1) + i);
+                    Reg l2 = L::load(locals.element(c * 4 + 2) + i);
+                    Reg l3 = L::load(locals.element(c * 4 + 3) + i);
+                    for (int r = 0; r < 4; ++r)
+                    {
+                        Reg value = L::mul(p[r], l0);
+                        value = L::madd(p[4 + r], l1, value);
+                        value = L::madd(p[8 + r], l2, value);
+                        value = L::madd(p[12 + r], l3, value);
+                        L::store(out.element(c * 4 + r) + i, value);
+                    }
+                }
+            }
+            return i;
+        }
+
+        template <typename L>
+        size_t normalRange(const Mat4Array &matrices, Mat3Array &out, size_t first, size_t count)
+        {
+            using Reg = typename L::Reg;
+            const Reg one = L::set1(1.0f);
+
+            size_t i = first;
+            for (; i + L::kWidth <= count; i += L::kWidth)
+            {
+                // Colunas a0, a1, a2 da parte 3x3
+                Reg a0x = L::load(matrices.element(0) + i), a0y = L::load(matrices.element(1) + i), a0z = L::load(matrices.element(2) + i);
+                Reg a1x = L::load(matrices.element(4) + i), a1y = L::load(matrices.element(5) + i), a1z = L::load(matrices.element(6) + i);
+                Reg a2x = L::load(matrices.element(8) + i), a2y = L::load(matrices.element(9) + i), a2z = L::load(matrices.element(10) + i);
+
+                // inverse(A) tem linhas a1 x a2, a2 x a0, a0 x a1 (divididas por det);
+                // na transposta elas viram as colunas
+                Reg c0x = L::sub(L::mul(a1y, a2z), L::mul(a1z, a2y));
+                Reg c0y = L::sub(L::mul(a1z, a2x), L::mul(a1x, a2z));
+                Reg c0z = L::sub(L::mul(a1x, a2y), L::mul(a1y, a2x));
+                Reg c1x = L::sub(L::mul(a2y, a0z), L::mul(a2z, a0y));
+                Reg c1y = L::sub(L::mul(a2z, a0x), L::mul(a2x, a0z));
+                Reg c1z = L::sub(L::mul(a2x, a0y), L::mul(a2y, a0x));
+                Reg c2x = L::sub(L::mul(a0y, a1z), L::mul(a0z, a1y));
+                Reg c2y = L::sub(L::mul(a0z, a1x), L::mul(a0x, a1z));
+                Reg c2z = L::sub(L::mul(a0x, a1y), L::mul(a0y, a1x));
+
+                Reg det = L::madd(a0z, c0z, L::madd(a0y, c0y, L::mul(a0x, c0x)));
+                Reg invDet = L::div(one, det);
+
+                L::store(out.element(0) + i, L::mul(c0x, invDet));
+                L::store(out.element(1) + i, L::mul(c0y, invDet));
+                L::store(out.element(2) + i, L::mul(c0z, invDet));
+                L::store(out.element(3) + i, L::mul(c1x, invDet));
+                L::store(out.element(4) + i, L::mul(c1y, invDet));
+                L::store(out.element(5) + i, L::mul(c1z, invDet));
+                L::store(out.element(6) + i, L::mul(c2x, invDet));
+                L::store(out.element(7) + i, L::mul(c2y, invDet));
+                L::store(out.element(8) + i, L::mul(c2z, invDet));
+            }
+            return i;
+        }
+    } // namespace
+
+    // =================== ARRAYS ===================
+
+    void Mat4Array::resize(size_t count)
+    {
+        for (std::vector<float> &element : mElements)
+        {
+            element.resize(count);
+        }
+    }
+
+    void Mat4Array::set(size_t index, const glm::mat4 &matrix)
+    {
+        for (int e = 0; e < 16; ++e)
+        {
+            mElements[e][index] = matrix[e / 4][e % 4];
+        }
+    }
+
+    glm::mat4 Mat4Array::get(size_t index) const
+    {
+        glm::mat4 matrix;
+        for (int e = 0; e < 16; ++e)
+        {
+            matrix[e / 4][e % 4] = mElements[e][index];
+        }
+        return matrix;
+    }
+
+    void Mat3Array::resize(size_t count)
+    {
+        for (std::vector<float> &element : mElements)
+        {
+            element.resize(count);
+        }
+    }
+
+    void Mat3Array::set(size_t index, const glm::mat3 &matrix)
+    {
+        for (int e = 0; e < 9; ++e)
+        {
+            mElements[e][index] = matrix[e / 3][e % 3];
+        }
+    }
+
+    glm::mat3 Mat3Array::get(size_t index) const
+    {
+        glm::mat3 matrix;
+        for (int e = 0; e < 9; ++e)
+        {
+            matrix[e / 3][e % 3] = mElements[e][index];
+        }
+        return matrix;
+    }
+
+    void TrsArray::resize(size_t count)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            translation[axis].resize(count);
+            rotation[axis].resize(count);
+            scale[axis].resize(count);
+        }
+    }
+
+    void TrsArray::set(size_t index, const glm::vec3 &t, const glm::vec3 &r, const glm::vec3 &s)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            translation[axis][index] = t[axis];
+            rotation[axis][index] = r[axis];
+            scale[axis][index] = s[axis];
+        }
+    }
+
+    // =================== KERNELS ===================
+
+    glm::mat4 TransformKernel::composeTrs(const glm::vec3 &translation, const glm::vec3 &rotation, const glm::vec3 &scale)
+    {
+        // Mesmas expressões do kernel em lote, com os campos de uma única entrada
+        float sa = std::sin(rotation.x), ca = std::cos(rotation.x);
+        float sb = std::sin(rotation.y), cb = std::cos(rotation.y);
+        float sc = std::sin(rotation.z), cc = std::cos(rotation.z);
+        float sasb = sa * sb;
+        float casb = ca * sb;
+
+        glm::mat4 matrix(1.0f);
+        matrix[0] = glm::vec4(cb * cc, sasb * cc + ca * sc, sa * sc - casb * cc, 0.0f) * scale.x;
+        matrix[1] = glm::vec4(-(cb * sc), ca * cc - sasb * sc, casb * sc + sa * cc, 0.0f) * scale.y;
+        matrix[2] = glm::vec4(sb, -(sa * cb), ca * cb, 0.0f) * scale.z;
+        matrix[3] = glm::vec4(translation, 1.0f);
+        return matrix;
+    }
+
+    void TransformKernel::composeTrs(const TrsArray &trs, Mat4Array &out)
+    {
+        const size_t count = trs.size();
+        out.resize(count);
+        size_t i = 0;
+#if defined(CG_TRANSFORM_WIDE_LANES)
+        i = composeRange<WideLanes>(trs, out, i, count);
+#endif
+        composeRange<ScalarLanes>(trs, out, i, count);
+    }
+
+    void TransformKernel::multiply(const Mat4Array &parents, const Mat4Array &locals, Mat4Array &out)
+    {
+        const size_t count = parents.size();
+        out.resize(count);
+        size_t i = 0;
+#if defined(CG_TRANSFORM_WIDE_LANES)
+        i = multiplyRange<WideLanes>(parents, locals, out, i, count);
+#endif
+        multiplyRange<ScalarLanes>(parents, locals, out, i, count);
+    }
+
+    void TransformKernel::normalMatrices(const Mat4Array &matrices, Mat3Array &out)
+    {
+        const size_t count = matrices.size();
+        out.resize(count);
+        size_t i = 0;
+#if defined(CG_TRANSFORM_WIDE_LANES)
+        i = normalRange<WideLanes>(matrices, out, i, count);
+#endif
+        normalRange<ScalarLanes>(matrices, out, i, count);
+    }
+
+    const char *TransformKernel::getPathName()
+    {
+#if defined(CG_SIMD_AVX2)
+        return "AVX2 + FMA (8 matrizes por lote)";
+#elif defined(CG_SIMD_AVX)
+        return "AVX (8 matrizes por lote)";
+#elif defined(CG_SIMD_SSE)
+        return "SSE (4 matrizes por lote)";
+#else
+        return "escalar";
+#endif
+    }
+
+} // namespace cg
@@ -0,0 +1,174 @@
+#include "render/VertexFormat.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace cg
+{
+
+    // =================== CONVERSÕES ===================
+
+    uint16_t packHalf(float value)
+    {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        uint32_t sign = (bits >> 16) & 0x8000u;
+        uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+        // Infinito e NaN
+        if (magnitude >= 0x7F800000u)
+            return static_cast<uint16_t>(sign | (magnitude > 0x7F800000u ? 0x7E00u : 0x7C00u));
+
+        // Acima do maior half representável (65504, arredondando)
+        if (magnitude >= 0x477FF000u)
+            return static_cast<uint16_t>(sign | 0x7C00u);
+
+        // Abaixo de 2^-14: half subnormal (unidades de 2^-24)
+        if (magnitude < 0x38800000u)
+        {
+            float absValue = 0.0f;
+            std::memcpy(&absValue, &magnitude, sizeof(absValue));
+            return static_cast<uint16_t>(sign | static_cast<uint32_t>(std::lrint(absValue * 16777216.0f)));
+        }
+
+        // Normal: reajusta o expoente (127 -> 15) e arredonda a mantissa para o par mais próximo
+        uint32_t half = (magnitude - 0x38000000u) >> 13;
+        uint32_t remainder = magnitude & 0x1FFFu;
+        if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+            half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    int16_t packSnorm16(float value)
+    {
+        if (!std::isfinite(value))
+            return 0;
+        value = std::clamp(value, -1.0f, 1.0f);
+        return static_cast<int16_t>(std::lround(value * 32767.0f));
+    }
+
+    uint32_t packSnorm10(const glm::vec3 &value)
+    {
+        auto pack = [](float v) -> uint32_t
+        {
+            if (!std::isfinite(v))
+                v = 0.0f;
+            v = std::clamp(v, -1.0f, 1.0f);
+            // Complemento de dois em 10 bits
+            return static_cast<uint32_t>(static_cast<int32_t>(std::lround(v * 511.0f))) & 0x3FFu;
+        };
+        return pack(value.x) | (pack(value.y) << 10) | (pack(value.z) << 20);
+    }
+
+    glm::vec2 encodeOctahedral(const glm::vec3 &normal)
+    {
+        float sum = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+        if (!std::isfinite(sum) || sum <= 0.0f)
+            return glm::vec2(0.0f); // normal inválida: decodifica como (0, 0, 1)
+
+        // Projeta na superfície do octaedro e dobra o hemisfério inferior sobre o superior
+        glm::vec2 p(normal.x / sum, normal.y / sum);
+        if (normal.z < 0.0f)
+        {
+            glm::vec2 folded(1.0f - std::abs(p.y), 1.0f - std::abs(p.x));
+            p.x = folded.x * (p.x >= 0.0f ? 1.0f : -1.0f);
+            p.y = folded.y * (p.y >= 0.0f ? 1.0f : -1.0f);
+        }
+        return p;
+    }
+
+    // =================== PARÂMETROS DE QUANTIZAÇÃO ===================
+
+    QuantizationParams QuantizationParams::fromBounds(const BoundingBox &box)
+    {
+        QuantizationParams params;
+        if (box.isEmpty())
+            return params; // sem posições válidas
+
+        params.positionOffset = box.center();
+        glm::vec3 halfExtent = box.extents();
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            // Eixo sem extensão (mesh plana): qualquer escala não nula reproduz o centro
+            params.positionScale[axis] = halfExtent[axis] > 0.0f ? halfExtent[axis] : 1.0f;
+        }
+        return params;
+    }
+
+    // =================== LAYOUT EM TEMPO DE EXECUÇÃO ===================
+
+    void VertexLayoutInfo::setupAttributes() const
+    {
+        for (const VertexAttribute &attribute : attributes)
+        {
+            glEnableVertexAttribArray(attribute.location);
+            glVertexAttribPointer(attribute.location, attribute.components, attribute.type, attribute.normalized,
+                                  static_cast<GLsizei>(stride), reinterpret_cast<const void *>(static_cast<uintptr_t>(attribute.offset)));
+        }
+    }
+
+    std::string VertexLayoutInfo::glslPrelude() const
+    {
+        std::string prelude;
+        for (const char *snippet : glsl)
+        {
+            prelude += snippet;
+        }
+        return prelude;
+    }
+
+    namespace
+    {
+        // Conversões usadas pelos trechos glslEncode (mesmos arredondamentos de
+        // packHalf, packSnorm16 e packSnorm10; GLSL 3.30 não tem packHalf2x16)
+        const char *kGlslEncodeHelpers = R"GLSL(
+        uint encodeHalf(float value) {
+            uint bits = floatBitsToUint(value);
+            uint signBit = (bits >> 16) & 0x8000u;
+            uint magnitude = bits & 0x7FFFFFFFu;
+            if (magnitude >= 0x7F800000u) return signBit | (magnitude > 0x7F800000u ? 0x7E00u : 0x7C00u);
+            if (magnitude >= 0x477FF000u) return signBit | 0x7C00u;
+            if (magnitude < 0x38800000u) return signBit | uint(roundEven(uintBitsToFloat(magnitude) * 16777216.0));
+            uint result = (magnitude - 0x38000000u) >> 13;
+            uint remainder = magnitude & 0x1FFFu;
+            if (remainder > 0x1000u || (remainder == 0x1000u && (result & 1u) != 0u)) result++;
+            return signBit | result;
+        }
+        uint encodeSnorm(float value, float range, uint mask) {
+            if (isnan(value) || isinf(value)) return 0u;
+            float scaled = clamp(value, -1.0, 1.0) * range;
+            return uint(int(scaled + (scaled >= 0.0 ? 0.5 : -0.5))) & mask;
+        }
+        uint encodeSnorm16(float value) { return encodeSnorm(value, 32767.0, 0xFFFFu); }
+        uint encodeSnorm10(float value) { return encodeSnorm(value, 511.0, 0x3FFu); }
+    )GLSL";
+    } // namespace
+
+    std::string VertexLayoutInfo::glslEncoder() const
+    {
+        std::string encoder = kGlslEncodeHelpers;
+        for (const char *snippet : glslEncode)
+        {
+            encoder += snippet;
+        }
+        return encoder;
+    }
+
+    const VertexLayoutInfo &getVertexLayout(VertexFormat format)
+    {
+        switch (format)
+        {
+        case VertexFormat::Compact:
+            return CompactVertexLayout::info();
+        case VertexFormat::CompactOctahedral:
+            return CompactOctahedralVertexLayout::info();
+        case VertexFormat::HalfFloat:
+            return HalfFloatVertexLayout::info();
+        case VertexFormat::Standard:
+        default:
+            return StandardVertexLayout::info();
+        }
+    }
+
+} // namespace cg